@@ -1,3 +1,7 @@
 ./build_server.sh
 printf "************************************************************************************\n\n"
 ./build_manager.sh
+printf "************************************************************************************\n\n"
+./build_vrfyidx.sh
+printf "************************************************************************************\n\n"
+./build_logdecode.sh
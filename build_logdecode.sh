@@ -0,0 +1,27 @@
+exec_name=logdecode.bin
+target_exec_name=logdecode.bin
+could_build=0
+
+if [ $# -ge 1 ]; then
+    target_exec_name=$1
+fi
+
+cd ./src/logdecode
+make clean
+CC=gcc make
+
+if [ $? -eq 0 ]; then
+    mv $exec_name ../../$target_exec_name
+    could_build=1
+fi
+
+make clean
+
+if [ $could_build -eq 1 ]; then
+    echo ""
+    echo "********************"
+    echo "* Build successful *"
+    echo "********************"
+    echo ""
+fi
+
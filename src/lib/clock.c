@@ -0,0 +1,63 @@
+#include "clock.h"
+
+/****************************************************************/
+/* Module-global variables                                      */
+/****************************************************************/
+
+typedef struct {
+    time_t      sec;                            // Second the cache refers to (0: never refreshed).
+    struct tm   tm;
+    char        datetime[CLOCK_DATETIME_LEN];
+} _ClockCache_t;
+
+static _Thread_local _ClockCache_t cache;
+
+/****************************************************************/
+/* Private function declarations                                */
+/****************************************************************/
+
+/**
+ * \brief       Refresh the cache of the calling thread if the second has changed.
+ */
+static void refresh(void);
+
+/****************************************************************/
+/* Public function definitions                                  */
+/****************************************************************/
+
+time_t Clock_now(void){
+    refresh();
+    return cache.sec;
+}
+
+void Clock_localtime(struct tm * tm){
+    refresh();
+    * tm = cache.tm;
+}
+
+const char * Clock_datetime(void){
+    refresh();
+    return cache.datetime;
+}
+
+uint64_t Clock_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/****************************************************************/
+/* Private function definitions                                 */
+/****************************************************************/
+
+static void refresh(void){
+    time_t now = time(NULL);
+    if (now == cache.sec){
+        return;
+    }
+    cache.sec = now;
+    localtime_r(&now, &cache.tm);
+    if (strftime(cache.datetime, CLOCK_DATETIME_LEN, CLOCK_DATETIME_FORMAT, &cache.tm) == 0){
+        cache.datetime[0] = '\0';
+    }
+}
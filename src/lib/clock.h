@@ -0,0 +1,60 @@
+/**
+ * \file        clock.h
+ * \brief       Wall clock with the local time and its formatted date and time cached,
+ *              so that they are computed at most once per second.
+ *
+ * \details     `localtime_r (3)` and `strftime (3)` are comparatively expensive (the
+ *              former may even check the timezone settings on every call), while most
+ *              callers (logs, mail file names) only need one-second resolution. The
+ *              cache is refreshed when `time (2)` (a vDSO call on Linux) reports a new
+ *              second. Each thread has its own cache, so no locking is involved.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __CLOCK_H__
+#define __CLOCK_H__
+
+#include <stdint.h>     // uint64_t
+#include <time.h>       // time_t, struct tm
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Maximum formatted date and time length, including the null terminator */
+#define CLOCK_DATETIME_LEN      32
+
+/* Date and time format as required by strftime (3). Must be CLOCK_DATETIME_LEN chars at most. */
+#define CLOCK_DATETIME_FORMAT   "%Y/%m/%d-%H:%M:%S"
+
+/*************************************************************************/
+
+/**
+ * \brief       Current time, in seconds since the Epoch.
+ */
+time_t Clock_now(void);
+
+/**
+ * \brief       Current local time.
+ *
+ * \param[out] tm           Where to store the broken-down local time.
+ */
+void Clock_localtime(struct tm * tm);
+
+/**
+ * \brief       Current local date and time, formatted as CLOCK_DATETIME_FORMAT.
+ *
+ * \return      A string owned by the clock, valid until the calling thread calls any
+ *              function of this module again.
+ */
+const char * Clock_datetime(void);
+
+/**
+ * \brief       Monotonic time, in nanoseconds since an unspecified point, to measure
+ *              intervals. Not cached.
+ */
+uint64_t Clock_ns(void);
+
+#endif // __CLOCK_H__
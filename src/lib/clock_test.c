@@ -0,0 +1,44 @@
+#include "clock.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* Format the local time the slow way, as the clock did before caching */
+static time_t reference(char * buff, struct tm * tm){
+    time_t now = time(NULL);
+    localtime_r(&now, tm);
+    strftime(buff, CLOCK_DATETIME_LEN, CLOCK_DATETIME_FORMAT, tm);
+    return now;
+}
+
+int main (void){
+    char expected[CLOCK_DATETIME_LEN];
+    struct tm expected_tm, tm;
+
+    /* Retry if the second changes in between */
+    bool matched = false;
+    for (int i = 0; i < 3 && ! matched; i++){
+        time_t before = reference(expected, &expected_tm);
+        const char * datetime = Clock_datetime();
+        Clock_localtime(&tm);
+        time_t now = Clock_now();
+        if (now != before || time(NULL) != before){
+            continue;
+        }
+        assert(strcmp(datetime, expected) == 0);
+        assert(tm.tm_year == expected_tm.tm_year && tm.tm_mon == expected_tm.tm_mon && tm.tm_mday == expected_tm.tm_mday);
+        assert(tm.tm_hour == expected_tm.tm_hour && tm.tm_min == expected_tm.tm_min && tm.tm_sec == expected_tm.tm_sec);
+        matched = true;
+    }
+    assert(matched);
+
+    /* The formatted string is cached, not rebuilt */
+    assert(Clock_datetime() == Clock_datetime());
+
+    /* Monotonic time never goes back */
+    uint64_t start = Clock_ns();
+    assert(Clock_ns() >= start);
+
+    puts("Clock: All tests passed!");
+}
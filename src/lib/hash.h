@@ -0,0 +1,40 @@
+/**
+ * \file        hash.h
+ * \brief       Hash functions shared by the hash tables and on-disk indexes of the server.
+ *
+ * \details     Files written by the server (such as the VRFY index, see vrfy_index.h) and
+ *              the shard of every log store mailbox (see logstore.h) depend on these
+ *              values: they must never change.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __HASH_H__
+#define __HASH_H__
+
+#include <stdint.h>     // uint8_t, uint32_t
+
+#define HASH_FNV1A_BASIS    2166136261U
+#define HASH_FNV1A_PRIME    16777619U
+
+/**
+ * \brief       Continue a 32-bit FNV-1a hash with a null-terminated string, as if it had
+ *              been appended to the one `hash` was computed from.
+ */
+static inline uint32_t Hash_fnv1a_update(uint32_t hash, const char * str){
+    while (* str != '\0'){
+        hash ^= (uint8_t) * str++;
+        hash *= HASH_FNV1A_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * \brief       32-bit FNV-1a hash of a null-terminated string.
+ */
+static inline uint32_t Hash_fnv1a(const char * str){
+    return Hash_fnv1a_update(HASH_FNV1A_BASIS, str);
+}
+
+#endif // __HASH_H__
@@ -1,90 +1,143 @@
 /**
  * \file        hashmap.c
  * \brief       Implementation of a HashMap.
- * 
+ *
  * \date        May, 2024
  * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
 */
 
 #include "hashmap.h"
 
-#define HASHMAP_DEFAULT_HASH_TABLE_SIZE 100
+#define HASHMAP_MIN_CAPACITY    8
+#define HASHMAP_FIBONACCI       11400714819323198485ULL     // 2^64 / golden ratio
 
-typedef struct _HashMap_Node_t{
+typedef struct _HashMap_Slot_t{
     HashMapKey                  key;
+    uint32_t                    dist;       // Distance to the home slot plus 1. 0 for empty slots.
     HashMapValue                val;
-    struct _HashMap_Node_t *    next;
-} _HashMap_Node_t;
+} _HashMap_Slot_t;
 
 typedef struct _HashMap_t{
-    struct _HashMap_Node_t **   table;
-    size_t                      table_size;
-    HashMapHashFunction         hash_fn;
-    HashMapKeyEqualsCallback    equals_fn;
+    struct _HashMap_Slot_t *    table;
+    size_t                      table_size; // Always a power of two.
+    unsigned                    shift;      // 64 - log2(table_size), for the built-in hash.
+    HashMapHashFunction         hash_fn;    // NULL for the built-in hash.
+    HashMapKeyEqualsCallback    equals_fn;  // NULL for ==.
     int32_t elem_count;
 } _HashMap_t;
 
-static HashMapErrors HashMap_find(HashMap map, HashMapKey key, HashMapValue * val, bool remove_on_found){
-    // Find position in the hash table
-    uint32_t position = map->hash_fn(key, map->table_size);
-    if (position >= map->table_size){ // As hash_fn is customizable, check if the returned position is within the hash table bounds
+/**
+ * \brief       Find the home slot of a key in a table of `size` slots.
+ *
+ * \return      HASHMAP_OK, or HASHMAP_BAD_HASH_FUNCTION if the hash function returned an
+ *              out of bounds position.
+ */
+static HashMapErrors HashMap_home(HashMap map, HashMapKey key, size_t size, unsigned shift, size_t * home){
+    if (map->hash_fn == NULL){
+        * home = (size_t) (((uint64_t) key * HASHMAP_FIBONACCI) >> shift);
+        return HASHMAP_OK;
+    }
+    uint32_t position = map->hash_fn(key, size);
+    if (position >= size){ // As hash_fn is customizable, check if the returned position is within the hash table bounds
         return HASHMAP_BAD_HASH_FUNCTION;
     }
+    * home = position;
+    return HASHMAP_OK;
+}
 
-    // Find the node inside the linked list for the calculated position in the hash table
-    _HashMap_Node_t * previous_node = NULL;
-    _HashMap_Node_t * current_node = map->table[position];
-    while(current_node != NULL && ! map->equals_fn(current_node->key, key)){
-        previous_node = current_node;
-        current_node = current_node->next;
-    }
-    if (current_node == NULL){
-        return HASHMAP_KEY_NOT_FOUND;
-    }
+static inline bool HashMap_equals(HashMap map, HashMapKey key1, HashMapKey key2){
+    return map->equals_fn == NULL ? key1 == key2 : map->equals_fn(key1, key2);
+}
 
-    // Store the value
-    if (val != NULL){
-        * val = current_node->val;
+/**
+ * \brief       Find the slot that holds a key.
+ *
+ * \return      HASHMAP_OK (and the slot index in `index`), HASHMAP_KEY_NOT_FOUND or HASHMAP_BAD_HASH_FUNCTION.
+ */
+static HashMapErrors HashMap_find(HashMap map, HashMapKey key, size_t * index){
+    size_t position;
+    HashMapErrors err = HashMap_home(map, key, map->table_size, map->shift, &position);
+    if (err != HASHMAP_OK){
+        return err;
     }
-    
-    // Remove the value if asked to do so
-    if (remove_on_found){
-        if (previous_node == NULL){ // The key was found in the first node of the linked list
-            map->table[position] = current_node->next;
-        }
-        else{
-            previous_node->next = current_node->next;
+
+    // Entries are ordered by distance to their home slot, so the key cannot be past an entry that is closer to its own
+    size_t mask = map->table_size - 1;
+    for (uint32_t dist = 1; map->table[position].dist >= dist; dist++){
+        if (map->table[position].dist == dist && HashMap_equals(map, map->table[position].key, key)){
+            * index = position;
+            return HASHMAP_OK;
         }
-        HASHMAP_FREE(current_node);
+        position = (position + 1) & mask;
     }
-
-    // Found!
-    return HASHMAP_OK;
+    return HASHMAP_KEY_NOT_FOUND;
 }
 
-HashMap HashMap_create(HashMapHashFunction hash_fn, HashMapKeyEqualsCallback equals_fn){
-    return HashMap_create_sized(hash_fn, equals_fn, HASHMAP_DEFAULT_HASH_TABLE_SIZE);
+/**
+ * \brief       Insert an entry known not to be present, displacing entries closer to their home slot.
+ */
+static void HashMap_insert(_HashMap_Slot_t * table, size_t mask, size_t position, _HashMap_Slot_t entry){
+    entry.dist = 1;
+    while (table[position].dist != 0){
+        if (table[position].dist < entry.dist){
+            _HashMap_Slot_t displaced = table[position];
+            table[position] = entry;
+            entry = displaced;
+        }
+        position = (position + 1) & mask;
+        entry.dist++;
+    }
+    table[position] = entry;
 }
 
-HashMap HashMap_create_sized(HashMapHashFunction hash_fn, HashMapKeyEqualsCallback equals_fn, const size_t table_size){
-    // Check parameters
-    if (hash_fn == NULL || equals_fn == NULL){
-        return NULL;
+/**
+ * \brief       Move every entry to a new table of `size` slots (a power of two).
+ */
+static HashMapErrors HashMap_resize(HashMap map, size_t size){
+    unsigned shift = 64;
+    for (size_t s = size; s > 1; s >>= 1){
+        shift--;
+    }
+    _HashMap_Slot_t * table = HASHMAP_CALLOC(size, sizeof(_HashMap_Slot_t)); // Every slot is initialized as empty
+    if (table == NULL){
+        return HASHMAP_NO_MEMORY;
     }
+    for (size_t i = 0; i < map->table_size; i++){
+        if (map->table[i].dist == 0){
+            continue;
+        }
+        size_t position;
+        if (HashMap_home(map, map->table[i].key, size, shift, &position) != HASHMAP_OK){
+            HASHMAP_FREE(table);
+            return HASHMAP_BAD_HASH_FUNCTION;
+        }
+        HashMap_insert(table, size - 1, position, map->table[i]);
+    }
+    HASHMAP_FREE(map->table);
+    map->table = table;
+    map->table_size = size;
+    map->shift = shift;
+    return HASHMAP_OK;
+}
 
+static HashMap HashMap_new(HashMapHashFunction hash_fn, HashMapKeyEqualsCallback equals_fn, size_t capacity){
     // Create HashMap structure
     HashMap map = HASHMAP_MALLOC(sizeof(_HashMap_t));
     if (map  == NULL){
         return NULL;
     }
-    map->table_size = table_size;
+    map->table = NULL;
+    map->table_size = 0;
     map->hash_fn = hash_fn;
     map->equals_fn = equals_fn;
     map->elem_count = 0;
-    
+
     // Create table
-    map->table = HASHMAP_CALLOC(map->table_size, sizeof(_HashMap_Node_t *)); // Each element is initialized to 0 (NULL)
-    if (map->table == NULL){
+    size_t size = HASHMAP_MIN_CAPACITY;
+    while (size < capacity && size <= SIZE_MAX / 2){
+        size <<= 1;
+    }
+    if (HashMap_resize(map, size) != HASHMAP_OK){
         HASHMAP_FREE(map);
         return NULL;
     }
@@ -93,91 +146,104 @@ HashMap HashMap_create_sized(HashMapHashFunction hash_fn, HashMapKeyEqualsCallba
     return map;
 }
 
+HashMap HashMap_create_default(const size_t capacity){
+    // Make room for `capacity` elements without growing
+    size_t size = capacity <= SIZE_MAX / 100 ? capacity * 100 / HASHMAP_MAX_LOAD_FACTOR + 1 : capacity;
+    return HashMap_new(NULL, NULL, size);
+}
+
+HashMap HashMap_create(HashMapHashFunction hash_fn, HashMapKeyEqualsCallback equals_fn){
+    return HashMap_create_sized(hash_fn, equals_fn, HASHMAP_DEFAULT_CAPACITY);
+}
+
+HashMap HashMap_create_sized(HashMapHashFunction hash_fn, HashMapKeyEqualsCallback equals_fn, const size_t table_size){
+    // Check parameters
+    if (hash_fn == NULL || equals_fn == NULL){
+        return NULL;
+    }
+    return HashMap_new(hash_fn, equals_fn, table_size);
+}
+
 HashMapErrors HashMap_put(HashMap const map, const HashMapKey key, const HashMapValue val){
-    if (map == NULL || map->table == NULL || map->hash_fn == NULL || map->equals_fn == NULL){
+    if (map == NULL || map->table == NULL){
         return HASHMAP_INVALID_STATE;
     }
-    // Find position in the hash table
-    uint32_t position = map->hash_fn(key, map->table_size);
-    if (position >= map->table_size){ // As hash_fn is customizable, check if the returned position is within the hash table bounds
-        return HASHMAP_BAD_HASH_FUNCTION;
-    }
-    // Traverse the linked list for the calculated position
-    _HashMap_Node_t * previous_node = NULL;
-    _HashMap_Node_t * current_node = map->table[position];
-    while (current_node != NULL){
-        // Make sure that the provided key is not already present in the Hash Map
-        if (map->equals_fn(current_node->key, key)){
-            return HASHMAP_DUPLICATED_KEY;
-        }
-        previous_node = current_node;
-        current_node = current_node->next;
+    // Make sure that the provided key is not already present in the Hash Map
+    size_t position;
+    HashMapErrors err = HashMap_find(map, key, &position);
+    if (err != HASHMAP_KEY_NOT_FOUND){
+        return err == HASHMAP_OK ? HASHMAP_DUPLICATED_KEY : err;
     }
-    // Create a new node
-    _HashMap_Node_t * new_node = HASHMAP_MALLOC(sizeof(_HashMap_Node_t));
-    if (new_node == NULL){
+    // Grow the table if the load factor would exceed its maximum
+    if (map->elem_count == INT32_MAX){
         return HASHMAP_NO_MEMORY;
     }
-    new_node->key = key;
-    new_node->val = val;
-    new_node->next = NULL;
-    // Insert the new node into the list
-    if (previous_node == NULL){ // No node in that table position
-        map->table[position] = new_node;
+    if (((size_t) map->elem_count + 1) * 100 > map->table_size * HASHMAP_MAX_LOAD_FACTOR){
+        if (map->table_size > SIZE_MAX / 2 / sizeof(_HashMap_Slot_t)){
+            return HASHMAP_NO_MEMORY;
+        }
+        if ((err = HashMap_resize(map, map->table_size * 2)) != HASHMAP_OK){
+            return err;
+        }
     }
-    else {
-        previous_node->next = new_node;
+    // Insert the new entry
+    if ((err = HashMap_home(map, key, map->table_size, map->shift, &position)) != HASHMAP_OK){
+        return err;
     }
+    HashMap_insert(map->table, map->table_size - 1, position, (_HashMap_Slot_t){ .key = key, .val = val });
     // Increment the size
     map->elem_count++;
     return HASHMAP_OK;
 }
 
 HashMapErrors HashMap_peek(HashMap const map, const HashMapKey key, HashMapValue * val){
-    if (map == NULL || map->table == NULL || map->hash_fn == NULL || map->equals_fn == NULL){
+    if (map == NULL || map->table == NULL){
         return HASHMAP_INVALID_STATE;
     }
-    HashMapValue value;
-    switch (HashMap_find(map, key, &value, false)){
-        case HASHMAP_KEY_NOT_FOUND:
-            return HASHMAP_KEY_NOT_FOUND;
-        case HASHMAP_BAD_HASH_FUNCTION:
-            return HASHMAP_BAD_HASH_FUNCTION;
-        default:
-            break;
+    size_t position;
+    HashMapErrors err = HashMap_find(map, key, &position);
+    if (err != HASHMAP_OK){
+        return err;
     }
     if (val != NULL){
-        * val = value;
+        * val = map->table[position].val;
     }
     return HASHMAP_OK;
 }
 
 HashMapErrors HashMap_pop(HashMap const map, const HashMapKey key, HashMapValue * val){
-    if (map == NULL || map->table == NULL || map->hash_fn == NULL || map->equals_fn == NULL){
+    if (map == NULL || map->table == NULL){
         return HASHMAP_INVALID_STATE;
     }
-    HashMapValue value;
-    switch (HashMap_find(map, key, &value, true)){
-        case HASHMAP_KEY_NOT_FOUND:
-            return HASHMAP_KEY_NOT_FOUND;
-        case HASHMAP_BAD_HASH_FUNCTION:
-            return HASHMAP_BAD_HASH_FUNCTION;
-        default:
-            break;
+    size_t position;
+    HashMapErrors err = HashMap_find(map, key, &position);
+    if (err != HASHMAP_OK){
+        return err;
     }
     if (val != NULL){
-        * val = value;
+        * val = map->table[position].val;
+    }
+    // Shift back the following entries until an empty slot or an entry in its home slot
+    size_t mask = map->table_size - 1;
+    size_t next = (position + 1) & mask;
+    while (map->table[next].dist > 1){
+        map->table[position] = map->table[next];
+        map->table[position].dist--;
+        position = next;
+        next = (next + 1) & mask;
     }
+    map->table[position].dist = 0;
     // Decrement the size
     map->elem_count--;
     return HASHMAP_OK;
-}   
+}
 
 bool HashMap_contains(HashMap const map, const HashMapKey key){
-    if (map == NULL || map->table == NULL || map->hash_fn == NULL || map->equals_fn == NULL){
+    if (map == NULL || map->table == NULL){
         return false;
     }
-    return HashMap_find(map, key, NULL, false) == HASHMAP_OK;
+    size_t position;
+    return HashMap_find(map, key, &position) == HASHMAP_OK;
 }
 
 void HashMap_cleanup(HashMap const map, HashMapCleanupCallback cb){
@@ -185,16 +251,11 @@ void HashMap_cleanup(HashMap const map, HashMapCleanupCallback cb){
         return;
     }
     if (map->table != NULL){
-        for (unsigned int i = 0; i < map->table_size; i++){
-            _HashMap_Node_t * current_node = map->table[i];
-            _HashMap_Node_t * next_node = NULL;
-            while (current_node != NULL){
-                if (cb != NULL){
-                    cb(current_node->val);
+        if (cb != NULL){
+            for (size_t i = 0; i < map->table_size; i++){
+                if (map->table[i].dist != 0){
+                    cb(map->table[i].val);
                 }
-                next_node = current_node->next;
-                HASHMAP_FREE(current_node);
-                current_node = next_node;
             }
         }
         HASHMAP_FREE(map->table);
@@ -203,7 +264,7 @@ void HashMap_cleanup(HashMap const map, HashMapCleanupCallback cb){
 }
 
 int32_t HashMap_size(HashMap const map){
-    if (map == NULL || map->table == NULL || map->hash_fn == NULL || map->equals_fn == NULL){
+    if (map == NULL || map->table == NULL){
         return HASHMAP_INVALID_STATE;
     }
     return map->elem_count;
@@ -1,6 +1,15 @@
 /**
  * \file        hashmap.h
  * \brief       Implementation of a HashMap.
+ *
+ * \details     Open addressing with robin hood probing: entries (key and value) are
+ *              stored inline in a single table, with no allocation per insert. Each entry
+ *              keeps its distance to its home slot, and insertions displace entries that
+ *              are closer to their home slot than the one being inserted, so that probe
+ *              sequences stay short even with high load factors. Removals shift the
+ *              following entries back instead of leaving tombstones. The table doubles its
+ *              capacity (a power of two) whenever the load factor would exceed
+ *              HASHMAP_MAX_LOAD_FACTOR.
  * 
  * \date        May, 2024
  * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
@@ -30,12 +39,22 @@
 
 /* Data type used for the Keys. */
 /* This type must be trivially copyable (via assignment). I.e. it cannot be an array type like char[], use char* instead. */
-#define HASHMAP_KEY_DATA_TYPE uint16_t
+/* It must be a scalar type (an integer or a pointer) of up to 64 bits, i.e. uint32_t, uint64_t or char*. HashMaps created */
+/* with HashMap_create_default() compare Keys with ==, so pointers are compared by address. */
+#ifndef HASHMAP_KEY_DATA_TYPE
+#define HASHMAP_KEY_DATA_TYPE uint32_t
+#endif
 
 /* Data type used for the Values. */
 /* This type must be trivially copyable (via assignment). I.e. it cannot be an array type like char[], use char* instead. */
 #define HASHMAP_VAL_DATA_TYPE void *
 
+/* Initial capacity used by HashMap_create(). */
+#define HASHMAP_DEFAULT_CAPACITY 64
+
+/* Maximum load factor (in percent) before the table grows. */
+#define HASHMAP_MAX_LOAD_FACTOR 85
+
 /*************************************************************************/
 /*                           NON - CUSTOMIZABLE                          */
 /*************************************************************************/
@@ -56,7 +75,7 @@ typedef HASHMAP_VAL_DATA_TYPE HashMapValue;
 typedef struct _HashMap_t * HashMap;
 
 /**
- * \typedef Hashing function callback
+ * \typedef Hashing function callback. It is called again for every Key whenever the table grows.
 */
 typedef uint32_t (* HashMapHashFunction) (const HashMapKey key, const size_t hash_table_size);
 
@@ -88,7 +107,17 @@ typedef enum {
 /*************************************************************************/
 
 /**
- * \brief       Initializes a new HashMap using the default hash table size (100).
+ * \brief       Initializes a new HashMap using the built-in hash function (Fibonacci hashing) and
+ *              comparing Keys with ==. This is the fastest option for integer Keys.
+ *
+ * \param[in]  capacity  Expected amount of elements. The HashMap grows beyond it as needed.
+ *
+ * \return      A new HashMap on success, NULL on failure (memory not available).
+ */
+HashMap HashMap_create_default(const size_t capacity);
+
+/**
+ * \brief       Initializes a new HashMap using the default initial capacity (HASHMAP_DEFAULT_CAPACITY).
  * 
  * \param[in]  hash_fn   Function used to perform hashing operations according to the HashMapKey data type.
  * \param[in]  equals_fn Function used to indicate whether 2 elements of type HashMapKey are equal or not.
@@ -98,12 +127,12 @@ typedef enum {
 HashMap HashMap_create(HashMapHashFunction hash_fn, HashMapKeyEqualsCallback equals_fn);
 
 /**
- * \brief       Initializes a new HashMap indicating a hash table size.
+ * \brief       Initializes a new HashMap indicating an initial hash table size.
  * 
  * \param[in]  hash_fn   Function used to perform hashing operations according to the HashMapKey data type.
  * \param[in]  equals_fn Function used to indicate whether 2 elements of type HashMapKey are equal or not.
- * \param[in]  size      Size of the internal hash table. A bigger size typically improves performance, but also 
- *                       increases memory usage.
+ * \param[in]  size      Initial size of the internal hash table, rounded up to a power of two. The table grows
+ *                       as needed, so this only saves the first resizes.
  * 
  * \return      A new HashMap on success, NULL on failure (memory not available or NULL passed as a function).
  */
@@ -6,6 +6,8 @@
 #include <stdlib.h>
 
 #define TEST_COUNT 65534
+#define DEFAULT_TEST_COUNT 200000
+#define DEFAULT_TEST_KEY(i) ((HashMapKey) (i) * 2654435761U + 70000)    // Spread keys, all beyond 16 bits
 
 static unsigned int num_digits(unsigned int number) {
     if (number == 0){
@@ -19,13 +21,13 @@ static unsigned int num_digits(unsigned int number) {
     return digits;
 }
 
-static uint32_t multiplicative_hash(const uint16_t key, const size_t size) {
+static uint32_t multiplicative_hash(const HashMapKey key, const size_t size) {
     const unsigned long long A = 2654435769U; // Knuth's multiplicative constant. See https://gist.github.com/badboy/6267743.
     unsigned long long hash = key * A;
     return (hash >> (32 - num_digits(size))) % size;
 }
 
-static bool key_equals(const uint16_t key1, const uint16_t key2){
+static bool key_equals(const HashMapKey key1, const HashMapKey key2){
     return key1 == key2;
 }
 
@@ -44,6 +46,44 @@ static void cleanup_callback(HashMapValue val) {
     free(val);
 }
 
+/* Built-in hash: growth from a small table, removals (backward shifts) and reinsertions */
+static void test_default(void) {
+    HashMap map = HashMap_create_default(0);
+    HashMapValue val;
+    assert(map != NULL);
+
+    for (uintptr_t i = 0; i < DEFAULT_TEST_COUNT; i++) {
+        assert(HashMap_put(map, DEFAULT_TEST_KEY(i), (HashMapValue) i) == HASHMAP_OK);
+    }
+    assert(HashMap_size(map) == DEFAULT_TEST_COUNT);
+    assert(HashMap_put(map, DEFAULT_TEST_KEY(7), NULL) == HASHMAP_DUPLICATED_KEY);
+
+    // Remove every odd key
+    for (uintptr_t i = 1; i < DEFAULT_TEST_COUNT; i += 2) {
+        assert(HashMap_pop(map, DEFAULT_TEST_KEY(i), &val) == HASHMAP_OK);
+        assert((uintptr_t) val == i);
+    }
+    assert(HashMap_size(map) == DEFAULT_TEST_COUNT / 2);
+    for (uintptr_t i = 0; i < DEFAULT_TEST_COUNT; i++) {
+        assert(HashMap_contains(map, DEFAULT_TEST_KEY(i)) == (i % 2 == 0));
+        if (i % 2 == 0) {
+            assert(HashMap_peek(map, DEFAULT_TEST_KEY(i), &val) == HASHMAP_OK);
+            assert((uintptr_t) val == i);
+        }
+    }
+
+    // Insert the odd keys back
+    for (uintptr_t i = 1; i < DEFAULT_TEST_COUNT; i += 2) {
+        assert(HashMap_put(map, DEFAULT_TEST_KEY(i), (HashMapValue) i) == HASHMAP_OK);
+    }
+    for (uintptr_t i = 0; i < DEFAULT_TEST_COUNT; i++) {
+        assert(HashMap_peek(map, DEFAULT_TEST_KEY(i), &val) == HASHMAP_OK);
+        assert((uintptr_t) val == i);
+    }
+    assert(HashMap_size(map) == DEFAULT_TEST_COUNT);
+    HashMap_cleanup(map, NULL);
+}
+
 int main(void) {
     HashMap map = HashMap_create(multiplicative_hash, key_equals);
     HashMapValue val;
@@ -145,5 +185,7 @@ int main(void) {
     HashMap_cleanup(map, cleanup_callback);
     // Do not check size after cleanup, since map is invalid after cleanup
 
+    test_default();
+
     puts("HashMap: All tests passed!");
 }
@@ -0,0 +1,141 @@
+/**
+ * \file        histogram.c
+ * \brief       Histogram of non-negative integer values (such as latencies), with fixed
+ *              memory and lock-free recording.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdatomic.h>  // atomic_ullong, atomic_fetch_add_explicit()
+
+#include "histogram.h"
+
+#define SUB_BUCKETS     (1ULL << HISTOGRAM_SUB_BUCKET_BITS)
+
+typedef struct _Histogram_t {
+    atomic_ullong   count;
+    atomic_ullong   sum;
+    atomic_ullong   max;
+    atomic_ullong   buckets[HISTOGRAM_BUCKET_QTY];
+} _Histogram_t;
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+/**
+ * \brief       Index of the bucket where `value` is counted.
+ *
+ * \details     Values below SUB_BUCKETS have a bucket each. Above, a value whose highest
+ *              set bit is bit `e` falls in block `e - HISTOGRAM_SUB_BUCKET_BITS + 1`, and
+ *              in the sub-bucket given by the HISTOGRAM_SUB_BUCKET_BITS bits below bit `e`.
+ */
+static size_t bucket_of(uint64_t value);
+
+/**
+ * \brief       Highest value counted in a bucket.
+ */
+static uint64_t bucket_max(size_t bucket);
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+Histogram Histogram_create(void){
+    Histogram self = HISTOGRAM_MALLOC(sizeof(_Histogram_t));
+    if (self == NULL){
+        return NULL;
+    }
+    atomic_init(&(self->count), 0);
+    atomic_init(&(self->sum), 0);
+    atomic_init(&(self->max), 0);
+    for (size_t i = 0; i < HISTOGRAM_BUCKET_QTY; i++){
+        atomic_init(&(self->buckets[i]), 0);
+    }
+    return self;
+}
+
+void Histogram_record(Histogram const self, uint64_t value){
+    if (self == NULL){
+        return;
+    }
+    atomic_fetch_add_explicit(&(self->buckets[bucket_of(value)]), 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&(self->count), 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&(self->sum), value, memory_order_relaxed);
+    unsigned long long max = atomic_load_explicit(&(self->max), memory_order_relaxed);
+    while (value > max && ! atomic_compare_exchange_weak_explicit(&(self->max), &max, value,
+                                                                   memory_order_relaxed, memory_order_relaxed));
+}
+
+uint64_t Histogram_count(Histogram const self){
+    return self == NULL ? 0 : atomic_load_explicit(&(self->count), memory_order_relaxed);
+}
+
+uint64_t Histogram_sum(Histogram const self){
+    return self == NULL ? 0 : atomic_load_explicit(&(self->sum), memory_order_relaxed);
+}
+
+uint64_t Histogram_max(Histogram const self){
+    return self == NULL ? 0 : atomic_load_explicit(&(self->max), memory_order_relaxed);
+}
+
+uint64_t Histogram_percentile(Histogram const self, double percentile){
+    uint64_t count = Histogram_count(self);
+    if (count == 0){
+        return 0;
+    }
+    if (percentile < 0){
+        percentile = 0;
+    }
+    else if (percentile > 100){
+        percentile = 100;
+    }
+
+    /* Rank of the value sought, among the values recorded in ascending order */
+    double exact = percentile / 100 * count;
+    uint64_t rank = (uint64_t) exact;
+    if (rank < exact || rank == 0){
+        rank++;
+    }
+
+    uint64_t max = Histogram_max(self);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKET_QTY; i++){
+        seen += atomic_load_explicit(&(self->buckets[i]), memory_order_relaxed);
+        if (seen >= rank){
+            uint64_t value = bucket_max(i);
+            return value < max ? value : max;
+        }
+    }
+    return max;         // Values recorded while counting
+}
+
+void Histogram_cleanup(Histogram self){
+    if (self == NULL){
+        return;
+    }
+    HISTOGRAM_FREE(self);
+}
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static size_t bucket_of(uint64_t value){
+    if (value < SUB_BUCKETS){
+        return value;
+    }
+    unsigned shift = 63 - __builtin_clzll(value) - HISTOGRAM_SUB_BUCKET_BITS;
+    return ((shift + 1) << HISTOGRAM_SUB_BUCKET_BITS) + ((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+static uint64_t bucket_max(size_t bucket){
+    size_t block = bucket >> HISTOGRAM_SUB_BUCKET_BITS;
+    uint64_t sub = bucket & (SUB_BUCKETS - 1);
+    if (block == 0){
+        return sub;
+    }
+    unsigned shift = block - 1;
+    return ((SUB_BUCKETS + sub) << shift) + ((1ULL << shift) - 1);
+}
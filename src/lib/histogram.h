@@ -0,0 +1,97 @@
+/**
+ * \file        histogram.h
+ * \brief       Histogram of non-negative integer values (such as latencies), with fixed
+ *              memory and lock-free recording.
+ *
+ * \details     Values are counted in log-bucketed buckets, as in HDR histograms: values
+ *              below 2^HISTOGRAM_SUB_BUCKET_BITS are counted exactly, and every power of two
+ *              above is split in 2^HISTOGRAM_SUB_BUCKET_BITS buckets, so that every value is
+ *              known with a relative error of 2^-HISTOGRAM_SUB_BUCKET_BITS at most, over the
+ *              whole 64-bit range. Recording a value is a few relaxed atomic operations, so
+ *              any thread may record values into the same Histogram.
+ *
+ * \note        Percentiles computed while other threads record values are approximate.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __HISTOGRAM_H__
+#define __HISTOGRAM_H__
+
+#include <stddef.h>     // size_t
+#include <stdint.h>     // uint64_t
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+#include <stdlib.h>
+
+/* Memory allocation function equivalent to malloc (3) or a malloc (3) wrapper. May not initialize the allocated zone. */
+#define HISTOGRAM_MALLOC(size) malloc((size))
+
+/* Memory freeing function equivalent to free (3) or a free (3) wrapper. */
+#define HISTOGRAM_FREE(ptr) free((ptr))
+
+/* Precision: every power of two is split in 2^HISTOGRAM_SUB_BUCKET_BITS buckets (at most 8) */
+#define HISTOGRAM_SUB_BUCKET_BITS   4
+
+/*************************************************************************/
+
+/**
+ * \brief       Amount of buckets of every Histogram.
+ */
+#define HISTOGRAM_BUCKET_QTY    ((64 - HISTOGRAM_SUB_BUCKET_BITS + 1) << HISTOGRAM_SUB_BUCKET_BITS)
+
+/**
+ * \typedef     Histogram main Abstract Data Type.
+ */
+typedef struct _Histogram_t * Histogram;
+
+/*************************************************************************/
+
+/**
+ * \brief       Create an empty Histogram.
+ *
+ * \return      A Histogram on success, NULL on memory allocation error.
+ */
+Histogram Histogram_create(void);
+
+/**
+ * \brief       Record a value. Thread-safe.
+ */
+void Histogram_record(Histogram const self, uint64_t value);
+
+/**
+ * \brief       Amount of values recorded.
+ */
+uint64_t Histogram_count(Histogram const self);
+
+/**
+ * \brief       Sum of the values recorded (wraps around on overflow).
+ */
+uint64_t Histogram_sum(Histogram const self);
+
+/**
+ * \brief       Highest value recorded, 0 if none was.
+ */
+uint64_t Histogram_max(Histogram const self);
+
+/**
+ * \brief       Get the value below or at which a percentage of the recorded values are.
+ *
+ * \param[in] self          The Histogram itself.
+ * \param[in] percentile    Percentage, from 0 to 100 (for instance, 99.9).
+ *
+ * \return      The highest value of the bucket where the percentile lies (never above the
+ *              highest value recorded), or 0 if no value was recorded.
+ */
+uint64_t Histogram_percentile(Histogram const self, double percentile);
+
+/**
+ * \brief       Free the Histogram. NULL-safe.
+ */
+void Histogram_cleanup(Histogram self);
+
+#endif // __HISTOGRAM_H__
@@ -0,0 +1,81 @@
+#include "histogram.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+
+#define THREAD_QTY      4
+#define PER_THREAD      100000
+
+static void * record(void * arg){
+    Histogram histogram = arg;
+    for (uint64_t i = 1; i <= PER_THREAD; i++){
+        Histogram_record(histogram, i);
+    }
+    return NULL;
+}
+
+/* Relative error of `value` with respect to `exact`, in 1/1000ths */
+static uint64_t error(uint64_t value, uint64_t exact){
+    uint64_t diff = value > exact ? value - exact : exact - value;
+    return diff * 1000 / exact;
+}
+
+int main(void) {
+    Histogram_record(NULL, 1);
+    assert(Histogram_count(NULL) == 0);
+    assert(Histogram_sum(NULL) == 0);
+    assert(Histogram_percentile(NULL, 50) == 0);
+    Histogram_cleanup(NULL);
+
+    // Test 1: empty histogram
+    Histogram histogram = Histogram_create();
+    assert(histogram != NULL);
+    assert(Histogram_count(histogram) == 0);
+    assert(Histogram_sum(histogram) == 0);
+    assert(Histogram_max(histogram) == 0);
+    assert(Histogram_percentile(histogram, 99) == 0);
+
+    // Test 2: small values are exact
+    for (uint64_t i = 0; i < 10; i++){
+        Histogram_record(histogram, i);
+    }
+    assert(Histogram_count(histogram) == 10);
+    assert(Histogram_sum(histogram) == 45);
+    assert(Histogram_max(histogram) == 9);
+    assert(Histogram_percentile(histogram, 50) == 4);
+    assert(Histogram_percentile(histogram, 90) == 8);
+    assert(Histogram_percentile(histogram, 100) == 9);
+    assert(Histogram_percentile(histogram, 0) == 0);
+    Histogram_cleanup(histogram);
+
+    // Test 3: concurrent recording, percentiles within the bucket precision
+    histogram = Histogram_create();
+    pthread_t threads[THREAD_QTY];
+    for (int i = 0; i < THREAD_QTY; i++){
+        pthread_create(&threads[i], NULL, record, histogram);
+    }
+    for (int i = 0; i < THREAD_QTY; i++){
+        pthread_join(threads[i], NULL);
+    }
+    assert(Histogram_count(histogram) == THREAD_QTY * PER_THREAD);
+    assert(Histogram_max(histogram) == PER_THREAD);
+    assert(Histogram_sum(histogram) == (uint64_t) THREAD_QTY * PER_THREAD * (PER_THREAD + 1) / 2);
+    double percentiles[] = { 50, 90, 99, 99.9 };
+    for (int i = 0; i < 4; i++){
+        uint64_t exact = (uint64_t) (percentiles[i] / 100 * PER_THREAD);
+        assert(Histogram_percentile(histogram, percentiles[i]) >= exact);
+        assert(error(Histogram_percentile(histogram, percentiles[i]), exact) <= 1000 >> HISTOGRAM_SUB_BUCKET_BITS);
+    }
+    assert(Histogram_percentile(histogram, 100) == PER_THREAD);
+    Histogram_cleanup(histogram);
+
+    // Test 4: the whole 64-bit range
+    histogram = Histogram_create();
+    Histogram_record(histogram, UINT64_MAX);
+    Histogram_record(histogram, 1ULL << 40);
+    assert(Histogram_percentile(histogram, 100) == UINT64_MAX);
+    assert(error(Histogram_percentile(histogram, 50), 1ULL << 40) <= 1000 >> HISTOGRAM_SUB_BUCKET_BITS);
+    Histogram_cleanup(histogram);
+
+    puts("Histogram: All tests passed!");
+}
@@ -0,0 +1,82 @@
+/**
+ * \file        ilist.c
+ * \brief       Intrusive doubly linked list.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include "ilist.h"
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static inline void _IList_link(IList * list, IListNode * prev, IListNode * node){
+    node->prev = prev;
+    node->next = prev->next;
+    prev->next->prev = node;
+    prev->next = node;
+    list->size++;
+}
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+void IList_init(IList * list){
+    list->head.prev = &(list->head);
+    list->head.next = &(list->head);
+    list->size = 0;
+}
+
+void IList_node_init(IListNode * node){
+    node->prev = NULL;
+    node->next = NULL;
+}
+
+bool IList_is_linked(const IListNode * node){
+    return node->next != NULL;
+}
+
+void IList_push_front(IList * list, IListNode * node){
+    _IList_link(list, &(list->head), node);
+}
+
+void IList_push_back(IList * list, IListNode * node){
+    _IList_link(list, list->head.prev, node);
+}
+
+void IList_remove(IList * list, IListNode * node){
+    if (node == NULL || node->next == NULL){
+        return;
+    }
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->prev = NULL;
+    node->next = NULL;
+    list->size--;
+}
+
+IListNode * IList_pop_front(IList * list){
+    IListNode * node = IList_first(list);
+    IList_remove(list, node);       // NULL-safe
+    return node;
+}
+
+IListNode * IList_first(const IList * list){
+    return list->size == 0 ? NULL : list->head.next;
+}
+
+IListNode * IList_next(const IList * list, const IListNode * node){
+    return node->next == &(list->head) ? NULL : node->next;
+}
+
+size_t IList_size(const IList * list){
+    return list->size;
+}
+
+void IList_clear(IList * list){
+    IListNode * node;
+    while ((node = IList_pop_front(list)) != NULL);
+}
@@ -0,0 +1,129 @@
+/**
+ * \file        ilist.h
+ * \brief       Intrusive doubly linked list: nodes are embedded in the elements themselves,
+ *              so linking and unlinking never allocate memory and any element can be
+ *              removed in O(1) without searching for it.
+ *
+ * \details     Embed an `IListNode` in the element type (one per list the element may
+ *              belong to simultaneously), and get the element back from its node with
+ *              `ILIST_ENTRY()`:
+ *
+ *                  typedef struct { int fd; IListNode ready; } Client;
+ *                  ...
+ *                  IList_push_back(&ready_list, &client->ready);
+ *                  for (IListNode * n = IList_first(&ready_list); n != NULL; n = IList_next(&ready_list, n)){
+ *                      Client * client = ILIST_ENTRY(n, Client, ready);
+ *                  }
+ *
+ *              Lists do not own their elements: cleaning up the elements is up to the caller.
+ *              A node may belong to a single list at a time.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __ILIST_H__
+#define __ILIST_H__
+
+#include <stddef.h>     // size_t, offsetof(), NULL
+#include <stdbool.h>    // bool
+
+/*************************************************************************/
+
+/**
+ * \brief       Get the element that contains a node.
+ *
+ * \param[in] node      Pointer to the IListNode.
+ * \param[in] type      Type of the element.
+ * \param[in] member    Name of the IListNode member within `type`.
+ */
+#define ILIST_ENTRY(node, type, member) ((type *) ((char *) (node) - offsetof(type, member)))
+
+/**
+ * \typedef     IListNode: a node, embedded in each element.
+ */
+typedef struct _IListNode_t {
+    struct _IListNode_t *   prev;
+    struct _IListNode_t *   next;       // NULL while not linked.
+} IListNode;
+
+/**
+ * \typedef     IList: a list. The head is a sentinel node, so the list is circular.
+ */
+typedef struct {
+    IListNode   head;
+    size_t      size;
+} IList;
+
+/*************************************************************************/
+
+/**
+ * \brief       Initialize an empty list.
+ */
+void IList_init(IList * list);
+
+/**
+ * \brief       Initialize a node as not linked to any list.
+ */
+void IList_node_init(IListNode * node);
+
+/**
+ * \brief       Check whether a node is linked to a list.
+ */
+bool IList_is_linked(const IListNode * node);
+
+/**
+ * \brief       Insert a node at the beginning of the list. The node must not be linked.
+ */
+void IList_push_front(IList * list, IListNode * node);
+
+/**
+ * \brief       Insert a node at the end of the list. The node must not be linked.
+ */
+void IList_push_back(IList * list, IListNode * node);
+
+/**
+ * \brief       Remove a node from the list it is linked to. Time complexity: O(1).
+ *
+ * \details     NULL-safe, and a no-op for nodes that are not linked.
+ *
+ * \param[in] list      The list that contains the node.
+ * \param[in] node      The node.
+ */
+void IList_remove(IList * list, IListNode * node);
+
+/**
+ * \brief       Remove the first node of the list.
+ *
+ * \return      The node removed, or NULL if the list is empty.
+ */
+IListNode * IList_pop_front(IList * list);
+
+/**
+ * \brief       Get the first node of the list without removing it.
+ *
+ * \return      The first node, or NULL if the list is empty.
+ */
+IListNode * IList_first(const IList * list);
+
+/**
+ * \brief       Get the node following another one.
+ *
+ * \details     To remove nodes while iterating, get the next node before removing the
+ *              current one.
+ *
+ * \return      The next node, or NULL if `node` is the last one.
+ */
+IListNode * IList_next(const IList * list, const IListNode * node);
+
+/**
+ * \brief       Amount of nodes in the list.
+ */
+size_t IList_size(const IList * list);
+
+/**
+ * \brief       Unlink every node, leaving the list empty. Time complexity: O(n).
+ */
+void IList_clear(IList * list);
+
+#endif // __ILIST_H__
@@ -0,0 +1,103 @@
+#include "ilist.h"
+#include <assert.h>
+#include <stdio.h>
+
+#define ELEM_QTY 1000
+
+typedef struct {
+    int         value;
+    IListNode   odd_even;       // Node in the odds or the evens list
+    IListNode   all;            // Node in the list of all elements
+} Elem;
+
+static Elem elems[ELEM_QTY];
+
+static int value_at(const IList * list, size_t index, size_t node_offset){
+    IListNode * node = IList_first(list);
+    for (size_t i = 0; i < index; i++){
+        node = IList_next(list, node);
+    }
+    return ((Elem *) ((char *) node - node_offset))->value;
+}
+
+int main(void) {
+    IList all, odds, evens;
+    IList_init(&all);
+    IList_init(&odds);
+    IList_init(&evens);
+    assert(IList_size(&all) == 0);
+    assert(IList_first(&all) == NULL);
+    assert(IList_pop_front(&all) == NULL);
+
+    // Test 1: an element may belong to several lists at once
+    for (int i = 0; i < ELEM_QTY; i++){
+        elems[i].value = i;
+        IList_node_init(&elems[i].odd_even);
+        IList_node_init(&elems[i].all);
+        assert(! IList_is_linked(&elems[i].all));
+        IList_push_back(&all, &elems[i].all);
+        if (i % 2 == 0){
+            IList_push_back(&evens, &elems[i].odd_even);
+        }
+        else{
+            IList_push_front(&odds, &elems[i].odd_even);
+        }
+        assert(IList_is_linked(&elems[i].all));
+    }
+    assert(IList_size(&all) == ELEM_QTY);
+    assert(IList_size(&evens) == ELEM_QTY / 2);
+    assert(IList_size(&odds) == ELEM_QTY / 2);
+    assert(value_at(&all, 0, offsetof(Elem, all)) == 0);
+    assert(value_at(&all, ELEM_QTY - 1, offsetof(Elem, all)) == ELEM_QTY - 1);
+    assert(value_at(&evens, 1, offsetof(Elem, odd_even)) == 2);
+    assert(value_at(&odds, 0, offsetof(Elem, odd_even)) == ELEM_QTY - 1);
+
+    // Test 2: iteration in order, with ILIST_ENTRY
+    int expected = 0;
+    for (IListNode * node = IList_first(&all); node != NULL; node = IList_next(&all, node)){
+        assert(ILIST_ENTRY(node, Elem, all)->value == expected);
+        expected++;
+    }
+    assert(expected == ELEM_QTY);
+
+    // Test 3: O(1) removal from the middle, while iterating
+    for (IListNode * node = IList_first(&all), * next; node != NULL; node = next){
+        next = IList_next(&all, node);
+        if (ILIST_ENTRY(node, Elem, all)->value % 3 == 0){
+            IList_remove(&all, node);
+            assert(! IList_is_linked(node));
+        }
+    }
+    assert(IList_size(&all) == ELEM_QTY - (ELEM_QTY + 2) / 3);
+    for (IListNode * node = IList_first(&all); node != NULL; node = IList_next(&all, node)){
+        assert(ILIST_ENTRY(node, Elem, all)->value % 3 != 0);
+    }
+
+    // Test 4: removing an unlinked node (or NULL) is a no-op
+    size_t size = IList_size(&all);
+    IList_remove(&all, &elems[0].all);
+    IList_remove(&all, NULL);
+    assert(IList_size(&all) == size);
+
+    // Test 5: the other lists are not affected, and an unlinked node can be linked again
+    assert(IList_size(&evens) == ELEM_QTY / 2);
+    IList_push_front(&all, &elems[0].all);
+    assert(IList_first(&all) == &elems[0].all);
+    assert(IList_size(&all) == size + 1);
+
+    // Test 6: pop and clear
+    IListNode * node = IList_pop_front(&odds);
+    assert(ILIST_ENTRY(node, Elem, odd_even)->value == ELEM_QTY - 1);
+    assert(! IList_is_linked(node));
+    IList_clear(&all);
+    IList_clear(&odds);
+    assert(IList_size(&all) == 0 && IList_first(&all) == NULL);
+    assert(IList_size(&odds) == 0);
+    for (int i = 0; i < ELEM_QTY; i++){
+        assert(! IList_is_linked(&elems[i].all));
+        assert(IList_is_linked(&elems[i].odd_even) == (i % 2 == 0));
+    }
+    IList_clear(&evens);
+
+    puts("IList: All tests passed!");
+}
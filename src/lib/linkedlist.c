@@ -13,11 +13,18 @@ typedef struct _LinkedList_Node_t {
     struct _LinkedList_Node_t * next;
 } _LinkedList_Node_t;
 
+typedef struct _LinkedList_Slab_t {
+    struct _LinkedList_Slab_t * next;
+    _LinkedList_Node_t nodes[LINKEDLIST_SLAB_NODES];
+} _LinkedList_Slab_t;
+
 typedef struct _LinkedList_t {
     struct _LinkedList_Node_t * head;
     struct _LinkedList_Node_t * tail; 
     size_t size;
     bool was_modified;
+    struct _LinkedList_Node_t * free_nodes;     // Nodes available for reuse.
+    struct _LinkedList_Slab_t * slabs;          // Every slab allocated, freed by LinkedList_cleanup.
 } _LinkedList_t;
 
 /*************************************************************************/
@@ -37,13 +44,29 @@ static void _LinkedList_remove(LinkedList const self,
 );
 
 /**
- * \brief   Remove every Node from the LinkedList, freeing the memory allocated
- *          for them.
+ * \brief   Remove every Node from the LinkedList, keeping them for reuse.
  * 
  * \param[in] self      The LinkedList itself.
  */
 static void _LinkedList_clear(LinkedList const self);
 
+/**
+ * \brief   Get a Node from the free list, allocating a new slab if it is empty.
+ * 
+ * \param[in] self      The LinkedList itself.
+ * 
+ * \return  A Node, or NULL on memory allocation error.
+ */
+static _LinkedList_Node_t * _LinkedList_node_alloc(LinkedList const self);
+
+/**
+ * \brief   Return a Node to the free list.
+ * 
+ * \param[in] self      The LinkedList itself.
+ * \param[in] node      The Node.
+ */
+static void _LinkedList_node_free(LinkedList const self, _LinkedList_Node_t * node);
+
 /*************************************************************************/
 /* Public functions                                                      */
 /*************************************************************************/
@@ -55,6 +78,8 @@ LinkedList LinkedList_create() {
         self->tail = NULL;
         self->size = 0;
         self->was_modified = false;
+        self->free_nodes = NULL;
+        self->slabs = NULL;
     }
     return self;
 }
@@ -64,7 +89,7 @@ LinkedListErrors LinkedList_prepend(LinkedList const self, int elem) {
         return LINKEDLIST_INVALID;
     }
 
-    _LinkedList_Node_t* new_node = LINKEDLIST_MALLOC(sizeof(_LinkedList_Node_t));
+    _LinkedList_Node_t* new_node = _LinkedList_node_alloc(self);
     if (new_node == NULL) {
         return LINKEDLIST_NO_MEMORY;
     }
@@ -87,7 +112,7 @@ LinkedListErrors LinkedList_append(LinkedList const self, int elem) {
         return LINKEDLIST_INVALID;
     }
 
-    _LinkedList_Node_t* new_node = LINKEDLIST_MALLOC(sizeof(_LinkedList_Node_t));
+    _LinkedList_Node_t* new_node = _LinkedList_node_alloc(self);
     if (new_node == NULL) {
         return LINKEDLIST_NO_MEMORY;
     }
@@ -124,7 +149,7 @@ LinkedListErrors LinkedList_insert(LinkedList const self, int elem, unsigned int
         return LinkedList_append(self, elem);
     }
 
-    _LinkedList_Node_t* new_node = LINKEDLIST_MALLOC(sizeof(_LinkedList_Node_t));
+    _LinkedList_Node_t* new_node = _LinkedList_node_alloc(self);
     if (new_node == NULL) {
         return LINKEDLIST_NO_MEMORY;
     }
@@ -295,7 +320,12 @@ LinkedListErrors LinkedList_clear(LinkedList const self){
 
 void LinkedList_cleanup(LinkedList self){
     if (self != NULL){
-        _LinkedList_clear(self);    // Remove all Nodes
+        _LinkedList_Slab_t * slab = self->slabs, * next;
+        while (slab != NULL){       // Every Node belongs to a slab
+            next = slab->next;
+            LINKEDLIST_FREE(slab);
+            slab = next;
+        }
         LINKEDLIST_FREE(self);
     }
 }
@@ -321,16 +351,36 @@ static void _LinkedList_remove(LinkedList const self,
         self->tail = last;
     }
 
-    LINKEDLIST_FREE(current);
+    _LinkedList_node_free(self, current);
     self->was_modified = true;
     self->size--;
 }
 
 static void _LinkedList_clear(LinkedList const self){
-    _LinkedList_Node_t * current = self->head, * next;
-    while (current != NULL){
-        next = current->next;
-        LINKEDLIST_FREE(current);
-        current = next;
+    if (self->head != NULL){        // Splice the whole list into the free list
+        self->tail->next = self->free_nodes;
+        self->free_nodes = self->head;
     }
 }
+
+static _LinkedList_Node_t * _LinkedList_node_alloc(LinkedList const self){
+    if (self->free_nodes == NULL){
+        _LinkedList_Slab_t * slab = LINKEDLIST_MALLOC(sizeof(_LinkedList_Slab_t));
+        if (slab == NULL){
+            return NULL;
+        }
+        slab->next = self->slabs;
+        self->slabs = slab;
+        for (unsigned int i = 0; i < LINKEDLIST_SLAB_NODES; i++){
+            _LinkedList_node_free(self, &(slab->nodes[i]));
+        }
+    }
+    _LinkedList_Node_t * node = self->free_nodes;
+    self->free_nodes = node->next;
+    return node;
+}
+
+static void _LinkedList_node_free(LinkedList const self, _LinkedList_Node_t * node){
+    node->next = self->free_nodes;
+    self->free_nodes = node;
+}
@@ -1,6 +1,11 @@
 /**
  * \file        linkedlist.h
  * \brief       Create and manage a Linked List of integers.
+ *
+ * \note        Nodes are allocated in slabs of LINKEDLIST_SLAB_NODES and recycled through a
+ *              free list, so a LinkedList that has reached its usual size performs no
+ *              further memory allocations. See ilist.h for a list whose nodes live inside
+ *              the elements themselves.
  * 
  * \date        June, 2024
  * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
@@ -24,6 +29,9 @@
 /* Memory freeing function equivalent to free (3) or a free (3) wrapper. */
 #define LINKEDLIST_FREE(ptr) free((ptr))
 
+/* Amount of nodes allocated at once. Removed nodes are kept for reuse until LinkedList_cleanup. */
+#define LINKEDLIST_SLAB_NODES 64
+
 /*************************************************************************/
 
 /**
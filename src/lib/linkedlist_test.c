@@ -292,6 +292,24 @@ void additional_tests(void) {
 
     assert(LinkedList_size(list) == 0);
 
+    // Nodes are reused after removals and clears
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            assert(LinkedList_append(list, i + round) == LINKEDLIST_OK);
+        }
+        for (int i = 0; i < 500; ++i) {
+            assert(LinkedList_remove_elem(list, i * 2 + round, true) == LINKEDLIST_OK);
+        }
+        assert(LinkedList_size(list) == 500);
+        for (int i = 0; i < 500; ++i) {
+            assert(LinkedList_get(list, &elem, i) == LINKEDLIST_OK);
+            assert(elem == i * 2 + 1 + round);
+        }
+        assert(LinkedList_clear(list) == LINKEDLIST_OK);
+        assert(LinkedList_size(list) == 0);
+        assert(LinkedList_get_first(list, &elem) == LINKEDLIST_BAD_INDEX);
+    }
+
     // Clean up
     LinkedList_cleanup(list);
 
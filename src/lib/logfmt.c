@@ -0,0 +1,374 @@
+#include <stdio.h>          // snprintf()
+#include <stdlib.h>         // malloc(), free()
+#include <string.h>         // memcpy(), strchr(), strlen()
+#include <stdint.h>         // intmax_t, uintmax_t, uintptr_t
+#include <stddef.h>         // ptrdiff_t
+
+#include "logfmt.h"
+
+#define FLAG_CHARS          "-+ #0'"
+#define MAX_SPEC_LEN        64
+#define VALUE_SIZE          8
+
+/****************************************************************/
+/* Private function declarations                                */
+/****************************************************************/
+
+/**
+ * \brief       Whether the length modifier of `spec` is `length`.
+ */
+static bool has_length(const char * fmt, const LogFmtSpec * spec, const char * length);
+
+/**
+ * \brief       Append a tagged 8-byte value to `buff`.
+ *
+ * \return      false if it does not fit.
+ */
+static bool put_value(uint8_t * buff, size_t size, size_t * used, LogFmtArg tag, const void * value);
+
+/**
+ * \brief       Read a tagged value from `args`, checking its tag.
+ *
+ * \return      false if there is none, or if its tag is not `tag`.
+ */
+static bool get_value(const uint8_t * args, size_t len, size_t * pos, LogFmtArg tag, void * value);
+
+/****************************************************************/
+/* Public function definitions                                  */
+/****************************************************************/
+
+bool LogFmt_next(const char * fmt, size_t * pos, LogFmtSpec * spec){
+    const char * percent = strchr(fmt + * pos, '%');
+    if (percent == NULL){
+        * pos += strlen(fmt + * pos);
+        return false;
+    }
+    size_t i = (size_t) (percent - fmt) + 1;
+    * spec = (LogFmtSpec){ .start = (size_t) (percent - fmt), .type = LOGFMT_ARG_NONE };
+
+    /* Flags, width and precision */
+    while (fmt[i] != '\0' && strchr(FLAG_CHARS, fmt[i]) != NULL){
+        i++;
+    }
+    for (int part = 0; part < 2; part++){
+        if (part == 1){
+            if (fmt[i] != '.'){
+                break;
+            }
+            i++;
+        }
+        if (fmt[i] == '*'){
+            spec->star_qty++;
+            i++;
+        }
+        while (fmt[i] >= '0' && fmt[i] <= '9'){
+            i++;
+        }
+    }
+
+    /* Length modifier */
+    spec->length_start = i;
+    if ((fmt[i] == 'h' && fmt[i + 1] == 'h') || (fmt[i] == 'l' && fmt[i + 1] == 'l')){
+        i += 2;
+    }
+    else if (fmt[i] != '\0' && strchr("hljztLq", fmt[i]) != NULL){
+        i++;
+    }
+    spec->length_len = i - spec->length_start;
+
+    /* Conversion */
+    spec->conv = fmt[i];
+    switch (fmt[i]){
+        case 'd': case 'i': case 'c':
+            spec->type = LOGFMT_ARG_INT;
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            spec->type = LOGFMT_ARG_UINT;
+            break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            spec->type = LOGFMT_ARG_DOUBLE;
+            break;
+        case 's':
+            spec->type = LOGFMT_ARG_STR;
+            break;
+        case 'p': case 'n':
+            spec->type = LOGFMT_ARG_PTR;
+            break;
+        case '%':
+            break;
+        default:
+            /* Unknown conversion: taken as plain text, without consuming arguments */
+            spec->conv = '\0';
+            spec->star_qty = 0;
+            i--;
+            break;
+    }
+    spec->end = i + 1;
+    * pos = spec->end;
+    return true;
+}
+
+void LogFmt_put_header(uint8_t * buff, const LogFmtHeader * header){
+    buff[0] = header->type;
+    buff[1] = header->info;
+    buff[2] = header->argc;
+    buff[3] = header->reserved;
+    memcpy(buff + 4, &header->id, sizeof(uint32_t));
+    memcpy(buff + 8, &header->timestamp, sizeof(uint64_t));
+    memcpy(buff + 16, &header->payload_len, sizeof(uint32_t));
+}
+
+void LogFmt_get_header(const uint8_t * buff, LogFmtHeader * header){
+    header->type        = buff[0];
+    header->info        = buff[1];
+    header->argc        = buff[2];
+    header->reserved    = buff[3];
+    memcpy(&header->id, buff + 4, sizeof(uint32_t));
+    memcpy(&header->timestamp, buff + 8, sizeof(uint64_t));
+    memcpy(&header->payload_len, buff + 16, sizeof(uint32_t));
+}
+
+size_t LogFmt_encode(const char * fmt, uint8_t * buff, size_t size, va_list ap, uint8_t * argc){
+    size_t used = 0;
+    size_t pos = 0;
+    LogFmtSpec spec;
+    * argc = 0;
+
+    while (* argc < UINT8_MAX - 2 && LogFmt_next(fmt, &pos, &spec)){
+        /* Width and precision */
+        for (unsigned i = 0; i < spec.star_qty; i++){
+            int64_t value = va_arg(ap, int);
+            if (! put_value(buff, size, &used, LOGFMT_ARG_INT, &value)){
+                return used;
+            }
+            (* argc)++;
+        }
+
+        switch (spec.type){
+            case LOGFMT_ARG_INT: {
+                int64_t value;
+                if      (has_length(fmt, &spec, "hh"))  value = (signed char) va_arg(ap, int);
+                else if (has_length(fmt, &spec, "h"))   value = (short) va_arg(ap, int);
+                else if (has_length(fmt, &spec, "l"))   value = va_arg(ap, long);
+                else if (has_length(fmt, &spec, "ll"))  value = va_arg(ap, long long);
+                else if (has_length(fmt, &spec, "j"))   value = va_arg(ap, intmax_t);
+                else if (has_length(fmt, &spec, "z"))   value = (int64_t) va_arg(ap, size_t);
+                else if (has_length(fmt, &spec, "t"))   value = va_arg(ap, ptrdiff_t);
+                else                                    value = va_arg(ap, int);
+                if (! put_value(buff, size, &used, LOGFMT_ARG_INT, &value)){
+                    return used;
+                }
+                break;
+            }
+            case LOGFMT_ARG_UINT: {
+                uint64_t value;
+                if      (has_length(fmt, &spec, "hh"))  value = (unsigned char) va_arg(ap, unsigned);
+                else if (has_length(fmt, &spec, "h"))   value = (unsigned short) va_arg(ap, unsigned);
+                else if (has_length(fmt, &spec, "l"))   value = va_arg(ap, unsigned long);
+                else if (has_length(fmt, &spec, "ll"))  value = va_arg(ap, unsigned long long);
+                else if (has_length(fmt, &spec, "j"))   value = va_arg(ap, uintmax_t);
+                else if (has_length(fmt, &spec, "z"))   value = va_arg(ap, size_t);
+                else if (has_length(fmt, &spec, "t"))   value = (uint64_t) va_arg(ap, ptrdiff_t);
+                else                                    value = va_arg(ap, unsigned);
+                if (! put_value(buff, size, &used, LOGFMT_ARG_UINT, &value)){
+                    return used;
+                }
+                break;
+            }
+            case LOGFMT_ARG_DOUBLE: {
+                double value = has_length(fmt, &spec, "L") ? (double) va_arg(ap, long double) : va_arg(ap, double);
+                if (! put_value(buff, size, &used, LOGFMT_ARG_DOUBLE, &value)){
+                    return used;
+                }
+                break;
+            }
+            case LOGFMT_ARG_STR: {
+                const char * str = va_arg(ap, const char *);
+                if (str == NULL){
+                    str = "(null)";
+                }
+                size_t len = strlen(str);
+                if (used + 1 + sizeof(uint16_t) > size){
+                    return used;
+                }
+                size_t room = size - used - 1 - sizeof(uint16_t);
+                len = len > room ? room : len;
+                len = len > LOGFMT_MAX_STR_LEN ? LOGFMT_MAX_STR_LEN : len;
+                uint16_t len16 = (uint16_t) len;
+                buff[used] = LOGFMT_ARG_STR;
+                memcpy(buff + used + 1, &len16, sizeof(uint16_t));
+                memcpy(buff + used + 1 + sizeof(uint16_t), str, len);
+                used += 1 + sizeof(uint16_t) + len;
+                break;
+            }
+            case LOGFMT_ARG_PTR: {
+                uint64_t value = (uint64_t) (uintptr_t) va_arg(ap, void *);
+                if (spec.conv == 'n'){
+                    continue;                   // Nothing to print: the pointer is just consumed
+                }
+                if (! put_value(buff, size, &used, LOGFMT_ARG_PTR, &value)){
+                    return used;
+                }
+                break;
+            }
+            case LOGFMT_ARG_NONE:
+                continue;
+        }
+        (* argc)++;
+    }
+    return used;
+}
+
+bool LogFmt_render(const char * fmt, const uint8_t * args, size_t len, char * out, size_t size){
+    size_t used = 0;                    // Characters written to `out`
+    size_t pos = 0;                     // Position in `fmt`
+    size_t arg_pos = 0;                 // Position in `args`
+    bool ok = true;
+    LogFmtSpec spec;
+
+    #define APPEND(...) do {                                                        \
+        int _written = snprintf(out + used, size - used, __VA_ARGS__);              \
+        if (_written > 0){                                                          \
+            used += (size_t) _written < size - used ? (size_t) _written : size - used - 1; \
+        }                                                                           \
+    } while (0)
+
+    if (size == 0){
+        return false;
+    }
+    out[0] = '\0';
+    while (ok){
+        size_t text_start = pos;
+        bool found = LogFmt_next(fmt, &pos, &spec);
+        size_t text_end = found ? spec.start : pos;
+        APPEND("%.*s", (int) (text_end - text_start), fmt + text_start);
+        if (! found){
+            break;
+        }
+        if (spec.conv == '%'){
+            APPEND("%%");
+            continue;
+        }
+        if (spec.conv == '\0'){
+            APPEND("%.*s", (int) (spec.end - spec.start), fmt + spec.start);
+            continue;
+        }
+        if (spec.conv == 'n'){
+            continue;
+        }
+
+        /* Rebuild the specification: '*' replaced by their values, own length modifier */
+        char conv[MAX_SPEC_LEN];
+        size_t conv_len = 0;
+        for (size_t i = spec.start; i < spec.end - 1 && ok && conv_len < MAX_SPEC_LEN - 8; i++){
+            if (i >= spec.length_start && i < spec.length_start + spec.length_len){
+                continue;
+            }
+            if (fmt[i] == '*'){
+                int64_t value = 0;
+                if (! (ok = get_value(args, len, &arg_pos, LOGFMT_ARG_INT, &value))){
+                    break;
+                }
+                int written = snprintf(conv + conv_len, MAX_SPEC_LEN - conv_len, "%d", (int) value);
+                conv_len += written > 0 ? (size_t) written : 0;
+                conv_len = conv_len < MAX_SPEC_LEN ? conv_len : MAX_SPEC_LEN - 1;
+                continue;
+            }
+            conv[conv_len++] = fmt[i];
+        }
+        if (! ok){
+            break;
+        }
+        bool wide = (spec.type == LOGFMT_ARG_INT || spec.type == LOGFMT_ARG_UINT) && spec.conv != 'c';
+        if (wide){
+            conv[conv_len++] = 'l';
+            conv[conv_len++] = 'l';
+        }
+        conv[conv_len++] = spec.conv;
+        conv[conv_len] = '\0';
+
+        switch (spec.type){
+            case LOGFMT_ARG_INT: {
+                int64_t value = 0;
+                if ((ok = get_value(args, len, &arg_pos, LOGFMT_ARG_INT, &value))){
+                    if (wide) APPEND(conv, (long long) value);
+                    else      APPEND(conv, (int) value);
+                }
+                break;
+            }
+            case LOGFMT_ARG_UINT: {
+                uint64_t value = 0;
+                if ((ok = get_value(args, len, &arg_pos, LOGFMT_ARG_UINT, &value))){
+                    APPEND(conv, (unsigned long long) value);
+                }
+                break;
+            }
+            case LOGFMT_ARG_DOUBLE: {
+                double value = 0;
+                if ((ok = get_value(args, len, &arg_pos, LOGFMT_ARG_DOUBLE, &value))){
+                    APPEND(conv, value);
+                }
+                break;
+            }
+            case LOGFMT_ARG_PTR: {
+                uint64_t value = 0;
+                if ((ok = get_value(args, len, &arg_pos, LOGFMT_ARG_PTR, &value))){
+                    APPEND(conv, (void *) (uintptr_t) value);
+                }
+                break;
+            }
+            case LOGFMT_ARG_STR: {
+                uint16_t str_len;
+                if (arg_pos + 1 + sizeof(uint16_t) > len || args[arg_pos] != LOGFMT_ARG_STR){
+                    ok = false;
+                    break;
+                }
+                memcpy(&str_len, args + arg_pos + 1, sizeof(uint16_t));
+                arg_pos += 1 + sizeof(uint16_t);
+                char * str;
+                if (arg_pos + str_len > len || (str = malloc((size_t) str_len + 1)) == NULL){
+                    ok = false;
+                    break;
+                }
+                memcpy(str, args + arg_pos, str_len);
+                str[str_len] = '\0';
+                arg_pos += str_len;
+                APPEND(conv, str);
+                free(str);
+                break;
+            }
+            case LOGFMT_ARG_NONE:
+                break;
+        }
+    }
+
+    #undef APPEND
+    return ok;
+}
+
+/****************************************************************/
+/* Private function definitions                                 */
+/****************************************************************/
+
+static bool has_length(const char * fmt, const LogFmtSpec * spec, const char * length){
+    return spec->length_len == strlen(length) && strncmp(fmt + spec->length_start, length, spec->length_len) == 0;
+}
+
+static bool put_value(uint8_t * buff, size_t size, size_t * used, LogFmtArg tag, const void * value){
+    if (* used + 1 + VALUE_SIZE > size){
+        return false;
+    }
+    buff[* used] = (uint8_t) tag;
+    memcpy(buff + * used + 1, value, VALUE_SIZE);
+    * used += 1 + VALUE_SIZE;
+    return true;
+}
+
+static bool get_value(const uint8_t * args, size_t len, size_t * pos, LogFmtArg tag, void * value){
+    if (* pos + 1 + VALUE_SIZE > len || args[* pos] != tag){
+        return false;
+    }
+    memcpy(value, args + * pos + 1, VALUE_SIZE);
+    * pos += 1 + VALUE_SIZE;
+    return true;
+}
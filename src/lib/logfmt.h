@@ -0,0 +1,161 @@
+/**
+ * \file        logfmt.h
+ * \brief       Binary log format, shared by the Logger (binary mode) and the logdecode
+ *              tool (src/logdecode).
+ *
+ * \details     Log records keep the format string and the raw arguments of every
+ *              message instead of the formatted text, so that formatting is left to
+ *              whoever reads the log. A binary log is a sequence of records, each of
+ *              them a `LogFmtHeader` (host byte order) followed by `payload_len` bytes:
+ *
+ *                  LOGFMT_REC_SESSION      Written when a Logger opens the file.
+ *                                          id: LOGFMT_VERSION. info: LOGFMT_SESSION_* flags.
+ *                                          timestamp: opening time.
+ *                                          payload: LOGFMT_MAGIC followed by the log prefix.
+ *                  LOGFMT_REC_FORMAT       String table entry, written once per format string
+ *                                          and session. id: format id. payload: the format string.
+ *                  LOGFMT_REC_LOG          Log message. info: LogLevels. argc: amount of arguments.
+ *                                          id: format id (valid within the session).
+ *                                          payload: `argc` arguments, each of them a
+ *                                          `LogFmtArg` tag followed by its value:
+ *                                              INT, UINT, DOUBLE, PTR   8 bytes
+ *                                              STR                      uint16_t length + bytes
+ *
+ *              Format ids are only valid within their session. Within a session, the
+ *              FORMAT record of an id always comes before every LOG record that uses it
+ *              (even when several threads log), so readers may render records as they
+ *              read them. A LOG record with id 0 carries its format string inline as
+ *              its first (STR) argument instead.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __LOGFMT_H__
+#define __LOGFMT_H__
+
+#include <stddef.h>     // size_t
+#include <stdint.h>     // uint8_t, uint16_t, uint32_t, uint64_t
+#include <stdbool.h>    // bool
+#include <stdarg.h>     // va_list
+
+/****************************************************************************************/
+/* Macro and constant definitions                                                       */
+/****************************************************************************************/
+
+#define LOGFMT_MAGIC            "SMTPDLOG"
+#define LOGFMT_MAGIC_LEN        8
+#define LOGFMT_VERSION          1
+
+/* Session flags */
+#define LOGFMT_SESSION_DATETIME 0x01        // Render date and time.
+#define LOGFMT_SESSION_LEVEL    0x02        // Render log level.
+
+/* Longest string argument kept (longer ones are truncated) */
+#define LOGFMT_MAX_STR_LEN      UINT16_MAX
+
+/****************************************************************************************/
+/* Custom data types and enumerations                                                   */
+/****************************************************************************************/
+
+/**
+ * \enum        LogFmtRecord: record types.
+ */
+typedef enum {
+    LOGFMT_REC_SESSION  = 'S',
+    LOGFMT_REC_FORMAT   = 'F',
+    LOGFMT_REC_LOG      = 'L',
+} LogFmtRecord;
+
+/**
+ * \enum        LogFmtArg: argument types (and tags of encoded arguments).
+ */
+typedef enum {
+    LOGFMT_ARG_NONE     = 0,        // No argument (i.e. "%%" or an unknown conversion).
+    LOGFMT_ARG_INT,                 // int64_t: signed integers and characters.
+    LOGFMT_ARG_UINT,                // uint64_t: unsigned integers.
+    LOGFMT_ARG_DOUBLE,              // double: floating point numbers.
+    LOGFMT_ARG_STR,                 // uint16_t length followed by the characters.
+    LOGFMT_ARG_PTR,                 // uint64_t: pointers.
+} LogFmtArg;
+
+/**
+ * \typedef     LogFmtHeader: header of every record.
+ */
+typedef struct {
+    uint8_t     type;               // LogFmtRecord.
+    uint8_t     info;               // Session flags or log level.
+    uint8_t     argc;               // Amount of arguments (LOGFMT_REC_LOG only).
+    uint8_t     reserved;
+    uint32_t    id;                 // Version or format id.
+    uint64_t    timestamp;          // Nanoseconds since the Epoch.
+    uint32_t    payload_len;
+} LogFmtHeader;
+
+#define LOGFMT_HEADER_SIZE      20  // Encoded size of a LogFmtHeader (without padding).
+
+/**
+ * \typedef     LogFmtSpec: a conversion specification within a format string.
+ */
+typedef struct {
+    size_t      start;              // Position of the '%'.
+    size_t      end;                // Position right after the conversion character.
+    size_t      length_start;       // Position of the length modifier.
+    size_t      length_len;         // Length of the length modifier (0 if none).
+    unsigned    star_qty;           // Amount of '*' (width or precision taken from int arguments).
+    char        conv;               // Conversion character ('%' for "%%").
+    LogFmtArg   type;               // Argument consumed by the conversion.
+} LogFmtSpec;
+
+/****************************************************************************************/
+
+/**
+ * \brief           Find the next conversion specification of a format string.
+ *
+ * \param[in]     fmt       The format string.
+ * \param[in,out] pos       Where to start looking. Set right after the conversion found.
+ * \param[out]    spec      The conversion found.
+ *
+ * \return          true if a conversion was found, false at the end of the string.
+ */
+bool LogFmt_next(const char * fmt, size_t * pos, LogFmtSpec * spec);
+
+/**
+ * \brief           Encode a record header into `buff` (LOGFMT_HEADER_SIZE bytes).
+ */
+void LogFmt_put_header(uint8_t * buff, const LogFmtHeader * header);
+
+/**
+ * \brief           Decode a record header from `buff` (LOGFMT_HEADER_SIZE bytes).
+ */
+void LogFmt_get_header(const uint8_t * buff, LogFmtHeader * header);
+
+/**
+ * \brief           Encode the arguments of a message (as consumed by `fmt`) into `buff`.
+ *                  Strings are truncated if they do not fit.
+ *
+ * \param[in]  fmt          The format string.
+ * \param[out] buff         Where to encode the arguments.
+ * \param[in]  size         Size of `buff`.
+ * \param[in]  ap           The arguments.
+ * \param[out] argc         Amount of arguments encoded.
+ *
+ * \return          Amount of bytes used.
+ */
+size_t LogFmt_encode(const char * fmt, uint8_t * buff, size_t size, va_list ap, uint8_t * argc);
+
+/**
+ * \brief           Render a message from its format string and encoded arguments, as
+ *                  `snprintf` would have.
+ *
+ * \param[in]  fmt          The format string.
+ * \param[in]  args         The encoded arguments.
+ * \param[in]  len          Size of `args` in bytes.
+ * \param[out] out          Where to write the message (always null-terminated).
+ * \param[in]  size         Size of `out`.
+ *
+ * \return          true on success, false if the arguments do not match `fmt`.
+ */
+bool LogFmt_render(const char * fmt, const uint8_t * args, size_t len, char * out, size_t size);
+
+#endif // __LOGFMT_H__
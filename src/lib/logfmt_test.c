@@ -0,0 +1,60 @@
+#include "logfmt.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BUFF_SIZE 512
+
+/* Encode the arguments, render them back, and compare with snprintf (3) */
+static void check(const char * fmt, ...){
+    uint8_t args[BUFF_SIZE];
+    char expected[BUFF_SIZE], rendered[BUFF_SIZE];
+    uint8_t argc;
+
+    va_list ap, ap2;
+    va_start(ap, fmt);
+    va_copy(ap2, ap);
+    size_t len = LogFmt_encode(fmt, args, BUFF_SIZE, ap, &argc);
+    vsnprintf(expected, BUFF_SIZE, fmt, ap2);
+    va_end(ap2);
+    va_end(ap);
+
+    assert(LogFmt_render(fmt, args, len, rendered, BUFF_SIZE));
+    if (strcmp(expected, rendered) != 0){
+        printf("\"%s\": expected \"%s\", got \"%s\"\n", fmt, expected, rendered);
+        assert(false);
+    }
+}
+
+int main (void){
+    /* Conversions used by smtpd messages */
+    check("Server started.");
+    check("New client connected at %s : %d.", "127.0.0.1", 52344);
+    check("Loaded %zu verified addresses from %s.", (size_t) 1000000, "./vrfy.idx");
+    check("Manager sent command %s (%02X)", "STATUS", 0x0A);
+
+    /* Every kind of argument */
+    check("%d %i %u %o %x %X %c", -1, 2, 3u, 8u, 255u, 255u, 'z');
+    check("%hhd %hd %ld %lld %jd %td", (signed char) -5, (short) -300, -70000L, -(1LL << 40), (intmax_t) -7, (ptrdiff_t) -9);
+    check("%hhu %hu %lu %llu %ju %zu", (unsigned char) 250, (unsigned short) 65000, 1UL << 31, 1ULL << 63, (uintmax_t) 7, (size_t) 9);
+    check("%f %.3e %g %10.2f %Lf", 3.5, 12345.678, 0.0001, -2.25, (long double) 1.5);
+    check("%p %s %s", (void *) 0x1234, "", (char *) NULL);
+    check("[%-8s] [%8s] [%.2s] [%*d] [%-*.*f]", "ab", "cd", "efgh", 6, 42, 9, 2, 3.14159);
+    check("100%% sure, %d%%", 5);
+
+    /* Header */
+    LogFmtHeader header = { .type = LOGFMT_REC_LOG, .info = 2, .argc = 3, .id = 77, .timestamp = 1234567890123456789ULL, .payload_len = 99 };
+    uint8_t buff[LOGFMT_HEADER_SIZE];
+    LogFmtHeader decoded;
+    LogFmt_put_header(buff, &header);
+    LogFmt_get_header(buff, &decoded);
+    assert(decoded.type == header.type && decoded.info == header.info && decoded.argc == header.argc);
+    assert(decoded.id == header.id && decoded.timestamp == header.timestamp && decoded.payload_len == header.payload_len);
+
+    /* Truncated arguments are detected */
+    uint8_t args[BUFF_SIZE];
+    char rendered[BUFF_SIZE];
+    assert(! LogFmt_render("%d %d", args, 0, rendered, BUFF_SIZE));
+
+    puts("LogFmt: All tests passed!");
+}
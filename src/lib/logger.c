@@ -1,12 +1,67 @@
+#include <string.h>         // memcpy(), strlen()
+#include <stdint.h>         // uint8_t, uint32_t, uint64_t, uintptr_t
+#include <stdatomic.h>      // atomic_*
+#include <signal.h>         // sigfillset(), pthread_sigmask()
+#include <pthread.h>        // pthread_*
+
 #include "logger.h"
+#include "logfmt.h"
+
+#define NS_PER_SEC          1000000000L
+#define NS_PER_MS           1000000L
+#define BLOCK_POLL_NS       50000           // 50 us between attempts when the ring is full
+#define STOP_WAIT_ROUNDS    2000            // 100 ms waiting for a slot that is never published
+#define DROPPED_FMT         "Logger: %zu messages dropped (ring full)"
+
+/**
+ * Slot of the ring. Producers claim slots in order, and `seq` tells whose turn it is:
+ *  seq == pos              empty, may be claimed by the producer that enqueues position `pos`.
+ *  seq == pos + 1          holds the line enqueued at position `pos`, ready to be written.
+ * Once written, the slot is released for position `pos + LOGGER_ASYNC_SLOTS`.
+ */
+typedef struct {
+    _Alignas(64) atomic_size_t  seq;
+    size_t                      len;
+    char                        text[LOGGER_ASYNC_LINE_SIZE];
+} _LogSlot_t;
+
+/**
+ * Entry of the string table. The producer that adds a format string writes its FORMAT
+ * record before setting `ready`, and others wait for it before using the id, so the
+ * FORMAT record always comes before the messages that refer to it.
+ */
+typedef struct {
+    _Atomic(const char *)       fmt;
+    atomic_bool                 ready;
+} _FormatSlot_t;
 
 typedef struct _Logger_t {
-    LogLevels       min_level;
+    atomic_int      min_level;                  // LogLevels. Can be changed while other threads log.
     bool            with_datetime;
     bool            with_level;
     bool            flush_immediately;
     const char *    log_prefix;
     FILE *          log_file;
+
+    /* Binary mode */
+    bool            binary;
+    _FormatSlot_t * formats;                    // String table: format strings by id minus one.
+
+    /* Asynchronous mode */
+    bool            async;
+    LoggerOverflow  overflow;
+    _LogSlot_t *    slots;
+    char *          file_buff;                  // stdio buffer of the log file.
+    atomic_size_t   tail;                       // Next position to be claimed by a producer.
+    size_t          head;                       // Next position to be written (writer thread only).
+    atomic_size_t   dropped;
+    size_t          dropped_reported;           // Writer thread only.
+    atomic_bool     stop;
+    atomic_bool     writer_idle;                // The writer thread is (about to be) sleeping.
+    pthread_mutex_t lock;
+    pthread_cond_t  wakeup;
+    pthread_t       writer;
+    bool            writer_running;
 } _Logger_t;
 
 static const char * LogLevelsStr[] = {
@@ -20,12 +75,102 @@ static const char * LogLevelsStr[] = {
 /****************************************************************/
 
 /**
- * \brief       Get the local time in format yyyy/mm/dd-HH:MM:SS.
- * 
- * \param[out] buff     Buffer to store the result.
- * \param[in]  size     Buffer size in bytes.
+ * \brief       Set up the ring and start the writer thread.
+ *
+ * \return      true on success, false on failure (errno is set accordingly).
+ */
+static bool start_async(Logger self);
+
+/**
+ * \brief       Format a whole log line (prefix, date and time, level, message and new
+ *              line) into `buff`, truncating it if needed.
+ *
+ * \return      The length of the line.
+ */
+static size_t format_line(Logger self, LogLevels level, char * buff, size_t size, const char * fmt, va_list ap);
+
+/**
+ * \brief       Claim a slot of the ring (asynchronous mode), applying the overflow policy
+ *              unless `must_block` is set.
+ *
+ * \param[out] pos      Position claimed.
+ *
+ * \return      The slot, or NULL if the line was dropped.
+ */
+static _LogSlot_t * claim(Logger self, bool must_block, size_t * pos);
+
+/**
+ * \brief       Hand a filled slot over to the writer thread.
+ */
+static void publish(Logger self, _LogSlot_t * slot, size_t pos);
+
+/**
+ * \brief       Log a message in binary mode (see logfmt.h).
+ *
+ * \return      true if the record was written or queued, false if it was dropped.
+ */
+static bool log_binary(Logger self, LogLevels level, const char * fmt, va_list ap);
+
+/**
+ * \brief       Encode a message record into `buff` (LOGGER_ASYNC_LINE_SIZE bytes).
+ *
+ * \param[in] id        Format id, or 0 to include the format string in the record.
+ *
+ * \return      The size of the record.
+ */
+static size_t encode_record(uint8_t * buff, LogLevels level, uint32_t id, const char * fmt, va_list ap);
+
+/**
+ * \brief       Write the amount of messages dropped since the last report (writer thread).
+ */
+static void write_dropped(Logger self, size_t dropped);
+
+/**
+ * \brief       Encode the report of dropped messages (a `size_t`, passed as the only
+ *              variable argument) as a binary record.
+ */
+static size_t encode_dropped(uint8_t * buff, ...);
+
+/**
+ * \brief       Find the id of a format string, adding it to the string table if needed.
+ *
+ * \param[out] is_new   Whether it was added (and so, its entry must be written, and then
+ *                      marked as ready). If another producer added it, waits until it is ready.
+ *
+ * \return      The id, or 0 if the string table is full.
+ */
+static uint32_t intern(Logger self, const char * fmt, bool * is_new);
+
+/**
+ * \brief       Write (or queue, in asynchronous mode) a record with a raw payload.
+ *              These records are never dropped, since messages depend on them.
+ */
+static void write_raw(Logger self, LogFmtHeader header, const void * payload, size_t len);
+
+/**
+ * \brief       Current time in nanoseconds since the Epoch.
+ */
+static uint64_t timestamp_ns(void);
+
+/**
+ * \brief       Wake the writer thread up if it is sleeping. Never blocks (it may be
+ *              called from a signal handler that interrupted the thread holding the
+ *              lock); if the wake up is missed, the writer thread wakes up by itself
+ *              after LOGGER_ASYNC_IDLE_MS.
+ */
+static void wake_writer(Logger self);
+
+/**
+ * \brief       Write every line that is ready, in order.
+ *
+ * \return      The amount of lines written.
  */
-void get_current_datetime(char * buff, size_t size);
+static size_t drain(Logger self);
+
+/**
+ * \brief       Writer thread.
+ */
+static void * writer_main(void * arg);
 
 /****************************************************************/
 /* Public function definitions                                  */
@@ -38,7 +183,7 @@ Logger Logger_create(LoggerConfig config, const char * const file_path){
     errno = 0;
 
     /* Allocate memory */
-    if ((self = (Logger) malloc(sizeof(_Logger_t))) == NULL){
+    if ((self = (Logger) calloc(1, sizeof(_Logger_t))) == NULL){
         goto err;
     }
 
@@ -48,32 +193,86 @@ Logger Logger_create(LoggerConfig config, const char * const file_path){
     }
 
     /* Initialize configuration */
-    self->min_level         = config.min_log_level;
+    atomic_init(&self->min_level, config.min_log_level);
     self->with_datetime     = config.with_datetime;
     self->with_level        = config.with_level;
     self->flush_immediately = config.flush_immediately;
     self->log_prefix        = config.log_prefix;
     self->log_file          = log_file;
+    self->async             = config.async;
+    self->overflow          = config.overflow;
+    self->binary            = config.binary;
+
+    /* Allocate the string table */
+    if (self->binary && (self->formats = calloc(LOGGER_BINARY_MAX_FORMATS, sizeof(* self->formats))) == NULL){
+        goto err;
+    }
+
+    /* Start writer thread */
+    if (self->async && ! start_async(self)){
+        goto err;
+    }
+
+    /* Binary mode: every Logger starts a new session */
+    if (self->binary){
+        uint8_t flags = (self->with_datetime ? LOGFMT_SESSION_DATETIME : 0) | (self->with_level ? LOGFMT_SESSION_LEVEL : 0);
+        size_t prefix_len = self->log_prefix == NULL ? 0 : strlen(self->log_prefix);
+        char payload[LOGGER_ASYNC_LINE_SIZE - LOGFMT_HEADER_SIZE];
+        prefix_len = prefix_len > sizeof(payload) - LOGFMT_MAGIC_LEN ? sizeof(payload) - LOGFMT_MAGIC_LEN : prefix_len;
+        memcpy(payload, LOGFMT_MAGIC, LOGFMT_MAGIC_LEN);
+        if (prefix_len > 0){
+            memcpy(payload + LOGFMT_MAGIC_LEN, self->log_prefix, prefix_len);
+        }
+        write_raw(self, (LogFmtHeader){ .type = LOGFMT_REC_SESSION, .info = flags, .id = LOGFMT_VERSION },
+                  payload, LOGFMT_MAGIC_LEN + prefix_len);
+    }
 
     /* Success */
     return self;
 
 err:
-    if (self != NULL){
-        free(self);
-    }
     if (log_file != NULL){
         fclose(log_file);
     }
+    if (self != NULL){
+        free(self->file_buff);          // After fclose (3), which may still use it
+        free(self->slots);
+        free(self->formats);
+        free(self);
+    }
 
     return NULL;
 }
 
 bool Logger_log(Logger const self, LogLevels level, const char * __restrict__ fmt, ...){
-    if (self == NULL || level < 0 || level >= LOG_LEVELS_QTY || level < self->min_level || fmt == NULL){
+    if (self == NULL || level < 0 || level >= LOG_LEVELS_QTY || (int) level < atomic_load_explicit(&self->min_level, memory_order_relaxed) || fmt == NULL){
         return false;
     }
 
+    /* Binary mode: keep the arguments, leave formatting to logdecode */
+    if (self->binary){
+        va_list ap;
+        va_start(ap, fmt);
+        bool logged = log_binary(self, level, fmt, ap);
+        va_end(ap);
+        return logged;
+    }
+
+    /* Asynchronous mode: just queue the line */
+    if (self->async){
+        size_t pos;
+        _LogSlot_t * slot = claim(self, false, &pos);
+        if (slot == NULL){
+            return false;
+        }
+        va_list ap;
+        va_start(ap, fmt);
+        slot->len = format_line(self, level, slot->text, LOGGER_ASYNC_LINE_SIZE, fmt, ap);
+        va_end(ap);
+        publish(self, slot, pos);
+        return true;
+    }
+
     bool did_print = false;
 
     /* Add log prefix */
@@ -84,9 +283,7 @@ bool Logger_log(Logger const self, LogLevels level, const char * __restrict__ fm
 
     /* Add date and time */
     if (self->with_datetime){
-        char datetime_buff[MAX_DATETIME_LEN] = {0};
-        get_current_datetime(datetime_buff, MAX_DATETIME_LEN);
-        fprintf(self->log_file, "@[%s] ", datetime_buff);
+        fprintf(self->log_file, "@[%s] ", Clock_datetime());
         did_print = true;
     }
     
@@ -118,14 +315,59 @@ bool Logger_log(Logger const self, LogLevels level, const char * __restrict__ fm
     return true;
 }
 
+bool Logger_enabled(Logger const self, LogLevels level){
+    return self != NULL && (int) level >= atomic_load_explicit(&self->min_level, memory_order_relaxed);
+}
+
+bool Logger_set_level(Logger const self, LogLevels level){
+    if (self == NULL || level < 0 || level >= LOG_LEVELS_QTY){
+        return false;
+    }
+    atomic_store_explicit(&self->min_level, level, memory_order_relaxed);
+    return true;
+}
+
+bool Logger_rate_limit(LoggerRateLimit * limit, unsigned per_sec, size_t * suppressed){
+    * suppressed = 0;
+
+    /* Refill the bucket once per second (only one caller wins the new window) */
+    time_t now = Clock_now();
+    time_t second = atomic_load_explicit(&limit->second, memory_order_relaxed);
+    if (second != now && atomic_compare_exchange_strong(&limit->second, &second, now)){
+        atomic_store_explicit(&limit->logged, 0, memory_order_relaxed);
+    }
+
+    if (atomic_fetch_add_explicit(&limit->logged, 1, memory_order_relaxed) >= per_sec){
+        atomic_fetch_add_explicit(&limit->suppressed, 1, memory_order_relaxed);
+        return false;
+    }
+    * suppressed = atomic_exchange_explicit(&limit->suppressed, 0, memory_order_relaxed);
+    return true;
+}
+
+size_t Logger_dropped(Logger const self){
+    return (self == NULL || ! self->async) ? 0 : atomic_load(&self->dropped);
+}
+
 void Logger_cleanup(Logger const self){
     if (self == NULL){
         return;
     }
+    if (self->writer_running){
+        /* The writer thread drains the ring before exiting */
+        atomic_store(&self->stop, true);
+        wake_writer(self);
+        pthread_join(self->writer, NULL);
+        pthread_cond_destroy(&self->wakeup);
+        pthread_mutex_destroy(&self->lock);
+    }
     if (self->log_file != NULL){
         fflush(self->log_file);
         fclose(self->log_file);
     }
+    free(self->file_buff);
+    free(self->slots);
+    free(self->formats);
     free(self);
 }
 
@@ -133,14 +375,332 @@ void Logger_cleanup(Logger const self){
 /* Private function definitions                                 */
 /****************************************************************/
 
-void get_current_datetime(char * buff, size_t size){
-    // Get the current time
-    time_t rawtime;
-    struct tm * timeinfo;
-    
-    time(&rawtime);
-    timeinfo = localtime(&rawtime);
+static bool start_async(Logger self){
+    if ((self->slots = aligned_alloc(_Alignof(_LogSlot_t), LOGGER_ASYNC_SLOTS * sizeof(_LogSlot_t))) == NULL){
+        return false;
+    }
+    for (size_t i = 0; i < LOGGER_ASYNC_SLOTS; i++){
+        atomic_init(&self->slots[i].seq, i);
+    }
+    atomic_init(&self->tail, 0);
+    atomic_init(&self->dropped, 0);
+    atomic_init(&self->stop, false);
+    atomic_init(&self->writer_idle, false);
+
+    /* Only the writer thread touches the file, so it can be fully buffered */
+    if ((self->file_buff = malloc(LOGGER_ASYNC_FILE_BUFF_SIZE)) != NULL){
+        setvbuf(self->log_file, self->file_buff, _IOFBF, LOGGER_ASYNC_FILE_BUFF_SIZE);
+    }
+
+    int err;
+    if ((err = pthread_mutex_init(&self->lock, NULL)) != 0){
+        errno = err;
+        return false;
+    }
+    if ((err = pthread_cond_init(&self->wakeup, NULL)) != 0){
+        pthread_mutex_destroy(&self->lock);
+        errno = err;
+        return false;
+    }
+
+    /* The writer thread must not handle signals meant for the rest of the program */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    err = pthread_create(&self->writer, NULL, writer_main, self);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (err != 0){
+        pthread_cond_destroy(&self->wakeup);
+        pthread_mutex_destroy(&self->lock);
+        errno = err;
+        return false;
+    }
+    self->writer_running = true;
+    return true;
+}
+
+static size_t format_line(Logger self, LogLevels level, char * buff, size_t size, const char * fmt, va_list ap){
+    size_t len = 0;
+    int written;
+
+    /* Prefix, date and time and level (same format as synchronous mode) */
+    if (self->log_prefix != NULL){
+        written = snprintf(buff + len, size - len, "[%s] ", self->log_prefix);
+        len += written > 0 ? (size_t) written : 0;
+    }
+    if (self->with_datetime && len < size){
+        written = snprintf(buff + len, size - len, "@[%s] ", Clock_datetime());
+        len += written > 0 ? (size_t) written : 0;
+    }
+    if (self->with_level && len < size){
+        written = snprintf(buff + len, size - len, "[%s] ", LogLevelsStr[level]);
+        len += written > 0 ? (size_t) written : 0;
+    }
+    if (len > 0 && len < size){
+        written = snprintf(buff + len, size - len, "--> ");
+        len += written > 0 ? (size_t) written : 0;
+    }
 
-    // Format the date and time
-    strftime(buff, size, DATETIME_FORMAT, timeinfo);
+    /* Message, leaving room for the new line */
+    if (len < size - 1){
+        written = vsnprintf(buff + len, size - 1 - len, fmt, ap);
+        len += written > 0 ? (size_t) written : 0;
+    }
+    if (len > size - 2){
+        len = size - 2;                 // Truncated
+    }
+    buff[len++] = '\n';
+    return len;
+}
+
+static _LogSlot_t * claim(Logger self, bool must_block, size_t * pos){
+    _LogSlot_t * slot;
+    * pos = atomic_load_explicit(&self->tail, memory_order_relaxed);
+    while (true){
+        slot = &(self->slots[* pos & (LOGGER_ASYNC_SLOTS - 1)]);
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq == * pos){
+            if (atomic_compare_exchange_weak_explicit(&self->tail, pos, * pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)){
+                return slot;
+            }
+            /* Lost the race: `pos` was reloaded */
+        }
+        else if (seq < * pos){
+            /* Full: the writer thread has not released this slot yet */
+            if (self->overflow == LOGGER_OVERFLOW_DROP && ! must_block){
+                atomic_fetch_add_explicit(&self->dropped, 1, memory_order_relaxed);
+                return NULL;
+            }
+            wake_writer(self);
+            nanosleep(&(struct timespec){ .tv_sec = 0, .tv_nsec = BLOCK_POLL_NS }, NULL);
+            * pos = atomic_load_explicit(&self->tail, memory_order_relaxed);
+        }
+        else{
+            /* Another producer claimed it */
+            * pos = atomic_load_explicit(&self->tail, memory_order_relaxed);
+        }
+    }
+}
+
+static void publish(Logger self, _LogSlot_t * slot, size_t pos){
+    atomic_store(&slot->seq, pos + 1);
+    if (atomic_load(&self->writer_idle)){
+        wake_writer(self);
+    }
+}
+
+static bool log_binary(Logger self, LogLevels level, const char * fmt, va_list ap){
+    bool is_new;
+    uint32_t id = intern(self, fmt, &is_new);
+    if (is_new){
+        write_raw(self, (LogFmtHeader){ .type = LOGFMT_REC_FORMAT, .id = id }, fmt, strlen(fmt));
+        atomic_store_explicit(&self->formats[id - 1].ready, true, memory_order_release);
+    }
+
+    /* Encode straight into the ring, or into a local buffer */
+    size_t pos = 0;
+    _LogSlot_t * slot = NULL;
+    uint8_t local[LOGGER_ASYNC_LINE_SIZE];
+    uint8_t * buff = local;
+    if (self->async){
+        if ((slot = claim(self, false, &pos)) == NULL){
+            return false;
+        }
+        buff = (uint8_t *) slot->text;
+    }
+
+    size_t len = encode_record(buff, level, id, fmt, ap);
+    if (self->async){
+        slot->len = len;
+        publish(self, slot, pos);
+    }
+    else{
+        fwrite(buff, 1, len, self->log_file);
+        if (self->flush_immediately){
+            fflush(self->log_file);
+        }
+    }
+    return true;
+}
+
+static size_t encode_record(uint8_t * buff, LogLevels level, uint32_t id, const char * fmt, va_list ap){
+    LogFmtHeader header = { .type = LOGFMT_REC_LOG, .info = (uint8_t) level, .id = id, .timestamp = timestamp_ns() };
+    size_t len = LOGFMT_HEADER_SIZE;
+
+    /* Without an id, the format string is the first argument */
+    if (id == 0){
+        size_t fmt_len = strlen(fmt);
+        uint16_t fmt_len16 = (uint16_t) (fmt_len > LOGGER_ASYNC_LINE_SIZE / 2 ? LOGGER_ASYNC_LINE_SIZE / 2 : fmt_len);
+        buff[len] = LOGFMT_ARG_STR;
+        memcpy(buff + len + 1, &fmt_len16, sizeof(uint16_t));
+        memcpy(buff + len + 1 + sizeof(uint16_t), fmt, fmt_len16);
+        len += 1 + sizeof(uint16_t) + fmt_len16;
+        header.argc = 1;
+    }
+    uint8_t argc;
+    len += LogFmt_encode(fmt, buff + len, LOGGER_ASYNC_LINE_SIZE - len, ap, &argc);
+    header.argc += argc;
+    header.payload_len = (uint32_t) (len - LOGFMT_HEADER_SIZE);
+    LogFmt_put_header(buff, &header);
+    return len;
+}
+
+static void write_dropped(Logger self, size_t dropped){
+    if (! self->binary){
+        fprintf(self->log_file, DROPPED_FMT "\n", dropped);
+        return;
+    }
+    uint8_t buff[LOGGER_ASYNC_LINE_SIZE];
+    fwrite(buff, 1, encode_dropped(buff, dropped), self->log_file);
+}
+
+static size_t encode_dropped(uint8_t * buff, ...){
+    va_list ap;
+    va_start(ap, buff);
+    size_t len = encode_record(buff, LOGGER_LEVEL_CRITICAL, 0, DROPPED_FMT, ap);
+    va_end(ap);
+    return len;
+}
+
+static uint32_t intern(Logger self, const char * fmt, bool * is_new){
+    /* Format strings are literals: their address identifies them */
+    * is_new = false;
+    size_t hash = (size_t) (((uintptr_t) fmt >> 3) * 2654435761U);
+    for (size_t n = 0; n < LOGGER_BINARY_MAX_FORMATS; n++){
+        size_t i = (hash + n) & (LOGGER_BINARY_MAX_FORMATS - 1);
+        const char * current = atomic_load(&self->formats[i].fmt);
+        if (current == NULL){
+            if (atomic_compare_exchange_strong(&self->formats[i].fmt, &current, fmt)){
+                * is_new = true;
+                return (uint32_t) i + 1;
+            }
+        }
+        if (current == fmt){
+            /* Added by another producer: wait until its FORMAT record is written (or queued) */
+            while (! atomic_load_explicit(&self->formats[i].ready, memory_order_acquire)){
+                nanosleep(&(struct timespec){ .tv_sec = 0, .tv_nsec = BLOCK_POLL_NS }, NULL);
+            }
+            return (uint32_t) i + 1;
+        }
+    }
+    return 0;
+}
+
+static void write_raw(Logger self, LogFmtHeader header, const void * payload, size_t len){
+    if (len > LOGGER_ASYNC_LINE_SIZE - LOGFMT_HEADER_SIZE){
+        len = LOGGER_ASYNC_LINE_SIZE - LOGFMT_HEADER_SIZE;          // Truncated
+    }
+    if (header.timestamp == 0){
+        header.timestamp = timestamp_ns();
+    }
+    header.payload_len = (uint32_t) len;
+
+    size_t pos = 0;
+    _LogSlot_t * slot = NULL;
+    uint8_t local[LOGGER_ASYNC_LINE_SIZE];
+    uint8_t * buff = local;
+    if (self->async){
+        slot = claim(self, true, &pos);
+        buff = (uint8_t *) slot->text;
+    }
+    LogFmt_put_header(buff, &header);
+    memcpy(buff + LOGFMT_HEADER_SIZE, payload, len);
+
+    if (self->async){
+        slot->len = LOGFMT_HEADER_SIZE + len;
+        publish(self, slot, pos);
+    }
+    else{
+        fwrite(buff, 1, LOGFMT_HEADER_SIZE + len, self->log_file);
+    }
+}
+
+static uint64_t timestamp_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t) ts.tv_sec * NS_PER_SEC + (uint64_t) ts.tv_nsec;
+}
+
+static void wake_writer(Logger self){
+    if (pthread_mutex_trylock(&self->lock) == 0){
+        pthread_cond_signal(&self->wakeup);
+        pthread_mutex_unlock(&self->lock);
+    }
+}
+
+static size_t drain(Logger self){
+    size_t written = 0;
+    while (true){
+        _LogSlot_t * slot = &(self->slots[self->head & (LOGGER_ASYNC_SLOTS - 1)]);
+        if (atomic_load(&slot->seq) != self->head + 1){
+            break;
+        }
+        fwrite(slot->text, 1, slot->len, self->log_file);
+        atomic_store_explicit(&slot->seq, self->head + LOGGER_ASYNC_SLOTS, memory_order_release);
+        self->head++;
+        written++;
+    }
+
+    /* Report dropped lines */
+    size_t dropped = atomic_load_explicit(&self->dropped, memory_order_relaxed);
+    if (dropped != self->dropped_reported){
+        write_dropped(self, dropped - self->dropped_reported);
+        self->dropped_reported = dropped;
+        written++;
+    }
+    return written;
+}
+
+static void * writer_main(void * arg){
+    Logger self = arg;
+
+    while (! atomic_load(&self->stop)){
+        if (drain(self) > 0){
+            /* One write (2) per batch instead of one per line */
+            if (self->flush_immediately){
+                fflush(self->log_file);
+            }
+            continue;
+        }
+
+        /* Nothing to write: sleep until woken up (or for a while) */
+        pthread_mutex_lock(&self->lock);
+        atomic_store(&self->writer_idle, true);
+        _LogSlot_t * slot = &(self->slots[self->head & (LOGGER_ASYNC_SLOTS - 1)]);
+        if (atomic_load(&slot->seq) != self->head + 1 && ! atomic_load(&self->stop)){
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += LOGGER_ASYNC_IDLE_MS * NS_PER_MS;
+            if (deadline.tv_nsec >= NS_PER_SEC){
+                deadline.tv_sec++;
+                deadline.tv_nsec -= NS_PER_SEC;
+            }
+            pthread_cond_timedwait(&self->wakeup, &self->lock, &deadline);
+        }
+        atomic_store(&self->writer_idle, false);
+        pthread_mutex_unlock(&self->lock);
+    }
+
+    /**
+     * Flush on shutdown: write everything that was queued. A slot that was claimed but
+     * is never published (its producer was interrupted by a signal handler that ended
+     * the program) is skipped after a while, so that shutdown cannot hang.
+     */
+    int rounds = 0;
+    while (self->head != atomic_load(&self->tail)){
+        if (drain(self) > 0){
+            rounds = 0;
+        }
+        else if (++rounds >= STOP_WAIT_ROUNDS){
+            self->head++;
+            rounds = 0;
+        }
+        else{
+            nanosleep(&(struct timespec){ .tv_sec = 0, .tv_nsec = BLOCK_POLL_NS }, NULL);
+        }
+    }
+    drain(self);                        // Dropped lines
+    fflush(self->log_file);
+    return NULL;
 }
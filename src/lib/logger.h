@@ -3,13 +3,34 @@
  * \brief       Implementation of a Logger, and macros to easily log
  *              messages to it.
  * 
- * \note        For further optimization, to use the macro `LOG_DEBUG()`, 
- *              the constant `__USE_DEBUG_LOGS__` must be defined at compile-time.
- *              Independently of the value passed to `LoggerConfig.min_log_level`,
- *              said macro expands empty when `__USE_DEBUG_LOGS__` is not defined
- *              in order to optimize production executables.
- *              All direct calls to `Logger_log()` with `LOGGER_LEVEL_DEBUG` passed
- *              as `level` do log debug messages without said constant defined.
+ * \note        For further optimization, the logging macros (`LOG_DEBUG()`, `LOG_VERBOSE()`,
+ *              `LOG_MSG()`, `LOG_ERR()` and their `_LIMITED` variants) compile out entirely
+ *              for levels below `LOGGER_COMPILE_MIN_LEVEL`, which can be set at compile-time
+ *              (i.e. `make LOG_MIN_LEVEL=LOGGER_LEVEL_NORMAL`). It defaults to
+ *              `LOGGER_LEVEL_DEBUG` when `__USE_DEBUG_LOGS__` is defined, and to
+ *              `LOGGER_LEVEL_INFO` otherwise. Above it, the macros check
+ *              `LoggerConfig.min_log_level` before evaluating their arguments.
+ *              All direct calls to `Logger_log()` are not affected by said constant.
+ *
+ * \note        Log calls in hot paths that clients can trigger at will may use the
+ *              `_LIMITED` macros, which log at most a given amount of messages per second
+ *              from each call site. The messages suppressed within a second are reported
+ *              by the next message logged from the same call site.
+ *
+ * \note        In asynchronous mode (`LoggerConfig.async`), callers only format the
+ *              log line into a slot of a preallocated lock-free ring, and a dedicated
+ *              writer thread drains it and writes to the log file in batches. Lines
+ *              longer than LOGGER_ASYNC_LINE_SIZE are truncated. When the ring is full,
+ *              `LoggerConfig.overflow` decides whether the line is dropped (and counted)
+ *              or the caller waits for room. Every queued line is written by
+ *              `Logger_cleanup()`.
+ *
+ * \note        In binary mode (`LoggerConfig.binary`), messages are not formatted: each
+ *              record keeps the id of its format string and the raw arguments, and every
+ *              format string is written once to the log (see logfmt.h). Binary logs are
+ *              rendered back to text with the logdecode tool (src/logdecode). Format
+ *              strings are identified by their address, so they must be string literals
+ *              (as the messages in messages.h are).
  * 
  * \date        June, 2024
  * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
@@ -25,6 +46,9 @@
 #include <unistd.h>     // close()
 #include <errno.h>      // errno
 #include <time.h>       // time_t, time(), localtime(), strftime()
+#include <stdatomic.h>  // atomic_*
+
+#include "clock.h"      // Clock_datetime()
 
 /****************************************************************************************/
 /* CUSTOMIZABLE                                                                         */
@@ -34,28 +58,116 @@
 #define LOGGER_DEFAULT_MIN_LOG_LEVEL   LOGGER_LEVEL_NORMAL
 
 /* Maximum formatted date and time length */
-#define MAX_DATETIME_LEN 32
+#define MAX_DATETIME_LEN CLOCK_DATETIME_LEN
+
+/* Date and time format as required by strftime (3). Set in clock.h, since the formatted date and time is cached there. */
+#define DATETIME_FORMAT CLOCK_DATETIME_FORMAT
+
+/* Asynchronous mode: amount of slots in the ring (a power of two) */
+#define LOGGER_ASYNC_SLOTS          4096
+
+/* Asynchronous mode: maximum length of a log line, including prefix, date and time, level and new line.
+   Binary mode: maximum size of a record. */
+#define LOGGER_ASYNC_LINE_SIZE      512
+
+/* Asynchronous mode: longest time the writer thread sleeps while the ring is empty */
+#define LOGGER_ASYNC_IDLE_MS        50
 
-/* Date and time format as required by strftime (3). Formatted date and time must be MAX_DATETIME_LEN chars at most. */
-#define DATETIME_FORMAT "%Y/%m/%d-%H:%M:%S"
+/* Asynchronous mode: size of the stdio buffer of the log file */
+#define LOGGER_ASYNC_FILE_BUFF_SIZE (64 * 1024)
+
+/* Rate limited macros: summary of the messages suppressed at a call site (count, file, line) */
+#define LOGGER_SUPPRESSED_FMT       "(%zu similar messages suppressed at %s:%d)"
+
+/* Binary mode: size of the string table (a power of two). Format strings beyond it are stored in every record. */
+#define LOGGER_BINARY_MAX_FORMATS   1024
 
 /****************************************************************************************/
 /* Macro and constant definitions                                                       */
 /****************************************************************************************/
 
+/* Minimum level compiled in by the logging macros (see notes at the top of this file).
+   Either a LogLevels name or its value. */
+#ifndef LOGGER_COMPILE_MIN_LEVEL
+#ifdef __USE_DEBUG_LOGS__
+#define LOGGER_COMPILE_MIN_LEVEL    LOGGER_LEVEL_DEBUG
+#else // __USE_DEBUG_LOGS__ not defined
+#define LOGGER_COMPILE_MIN_LEVEL    LOGGER_LEVEL_INFO
+#endif // __USE_DEBUG_LOGS__
+#endif // LOGGER_COMPILE_MIN_LEVEL
+
+/* Value of a level name for the preprocessor, which does not see enumerations */
+#define LOG_RANK(level)                     LOG_RANK_(level)
+#define LOG_RANK_(level)                    LOG_RANK_##level
+#define LOG_RANK_LOGGER_LEVEL_DEBUG         0
+#define LOG_RANK_LOGGER_LEVEL_INFO          1
+#define LOG_RANK_LOGGER_LEVEL_NORMAL        2
+#define LOG_RANK_LOGGER_LEVEL_CRITICAL      3
+#define LOG_RANK_0                          0
+#define LOG_RANK_1                          1
+#define LOG_RANK_2                          2
+#define LOG_RANK_3                          3
+
 /**
  *              Logger macros. These macros provide easy access to the logger from any
  *              function. It is required to have a reference to the Logger to be used
  *              (that is, a variable of type Logger), called "logger" to use these macros.
+ *
+ *              The `_LIMITED` variants log at most `per_sec` messages per second from the
+ *              call site. These are statements, not expressions.
  */
-#ifdef __USE_DEBUG_LOGS__
-#define LOG_DEBUG(...)     Logger_log(logger, LOGGER_LEVEL_DEBUG,    __VA_ARGS__)
-#else // __USE_DEBUG_LOGS__ not defined
-#define LOG_DEBUG(...)
-#endif // __USE_DEBUG_LOGS__
-#define LOG_VERBOSE(...)   Logger_log(logger, LOGGER_LEVEL_INFO,     __VA_ARGS__)
-#define LOG_MSG(...)       Logger_log(logger, LOGGER_LEVEL_NORMAL,   __VA_ARGS__)
-#define LOG_ERR(...)       Logger_log(logger, LOGGER_LEVEL_CRITICAL, __VA_ARGS__)
+#if LOG_RANK(LOGGER_COMPILE_MIN_LEVEL) <= 0
+#define LOG_DEBUG(...)                      LOG_AT(LOGGER_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_DEBUG_LIMITED(per_sec, ...)     LOG_LIMITED(LOGGER_LEVEL_DEBUG, per_sec, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...)                      LOG_OFF(LOGGER_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_DEBUG_LIMITED(per_sec, ...)     LOG_OFF_LIMITED(LOGGER_LEVEL_DEBUG, __VA_ARGS__)
+#endif
+
+#if LOG_RANK(LOGGER_COMPILE_MIN_LEVEL) <= 1
+#define LOG_VERBOSE(...)                    LOG_AT(LOGGER_LEVEL_INFO, __VA_ARGS__)
+#define LOG_VERBOSE_LIMITED(per_sec, ...)   LOG_LIMITED(LOGGER_LEVEL_INFO, per_sec, __VA_ARGS__)
+#else
+#define LOG_VERBOSE(...)                    LOG_OFF(LOGGER_LEVEL_INFO, __VA_ARGS__)
+#define LOG_VERBOSE_LIMITED(per_sec, ...)   LOG_OFF_LIMITED(LOGGER_LEVEL_INFO, __VA_ARGS__)
+#endif
+
+#if LOG_RANK(LOGGER_COMPILE_MIN_LEVEL) <= 2
+#define LOG_MSG(...)                        LOG_AT(LOGGER_LEVEL_NORMAL, __VA_ARGS__)
+#define LOG_MSG_LIMITED(per_sec, ...)       LOG_LIMITED(LOGGER_LEVEL_NORMAL, per_sec, __VA_ARGS__)
+#else
+#define LOG_MSG(...)                        LOG_OFF(LOGGER_LEVEL_NORMAL, __VA_ARGS__)
+#define LOG_MSG_LIMITED(per_sec, ...)       LOG_OFF_LIMITED(LOGGER_LEVEL_NORMAL, __VA_ARGS__)
+#endif
+
+#define LOG_ERR(...)                        LOG_AT(LOGGER_LEVEL_CRITICAL, __VA_ARGS__)
+#define LOG_ERR_LIMITED(per_sec, ...)       LOG_LIMITED(LOGGER_LEVEL_CRITICAL, per_sec, __VA_ARGS__)
+
+/* Arguments are only evaluated if the Logger would log the message */
+#define LOG_AT(level, ...)                                                                  \
+    (Logger_enabled(logger, level) ? Logger_log(logger, level, __VA_ARGS__) : false)
+
+#define LOG_LIMITED(level, per_sec, ...)                                                    \
+    do {                                                                                    \
+        if (Logger_enabled(logger, level)){                                                 \
+            static LoggerRateLimit _log_rate_limit;                                         \
+            size_t _log_suppressed;                                                         \
+            if (Logger_rate_limit(&_log_rate_limit, per_sec, &_log_suppressed)){            \
+                if (_log_suppressed > 0){                                                   \
+                    Logger_log(logger, level, LOGGER_SUPPRESSED_FMT,                        \
+                               _log_suppressed, __FILE__, __LINE__);                        \
+                }                                                                           \
+                Logger_log(logger, level, __VA_ARGS__);                                     \
+            }                                                                               \
+        }                                                                                   \
+    } while (0)
+
+/* Compiled out: arguments are never evaluated (sizeof), but they are still type checked */
+#define LOG_OFF(level, ...)                                                                 \
+    Logger_off(sizeof(Logger_log(logger, level, __VA_ARGS__)))
+
+#define LOG_OFF_LIMITED(level, ...)                                                         \
+    do { (void) sizeof(Logger_log(logger, level, __VA_ARGS__)); } while (0)
 
 /****************************************************************************************/
 /* Custom data types and enumerations                                                   */
@@ -91,6 +203,24 @@ typedef enum {
     LOG_LEVELS_QTY
 } LogLevels;
 
+/**
+ * \enum        LoggerOverflow: what to do, in asynchronous mode, when the ring is full.
+ */
+typedef enum {
+    LOGGER_OVERFLOW_DROP,               // Drop the line. Dropped lines are counted and reported in the log.
+    LOGGER_OVERFLOW_BLOCK,              // Wait until the writer thread makes room.
+} LoggerOverflow;
+
+/**
+ * \typedef     LoggerRateLimit: state of a rate limited call site (see `LOG_LIMITED()`).
+ *              Zero-initialized (i.e. static) instances are ready to use.
+ */
+typedef struct {
+    _Atomic(time_t)     second;         // Second of the current window.
+    atomic_uint         logged;         // Messages allowed within the current window.
+    atomic_size_t       suppressed;     // Messages suppressed since the last message logged.
+} LoggerRateLimit;
+
 /**
  * \typedef      LoggerConfig: Logger configuration. This structure is used to set varios
  *              parameters that customize the way the Logger behaves.
@@ -105,6 +235,10 @@ typedef struct {
                                         // Note that the string is NOT internally copied, so it must either be in
                                         // the constants memory section or must be dynamically allocated and not free'd
                                         // while the Logger is in use.
+    bool            async;              // Write logs from a background thread (see notes at the top of this file).
+                                        // With flush_immediately, the log file is flushed after every batch.
+    LoggerOverflow  overflow;           // Asynchronous mode only: what to do when the ring is full.
+    bool            binary;             // Write binary records instead of text (see notes at the top of this file).
 } LoggerConfig;
 
 /****************************************************************************************/
@@ -128,13 +262,64 @@ Logger Logger_create(LoggerConfig config, const char * const file_path);
  *                          as `printf` (i.e. %d, %i, %lg, %s, etc.).
  * \param[in] ...           Variable arguments (values for each specifier used in `fmt`).
  * 
- * \return          true if the message was logged, false otherwise.
+ * \return          true if the message was logged (or queued, in asynchronous mode), false otherwise.
  */
 bool Logger_log(Logger const self, LogLevels level, const char * __restrict__ fmt, ...);
 
 /**
- * \brief           Cleanup the Logger (flush and close its open log file, and free its
- *                  allocated memory).
+ * \brief           Check whether messages of a given level would be logged, so that their
+ *                  arguments need not be evaluated otherwise.
+ *
+ * \param[in] self          The Logger itself.
+ * \param[in] level         The log level.
+ *
+ * \return          true if `level` is not below the minimum level of the Logger, false
+ *                  otherwise (or if `self` is NULL).
+ */
+bool Logger_enabled(Logger const self, LogLevels level);
+
+/**
+ * \brief           Change the minimum level of the Logger. Safe while other threads log.
+ *
+ * \param[in] self          The Logger itself.
+ * \param[in] level         The new minimum log level.
+ *
+ * \return          true on success, false if `level` is not a valid level (or if `self` is NULL).
+ */
+bool Logger_set_level(Logger const self, LogLevels level);
+
+/**
+ * \brief           Take a token from the bucket of a rate limited call site. The bucket
+ *                  holds `per_sec` tokens and is refilled every second.
+ *
+ * \param[in,out] limit     State of the call site.
+ * \param[in] per_sec       Maximum amount of messages per second.
+ * \param[out] suppressed   Amount of messages suppressed since the last one allowed (only
+ *                          meaningful if a token was taken; 0 otherwise).
+ *
+ * \return          true if the message may be logged, false if it must be suppressed.
+ */
+bool Logger_rate_limit(LoggerRateLimit * limit, unsigned per_sec, size_t * suppressed);
+
+/**
+ * \brief           Result of the logging macros compiled out (see `LOG_OFF()`).
+ */
+static inline bool Logger_off(size_t unused){
+    (void) unused;
+    return false;
+}
+
+/**
+ * \brief           Amount of messages dropped because the ring was full (asynchronous mode
+ *                  with LOGGER_OVERFLOW_DROP only).
+ *
+ * \param[in] self          The Logger itself.
+ */
+size_t Logger_dropped(Logger const self);
+
+/**
+ * \brief           Cleanup the Logger (write every queued message, flush and close its open
+ *                  log file, and free its allocated memory).
  * 
  * \param[in] self          The Logger itself.
  */
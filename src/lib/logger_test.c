@@ -1,8 +1,230 @@
 #include "logger.h"
+#include "logfmt.h"
 #include <assert.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <string.h>
 
 #define LOGFILE "./logfile.log"
+#define ASYNC_LOGFILE "./logfile_async.log"
+#define ASYNC_LOGS 20000
+#define BINARY_LOGFILE "./logfile.bin"
+#define LEVEL_LOGFILE "./logfile_level.log"
+#define THREADS_LOGFILE "./logfile_threads.bin"
+#define THREADS 4
+#define THREAD_FORMATS 64
+
+/* Every message logged in asynchronous mode must be written, in order */
+static void test_async(void){
+    LoggerConfig cfg = {
+        .with_level = true,
+        .min_log_level = LOGGER_DEFAULT_MIN_LOG_LEVEL,
+        .async = true,
+        .overflow = LOGGER_OVERFLOW_BLOCK
+    };
+    Logger logger = Logger_create(cfg, ASYNC_LOGFILE);
+    assert(logger != NULL);
+
+    assert(! LOG_VERBOSE("msg"));
+    for (int i = 0; i < ASYNC_LOGS; i++){
+        assert(LOG_MSG("async %d", i));
+    }
+    assert(Logger_dropped(logger) == 0);
+    Logger_cleanup(logger);
+
+    FILE * file = fopen(ASYNC_LOGFILE, "r");
+    assert(file != NULL);
+    char line[128];
+    int count = 0;
+    while (fgets(line, sizeof(line), file) != NULL){
+        char expected[128];
+        snprintf(expected, sizeof(expected), "[ NORMAL ] --> async %d\n", count);
+        assert(strcmp(line, expected) == 0);
+        count++;
+    }
+    fclose(file);
+    remove(ASYNC_LOGFILE);
+    assert(count == ASYNC_LOGS);
+}
+
+/* Binary records must hold the format strings and arguments of every message */
+static void test_binary(bool async){
+    LoggerConfig cfg = {
+        .log_prefix = "bin",
+        .with_level = true,
+        .min_log_level = LOGGER_DEFAULT_MIN_LOG_LEVEL,
+        .async = async,
+        .overflow = LOGGER_OVERFLOW_BLOCK,
+        .binary = true
+    };
+    Logger logger = Logger_create(cfg, BINARY_LOGFILE);
+    assert(logger != NULL);
+    for (int i = 0; i < 3; i++){
+        assert(LOG_MSG("New client connected at %s : %d.", "127.0.0.1", 1000 + i));
+    }
+    assert(LOG_ERR("Loaded %zu addresses", (size_t) 42));
+    Logger_cleanup(logger);
+
+    const char * expected[] = {
+        "New client connected at 127.0.0.1 : 1000.",
+        "New client connected at 127.0.0.1 : 1001.",
+        "New client connected at 127.0.0.1 : 1002.",
+        "Loaded 42 addresses",
+    };
+    char * formats[2] = {0};
+    uint32_t ids[2] = {0};
+    int format_qty = 0;
+    uint8_t record[LOGGER_ASYNC_LINE_SIZE];
+    char rendered[LOGGER_ASYNC_LINE_SIZE];
+    int sessions = 0, messages = 0;
+
+    FILE * file = fopen(BINARY_LOGFILE, "rb");
+    assert(file != NULL);
+    while (fread(record, 1, LOGFMT_HEADER_SIZE, file) == LOGFMT_HEADER_SIZE){
+        LogFmtHeader header;
+        LogFmt_get_header(record, &header);
+        assert(header.payload_len <= sizeof(record) && fread(record, 1, header.payload_len, file) == header.payload_len);
+        switch (header.type){
+            case LOGFMT_REC_SESSION:
+                assert(header.id == LOGFMT_VERSION && header.info == LOGFMT_SESSION_LEVEL);
+                assert(header.payload_len == LOGFMT_MAGIC_LEN + 3 && memcmp(record, LOGFMT_MAGIC "bin", header.payload_len) == 0);
+                sessions++;
+                break;
+            case LOGFMT_REC_FORMAT:
+                assert(header.id > 0 && format_qty < 2);
+                ids[format_qty] = header.id;
+                formats[format_qty] = calloc(1, header.payload_len + 1);
+                memcpy(formats[format_qty++], record, header.payload_len);
+                break;
+            case LOGFMT_REC_LOG: {
+                int f = ids[0] == header.id ? 0 : 1;
+                assert(messages < 4 && header.info == (messages < 3 ? LOGGER_LEVEL_NORMAL : LOGGER_LEVEL_CRITICAL));
+                assert(ids[f] == header.id && header.argc == (messages < 3 ? 2 : 1));
+                assert(LogFmt_render(formats[f], record, header.payload_len, rendered, sizeof(rendered)));
+                assert(strcmp(rendered, expected[messages]) == 0);
+                messages++;
+                break;
+            }
+            default:
+                assert(false);
+        }
+    }
+    fclose(file);
+    remove(BINARY_LOGFILE);
+    for (int i = 0; i < format_qty; i++){
+        free(formats[i]);
+    }
+    assert(sessions == 1 && format_qty == 2 && messages == 4);
+}
+
+/* Producers racing to add the same format strings */
+static const char * thread_formats[THREAD_FORMATS];
+static pthread_barrier_t thread_barrier;
+
+static void * log_formats(void * arg){
+    Logger logger = arg;
+    pthread_barrier_wait(&thread_barrier);
+    for (int i = 0; i < THREAD_FORMATS; i++){
+        assert(Logger_log(logger, LOGGER_LEVEL_NORMAL, thread_formats[i], i));
+    }
+    return NULL;
+}
+
+/* With several producers, every format record comes before the messages that use it */
+static void test_binary_threads(void){
+    static char formats[THREAD_FORMATS][16];
+    for (int i = 0; i < THREAD_FORMATS; i++){
+        snprintf(formats[i], sizeof(formats[i]), "format %d: %%d", i);
+        thread_formats[i] = formats[i];
+    }
+    LoggerConfig cfg = {
+        .min_log_level = LOGGER_DEFAULT_MIN_LOG_LEVEL,
+        .async = true,
+        .overflow = LOGGER_OVERFLOW_BLOCK,
+        .binary = true
+    };
+    Logger logger = Logger_create(cfg, THREADS_LOGFILE);
+    assert(logger != NULL);
+    pthread_t threads[THREADS];
+    pthread_barrier_init(&thread_barrier, NULL, THREADS);
+    for (int i = 0; i < THREADS; i++){
+        assert(pthread_create(&threads[i], NULL, log_formats, logger) == 0);
+    }
+    for (int i = 0; i < THREADS; i++){
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&thread_barrier);
+    Logger_cleanup(logger);
+
+    bool known[LOGGER_BINARY_MAX_FORMATS + 1] = {0};
+    uint8_t record[LOGGER_ASYNC_LINE_SIZE];
+    int format_qty = 0, messages = 0;
+    FILE * file = fopen(THREADS_LOGFILE, "rb");
+    assert(file != NULL);
+    while (fread(record, 1, LOGFMT_HEADER_SIZE, file) == LOGFMT_HEADER_SIZE){
+        LogFmtHeader header;
+        LogFmt_get_header(record, &header);
+        assert(header.payload_len <= sizeof(record) && fread(record, 1, header.payload_len, file) == header.payload_len);
+        if (header.type == LOGFMT_REC_FORMAT){
+            assert(header.id > 0 && header.id <= LOGGER_BINARY_MAX_FORMATS && ! known[header.id]);
+            known[header.id] = true;
+            format_qty++;
+        }
+        else if (header.type == LOGFMT_REC_LOG){
+            assert(header.id <= LOGGER_BINARY_MAX_FORMATS && known[header.id]);
+            messages++;
+        }
+    }
+    fclose(file);
+    remove(THREADS_LOGFILE);
+    assert(format_qty == THREAD_FORMATS && messages == THREADS * THREAD_FORMATS);
+}
+
+/* Filtered levels do not evaluate their arguments, and rate limited sites report what they suppress */
+static void test_rate_limit(void){
+    int evaluated = 0;
+    Logger logger = NULL;
+    assert(! LOG_ERR("%d", evaluated++));
+    assert(evaluated == 0);
+
+    /* Retry if the second changes in the middle, since the bucket is refilled */
+    size_t suppressed;
+    time_t start;
+    int allowed;
+    do {
+        LoggerRateLimit limit = {0};
+        start = Clock_now();
+        allowed = 0;
+        for (int i = 0; i < 10; i++){
+            allowed += Logger_rate_limit(&limit, 3, &suppressed);
+        }
+    } while (Clock_now() != start);
+    assert(allowed == 3);
+
+    LoggerRateLimit limit = {0};
+    atomic_store(&limit.second, (time_t) 1);
+    atomic_store(&limit.logged, 3);
+    atomic_store(&limit.suppressed, 7);
+    assert(Logger_rate_limit(&limit, 3, &suppressed) && suppressed == 7);
+    assert(Logger_rate_limit(&limit, 3, &suppressed) && suppressed == 0);
+}
+
+/* The minimum level can be changed after the Logger is created */
+static void test_set_level(void){
+    LoggerConfig cfg = { .min_log_level = LOGGER_LEVEL_NORMAL };
+    Logger logger = Logger_create(cfg, LEVEL_LOGFILE);
+    assert(logger != NULL);
+
+    assert(! LOG_VERBOSE("msg"));
+    assert(Logger_set_level(logger, LOGGER_LEVEL_INFO));
+    assert(Logger_enabled(logger, LOGGER_LEVEL_INFO) && ! Logger_enabled(logger, LOGGER_LEVEL_DEBUG));
+    assert(Logger_set_level(logger, LOGGER_LEVEL_CRITICAL));
+    assert(! LOG_MSG("msg"));
+    assert(! Logger_set_level(logger, LOG_LEVELS_QTY));
+    assert(! Logger_enabled(logger, LOGGER_LEVEL_NORMAL));
+    assert(! Logger_set_level(NULL, LOGGER_LEVEL_INFO));
+    Logger_cleanup(logger);
+}
 
 int main (void){
     LoggerConfig cfg = {
@@ -25,5 +247,12 @@ int main (void){
 
     assert(system("python3 check_logs.py") == 0);
 
+    test_rate_limit();
+    test_set_level();
+    test_async();
+    test_binary(false);
+    test_binary(true);
+    test_binary_threads();
+
     puts("Logger: All tests passed!");
 }
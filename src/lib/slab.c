@@ -0,0 +1,129 @@
+/**
+ * \file        slab.c
+ * \brief       Slab allocator for objects of a fixed size.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdalign.h>   // alignof
+#include <stdint.h>     // uint8_t
+
+#include "slab.h"
+
+/**
+ * Freed objects are linked through their first bytes.
+ */
+typedef struct _Slab_Free_t {
+    struct _Slab_Free_t * next;
+} _Slab_Free_t;
+
+/**
+ * Slab header, followed by its objects.
+ */
+typedef union _Slab_Chunk_t {
+    union _Slab_Chunk_t * next;
+    max_align_t           align;        // Objects that follow the header are suitably aligned.
+} _Slab_Chunk_t;
+
+typedef struct _Slab_t {
+    size_t              obj_size;       // Size of each object, a multiple of alignof(max_align_t).
+    size_t              objs_per_slab;
+    _Slab_Free_t *      free;           // Freed objects.
+    uint8_t *           next;           // Next object to carve from the newest slab.
+    uint8_t *           end;            // End of the newest slab.
+    _Slab_Chunk_t *     slabs;          // Every slab allocated.
+    size_t              slab_qty;
+    size_t              in_use;         // Objects currently allocated.
+} _Slab_t;
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+Slab Slab_create(size_t obj_size, size_t objs_per_slab){
+    if (obj_size == 0){
+        return NULL;
+    }
+    Slab self = SLAB_MALLOC(sizeof(_Slab_t));
+    if (self == NULL){
+        return NULL;
+    }
+    if (obj_size < sizeof(_Slab_Free_t)){
+        obj_size = sizeof(_Slab_Free_t);
+    }
+    const size_t align = alignof(max_align_t);
+    self->obj_size      = (obj_size + align - 1) / align * align;
+    self->objs_per_slab = objs_per_slab == 0 ? SLAB_DEFAULT_OBJS : objs_per_slab;
+    self->free          = NULL;
+    self->next          = NULL;
+    self->end           = NULL;
+    self->slabs         = NULL;
+    self->slab_qty      = 0;
+    self->in_use        = 0;
+    return self;
+}
+
+void * Slab_alloc(Slab const self){
+    if (self == NULL){
+        return NULL;
+    }
+    void * obj;
+
+    /* Reuse a freed object */
+    if (self->free != NULL){
+        obj = self->free;
+        self->free = self->free->next;
+    }
+
+    /* Carve a new one, allocating a new slab if the newest one is exhausted */
+    else{
+        if (self->next == self->end){
+            _Slab_Chunk_t * slab = SLAB_MALLOC(sizeof(_Slab_Chunk_t) + self->obj_size * self->objs_per_slab);
+            if (slab == NULL){
+                return NULL;
+            }
+            slab->next  = self->slabs;
+            self->slabs = slab;
+            self->slab_qty++;
+            self->next  = (uint8_t *) (slab + 1);
+            self->end   = self->next + self->obj_size * self->objs_per_slab;
+        }
+        obj = self->next;
+        self->next += self->obj_size;
+    }
+
+    self->in_use++;
+    return obj;
+}
+
+void Slab_free(Slab const self, void * obj){
+    if (self == NULL || obj == NULL){
+        return;
+    }
+    _Slab_Free_t * node = obj;
+    node->next = self->free;
+    self->free = node;
+    self->in_use--;
+}
+
+size_t Slab_in_use(Slab const self){
+    return self == NULL ? 0 : self->in_use;
+}
+
+size_t Slab_capacity(Slab const self){
+    return self == NULL ? 0 : self->slab_qty * self->objs_per_slab;
+}
+
+void Slab_cleanup(Slab self){
+    if (self == NULL){
+        return;
+    }
+    _Slab_Chunk_t * slab = self->slabs, * next;
+    while (slab != NULL){
+        next = slab->next;
+        SLAB_FREE(slab);
+        slab = next;
+    }
+    SLAB_FREE(self);
+}
@@ -0,0 +1,86 @@
+/**
+ * \file        slab.h
+ * \brief       Slab allocator for objects of a fixed size.
+ *
+ * \details     Objects are carved from slabs holding several of them at once, and freed
+ *              objects are kept in a free list for reuse, so once a Slab has grown to its
+ *              usual amount of objects, allocating and freeing them is O(1) and performs no
+ *              further memory allocations. Objects of the same Slab are also close to each
+ *              other in memory. Slabs are only released by `Slab_cleanup`.
+ *
+ * \note        Not thread-safe.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __SLAB_H__
+#define __SLAB_H__
+
+#include <stddef.h>     // size_t
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+#include <stdlib.h>
+
+/* Memory allocation function equivalent to malloc (3) or a malloc (3) wrapper. May not initialize the allocated zone. */
+#define SLAB_MALLOC(size) malloc((size))
+
+/* Memory freeing function equivalent to free (3) or a free (3) wrapper. */
+#define SLAB_FREE(ptr) free((ptr))
+
+/* Default amount of objects per slab */
+#define SLAB_DEFAULT_OBJS 64
+
+/*************************************************************************/
+
+/**
+ * \typedef     Slab main Abstract Data Type.
+ */
+typedef struct _Slab_t * Slab;
+
+/*************************************************************************/
+
+/**
+ * \brief       Create a Slab allocator. No memory is reserved for objects until one is needed.
+ *
+ * \param[in] obj_size      Size of the objects, in bytes. Rounded up so that every object is
+ *                          suitably aligned for any type.
+ * \param[in] objs_per_slab Amount of objects allocated at once. 0 means `SLAB_DEFAULT_OBJS`.
+ *
+ * \return      A Slab on success, NULL on error (`obj_size` is 0, or not enough memory).
+ */
+Slab Slab_create(size_t obj_size, size_t objs_per_slab);
+
+/**
+ * \brief       Allocate an object. Its contents are not initialized.
+ *
+ * \return      The object, or NULL if `self` is NULL or on memory allocation error.
+ */
+void * Slab_alloc(Slab const self);
+
+/**
+ * \brief       Free an object allocated by `Slab_alloc` with the same Slab, keeping it for
+ *              reuse. NULL-safe.
+ */
+void Slab_free(Slab const self, void * obj);
+
+/**
+ * \brief       Amount of objects currently allocated.
+ */
+size_t Slab_in_use(Slab const self);
+
+/**
+ * \brief       Amount of objects that fit in every slab allocated so far.
+ */
+size_t Slab_capacity(Slab const self);
+
+/**
+ * \brief       Release every slab, and the Slab itself. Objects still allocated become
+ *              invalid. NULL-safe.
+ */
+void Slab_cleanup(Slab self);
+
+#endif // __SLAB_H__
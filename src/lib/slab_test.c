@@ -0,0 +1,74 @@
+#include "slab.h"
+#include <assert.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define OBJ_SIZE    37
+#define PER_SLAB    8
+#define OBJ_QTY     100
+
+int main(void) {
+    assert(Slab_create(0, PER_SLAB) == NULL);
+    assert(Slab_alloc(NULL) == NULL);
+    Slab_free(NULL, NULL);
+    Slab_cleanup(NULL);
+
+    Slab slab = Slab_create(OBJ_SIZE, PER_SLAB);
+    assert(slab != NULL);
+    assert(Slab_in_use(slab) == 0);
+    assert(Slab_capacity(slab) == 0);     // Nothing reserved until needed
+
+    // Test 1: objects are distinct, aligned and writable
+    uint8_t * objs[OBJ_QTY];
+    for (int i = 0; i < OBJ_QTY; i++){
+        objs[i] = Slab_alloc(slab);
+        assert(objs[i] != NULL);
+        assert((uintptr_t) objs[i] % alignof(max_align_t) == 0);
+        memset(objs[i], i, OBJ_SIZE);
+    }
+    for (int i = 0; i < OBJ_QTY; i++){
+        for (int j = 0; j < OBJ_SIZE; j++){
+            assert(objs[i][j] == (uint8_t) i);
+        }
+    }
+    assert(Slab_in_use(slab) == OBJ_QTY);
+    size_t capacity = Slab_capacity(slab);
+    assert(capacity >= OBJ_QTY && capacity < OBJ_QTY + PER_SLAB);
+
+    // Test 2: freed objects are reused, without growing
+    for (int i = 0; i < OBJ_QTY; i += 2){
+        Slab_free(slab, objs[i]);
+    }
+    Slab_free(slab, NULL);
+    assert(Slab_in_use(slab) == OBJ_QTY / 2);
+    for (int round = 0; round < 1000; round++){
+        uint8_t * obj = Slab_alloc(slab);
+        assert(obj != NULL);
+        Slab_free(slab, obj);
+    }
+    for (int i = 0; i < OBJ_QTY; i += 2){
+        objs[i] = Slab_alloc(slab);
+        memset(objs[i], i, OBJ_SIZE);
+    }
+    assert(Slab_capacity(slab) == capacity);
+    assert(Slab_in_use(slab) == OBJ_QTY);
+
+    // Test 3: odd objects were not overwritten
+    for (int i = 1; i < OBJ_QTY; i += 2){
+        for (int j = 0; j < OBJ_SIZE; j++){
+            assert(objs[i][j] == (uint8_t) i);
+        }
+    }
+    Slab_cleanup(slab);
+
+    // Test 4: default amount of objects per slab, objects smaller than a pointer
+    slab = Slab_create(1, 0);
+    assert(slab != NULL);
+    assert(Slab_alloc(slab) != NULL);
+    assert(Slab_capacity(slab) == SLAB_DEFAULT_OBJS);
+    Slab_cleanup(slab);
+
+    puts("Slab: All tests passed!");
+}
@@ -0,0 +1,232 @@
+/**
+ * \file        logdecode.c
+ * \brief       Render a binary smtpd log (see src/lib/logfmt.h) in the same text format
+ *              that the Logger writes in text mode.
+ *
+ *              Usage: logdecode [BINARY LOG]    (standard input if omitted or "-")
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdio.h>          // FILE, fopen(), fread(), printf()
+#include <stdlib.h>         // realloc(), free(), EXIT_SUCCESS, EXIT_FAILURE
+#include <string.h>         // memcmp(), strcmp(), strerror()
+#include <errno.h>          // errno
+#include <time.h>           // time_t, localtime_r(), strftime()
+
+#include "logfmt.h"
+#include "logger.h"         // LOG_LEVELS, DATETIME_FORMAT, MAX_DATETIME_LEN
+
+#define MAX_MSG_LEN         (1 << 16)
+#define NS_PER_SEC          1000000000ULL
+
+static const char * LogLevelsStr[] = {
+    #define XX(log_level_numeric, log_level_ascii) log_level_ascii,
+    LOG_LEVELS(XX)
+    #undef XX
+};
+
+/**
+ * \typedef     Session: rendering settings and string table of a session.
+ */
+typedef struct {
+    char *      prefix;             // NULL for no prefix.
+    bool        with_datetime;
+    bool        with_level;
+    char **     formats;            // Format strings by id.
+    size_t      format_qty;
+} Session;
+
+/**
+ * \brief       Read the next record of a log. The payload is kept in `* payload`, which
+ *              grows as needed.
+ *
+ * \return      1 if a record was read, 0 at the end of the log, -1 if the log is truncated
+ *              and -2 if memory could not be allocated.
+ */
+static int read_record(FILE * file, LogFmtHeader * header, uint8_t ** payload, size_t * capacity){
+    uint8_t buff[LOGFMT_HEADER_SIZE];
+    size_t len = fread(buff, 1, LOGFMT_HEADER_SIZE, file);
+    if (len < LOGFMT_HEADER_SIZE){
+        return len == 0 && ! ferror(file) ? 0 : -1;
+    }
+    LogFmt_get_header(buff, header);
+    if (header->payload_len > * capacity){
+        uint8_t * bigger = realloc(* payload, header->payload_len);
+        if (bigger == NULL){
+            return -2;
+        }
+        * payload = bigger;
+        * capacity = header->payload_len;
+    }
+    return fread(* payload, 1, header->payload_len, file) == header->payload_len ? 1 : -1;
+}
+
+/**
+ * \brief       Copy `len` bytes into a new null-terminated string.
+ */
+static char * copy_str(const uint8_t * data, size_t len){
+    char * str = malloc(len + 1);
+    if (str != NULL){
+        memcpy(str, data, len);
+        str[len] = '\0';
+    }
+    return str;
+}
+
+static void clear_session(Session * session){
+    for (size_t i = 0; i < session->format_qty; i++){
+        free(session->formats[i]);
+    }
+    free(session->formats);
+    free(session->prefix);
+    * session = (Session){ .with_datetime = true, .with_level = true };
+}
+
+/**
+ * \brief       Add a format string to the string table of a session.
+ */
+static bool add_format(Session * session, uint32_t id, const uint8_t * data, size_t len){
+    if (id >= session->format_qty){
+        char ** bigger = realloc(session->formats, ((size_t) id + 1) * sizeof(char *));
+        if (bigger == NULL){
+            return false;
+        }
+        memset(bigger + session->format_qty, 0, ((size_t) id + 1 - session->format_qty) * sizeof(char *));
+        session->formats = bigger;
+        session->format_qty = (size_t) id + 1;
+    }
+    free(session->formats[id]);
+    return (session->formats[id] = copy_str(data, len)) != NULL;
+}
+
+/**
+ * \brief       Print a message record.
+ */
+static void print_record(const Session * session, const LogFmtHeader * header, const uint8_t * payload, char * msg){
+    const char * fmt = header->id < session->format_qty ? session->formats[header->id] : NULL;
+    char * inline_fmt = NULL;
+    size_t args_len = header->payload_len;
+
+    /* Records without id carry their format string as the first argument */
+    if (header->id == 0 && args_len >= 1 + sizeof(uint16_t) && payload[0] == LOGFMT_ARG_STR){
+        uint16_t len;
+        memcpy(&len, payload + 1, sizeof(uint16_t));
+        if (1 + sizeof(uint16_t) + len <= args_len){
+            fmt = inline_fmt = copy_str(payload + 1 + sizeof(uint16_t), len);
+            payload     += 1 + sizeof(uint16_t) + len;
+            args_len    -= 1 + sizeof(uint16_t) + len;
+        }
+    }
+
+    if (fmt == NULL){
+        snprintf(msg, MAX_MSG_LEN, "<unknown format %u>", (unsigned) header->id);
+    }
+    else{
+        LogFmt_render(fmt, payload, args_len, msg, MAX_MSG_LEN);       // Renders as much as it can
+    }
+    free(inline_fmt);
+
+    bool did_print = false;
+    if (session->prefix != NULL){
+        printf("[%s] ", session->prefix);
+        did_print = true;
+    }
+    if (session->with_datetime){
+        char datetime[MAX_DATETIME_LEN] = {0};
+        time_t sec = (time_t) (header->timestamp / NS_PER_SEC);
+        struct tm tm;
+        localtime_r(&sec, &tm);
+        strftime(datetime, MAX_DATETIME_LEN, DATETIME_FORMAT, &tm);
+        printf("@[%s] ", datetime);
+        did_print = true;
+    }
+    if (session->with_level){
+        printf("[%s] ", header->info < LOG_LEVELS_QTY ? LogLevelsStr[header->info] : "   ??   ");
+        did_print = true;
+    }
+    if (did_print){
+        printf("--> ");
+    }
+    printf("%s\n", msg);
+}
+
+int main(int argc, char ** argv){
+    if (argc > 2){
+        fprintf(stderr, "Usage: %s [BINARY LOG]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Records are rendered as they are read: FORMAT records precede the messages that use them */
+    bool from_stdin = argc < 2 || strcmp(argv[1], "-") == 0;
+    FILE * file = from_stdin ? stdin : fopen(argv[1], "rb");
+    if (file == NULL){
+        fprintf(stderr, "Could not open %s: %s\n", argv[1], strerror(errno));
+        return EXIT_FAILURE;
+    }
+    char * msg = malloc(MAX_MSG_LEN);
+    if (msg == NULL){
+        fprintf(stderr, "Could not allocate memory\n");
+        if (! from_stdin){
+            fclose(file);
+        }
+        return EXIT_FAILURE;
+    }
+
+    Session session = { .with_datetime = true, .with_level = true };
+    uint8_t * payload = NULL;
+    size_t capacity = 0;
+    size_t offset = 0;
+    int status = EXIT_SUCCESS;
+    LogFmtHeader header;
+    int read;
+    while ((read = read_record(file, &header, &payload, &capacity)) > 0){
+        bool valid = true;
+        if (header.type == LOGFMT_REC_SESSION){
+            clear_session(&session);
+            valid = header.payload_len >= LOGFMT_MAGIC_LEN && memcmp(payload, LOGFMT_MAGIC, LOGFMT_MAGIC_LEN) == 0
+                    && header.id == LOGFMT_VERSION;
+            if (valid){
+                session.with_datetime   = header.info & LOGFMT_SESSION_DATETIME;
+                session.with_level      = header.info & LOGFMT_SESSION_LEVEL;
+                if (header.payload_len > LOGFMT_MAGIC_LEN){
+                    session.prefix = copy_str(payload + LOGFMT_MAGIC_LEN, header.payload_len - LOGFMT_MAGIC_LEN);
+                }
+            }
+        }
+        else if (header.type == LOGFMT_REC_FORMAT){
+            if (! add_format(&session, header.id, payload, header.payload_len)){
+                read = -2;
+                break;
+            }
+        }
+        else if (header.type == LOGFMT_REC_LOG){
+            print_record(&session, &header, payload, msg);
+        }
+        else{
+            valid = false;
+        }
+        if (! valid){
+            read = -1;
+            break;
+        }
+        offset += LOGFMT_HEADER_SIZE + header.payload_len;
+    }
+    if (read == -1){
+        fprintf(stderr, "Corrupt log at offset %zu\n", offset);
+        status = EXIT_FAILURE;
+    }
+    else if (read == -2){
+        fprintf(stderr, "Could not allocate memory\n");
+        status = EXIT_FAILURE;
+    }
+    if (! from_stdin){
+        fclose(file);
+    }
+
+    clear_session(&session);
+    free(payload);
+    free(msg);
+    return status;
+}
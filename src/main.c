@@ -8,6 +8,7 @@
  */
 
 #include <stdio.h>
+#include <inttypes.h>
 #include <signal.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -17,6 +18,8 @@
 
 #include "lib/exceptions.h"
 #include "lib/logger.h"
+#include "lib/slab.h"
+#include "lib/clock.h"
 
 #include "utils/selector.h"
 #include "utils/stats.h"
@@ -25,9 +28,19 @@
 #include "utils/stats.h"
 #include "utils/args.h"
 #include "utils/client_data.h"
-
-#define BACKLOG_SIZE            10
+#include "utils/spool.h"
+#include "utils/storage.h"
+#include "utils/vrfy_live.h"
+#include "utils/rcpt_table.h"
+#include "utils/bufpool.h"
+#include "utils/metrics.h"
+#include "utils/shm_stats.h"
+#include "utils/limits.h"
+
+#define BACKLOG_SIZE            10      // Initial listen backlog (see LIMIT_BACKLOG)
 #define MAX_BUFFER_SIZE         1049
+#define CLIENT_SLAB_OBJS        256     // Clients allocated at once
+#define SELECTOR_TICK           1       // Seconds between wake-ups while idle, to publish shared memory statistics
 
 /****************************************************************/
 /* Global variables                                             */
@@ -36,13 +49,31 @@
 Logger      logger      = NULL;     // Logger (see src/lib/logger.h)
 Selector    selector    = NULL;     // Selector (see src/utils/selector.h)
 Stats       stats       = NULL;     // Stats (see src/utils/stats.h)
+BufPool     bufpool     = NULL;     // I/O buffers of all clients (see src/utils/bufpool.h)
+Slab        client_slab = NULL;     // Client data and parsers (see src/lib/slab.h)
+Metrics     metrics     = NULL;     // Prometheus metrics scrapers, NULL if disabled (see src/utils/metrics.h)
+ShmStats    shm_stats   = NULL;     // Shared memory statistics, NULL if disabled (see src/utils/shm_stats.h)
+Limits      limits      = NULL;     // Operational limits, changed by the manager (see src/utils/limits.h)
 
 bool        transform_enabled = false;
 char        *transform_cmd    = NULL;
 char *      domain      = NULL;
 
 bool        vrfy_enabled = false;
-char        *vrfy_mails  = NULL;
+VrfyLive    vrfy_live    = NULL;    // Verified addresses, reloaded on changes (see src/utils/vrfy_live.h)
+RcptTable   rcpt_table   = NULL;    // Local recipients, NULL accepts any (see src/utils/rcpt_table.h)
+
+size_t      spool_buff_size = SPOOL_DEFAULT_BUFF_SIZE;          // Per-client spool buffer size (see src/utils/spool.h)
+size_t      spool_mem_threshold = SPOOL_DEFAULT_MEM_THRESHOLD;  // Maximum size of a memory-resident mail
+size_t      max_connections = 0;                                // Most concurrent SMTP connections (0: no limit)
+size_t      max_mail_size   = 0;                                // Largest mail accepted (0: no limit)
+size_t      max_recipients  = 0;                                // Most recipients of a mail (0: no limit)
+
+static int  sv_fd_4         = -1;                               // IPv4 server socket
+static int  sv_fd_6         = -1;                               // IPv6 server socket
+
+char *      inbox_roots     = INBOX_DEFAULT_ROOTS;              // Comma-separated inbox roots (see src/utils/dircache.h)
+bool        inbox_fanout    = false;                            // Spread mail files across hashed subdirectories
 
 /****************************************************************/
 /* Extern global variables                                      */
@@ -88,6 +119,13 @@ static void smtpd_abort(void);
  */
 void sigint_handler(int sigint);
 
+/**
+ * \brief       Captures `SIGHUP` signal to reload the verified addresses.
+ *
+ * \param[in] signum    Signal number (`SIGHUP`).
+ */
+void sighup_handler(int signum);
+
 /**
  * \brief       Free all data from a client (a structure `_ClientData_t`).
  *
@@ -95,6 +133,11 @@ void sigint_handler(int sigint);
  */
 void free_client_data(void * arg);
 
+/**
+ * \brief       Make a new value of a limit take effect (see Limits_commit).
+ */
+static void apply_limit(LimitKey key, uint64_t val);
+
 /****************************************************************/
 /* Main function                                                */
 /****************************************************************/
@@ -121,27 +164,21 @@ int main(int argc, char ** argv){
 
 static void smtpd_init(SMTPDArgs * const args){
     /* Variables */
-    int         sv_fd_4     = -1;       // IPv4 server socket
-    int         sv_fd_6     = -1;       // IPv6 server socket
     int         mngr_fd     = -1;       // UDP management port
+    int         metrics_fd  = -1;       // TCP metrics port (optional)
 
     /* Logger configuration */
     LoggerConfig logger_cfg = {
         .min_log_level      = args->min_log_level,  // Minimum log level
         .with_datetime      = true,                 // Include date and time in logs
         .with_level         = true,                 // Include log levels
-        .flush_immediately  = true,                 // Disable buffering for real-time log viewing (tail -f)
-        .log_prefix         = PRODUCT_NAME " v" PRODUCT_VERSION     // Product info as log prefix
+        .flush_immediately  = true,                 // Flush every batch for real-time log viewing (tail -f)
+        .log_prefix         = PRODUCT_NAME " v" PRODUCT_VERSION,    // Product info as log prefix
+        .async              = true,                 // Write logs from a background thread, off the event loop
+        .overflow           = LOGGER_OVERFLOW_DROP, // Never stall the event loop on a slow disk
+        .binary             = args->log_binary      // Binary records, rendered offline by logdecode
     };
 
-    /**
-     * Directories used to store tmp and persistent mails
-     * It is no necessary to check for error because it will
-     * error iif the directories are already created.
-     */
-    mkdir(TMP, FILE_PERMISSIONS);
-    mkdir(INBOX, FILE_PERMISSIONS);
-
     /* Initialization of global command-line arguments */
     domain = args->domain;
 
@@ -149,15 +186,34 @@ static void smtpd_init(SMTPDArgs * const args){
     transform_cmd = args->trsf_cmd;
 
     vrfy_enabled = args->vrfy_enabled;
-    vrfy_mails = args->vrfy_mails;
+
+    /* Initial limits: the manager can change them at runtime */
+    uint64_t initial_limits[LIMIT_QTY] = {
+        [LIMIT_MAX_CONNS]       = 0,
+        [LIMIT_BACKLOG]         = BACKLOG_SIZE,
+        [LIMIT_SPOOL_BUFF_SIZE] = args->spool_buff_size < SPOOL_MIN_BUFF_SIZE ? SPOOL_MIN_BUFF_SIZE : args->spool_buff_size,
+        [LIMIT_MEM_THRESHOLD]   = args->spool_mem_threshold,
+        [LIMIT_MEM_BUDGET]      = args->spool_mem_budget,
+        [LIMIT_MAX_MAIL_SIZE]   = 0,
+        [LIMIT_MAX_RCPTS]       = 0,
+        [LIMIT_LOG_LEVEL]       = args->min_log_level,
+    };
+
+    inbox_roots = args->inbox_roots;
+    inbox_fanout = args->inbox_fanout;
 
     /* Status */
     bool comp_regex = false;
+    bool storage_ok = false;
+    bool limits_ok  = false;
 
     TRY{
         /* Set SIGINT handler */
         signal(SIGINT, sigint_handler);
 
+        /* Set SIGHUP handler */
+        signal(SIGHUP, sighup_handler);
+
         /* Create Logger */
         THROW_IF(
             (logger =
@@ -199,12 +255,64 @@ static void smtpd_init(SMTPDArgs * const args){
         );                              // Expected return: true
         LOG_VERBOSE(MSG_INFO_MNG_SOCKET_CREATED, args->mngr_port);
 
+        /* Create metrics socket, only reachable from the local host */
+        if (args->metrics_port != 0){
+            THROW_IF_NOT(tcp_serve_local(args->metrics_port, BACKLOG_SIZE, &metrics_fd));
+            LOG_VERBOSE(MSG_INFO_METRICS_SOCKET_CREATED, args->metrics_port);
+        }
+
         /* Create Stats */
         THROW_IF((stats = Stats_init()) == NULL);
         LOG_VERBOSE(MSG_INFO_STATS_CREATED);
 
+        /* Set and apply the initial limits */
+        THROW_IF((limits = Limits_create()) == NULL);
+        for (LimitKey key = 0; key < LIMIT_QTY; key++){
+            THROW_IF_NOT(Limits_set(limits, key, initial_limits[key]));
+        }
+        Limits_commit(limits, apply_limit);
+        limits_ok = true;
+
+        /* Publish statistics into shared memory */
+        if (args->shm_stats != NULL){
+            THROW_IF((shm_stats = ShmStats_create(args->shm_stats, stats)) == NULL);
+            LOG_VERBOSE(MSG_INFO_SHM_STATS_CREATED, args->shm_stats);
+        }
+
+        /* Create the metrics scraper slots */
+        if (metrics_fd != -1){
+            THROW_IF((metrics = Metrics_create(stats)) == NULL);
+        }
+
+        /* Create the I/O buffer pool */
+        THROW_IF((bufpool = BufPool_create(args->hugepages, args->mirrored_buffers)) == NULL);
+        LOG_VERBOSE(MSG_INFO_BUFPOOL_CREATED, args->hugepages ? "requested" : "disabled",
+                    args->mirrored_buffers ? "mirrored" : "regular");
+
+        /* Create the client data allocator */
+        THROW_IF((client_slab = Slab_create(sizeof(_ClientData_t) + parserSize(), CLIENT_SLAB_OBJS)) == NULL);
+
+        /* Initialize mail storage backend */
+        THROW_IF_NOT(storage_ok = Storage_init(args->storage));
+        LOG_VERBOSE(MSG_INFO_STORAGE_INIT, args->storage);
+
+        /* Load verified addresses */
+        if (vrfy_enabled){
+            THROW_IF((vrfy_live = VrfyLive_open(args->vrfy_mails)) == NULL);
+            LOG_VERBOSE(MSG_INFO_VRFY_INDEX_LOADED, VrfyLive_count(vrfy_live), args->vrfy_mails);
+        }
+
+        /* Load local recipients */
+        if (args->rcpt_file != NULL){
+            THROW_IF((rcpt_table = RcptTable_load(args->rcpt_file)) == NULL);
+            LOG_VERBOSE(MSG_INFO_RCPT_TABLE_LOADED, RcptTable_count(rcpt_table), args->rcpt_file);
+        }
+
         /* Create Selector */
-        THROW_IF((selector = Selector_create(free_client_data)) == NULL);
+        THROW_IF((selector = Selector_create_timeout(
+            shm_stats != NULL ? SELECTOR_TICK : SELECTOR_NO_TIMEOUT,
+            free_client_data
+        )) == NULL);
         LOG_VERBOSE(MSG_INFO_SELECTOR_CREATED);
 
         /* Add both of the server sockets and the manager socket to the Selector */
@@ -241,6 +349,19 @@ static void smtpd_init(SMTPDArgs * const args){
             == SELECTOR_OK
         );
         LOG_DEBUG(MSG_DEBUG_SELECTOR_ADD, mngr_fd, SOCK_TYPE_MANAGER);
+        if (metrics_fd != -1){
+            THROW_IF_NOT(
+                Selector_add(
+                    selector,               // The Selector itself
+                    metrics_fd,             // File descriptor to add
+                    SELECTOR_READ,          // Mode
+                    SOCK_TYPE_METRICS_SERVER,   // File descriptor type
+                    NULL                    // No data needed (scrapers are looked up by fd)
+                )
+                == SELECTOR_OK
+            );
+            LOG_DEBUG(MSG_DEBUG_SELECTOR_ADD, metrics_fd, SOCK_TYPE_METRICS_SERVER);
+        }
     }
     CATCH{
         /* Could not create the logger */
@@ -269,11 +390,46 @@ static void smtpd_init(SMTPDArgs * const args){
             LOG_ERR(MSG_ERR_MNGR_SOCKET);
         }
 
+        /* Could not create metrics socket */
+        else if (args->metrics_port != 0 && metrics_fd == -1){
+            LOG_ERR(MSG_ERR_METRICS_SOCKET, args->metrics_port);
+        }
+
         /* Could not initialize Stats */
         else if (stats == NULL){
             LOG_ERR(MSG_ERR_STATS_CREATION);
         }
 
+        /* Initial limits out of range */
+        else if (limits != NULL && ! limits_ok){
+            LOG_ERR(MSG_ERR_LIMITS);
+        }
+
+        /* Could not create the shared memory segment */
+        else if (args->shm_stats != NULL && shm_stats == NULL){
+            LOG_ERR(MSG_ERR_SHM_STATS, args->shm_stats);
+        }
+
+        /* Could not create the metrics scraper slots, the I/O buffer pool or the client data allocator */
+        else if (bufpool == NULL || client_slab == NULL || (metrics_fd != -1 && metrics == NULL)){
+            LOG_ERR(MSG_ERR_NO_MEM);
+        }
+
+        /* Could not initialize mail storage backend */
+        else if (! storage_ok){
+            LOG_ERR(MSG_ERR_STORAGE_INIT, args->storage);
+        }
+
+        /* Could not load verified addresses */
+        else if (vrfy_enabled && vrfy_live == NULL){
+            LOG_ERR(MSG_ERR_VRFY_INDEX, args->vrfy_mails);
+        }
+
+        /* Could not load local recipients */
+        else if (args->rcpt_file != NULL && rcpt_table == NULL){
+            LOG_ERR(MSG_ERR_RCPT_TABLE, args->rcpt_file);
+        }
+
         /* Could not create Selector */
         else if (selector == NULL){
             LOG_ERR(MSG_ERR_SELECTOR_CREATION);
@@ -288,6 +444,7 @@ static void smtpd_init(SMTPDArgs * const args){
         safe_close(sv_fd_4);
         safe_close(sv_fd_6);
         safe_close(mngr_fd);
+        safe_close(metrics_fd);
         smtpd_abort();
     }
 
@@ -297,7 +454,7 @@ static void smtpd_init(SMTPDArgs * const args){
 static void smtpd_start(void){
     while (true){
         /* Perform a select (2) operation */
-        LOG_DEBUG(MSG_DEBUG_SELECTOR_SELECT);
+        LOG_DEBUG_LIMITED(MSG_RATE_LIMIT, MSG_DEBUG_SELECTOR_SELECT);
         SelectorErrors err = Selector_select(selector);     // Blocking
         if (err != SELECTOR_OK){
 
@@ -308,6 +465,9 @@ static void smtpd_start(void){
             return;
         }
 
+        /* Publish statistics into shared memory, every SHM_STATS_INTERVAL_MS at most */
+        ShmStats_tick(shm_stats);       // NULL-safe
+
         /* Iterate through all ready file descriptors */
         int     sock_fd;
         int     sock_type;
@@ -322,7 +482,7 @@ static void smtpd_start(void){
             }
 
             /* Call handler for that socket type */
-            LOG_DEBUG(MSG_DEBUG_SOCKET_READY, sock_fd, sock_type, "READ");
+            LOG_DEBUG_LIMITED(MSG_RATE_LIMIT, MSG_DEBUG_SOCKET_READY, sock_fd, sock_type, "READ");
             HandlerErrors ret = read_handlers[sock_type](sock_fd, sock_data);
 
             /* Abort on no memory */
@@ -341,7 +501,7 @@ static void smtpd_start(void){
             }
 
             /* Call handler for that socket type */
-            LOG_DEBUG(MSG_DEBUG_SOCKET_READY, sock_fd, sock_type, "WRITE");
+            LOG_DEBUG_LIMITED(MSG_RATE_LIMIT, MSG_DEBUG_SOCKET_READY, sock_fd, sock_type, "WRITE");
             HandlerErrors ret = write_handlers[sock_type](sock_fd, sock_data);
 
             /* Abort on no memory */
@@ -350,13 +510,24 @@ static void smtpd_start(void){
                 return;
             }
         }
+
+        /* Apply the limits changed by the manager, between iterations */
+        Limits_commit(limits, apply_limit);
     }
 }
 
 static void smtpd_cleanup(int exit_code){
     Selector_cleanup(selector);     // NULL-safe
+    BufPool_cleanup(bufpool);       // NULL-safe. After the Selector, which returns the client buffers
+    Slab_cleanup(client_slab);      // NULL-safe. After the Selector, which frees the client data
     Logger_cleanup(logger);         // NULL-safe
+    Metrics_cleanup(metrics);       // NULL-safe. After the Selector, which closes the scrapers
+    ShmStats_cleanup(shm_stats);    // NULL-safe. Removes the segment
     Stats_cleanup(stats);           // NUll-safe
+    Storage_cleanup();              // Safe if not initialized
+    VrfyLive_close(vrfy_live);      // NULL-safe
+    RcptTable_cleanup(rcpt_table);  // NULL-safe
+    Limits_cleanup(limits);         // NULL-safe
     exit(exit_code);
 }
 
@@ -371,29 +542,36 @@ void sigint_handler(int signum){
     smtpd_cleanup(EXIT_SUCCESS);    // No error occurred
 }
 
+void sighup_handler(int signum){
+    (void) signum;                  // Avoids unused parameter warning
+    VrfyLive_request_reload(vrfy_live);     // NULL-safe and async-signal-safe
+}
+
 void free_client_data(void * arg){
     ClientData data = (ClientData) arg;
     if (data == NULL){
         return;
     }
 
-    FREE_PTR(destroyParser, data->parser);
+    Stats_record(stats, HISTKEY_CONN_LIFETIME, Clock_ns() - data->accepted_ns);
+
+    finishParser(data->parser);     // Its memory belongs to the client data
 
     FREE_PTR(free, data->clientDomain);
     FREE_PTR(free, data->senderMail);
 
-    if(data->receiverMails != NULL){
-        for(int i =0; i < data->receiverMailsAmount ;i++){
-            FREE_PTR(free, data->receiverMails[i]);
-        }
+    for(int i =0; i < data->receiverMailsAmount ;i++){
+        FREE_PTR(free, data->receiverMails[i]);
+    }
+    if(data->receiverMails != data->inlineRcpts){
         free(data->receiverMails);
     }
 
-    if(!(data->closedMailFd < 1)) {
-        fclose(data->mailFile);
-    }
+    Storage_abort(data->msg);       // NULL-safe
 
-    free(data);
+    BufPool_put(bufpool, data->buffer.data, data->buffer.limit - data->buffer.data);   // NULL-safe
+
+    Slab_free(client_slab, data);
 }
 
 /*
@@ -420,3 +598,36 @@ switch(str->cmd){
 }
 writeClient(parser->status);
  */
+
+static void apply_limit(LimitKey key, uint64_t val){
+    switch (key){
+        case LIMIT_MAX_CONNS:
+            max_connections = (size_t) val;
+            break;
+        case LIMIT_BACKLOG:
+            listen(sv_fd_4, (int) val);     // Listening again only updates the backlog
+            listen(sv_fd_6, (int) val);
+            break;
+        case LIMIT_SPOOL_BUFF_SIZE:
+            spool_buff_size = (size_t) val;
+            break;
+        case LIMIT_MEM_THRESHOLD:
+            spool_mem_threshold = (size_t) val;
+            break;
+        case LIMIT_MEM_BUDGET:
+            spool_set_memory_budget((size_t) val);
+            break;
+        case LIMIT_MAX_MAIL_SIZE:
+            max_mail_size = (size_t) val;
+            break;
+        case LIMIT_MAX_RCPTS:
+            max_recipients = (size_t) val;
+            break;
+        case LIMIT_LOG_LEVEL:
+            Logger_set_level(logger, (LogLevels) val);
+            break;
+        default:
+            return;
+    }
+    LOG_MSG(MSG_LIMIT_CHANGED, Limits_name(key), val);
+}
@@ -67,8 +67,16 @@ static const char * team_members_ids[] ={
 bool parse_args(int argc, char **argv, UDPArgs *const result) {
     int c;
     int flag = 0;
-    while ((c = getopt(argc, argv, "hi:p:v")) != -1) {
+    static struct option long_options[] = {
+        { "shm", required_argument, NULL, 's' },
+        { 0, 0, 0, 0 }
+    };
+    memset(result, 0, sizeof(UDPArgs));
+    while ((c = getopt_long(argc, argv, "hi:p:v", long_options, NULL)) != -1) {
         switch (c) {
+            case 's':
+                result->shm_name = optarg;
+                break;
             case 'h':
                 usage(argv[0]);
                 break;
@@ -101,7 +109,7 @@ bool parse_args(int argc, char **argv, UDPArgs *const result) {
     }
 
     // Ensure mandatory options are set
-    if (!result->server_ip || result->port == 0 || flag != 2) {
+    if (result->shm_name == NULL && (!result->server_ip || result->port == 0 || flag != 2)) {
         fprintf(stderr, "Error: Missing required arguments.\n");
         usage(argv[0]);
     }
@@ -119,13 +127,15 @@ bool parse_args(int argc, char **argv, UDPArgs *const result) {
 void usage(const char *progname) {
     fprintf(stderr,
         "Usage: %s -i <IP ADDRESS> -p <PORT>\n"
+        "       %s --shm <NAME>\n"
         "\n"
         "   -i <IP ADDRESS>   Server IP address\n"
         "   -p <PORT>         Server port number\n"
+        "   --shm <NAME>      Print the statistics the server publishes into /dev/shm/<NAME> (smtpd -e) and exit.\n"
         "   -h                Print this help message and exit.\n"
         "   -v                Print version information and exit.\n"
         "\n",
-        progname);
+        progname, progname);
     exit(EXIT_FAILURE);
 }
 
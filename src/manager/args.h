@@ -48,6 +48,7 @@
 typedef struct {
     char *server_ip;
     int port;
+    char *shm_name;     // Read statistics from this shared memory segment instead (--shm)
 } UDPArgs;
 
 bool parse_args(int argc, char **argv, UDPArgs *const result);
@@ -5,9 +5,16 @@
 #include <arpa/inet.h>
 #include <inttypes.h>
 #include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdatomic.h>
 
 #include "manager.h"
 #include "args.h"
+#include "../utils/shm_stats.h"
+#include "../utils/limits.h"
 
 #define LITTLE_ENDIAN 1
 #define BIG_ENDIAN 2
@@ -20,8 +27,56 @@ struct Request {
     uint16_t identifier;    // Request identifier
     uint8_t auth[8];        // Authentication data
     MngrCommand command;    // Command
+    uint8_t argument;       // Command argument
 };
 
+// Histograms, in protocol order (as in HistKey, src/utils/stats.h). Latencies are in nanoseconds.
+static const struct { const char * name; bool latency; } histograms[] = {
+    {"HELO", true}, {"EHLO", true}, {"MAIL FROM", true}, {"RCPT TO", true}, {"DATA", true},
+    {"VRFY", true}, {"End of DATA to reply", true}, {"Transformation", true},
+    {"Delivery to an inbox", true}, {"Connection lifetime", true}, {"Mail size (bytes)", false},
+    {"Recipients per mail", false}
+};
+#define HISTOGRAM_QTY (sizeof(histograms) / sizeof(histograms[0]))
+
+// Names of the version 0x01 types, by class (see manager.h)
+static const char * const stat_names[] = {
+    #define XX(KEY, KIND, NAME, DESCRIPTION) NAME,
+    STATS_CATALOGUE(XX)
+    #undef XX
+};
+static const char * const hist_names[] = {
+    #define XX(KEY, UNIT, NAME, DESCRIPTION) NAME,
+    STATS_HISTOGRAMS(XX)
+    #undef XX
+};
+static const char * const hist_units[] = {
+    #define XX(KEY, UNIT, NAME, DESCRIPTION) UNIT,
+    STATS_HISTOGRAMS(XX)
+    #undef XX
+};
+static const char * const server_names[TLV_SERVER_QTY] = {
+    [TLV_SERVER_TRANSFORMACIONES] = "transformations_enabled",
+    [TLV_SERVER_BUFFERS_EN_USO] = "buffers_in_use",
+    [TLV_SERVER_BUFFERS_RESERVADOS] = "buffers_reserved",
+    [TLV_SERVER_HUGEPAGES] = "huge_pages",
+    [TLV_SERVER_VRFY_DIRECCIONES] = "verified_addresses",
+};
+static const char * const limit_names[] = {
+    #define XX(KEY, NAME, MIN, MAX, DESCRIPTION) NAME,
+    LIMITS_CATALOGUE(XX)
+    #undef XX
+};
+static const struct { const char * const * names; size_t qty; } tlv_classes[] = {
+    [TLV_CLASS_STAT] = { stat_names, sizeof(stat_names) / sizeof(stat_names[0]) },
+    [TLV_CLASS_HIST] = { hist_names, sizeof(hist_names) / sizeof(hist_names[0]) },
+    [TLV_CLASS_SERVER] = { server_names, TLV_SERVER_QTY },
+    [TLV_CLASS_LIMIT] = { limit_names, sizeof(limit_names) / sizeof(limit_names[0]) },
+};
+#define TLV_CLASS_QTY (sizeof(tlv_classes) / sizeof(tlv_classes[0]))
+#define CMD_TLV (CMD_LATENCIA_P999 + 1)    // Menu option for a version 0x01 query
+#define CMD_TLV_LIMITS (CMD_TLV + 1)        // Menu option to show or set limits
+
 // Structure for the response
 struct Response {
     uint8_t signature[2];   // Protocol signature
@@ -67,6 +122,12 @@ uint64_t switch_endian(uint64_t x){
 static void send_request(int sockfd, const struct sockaddr *addr, socklen_t addrlen, struct Request *req);
 static void receive_response(int sockfd, struct sockaddr *addr, socklen_t *addrlen, struct Response *res);
 static void print_menu();
+static int print_shm_stats(const char *name);
+static void query_tlv(int sockfd, const struct sockaddr *addr, socklen_t addrlen, char *names);
+static void set_limits(int sockfd, const struct sockaddr *addr, socklen_t addrlen, char *assignments);
+static void print_tlv_response(int sockfd);
+static bool find_tlv_type(const char *name, uint8_t *class, uint8_t *index);
+static uint64_t get_be64(const uint8_t *src);
 
 int main(int argc, char *argv[]) {
     UDPArgs args;
@@ -80,6 +141,10 @@ int main(int argc, char *argv[]) {
         exit(EXIT_FAILURE);
     }
 
+    if (args.shm_name != NULL) {
+        return print_shm_stats(args.shm_name);
+    }
+
     char *server_ip = args.server_ip;
     int port = args.port;
 
@@ -104,7 +169,8 @@ int main(int argc, char *argv[]) {
         0x00,
         htons(0x1234),
         { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 },
-        CMD_CONEX_HISTORICAS
+        CMD_CONEX_HISTORICAS,
+        0x00
     };
 
     struct Response res;
@@ -124,12 +190,46 @@ int main(int argc, char *argv[]) {
             continue;
         }
 
-        if (command < 0 || command > 5) {
-            printf("Invalid command. Please select a number from 0 to 1.\n");
+        if (command < 0 || command > CMD_TLV_LIMITS) {
+            printf("Invalid command. Please select a number from 0 to %d.\n", CMD_TLV_LIMITS);
+            continue;
+        }
+
+        if (command == CMD_TLV) {
+            printf("Values to query, separated by spaces (none for all): ");
+            if (fgets(input, sizeof(input), stdin) == NULL) {
+                printf("Error reading input.\n");
+                continue;
+            }
+            query_tlv(sockfd, (struct sockaddr *)&server_addr, sizeof(server_addr), input);
+            continue;
+        }
+
+        if (command == CMD_TLV_LIMITS) {
+            printf("Limits to set, as name=value separated by spaces (none to show them all): ");
+            if (fgets(input, sizeof(input), stdin) == NULL) {
+                printf("Error reading input.\n");
+                continue;
+            }
+            set_limits(sockfd, (struct sockaddr *)&server_addr, sizeof(server_addr), input);
             continue;
         }
 
         req.command = (MngrCommand)command;
+        req.argument = 0x00;
+        if (command >= CMD_LATENCIA_P50) {
+            printf("\nHistograms:\n");
+            for (size_t i = 0; i < HISTOGRAM_QTY; i++) {
+                printf("%zu. %s\n", i, histograms[i].name);
+            }
+            printf("Select a histogram (0-%zu): ", HISTOGRAM_QTY - 1);
+            unsigned histogram;
+            if (fgets(input, sizeof(input), stdin) == NULL || sscanf(input, "%u", &histogram) != 1 || histogram >= HISTOGRAM_QTY) {
+                printf("Invalid histogram.\n");
+                continue;
+            }
+            req.argument = (uint8_t)histogram;
+        }
 
         send_request(sockfd, (struct sockaddr *)&server_addr, sizeof(server_addr), &req);
 
@@ -143,6 +243,15 @@ int main(int argc, char *argv[]) {
         if (command == CMD_TRANSFORMACIONES_OFF || command == CMD_TRANSFORMACIONES_ON || command == CMD_ESTADO_TRANSFORMACIONES) {
             printf("Transformation status = %s\n", res.booleano ? "ON" : "OFF");
         }
+        if (command == CMD_BUFFERS_EN_USO || command == CMD_BUFFERS_RESERVADOS) {
+            printf("Huge pages = %s\n", res.booleano ? "YES" : "NO");
+        }
+        if (command >= CMD_LATENCIA_P50 && histograms[req.argument].latency) {
+            printf("Latency = %.3f ms%s\n", res.cantidad / 1e6, res.booleano ? "" : " (none recorded)");
+        }
+        else if (command >= CMD_LATENCIA_P50) {
+            printf("%s = %" PRIu64 "%s\n", histograms[req.argument].name, res.cantidad, res.booleano ? "" : " (none recorded)");
+        }
     }
 
     close(sockfd);
@@ -167,6 +276,7 @@ static void send_request(int sockfd, const struct sockaddr *addr, socklen_t addr
     
     memcpy(buffer + 5, req->auth, 8);
     buffer[13] = req->command;
+    buffer[14] = req->argument;
 
     // Send the request
     if (sendto(sockfd, buffer, sizeof(buffer), 0, addr, addrlen) != sizeof(buffer)) {
@@ -216,5 +326,242 @@ static void print_menu() {
     printf("3. Check transformation status\n");
     printf("4. Transformations ON\n");
     printf("5. Transformations OFF\n");
-    printf("Select a command (0-5): ");
+    printf("6. Reload verified addresses\n");
+    printf("7. Bytes of I/O buffers in use\n");
+    printf("8. Bytes reserved for I/O buffers\n");
+    printf("9. Most concurrent connections\n");
+    printf("10. Latency median\n");
+    printf("11. Latency 90th percentile\n");
+    printf("12. Latency 99th percentile\n");
+    printf("13. Latency 99.9th percentile\n");
+    printf("14. Several values in a single request\n");
+    printf("15. Show or set limits\n");
+    printf("Select a command (0-15): ");
+}
+
+// Query the values named in `names` (all of them if none) with a single version 0x01 request, and print them
+static void query_tlv(int sockfd, const struct sockaddr *addr, socklen_t addrlen, char *names) {
+    uint8_t buffer[TLV_MAX_REQUEST] = {
+        PROTOCOL_SIGNATURE_1, PROTOCOL_SIGNATURE_2, PROTOCOL_VERSION_TLV, 0x12, 0x34,
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, TLV_CMD_GET, 0x00
+    };
+    size_t qty = 0;
+    for (char *name = strtok(names, " \t\r\n"); name != NULL && qty < TLV_MAX_TYPES; name = strtok(NULL, " \t\r\n")) {
+        if (!find_tlv_type(name, &buffer[15 + 2 * qty], &buffer[16 + 2 * qty])) {
+            printf("Unknown value: %s\n", name);
+            return;
+        }
+        qty++;
+    }
+    buffer[14] = qty;
+
+    size_t len = 15 + 2 * qty;
+    if (sendto(sockfd, buffer, len, 0, addr, addrlen) != (ssize_t)len) {
+        perror("sendto failed");
+        exit(EXIT_FAILURE);
+    }
+    print_tlv_response(sockfd);
+}
+
+// Set the limits in `assignments` ("name=value ...") with a single version 0x01 request, or show them all if none
+static void set_limits(int sockfd, const struct sockaddr *addr, socklen_t addrlen, char *assignments) {
+    uint8_t buffer[TLV_MAX_REQUEST] = {
+        PROTOCOL_SIGNATURE_1, PROTOCOL_SIGNATURE_2, PROTOCOL_VERSION_TLV, 0x12, 0x34,
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, TLV_CMD_SET, 0x00
+    };
+    size_t qty = 0, len = 15;
+    for (char *assignment = strtok(assignments, " \t\r\n"); assignment != NULL && qty < TLV_MAX_TYPES; assignment = strtok(NULL, " \t\r\n")) {
+        char *value = strchr(assignment, '=');
+        char *end = NULL;
+        uint64_t val = 0;
+        if (value != NULL) {
+            *value++ = '\0';
+            val = strtoull(value, &end, 10);
+        }
+        if (value == NULL || *value == '\0' || *end != '\0') {
+            printf("Expected name=value: %s\n", assignment);
+            return;
+        }
+        if (!find_tlv_type(assignment, &buffer[len], &buffer[len + 1]) || buffer[len] != TLV_CLASS_LIMIT) {
+            printf("Unknown limit: %s\n", assignment);
+            return;
+        }
+        buffer[len + 2] = 8;
+        for (int i = 7; i >= 0; i--, val >>= 8) {
+            buffer[len + 3 + i] = val & 0xFF;
+        }
+        len += 11;
+        qty++;
+    }
+    buffer[14] = qty;
+
+    // No assignments: query every limit
+    if (qty == 0) {
+        buffer[13] = TLV_CMD_GET;
+        for (; qty < tlv_classes[TLV_CLASS_LIMIT].qty; qty++, len += 2) {
+            buffer[len] = TLV_CLASS_LIMIT;
+            buffer[len + 1] = qty;
+        }
+        buffer[14] = qty;
+    }
+
+    if (sendto(sockfd, buffer, len, 0, addr, addrlen) != (ssize_t)len) {
+        perror("sendto failed");
+        exit(EXIT_FAILURE);
+    }
+    print_tlv_response(sockfd);
+}
+
+// Receive a version 0x01 response, and print its entries
+static void print_tlv_response(int sockfd) {
+    uint8_t response[TLV_MAX_RESPONSE];
+    ssize_t n = recvfrom(sockfd, response, sizeof(response), 0, NULL, NULL);
+    if (n < 8 || response[2] != PROTOCOL_VERSION_TLV) {
+        fprintf(stderr, "Error: Response received with incorrect length or version.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint16_t count = (response[6] << 8) | response[7];
+    printf("\nReceived response: %zd bytes, %u values\n", n, count);
+    printf("Status: %u%s\n\n", response[5], response[5] == STATUS_TRUNCATED ? " (truncated)" :
+           response[5] == STATUS_INVALID_VALUE ? " (invalid values, nothing changed)" : "");
+    for (ssize_t pos = 8; count > 0 && pos + 3 <= n; count--) {
+        uint8_t class = response[pos], index = response[pos + 1], length = response[pos + 2];
+        const uint8_t *value = response + pos + 3;
+        pos += 3 + length;
+        if (pos > n) {
+            fprintf(stderr, "Error: Truncated entry.\n");
+            break;
+        }
+        const char *name = class < TLV_CLASS_QTY && index < tlv_classes[class].qty ? tlv_classes[class].names[index] : "?";
+        if (length == 0) {
+            printf("%-*s %20s\n", SHM_STATS_NAME_SIZE, name, "(unavailable)");
+        }
+        else if (class == TLV_CLASS_HIST && length >= 56) {
+            printf("%-*s count %" PRIu64 ", sum %" PRIu64 ", p50 %" PRIu64 ", p90 %" PRIu64 ", p99 %" PRIu64
+                   ", p99.9 %" PRIu64 ", max %" PRIu64 " %s\n", SHM_STATS_NAME_SIZE, name,
+                   get_be64(value), get_be64(value + 8), get_be64(value + 16), get_be64(value + 24),
+                   get_be64(value + 32), get_be64(value + 40), get_be64(value + 48), index < tlv_classes[class].qty ? hist_units[index] : "");
+        }
+        else if (class == TLV_CLASS_LIMIT && length >= 8) {
+            printf("%-*s %20" PRIu64 "\n", SHM_STATS_NAME_SIZE, name, get_be64(value));
+        }
+        else if (length >= 8) {
+            printf("%-*s %20" PRId64, SHM_STATS_NAME_SIZE, name, (int64_t)get_be64(value));
+            if (class == TLV_CLASS_STAT && length >= 16) {
+                printf("  (max %" PRId64 ")", (int64_t)get_be64(value + 8));
+            }
+            printf("\n");
+        }
+        else {
+            printf("%-*s %20s\n", SHM_STATS_NAME_SIZE, name, value[0] ? "YES" : "NO");
+        }
+    }
+}
+
+// Find the version 0x01 type of a value by its name
+static bool find_tlv_type(const char *name, uint8_t *class, uint8_t *index) {
+    for (size_t c = 0; c < TLV_CLASS_QTY; c++) {
+        for (size_t i = 0; i < tlv_classes[c].qty; i++) {
+            if (strcmp(name, tlv_classes[c].names[i]) == 0) {
+                *class = c;
+                *index = i;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Read a 64-bit integer in network byte order
+static uint64_t get_be64(const uint8_t *src) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | src[i];
+    }
+    return value;
+}
+
+// Print a consistent snapshot of the statistics published into shared memory (see src/utils/shm_stats.h)
+static int print_shm_stats(const char *name) {
+    char path[BUF_SIZE];
+    snprintf(path, sizeof(path), "/%s", name);
+    int fd = shm_open(path, O_RDONLY, 0);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    void *mem = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        perror("mmap failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Validate the header, and that every entry lies within the segment
+    ShmStatsHeader *header = mem;
+    if ((size_t)st.st_size < sizeof(ShmStatsHeader) || memcmp(header->magic, SHM_STATS_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SHM_STATS_VERSION || header->stat_size < sizeof(ShmStat) || header->hist_size < sizeof(ShmHist) ||
+        (uint64_t)header->stat_offset + (uint64_t)header->stat_qty * header->stat_size > (uint64_t)st.st_size ||
+        (uint64_t)header->hist_offset + (uint64_t)header->hist_qty * header->hist_size > (uint64_t)st.st_size) {
+        fprintf(stderr, "%s is not a statistics segment this manager understands.\n", path);
+        exit(EXIT_FAILURE);
+    }
+    uint32_t stat_qty = header->stat_qty, hist_qty = header->hist_qty;
+    int64_t (*stats)[2] = malloc(stat_qty * sizeof(*stats) + 1);
+    uint64_t (*hists)[7] = malloc(hist_qty * sizeof(*hists) + 1);
+    if (stats == NULL || hists == NULL) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Copy the values under the seqlock, retrying while the server publishes
+    uint64_t seq, published;
+    do {
+        while ((seq = atomic_load_explicit(&header->seq, memory_order_acquire)) & 1) {
+            sched_yield();
+        }
+        for (uint32_t i = 0; i < stat_qty; i++) {
+            ShmStat *entry = (ShmStat *)((char *)mem + header->stat_offset + (size_t)i * header->stat_size);
+            stats[i][0] = atomic_load_explicit(&entry->value, memory_order_relaxed);
+            stats[i][1] = atomic_load_explicit(&entry->max, memory_order_relaxed);
+        }
+        for (uint32_t i = 0; i < hist_qty; i++) {
+            ShmHist *entry = (ShmHist *)((char *)mem + header->hist_offset + (size_t)i * header->hist_size);
+            hists[i][0] = atomic_load_explicit(&entry->count, memory_order_relaxed);
+            hists[i][1] = atomic_load_explicit(&entry->sum, memory_order_relaxed);
+            hists[i][2] = atomic_load_explicit(&entry->p50, memory_order_relaxed);
+            hists[i][3] = atomic_load_explicit(&entry->p90, memory_order_relaxed);
+            hists[i][4] = atomic_load_explicit(&entry->p99, memory_order_relaxed);
+            hists[i][5] = atomic_load_explicit(&entry->p999, memory_order_relaxed);
+            hists[i][6] = atomic_load_explicit(&entry->max, memory_order_relaxed);
+        }
+        published = atomic_load_explicit(&header->published, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+    } while (atomic_load_explicit(&header->seq, memory_order_relaxed) != seq);
+
+    printf("Server PID %" PRIu64 ", published %" PRIu64 ".%03" PRIu64 " (seconds since the epoch)\n\n",
+           header->pid, published / 1000000000, published / 1000000 % 1000);
+    for (uint32_t i = 0; i < stat_qty; i++) {
+        ShmStat *entry = (ShmStat *)((char *)mem + header->stat_offset + (size_t)i * header->stat_size);
+        printf("%-*.*s %20" PRId64, SHM_STATS_NAME_SIZE, SHM_STATS_NAME_SIZE, entry->name, stats[i][0]);
+        if (entry->gauge) {
+            printf("  (max %" PRId64 ")", stats[i][1]);
+        }
+        printf("\n");
+    }
+    printf("\n%-*s %10s %14s %12s %12s %12s %12s %12s %6s\n", SHM_STATS_NAME_SIZE, "distribution", "count", "sum",
+           "p50", "p90", "p99", "p99.9", "max", "unit");
+    for (uint32_t i = 0; i < hist_qty; i++) {
+        ShmHist *entry = (ShmHist *)((char *)mem + header->hist_offset + (size_t)i * header->hist_size);
+        printf("%-*.*s %10" PRIu64 " %14" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %6.*s\n",
+               SHM_STATS_NAME_SIZE, SHM_STATS_NAME_SIZE, entry->name, hists[i][0], hists[i][1], hists[i][2], hists[i][3],
+               hists[i][4], hists[i][5], hists[i][6], SHM_STATS_UNIT_SIZE, entry->unit);
+    }
+
+    free(stats);
+    free(hists);
+    munmap(mem, st.st_size);
+    return EXIT_SUCCESS;
 }
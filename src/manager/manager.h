@@ -1,18 +1,25 @@
 #ifndef __MANAGER_H__
 #define __MANAGER_H__
 
+#include <stdint.h>     // uint16_t
+
 // Protocol definitions
 #define PROTOCOL_SIGNATURE_1 0xFF  // First byte of protocol signature
 #define PROTOCOL_SIGNATURE_2 0xFE  // Second byte of protocol signature
 #define PROTOCOL_VERSION 0x00       // Protocol version
+#define PROTOCOL_VERSION_TLV 0x01   // Protocol version with batched queries (see below)
 /*
 
 Request
-                +----+------------+--------------+------------+-----------------+-----------------+
-Field           |SIG1| SIG2       | VERSION      | IDENTIFIER | AUTHENTICATION  | COMMAND         |
-                +----+------------+--------------+------------+-----------------+-----------------+
-Size (bytes)    | 1  | 1          | 1            | 2          | 8               | 1               |
-                +----+------------+--------------+------------+-----------------+-----------------+
+                +----+------------+--------------+------------+-----------------+-----------------+-----------+
+Field           |SIG1| SIG2       | VERSION      | IDENTIFIER | AUTHENTICATION  | COMMAND         | ARGUMENT  |
+                +----+------------+--------------+------------+-----------------+-----------------+-----------+
+Size (bytes)    | 1  | 1          | 1            | 2          | 8               | 1               | 1         |
+                +----+------------+--------------+------------+-----------------+-----------------+-----------+
+
+ARGUMENT is only used by the CMD_LATENCIA_* commands, where it selects the histogram (as in
+HistKey, src/utils/stats.h). Their response holds the percentile in QUANTITY, in the unit of the
+histogram (nanoseconds for latencies), and whether any value was recorded in BOOLEAN.
 
 Response
                 +----+------------+----------+--------------+-----------+------------+-------------
@@ -21,9 +28,90 @@ Field           |SIG1| SIG2       | VERSION  | IDENTIFIER   | STATUS    | QUANTI
 Size (bytes)    | 1  | 1          | 1        | 2            | 1         | 8          | 1          |
                 +----+------------+----------+--------------+-----------+------------+-------------
 
+Version 0x01 (TLV)
+
+A single request queries any amount of values, and the response carries them all in a single
+datagram, as type-length-value entries. Servers keep answering version 0x00 requests as above.
+Every multi-byte field of version 0x01 is in network byte order.
+
+Request
+                +----+------------+--------------+------------+-----------------+-----------+--------+-------------+
+Field           |SIG1| SIG2       | VERSION      | IDENTIFIER | AUTHENTICATION  | COMMAND   | COUNT  | TYPES       |
+                +----+------------+--------------+------------+-----------------+-----------+--------+-------------+
+Size (bytes)    | 1  | 1          | 1            | 2          | 8               | 1         | 1      | 2 * COUNT   |
+                +----+------------+--------------+------------+-----------------+-----------+--------+-------------+
+
+COMMAND is a MngrTlvCommand. For TLV_CMD_GET, TYPES lists the values wanted, in the order they are
+to be answered; a COUNT of 0 asks for every value the server has. For TLV_CMD_SET, TYPES is instead
+made of COUNT entries (as in the response below) with the new values of some limits, as unsigned
+integers of up to 8 bytes.
+
+Response
+                +----+------------+----------+--------------+-----------+------------+-------------
+Field           |SIG1| SIG2       | VERSION  | IDENTIFIER   | STATUS    | COUNT      | ENTRIES    |
+                +----+------------+----------+--------------+-----------+------------+-------------
+Size (bytes)    | 1  | 1          | 1        | 2            | 1         | 2          | (variable) |
+                +----+------------+----------+--------------+-----------+------------+-------------
+
+IDENTIFIER is the one of the request. ENTRIES holds COUNT entries, back to back:
+
+                +------------+----------+------------+
+Field           | TYPE       | LENGTH   | VALUE      |
+                +------------+----------+------------+
+Size (bytes)    | 2          | 1        | LENGTH     |
+                +------------+----------+------------+
+
+The high byte of TYPE is a MngrTlvClass, and the low byte an index within it:
+
+    TLV_CLASS_STAT      Statistic, as in StatKey (src/utils/stats.h). VALUE is a signed 64-bit
+                        integer; gauges are followed by their high-water mark (LENGTH 16).
+    TLV_CLASS_HIST      Histogram, as in HistKey. VALUE is the amount of values recorded, their
+                        sum, their 50th, 90th, 99th and 99.9th percentiles and their maximum, as
+                        unsigned 64-bit integers (LENGTH 56), in the unit of the histogram.
+    TLV_CLASS_SERVER    Server state, as in MngrTlvServer.
+    TLV_CLASS_LIMIT     Operational limit, as in LimitKey (src/utils/limits.h). VALUE is an
+                        unsigned 64-bit integer.
+
+The response to TLV_CMD_SET holds the value of every limit set. New values take effect before the
+server handles any further request, connection or mail. If any entry is not a limit, or its value
+is out of range, no limit is changed: those entries are answered with LENGTH 0, and STATUS is
+STATUS_INVALID_VALUE.
+
+Types the server does not know are answered with LENGTH 0, so that clients can ask newer servers
+and older ones alike. Entries that do not fit in TLV_MAX_RESPONSE bytes are left out, and STATUS
+is then STATUS_TRUNCATED.
 
 */
 
+#define TLV_MAX_TYPES 255           // Most types in a single request
+#define TLV_MAX_REQUEST (15 + 11 * TLV_MAX_TYPES)
+#define TLV_MAX_RESPONSE 1472       // Largest UDP payload in a 1500-byte Ethernet frame
+#define TLV_TYPE(CLASS, INDEX) ((uint16_t) (((CLASS) << 8) | (INDEX)))
+
+// Possible version 0x01 commands
+typedef enum {
+    TLV_CMD_GET = 0x00,                     // Query a list of values, or all of them
+    TLV_CMD_SET = 0x01,                     // Change some limits
+} MngrTlvCommand;
+
+// Classes of version 0x01 types (high byte of TYPE)
+typedef enum {
+    TLV_CLASS_STAT = 0x00,                  // Statistics (StatKey)
+    TLV_CLASS_HIST = 0x01,                  // Histograms (HistKey)
+    TLV_CLASS_SERVER = 0x02,                // Server state (MngrTlvServer)
+    TLV_CLASS_LIMIT = 0x03,                 // Operational limits (LimitKey)
+} MngrTlvClass;
+
+// Server state (low byte of TLV_CLASS_SERVER types)
+typedef enum {
+    TLV_SERVER_TRANSFORMACIONES = 0x00,     // Transformations enabled (1 byte, boolean)
+    TLV_SERVER_BUFFERS_EN_USO = 0x01,       // Bytes of I/O buffers lent to connections (8 bytes)
+    TLV_SERVER_BUFFERS_RESERVADOS = 0x02,   // Bytes reserved by the I/O buffer pool (8 bytes)
+    TLV_SERVER_HUGEPAGES = 0x03,            // I/O buffers backed by huge pages (1 byte, boolean)
+    TLV_SERVER_VRFY_DIRECCIONES = 0x04,     // Verified addresses loaded (8 bytes, none if VRFY is disabled)
+    TLV_SERVER_QTY
+} MngrTlvServer;
+
 // Possible commands
 typedef enum {
     CMD_CONEX_HISTORICAS = 0x00,         // Historical connections count command
@@ -32,6 +120,14 @@ typedef enum {
     CMD_ESTADO_TRANSFORMACIONES = 0x03,  // Check transformations status command
     CMD_TRANSFORMACIONES_ON = 0x04,      // Enable transformations command
     CMD_TRANSFORMACIONES_OFF = 0x05,     // Disable transformations command
+    CMD_VRFY_RELOAD = 0x06,              // Reload verified addresses command
+    CMD_BUFFERS_EN_USO = 0x07,           // Bytes of I/O buffers lent to connections command
+    CMD_BUFFERS_RESERVADOS = 0x08,       // Bytes reserved by the I/O buffer pool command
+    CMD_CONEX_MAXIMAS = 0x09,            // Most concurrent connections since the server started command
+    CMD_LATENCIA_P50 = 0x0A,             // Median of a latency histogram command
+    CMD_LATENCIA_P90 = 0x0B,             // 90th percentile of a latency histogram command
+    CMD_LATENCIA_P99 = 0x0C,             // 99th percentile of a latency histogram command
+    CMD_LATENCIA_P999 = 0x0D,            // 99.9th percentile of a latency histogram command
 } MngrCommand;
 
 // Possible responses
@@ -41,7 +137,9 @@ enum MngrStatus {
     STATUS_INVALID_VERSION = 0x02,          // Invalid version status
     STATUS_INVALID_COMMAND = 0x03,          // Invalid command status
     STATUS_INVALID_REQUEST_LENGTH = 0x04,   // Invalid request length status
-    STATUS_UNEXPECTED_ERROR = 0x05          // Unexpected error status
+    STATUS_UNEXPECTED_ERROR = 0x05,         // Unexpected error status
+    STATUS_TRUNCATED = 0x06,                // Some entries did not fit in the response (version 0x01)
+    STATUS_INVALID_VALUE = 0x07             // Some limits could not be set, so none was (version 0x01)
 };
 
 #endif // __MANAGER_H__
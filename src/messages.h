@@ -8,6 +8,9 @@
 #ifndef __MESSAGES_H__
 #define __MESSAGES_H__
 
+/* Maximum log lines per second from each call site that clients can trigger at will (see LOG_LIMITED()) */
+#define MSG_RATE_LIMIT              100
+
 /********************************************************/
 /* Pre-Logger error messages                            */
 /********************************************************/
@@ -28,7 +31,13 @@
 #define MSG_ERR_REGEX_COMPILATION   "Could not compile SMTP parser regexes."
 #define MSG_ERR_SV_SOCKET           "Could not create server socket."
 #define MSG_ERR_MNGR_SOCKET         "Could not create management socket."
+#define MSG_ERR_METRICS_SOCKET      "Could not create metrics socket on TCP port %d."
 #define MSG_ERR_STATS_CREATION      "Could not initialize statistics."
+#define MSG_ERR_LIMITS              "Initial limits out of range (see -b, -r and -R)."
+#define MSG_ERR_SHM_STATS           "Could not publish statistics into shared memory segment /dev/shm/%s."
+#define MSG_ERR_STORAGE_INIT        "Could not initialize storage backend %s."
+#define MSG_ERR_VRFY_INDEX          "Could not load verified addresses from %s."
+#define MSG_ERR_RCPT_TABLE          "Could not load local recipients from %s."
 #define MSG_ERR_SELECTOR_CREATION   "Could not create Selector."
 #define MSG_ERR_NO_MEM              "Could not allocate memory."
 #define MSG_ERR_SELECT              "select (2) error."
@@ -40,6 +49,8 @@
 
 #define MSG_SERVER_STARTED          "Server started."
 #define MSG_NEW_CLIENT              "New client connected at %s : %d."
+#define MSG_LIMIT_CHANGED           "Limit %s set to %" PRIu64 "."
+#define MSG_TOO_MANY_CONNECTIONS    "Refused a connection: max_connections (%zu) reached."
 
 /********************************************************/
 /* Verbose log messages                                 */
@@ -49,7 +60,13 @@
 #define MSG_INFO_REGEX_COMPILED     "Compiled SMTP parser regexes."
 #define MSG_INFO_SV_SOCKET_CREATED  "Listening for SMTP connections on TCP port %d."
 #define MSG_INFO_MNG_SOCKET_CREATED "Listening for management connections on UDP port %d."
+#define MSG_INFO_METRICS_SOCKET_CREATED "Serving Prometheus metrics on http://127.0.0.1:%d/metrics."
 #define MSG_INFO_STATS_CREATED      "Statistics initialized."
+#define MSG_INFO_SHM_STATS_CREATED  "Publishing statistics into shared memory segment /dev/shm/%s."
+#define MSG_INFO_BUFPOOL_CREATED    "I/O buffer pool created (huge pages %s, %s buffers)."
+#define MSG_INFO_STORAGE_INIT       "Storage backend %s initialized."
+#define MSG_INFO_VRFY_INDEX_LOADED  "Loaded %zu verified addresses from %s."
+#define MSG_INFO_RCPT_TABLE_LOADED  "Loaded %zu local recipients from %s."
 #define MSG_INFO_SELECTOR_CREATED   "Selector started."
 #define MSG_INFO_BAD_MNGR_COMMAND   "Manager sent an invalid command."
 #define MSG_INFO_MNGR_COMMAND       "Manager sent command %s (%02X)"
@@ -13,27 +13,31 @@
 #include "utils/client_data.h"
 #include "domain.h"
 #include "utils/sockets.h"
-#include "utils/transform.h"
+#include "utils/storage.h"
+#include "utils/vrfy_live.h"
+#include "utils/metrics.h"
+#include "utils/limits.h"
+#include "lib/slab.h"
+#include "lib/clock.h"
 
 #define CLOSED 0
-#define MANAGER_READ_BUFF_SIZE 15
+#define MANAGER_READ_BUFF_SIZE TLV_MAX_REQUEST
 #define REL_TMP "../tmp"
 #define REL_INBOX "../inbox"
-#define RW_FOPEN "a+"
 
 #define SERVER_ERROR "421-%s Server error.\r\n"
-#define LITERAL_STR "%s"
-#define DEFAULT_TMP_MAIL "%s/From:%s %d-%02d-%02d %02d:%02d:%02d"
-#define DEFAULT_MAIL_NAME "From:%s %d-%02d-%02d %02d:%02d:%02d"
+#define TOO_MANY_CONNECTIONS "421 %s Too many connections, try again later.\r\n"
+#define TOO_MANY_RCPTS "452 Too many recipients.\r\n"
+#define MAIL_TOO_LARGE "552 Mail exceeds the maximum size.\r\n"
+#define LOCAL_ERROR "451 Requested action aborted: local error in processing.\r\n"
 
 #define DOT_CLRF ".\r\n"
 
-#define MAX_DIR_SIZE 512 // Out file system has a 2-level directory to save the mails
 /***********************************************************************************************/
 /* Global variables                                                                            */
 /***********************************************************************************************/
 
-static MngrCommand              current_manager_cmd;
+static MngrRequest              current_manager_req;
 static struct sockaddr_storage  manager_addr;
 static socklen_t                manager_addr_len;
 
@@ -44,13 +48,24 @@ static socklen_t                manager_addr_len;
 extern Logger       logger;
 extern Selector     selector;
 extern Stats        stats;
+extern BufPool      bufpool;
+extern Slab         client_slab;
 
 extern bool         transform_enabled;
 extern char *       domain;
 extern char        *transform_cmd;
 
 extern bool        vrfy_enabled;
-extern char        *vrfy_mails;
+extern VrfyLive    vrfy_live;
+
+extern Metrics     metrics;
+extern Limits      limits;
+
+extern size_t      max_connections;
+extern size_t      max_mail_size;
+extern size_t      max_recipients;
+
+extern void         free_client_data(void * arg);   // See main.c
 
 /***********************************************************************************************/
 /* Read / Write handler pointer arrays                                                         */
@@ -87,6 +102,115 @@ char *strdup(const char *s);
 
 #define RESPONSE_SIZE 15
 
+/**
+ * \brief       Create the data of a new client, with its parser, in a single allocation
+ *              from the client Slab.
+ *
+ * \return      The client data, or NULL on memory allocation error.
+ */
+static ClientData create_client_data(void);
+
+/**
+ * \brief       Add a recipient to the current mail of a client, moving the recipients to
+ *              the heap once they do not fit within the client data.
+ *
+ * \return      false on memory allocation error, true otherwise.
+ */
+static bool add_receiver(ClientData clientData, char * receiver);
+
+/**
+ * \brief       Make room in the client's buffer: draw a buffer from the BufPool if the client
+ *              holds none, or move the buffered data to a buffer of the next size class if it
+ *              is full. Buffers of a mirrored BufPool are used as rings, never compacted.
+ *
+ * \return      false if the buffer could not be drawn or grown, true otherwise.
+ */
+static bool client_buffer_reserve(ClientData clientData);
+
+/**
+ * \brief       Initialize the client's buffer over a buffer drawn from the BufPool.
+ */
+static void client_buffer_init(buffer * b, size_t size, uint8_t * data);
+
+/**
+ * \brief       Return the client's buffer to the BufPool if it is drained, so that idle
+ *              connections hold no buffer.
+ */
+static void client_buffer_release(ClientData clientData);
+
+/**
+ * \brief       Extract the next complete line from the client's buffer into `line` (null
+ *              terminated, at least BUFF_SIZE + 1 bytes long). Lines longer than BUFF_SIZE
+ *              are split. If the buffer is full and holds no line break, its whole content is
+ *              taken as a line so that the client cannot stall the connection.
+ *
+ * \return      true if a line was extracted, false if no complete line is buffered.
+ */
+static bool next_client_line(ClientData clientData, char * line);
+
+/**
+ * \brief       Parse and execute a single line sent by a client.
+ *
+ * \return      true if a reply was queued (the socket now waits to be writable), false if
+ *              the line needs no reply (mail contents during DATA).
+ */
+static bool process_client_line(int fd, ClientData clientData, char * line);
+
+/**
+ * \brief       Process every complete line buffered for a client, stopping at the first one
+ *              that needs a reply. This way, all mail contents received in a single recv (2)
+ *              reach the spool at once, and pipelined commands are not left waiting in the
+ *              buffer.
+ *
+ * \return      true if a reply was queued, false if more input is needed.
+ */
+static bool process_client_lines(int fd, ClientData clientData);
+
+/**
+ * \brief       Forget the recipients of a mail that could not be stored or was refused, and
+ *              reply with `reply` (a format, which may include the client's domain).
+ */
+static void abort_mail(ClientData clientData, const char * reply);
+
+/**
+ * \brief       Record the time from the arrival of a command to its reply being queued, or
+ *              from the end of the mail contents to its reply.
+ */
+static void record_service_time(ClientData clientData, CommandStructure * structure);
+
+/**
+ * \brief       Count the reply queued for a client, by status class and by command.
+ */
+static void count_reply(ClientData clientData);
+
+/**
+ * \brief       Remove a metrics scraper from the Selector, release its slot and close it.
+ */
+static void close_scraper(int fd);
+
+/**
+ * \brief       Whether a newly accepted connection is within max_connections. If not, it is
+ *              told so and closed.
+ */
+static bool connection_allowed(int sock);
+
+/**
+ * \brief       Answer a version 0x01 (TLV) manager request (see src/manager/manager.h).
+ */
+static HandlerErrors handle_manager_write_tlv(int fd);
+
+/**
+ * \brief       Encode the value of a version 0x01 type into `value`.
+ *
+ * \return      The length of the value, 0 if the type is unknown.
+ */
+static uint8_t tlv_value(uint16_t type, uint8_t * value);
+
+/**
+ * \brief       Store a 64-bit integer in network byte order.
+ */
+static void put_be64(uint8_t * dst, uint64_t value);
+
 // static const char * get_cmd_string(MngrCommand cmd);
 
 /***********************************************************************************************/
@@ -110,23 +234,16 @@ HandlerErrors handle_server4 (int fd, void * _){
         } while (errno == EINTR);
 
         /* If there was a connection to be accepted */
+        if (sock != -1 && !connection_allowed(sock)){
+            continue;
+        }
         if (sock != -1){
             /* Create client data */
-            ClientData data = malloc(sizeof(_ClientData_t));
-            for(int i = 0; i < BUFF_SIZE; i++) {
-                data->r_buff[i] = '\0';
+            ClientData data = create_client_data();
+            if (data == NULL){
+                close(sock);
+                return HANDLER_NO_MEM;
             }
-            buffer_init(&data->buffer, BUFF_SIZE, data->r_buff);
-            data->parser = initParser(domain);
-            data->receiverMails = (char **) malloc(sizeof(char *));
-            data->receiverMailsAmount = 0;
-            data->clientDomain = NULL;
-            data->senderMail = NULL;
-            data->mailFile = NULL;
-            data->mailPath = NULL;
-            data->closedMailFd = SUCCESS;
-            data->parser->vrfyAllowed = vrfy_enabled;
-            data->parser->transformAllowed = transform_enabled;
 
             /* Add the accepted connection's fd to the Selector */
             SelectorErrors ret = Selector_add(
@@ -138,17 +255,16 @@ HandlerErrors handle_server4 (int fd, void * _){
             );
             if (ret == SELECTOR_NO_MEMORY){
                 close(sock);
-                FREE_PTR(free, data->receiverMails);
-                FREE_PTR(free, data);
+                free_client_data(data);
                 return HANDLER_NO_MEM;
             }
-            LOG_DEBUG(MSG_DEBUG_SELECTOR_ADD, sock, SOCK_TYPE_CLIENT);
+            LOG_DEBUG_LIMITED(MSG_RATE_LIMIT, MSG_DEBUG_SELECTOR_ADD, sock, SOCK_TYPE_CLIENT);
 
             /* Create log */
             char ip [INET_ADDRSTRLEN];
             inet_ntop(AF_INET, &(addr.sin_addr), ip, INET_ADDRSTRLEN);
             uint16_t port = ntohs(addr.sin_port);
-            LOG_MSG(MSG_NEW_CLIENT, ip, port);
+            LOG_MSG_LIMITED(MSG_RATE_LIMIT, MSG_NEW_CLIENT, ip, port);
 
             /* Increment statistics */
             Stats_increment(stats, STATKEY_CONNS);
@@ -181,23 +297,16 @@ HandlerErrors handle_server6 (int fd, void * _){
         } while (errno == EINTR);
 
         /* If there was a connection to be accepted */
+        if (sock != -1 && !connection_allowed(sock)){
+            continue;
+        }
         if (sock != -1){
             /* Create client data */
-            ClientData data = malloc(sizeof(_ClientData_t));
-            for(int i = 0; i < BUFF_SIZE; i++) {
-                data->r_buff[i] = '\0';
+            ClientData data = create_client_data();
+            if (data == NULL){
+                close(sock);
+                return HANDLER_NO_MEM;
             }
-            buffer_init(&data->buffer, BUFF_SIZE, data->r_buff);
-            data->parser = initParser(domain);
-            data->receiverMails = (char **) malloc(sizeof(char *));
-            data->receiverMailsAmount = 0;
-            data->clientDomain = NULL;
-            data->senderMail = NULL;
-            data->mailFile = NULL;
-            data->mailPath = NULL;
-            data->closedMailFd = SUCCESS;
-            data->parser->vrfyAllowed = vrfy_enabled;
-            data->parser->transformAllowed = transform_enabled;
 
             /* Add the accepted connection's fd to the Selector */
             SelectorErrors ret = Selector_add(
@@ -209,17 +318,16 @@ HandlerErrors handle_server6 (int fd, void * _){
             );
             if (ret == SELECTOR_NO_MEMORY){
                 close(sock);
-                FREE_PTR(free, data->receiverMails);
-                FREE_PTR(free, data);
+                free_client_data(data);
                 return HANDLER_NO_MEM;
             }
-            LOG_DEBUG(MSG_DEBUG_SELECTOR_ADD, sock, SOCK_TYPE_CLIENT);
+            LOG_DEBUG_LIMITED(MSG_RATE_LIMIT, MSG_DEBUG_SELECTOR_ADD, sock, SOCK_TYPE_CLIENT);
 
             /* Create log */
             char ip [INET6_ADDRSTRLEN];
             inet_ntop(AF_INET6, &(addr.sin6_addr), ip, INET6_ADDRSTRLEN);
             uint16_t port = ntohs(addr.sin6_port);
-            LOG_MSG(MSG_NEW_CLIENT, ip, port);
+            LOG_MSG_LIMITED(MSG_RATE_LIMIT, MSG_NEW_CLIENT, ip, port);
 
             /* Increment statistics */
             Stats_increment(stats, STATKEY_CONNS);
@@ -240,160 +348,41 @@ HandlerErrors handle_server6 (int fd, void * _){
  */
 HandlerErrors handle_client_read(int fd, void * data){
     ClientData clientData = (ClientData) data;
-    char buff[BUFF_SIZE] = {0};
 
-    ssize_t bytes = recv(fd, buff, BUFF_SIZE, MSG_DONTWAIT);
-    if(bytes == CLOSED) {
-        LOG_VERBOSE("Connection ended");
+    /* Receive directly into the free space of the client's buffer */
+    size_t space;
+    if(!client_buffer_reserve(clientData) && clientData->buffer.data == NULL) {
+        return HANDLER_NO_MEM;
+    }
+    uint8_t * ptr = buffer_write_ptr(&clientData->buffer, &space);
+
+    ssize_t bytes = recv(fd, ptr, space, MSG_DONTWAIT);
+    if(bytes == CLOSED || (bytes == ERR && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        LOG_VERBOSE_LIMITED(MSG_RATE_LIMIT, "Connection ended");
         Stats_decrement(stats, STATKEY_CURR_CONNS);
         Selector_remove(selector, fd, SELECTOR_READ_WRITE, true);
         safe_close(fd);
         return HANDLER_OK;
     }
-    else if(bytes == ERR && (errno == EAGAIN || errno == EWOULDBLOCK)) {
-        return HANDLER_OK;
-    }
-
-    Stats_update(stats, STATKEY_TRANSF_BYTES, bytes); // Increment transferred bytes by the number of bytes read
-
-    bool readyToParse = false;
-
-    for(int i = 0; i < bytes && buff[i] != '\0'; i++){
-        if(buff[i] == '\n'){
-            readyToParse = true;
-        }
-        buffer_write(&clientData->buffer, buff[i]);
-    }
-
-    if(!readyToParse) {
+    else if(bytes == ERR) {
         return HANDLER_OK;
     }
+    buffer_write_adv(&clientData->buffer, bytes);
+    clientData->recv_ns = Clock_ns();
 
-    for(int i = 0; i < BUFF_SIZE ;i++) {
-        buff[i] = '\0';
+    /* Draw a larger buffer next time if this one was filled, or one as large as this read otherwise */
+    clientData->buff_hint = (size_t) bytes == space ? space + 1 : (size_t) bytes;
+    if(!buffer_can_write(&clientData->buffer)) {
+        client_buffer_reserve(clientData);      // Leave room for the rest of a line
     }
 
-    int i = 0;
-    char c;
-    while((c = buffer_read(&clientData->buffer)) != '\n'){
-        buff[i++] = c;
-    }
-    buff[i] = c;
-
-    buffer_compact(&clientData->buffer);
-
-    int ret = parseCmd(clientData->parser, buff);
-    if(ret == TERMINAL) {
-        clientData->parser->structure->cmd = QUIT;
-        Selector_add(selector, fd, SELECTOR_WRITE, -1, NULL);
-        Selector_remove(selector, fd, SELECTOR_READ, false);
-        return HANDLER_OK;
-    }
-    if(ret == ERR) {
-        Selector_add(selector, fd, SELECTOR_WRITE, - 1, NULL);
-        Selector_remove(selector, fd, SELECTOR_READ, false);
-        return HANDLER_OK;
-    }
-
-    CommandStructure * structure = clientData->parser->structure;
-    switch(structure->cmd) {
-        case HELO: clientData->clientDomain = strdup(structure->heloDomain); break;
-        case EHLO: clientData->clientDomain = strdup(structure->ehloDomain); break;
-        case MAIL_FROM: {
-            clientData->senderMail = strdup(structure->mailFromStr);
-            if(clientData->mailFile == NULL){
-                char fileName[MAX_DIR_SIZE] = {0};
-
-                time_t t = time(NULL);
-                struct tm tm = *localtime(&t);
-                sprintf(fileName, DEFAULT_TMP_MAIL, TMP, clientData->senderMail, tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
-                if(clientData->mailPath != NULL){
-                    free(clientData->mailPath);
-                }
-                clientData->mailPath = strdup(fileName);
-            }
-            break;
-        }
-        case RCPT_TO: {
-            clientData->receiverMails[clientData->receiverMailsAmount] = strdup(structure->rcptToStr);
-            clientData->receiverMailsAmount++;
-            clientData->receiverMails = realloc(clientData->receiverMails, sizeof(char*)*(clientData->receiverMailsAmount + 1));
-            break;
-        }
-        case DATA: {
-            if(structure->dataStr != NULL && strncmp(structure->dataStr, DOT_CLRF, strlen(DOT_CLRF)) == SUCCESS) {
-
-                time_t t = time(NULL);
-                struct tm tm = *localtime(&t);
-
-                char filename[MAX_DIR_SIZE] = {0};
-                sprintf(filename, DEFAULT_MAIL_NAME, clientData->senderMail, tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
-                clientData->closedMailFd = fclose(clientData->mailFile);
-
-                if(clientData->parser->transform && transform_enabled) {
-                    int ret = transform(transform_cmd, clientData->mailPath);
-                    if(ret == ERR) {
-                        sprintf(buff, SERVER_ERROR, clientData->clientDomain);
-                        if(clientData->parser->status != NULL) free(clientData->parser->status);
-                        clientData->parser->status = strdup(buff);
-                        for(int i = 0; i < clientData->receiverMailsAmount ;i++) free(clientData->receiverMails[i]);
-                        clientData->receiverMailsAmount = 0;
-                        remove(clientData->mailPath);
-                        free(clientData->mailPath);
-                        Selector_add(selector, fd, SELECTOR_WRITE, -1, NULL);
-                        Selector_remove(selector, fd, SELECTOR_READ, false);
-                        return HANDLER_OK;
-
-                    }
-                }
-
-                for(int i = 0; i < clientData->receiverMailsAmount ;i++){
-                    int ret = dump(clientData->mailPath, clientData->receiverMails[i], clientData->senderMail, filename);
-                    if(ret == ERR) {
-                        sprintf(buff, SERVER_ERROR, clientData->clientDomain);
-                        if(clientData->parser->status != NULL) free(clientData->parser->status);
-                        for(int i = 0; i < clientData->receiverMailsAmount ;i++) free(clientData->receiverMails[i]);
-                        clientData->receiverMailsAmount = 0;
-                        remove(clientData->mailPath);
-                        free(clientData->mailPath);
-                        Selector_add(selector, fd, SELECTOR_WRITE, -1, NULL);
-                        Selector_remove(selector, fd, SELECTOR_READ, false);
-                        return HANDLER_OK;
-                    }
-                }
-                for(int i = 0; i < clientData->receiverMailsAmount ;i++) free(clientData->receiverMails[i]);
-                clientData->receiverMailsAmount = 0;
-                remove(clientData->mailPath);
-                free(clientData->mailPath);
-            }
-            else if(structure->dataStr != NULL){
-                fprintf(clientData->mailFile, LITERAL_STR, structure->dataStr);
-            }
-            else {
-                clientData->mailFile = fopen(clientData->mailPath, RW_FOPEN);
-                if(clientData->mailFile == NULL) {
-                    char buff[BUFF_SIZE] = {0};
-                    sprintf(buff, SERVER_ERROR, clientData->clientDomain);
-                    clientData->parser->status = strdup(buff);
-                    rollBack(clientData->parser);
-                    free(clientData->senderMail);
-                    Selector_add(selector, fd, SELECTOR_WRITE, -1, NULL);
-                    Selector_remove(selector, fd, SELECTOR_READ, false);
-                    return HANDLER_OK;
-                }
-                clientData->closedMailFd = 1;
-            }
-        }
-        default: break;
-    }
+    Stats_update(stats, STATKEY_TRANSF_BYTES, bytes); // Increment transferred bytes by the number of bytes read
+    Stats_update(stats, STATKEY_BYTES_IN, bytes);
 
-    Selector_add(selector, fd, SELECTOR_WRITE, -1, NULL);
-    Selector_remove(selector, fd, SELECTOR_READ, false);
+    process_client_lines(fd, clientData);
     return HANDLER_OK;
 }
 
-
-
 HandlerErrors handle_manager_read(int fd, void * data) {
     (void) data;
 
@@ -428,12 +417,11 @@ HandlerErrors handle_manager_read(int fd, void * data) {
     }
 
     /* Parse read message */
-    MngrCommand cmd;
-    if (!manager_parse(buffer, (size_t) read_bytes, &cmd)) {
-        LOG_VERBOSE("Manager sent an invalid command.");
+    if (!manager_parse(buffer, (size_t) read_bytes, &current_manager_req)) {
+        LOG_VERBOSE_LIMITED(MSG_RATE_LIMIT, "Manager sent an invalid command.");
         return HANDLER_NO_OP;
     }
-    LOG_VERBOSE("DETECTED %d\n", current_manager_cmd = cmd);
+    LOG_VERBOSE("DETECTED %d\n", current_manager_req.cmd);
 
     Selector_add(selector, fd, SELECTOR_WRITE, -1, NULL);
     Selector_remove(selector, fd, SELECTOR_READ, false);
@@ -442,6 +430,48 @@ HandlerErrors handle_manager_read(int fd, void * data) {
 }
 
 
+HandlerErrors handle_metrics_server(int fd, void * _) {
+    (void) _;
+
+    while(true) {
+        int sock;
+        do {
+            sock = accept(fd, NULL, NULL);
+        } while(sock < 0 && errno == EINTR);
+        if(sock < 0) {
+            return HANDLER_OK;      // No more connections pending
+        }
+        int evicted;
+        if(!Metrics_open(metrics, sock, &evicted)) {
+            safe_close(sock);
+            continue;
+        }
+        if(evicted != -1) {
+            close_scraper(evicted);     // Its slot now belongs to `sock`
+        }
+        if(Selector_add(selector, sock, SELECTOR_READ, SOCK_TYPE_METRICS, NULL) != SELECTOR_OK) {
+            Metrics_close(metrics, sock);
+            safe_close(sock);
+            return HANDLER_NO_MEM;
+        }
+        LOG_DEBUG_LIMITED(MSG_RATE_LIMIT, MSG_DEBUG_SELECTOR_ADD, sock, SOCK_TYPE_METRICS);
+    }
+}
+
+HandlerErrors handle_metrics_read(int fd, void * _) {
+    (void) _;
+
+    switch(Metrics_read(metrics, fd)) {
+        case METRICS_WAIT: break;
+        case METRICS_REPLY:
+            Selector_add(selector, fd, SELECTOR_WRITE, -1, NULL);
+            Selector_remove(selector, fd, SELECTOR_READ, false);
+            break;
+        case METRICS_CLOSE: close_scraper(fd); break;
+    }
+    return HANDLER_OK;
+}
+
 /***********************************************************************************************/
 /* Write handler definitions                                                                   */
 /***********************************************************************************************/
@@ -453,14 +483,16 @@ HandlerErrors handle_client_write(int fd, void * data){
     ClientData clientData = (ClientData) data;
 
     if(clientData->parser->status == NULL){
-        Selector_add(selector, fd, SELECTOR_READ, -1, NULL);
-        Selector_remove(selector, fd, SELECTOR_WRITE, false);
+        if(!process_client_lines(fd, clientData)) {
+            Selector_add(selector, fd, SELECTOR_READ, -1, NULL);
+            Selector_remove(selector, fd, SELECTOR_WRITE, false);
+        }
         return HANDLER_OK;
     }
 
     ssize_t bytes = send(fd, clientData->parser->status, strlen(clientData->parser->status), MSG_DONTWAIT);
     if(bytes == CLOSED) {
-        LOG_VERBOSE("Connection ended");
+        LOG_VERBOSE_LIMITED(MSG_RATE_LIMIT, "Connection ended");
         Stats_decrement(stats, STATKEY_CURR_CONNS);
         Selector_remove(selector, fd, SELECTOR_READ_WRITE, true);
         safe_close(fd);
@@ -471,14 +503,21 @@ HandlerErrors handle_client_write(int fd, void * data){
     }
 
     Stats_update(stats, STATKEY_TRANSF_BYTES, bytes); // Increment transferred bytes by the number of bytes sent
+    Stats_update(stats, STATKEY_BYTES_OUT, bytes);
 
     if(clientData->parser->structure != NULL &&
         clientData->parser->structure->cmd == QUIT) {
+        Stats_decrement(stats, STATKEY_CURR_CONNS);
         Selector_remove(selector, fd, SELECTOR_WRITE, true);
         safe_close(fd);
         return HANDLER_OK;
     }
 
+    /* Commands pipelined by the client may already be buffered */
+    if(process_client_lines(fd, clientData)) {
+        return HANDLER_OK;
+    }
+
     Selector_add(selector, fd, SELECTOR_READ, -1, NULL);
     Selector_remove(selector, fd, SELECTOR_WRITE, false);
     return HANDLER_OK;
@@ -489,6 +528,10 @@ HandlerErrors handle_client_write(int fd, void * data){
 HandlerErrors handle_manager_write(int fd, void *data) {
     (void) data;
 
+    if (current_manager_req.version == PROTOCOL_VERSION_TLV) {
+        return handle_manager_write_tlv(fd);
+    }
+
     uint8_t response[RESPONSE_SIZE] = {0};
     StatVal statval;
 
@@ -502,8 +545,8 @@ HandlerErrors handle_manager_write(int fd, void *data) {
     uint16_t identifier = 0x1234;
     response[3] = (identifier >> 8) & 0xFF;
     response[4] = identifier & 0xFF;
-    LOG_VERBOSE("command: %d", current_manager_cmd);
-    switch (current_manager_cmd) {
+    LOG_VERBOSE("command: %d", current_manager_req.cmd);
+    switch (current_manager_req.cmd) {
         case CMD_CONEX_HISTORICAS:
             response[5] = 0x00;  // Status: Success
             response[14] = 0x00; // Boolean: 0 (FALSE)
@@ -522,6 +565,15 @@ HandlerErrors handle_manager_write(int fd, void *data) {
 
             break;
 
+        case CMD_CONEX_MAXIMAS:
+            response[5] = 0x00;  // Status: Success
+            response[14] = 0x00; // Boolean: 0 (FALSE)
+
+            Stats_get_max(stats, STATKEY_CURR_CONNS, &statval);
+            memcpy(&(response[6]), &statval, sizeof(uint64_t));
+
+            break;
+
         case CMD_BYTES_TRANSFERIDOS:
             response[5] = 0x00;  // Status: Success
             response[14] = 0x00; // Boolean: 0 (FALSE)
@@ -552,6 +604,55 @@ HandlerErrors handle_manager_write(int fd, void *data) {
 
             break;
 
+        case CMD_VRFY_RELOAD:
+            /* The reload happens in the background: reply with the addresses loaded so far */
+            if (vrfy_live == NULL) {
+                response[5] = STATUS_UNEXPECTED_ERROR;
+                response[14] = 0x00; // Boolean: 0 (FALSE)
+                break;
+            }
+            response[5] = 0x00;  // Status: Success
+            response[14] = 0x01; // Boolean: 1 (TRUE), reload requested
+
+            VrfyLive_request_reload(vrfy_live);
+            statval = (StatVal) VrfyLive_count(vrfy_live);
+            memcpy(&(response[6]), &statval, sizeof(uint64_t));
+
+            break;
+
+        case CMD_BUFFERS_EN_USO:
+        case CMD_BUFFERS_RESERVADOS: {
+            BufPoolStats pool;
+            BufPool_stats(bufpool, &pool);
+            response[5] = 0x00;  // Status: Success
+            response[14] = pool.hugepages ? 0x01 : 0x00; // Boolean: backed by huge pages
+
+            statval = (StatVal) (current_manager_req.cmd == CMD_BUFFERS_EN_USO ? pool.lent_bytes : pool.reserved_bytes);
+            memcpy(&(response[6]), &statval, sizeof(uint64_t));
+
+            break;
+        }
+
+        case CMD_LATENCIA_P50:
+        case CMD_LATENCIA_P90:
+        case CMD_LATENCIA_P99:
+        case CMD_LATENCIA_P999: {
+            static const double percentiles[] = { 50, 90, 99, 99.9 };
+            StatVal samples;
+            if (!Stats_percentile(stats, (HistKey) current_manager_req.arg,
+                                  percentiles[current_manager_req.cmd - CMD_LATENCIA_P50], &statval, &samples)) {
+                response[5] = STATUS_INVALID_COMMAND;
+                response[14] = 0x00; // Boolean: 0 (FALSE)
+                break;
+            }
+            response[5] = 0x00;  // Status: Success
+            response[14] = samples > 0 ? 0x01 : 0x00; // Boolean: any latency recorded
+
+            memcpy(&(response[6]), &statval, sizeof(uint64_t));
+
+            break;
+        }
+
         default:
             response[5] = 0x03;  // Status: Invalid command
             response[14] = 0x00; // Boolean: 0 (FALSE)
@@ -567,7 +668,7 @@ HandlerErrors handle_manager_write(int fd, void *data) {
         manager_addr_len
     );
     LOG_VERBOSE("%d", manager_addr_len);
-    LOG_VERBOSE("cmd = %d", current_manager_cmd);
+    LOG_VERBOSE("cmd = %d", current_manager_req.cmd);
 
     Selector_add(selector, fd, SELECTOR_READ, -1, NULL);
     Selector_remove(selector, fd, SELECTOR_WRITE, false);
@@ -575,10 +676,478 @@ HandlerErrors handle_manager_write(int fd, void *data) {
     return HANDLER_OK;
 }
 
+HandlerErrors handle_metrics_write(int fd, void * _) {
+    (void) _;
+
+    if(Metrics_write(metrics, fd) != METRICS_WAIT) {
+        close_scraper(fd);
+    }
+    return HANDLER_OK;
+}
+
 /***********************************************************************************************/
 /* Private helper definitions                                                                  */
 /***********************************************************************************************/
 
+static void close_scraper(int fd) {
+    Metrics_close(metrics, fd);
+    Selector_remove(selector, fd, SELECTOR_READ_WRITE, false);
+    safe_close(fd);
+}
+
+static bool connection_allowed(int sock) {
+    StatVal current;
+    if(max_connections == 0 || !Stats_get(stats, STATKEY_CURR_CONNS, &current) || (size_t) current < max_connections) {
+        return true;
+    }
+    char buff[BUFF_SIZE];
+    int len = snprintf(buff, sizeof(buff), TOO_MANY_CONNECTIONS, domain);
+    send(sock, buff, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+    close(sock);
+    Stats_increment(stats, STATKEY_CONNS_REJECTED);
+    LOG_MSG_LIMITED(MSG_RATE_LIMIT, MSG_TOO_MANY_CONNECTIONS, max_connections);
+    return false;
+}
+
+static HandlerErrors handle_manager_write_tlv(int fd) {
+    uint8_t response[TLV_MAX_RESPONSE];
+    size_t len = 8;             // Entries start after the header
+    uint16_t count = 0;
+    uint8_t status = STATUS_SUCCESS;
+
+    /* Change the limits listed, only if all of them can be changed */
+    bool valid[TLV_MAX_TYPES];
+    if (current_manager_req.tlv_cmd == TLV_CMD_SET) {
+        bool all_valid = true;
+        for (size_t i = 0; i < current_manager_req.type_qty; i++) {
+            uint16_t type = current_manager_req.types[i];
+            valid[i] = (type >> 8) == TLV_CLASS_LIMIT && Limits_valid((LimitKey) (type & 0xFF), current_manager_req.values[i]);
+            all_valid = all_valid && valid[i];
+        }
+        for (size_t i = 0; i < current_manager_req.type_qty && all_valid; i++) {
+            Limits_set(limits, (LimitKey) (current_manager_req.types[i] & 0xFF), current_manager_req.values[i]);
+        }
+        status = all_valid ? STATUS_SUCCESS : STATUS_INVALID_VALUE;
+    }
+
+    /* Every type, class by class, if none was listed */
+    uint16_t all[STATKEY_QTY + HISTKEY_QTY + TLV_SERVER_QTY + LIMIT_QTY];
+    const uint16_t * types = current_manager_req.types;
+    size_t type_qty = current_manager_req.type_qty;
+    if (type_qty == 0 && current_manager_req.tlv_cmd == TLV_CMD_GET) {
+        for (int key = 0; key < STATKEY_QTY; key++) {
+            all[type_qty++] = TLV_TYPE(TLV_CLASS_STAT, key);
+        }
+        for (int key = 0; key < HISTKEY_QTY; key++) {
+            all[type_qty++] = TLV_TYPE(TLV_CLASS_HIST, key);
+        }
+        for (int key = 0; key < TLV_SERVER_QTY; key++) {
+            all[type_qty++] = TLV_TYPE(TLV_CLASS_SERVER, key);
+        }
+        for (int key = 0; key < LIMIT_QTY; key++) {
+            all[type_qty++] = TLV_TYPE(TLV_CLASS_LIMIT, key);
+        }
+        types = all;
+    }
+
+    /* Pack as many entries as fit in a single datagram */
+    for (size_t i = 0; i < type_qty; i++) {
+        uint8_t value[UINT8_MAX];
+        bool rejected = current_manager_req.tlv_cmd == TLV_CMD_SET && !valid[i];
+        uint8_t length = rejected ? 0 : tlv_value(types[i], value);
+        if (len + 3 + length > sizeof(response)) {
+            status = status == STATUS_SUCCESS ? STATUS_TRUNCATED : status;
+            break;
+        }
+        response[len] = (types[i] >> 8) & 0xFF;
+        response[len + 1] = types[i] & 0xFF;
+        response[len + 2] = length;
+        memcpy(&(response[len + 3]), value, length);
+        len += 3 + length;
+        count++;
+    }
+
+    response[0] = PROTOCOL_SIGNATURE_1;
+    response[1] = PROTOCOL_SIGNATURE_2;
+    response[2] = PROTOCOL_VERSION_TLV;
+    response[3] = (current_manager_req.identifier >> 8) & 0xFF;
+    response[4] = current_manager_req.identifier & 0xFF;
+    response[5] = status;
+    response[6] = (count >> 8) & 0xFF;
+    response[7] = count & 0xFF;
+
+    sendto(
+        fd,
+        response,
+        len,
+        MSG_DONTWAIT,
+        (struct sockaddr *) &manager_addr,
+        manager_addr_len
+    );
+    LOG_VERBOSE("TLV response: %u entries, %zu bytes", count, len);
+
+    Selector_add(selector, fd, SELECTOR_READ, -1, NULL);
+    Selector_remove(selector, fd, SELECTOR_WRITE, false);
+
+    return HANDLER_OK;
+}
+
+static uint8_t tlv_value(uint16_t type, uint8_t * value) {
+    uint8_t index = type & 0xFF;
+    StatVal statval;
+    switch (type >> 8) {
+        case TLV_CLASS_STAT:
+            if (!Stats_get(stats, (StatKey) index, &statval)) {
+                return 0;
+            }
+            put_be64(value, (uint64_t) statval);
+            if (!Stats_get_max(stats, (StatKey) index, &statval)) {
+                return 8;
+            }
+            put_be64(value + 8, (uint64_t) statval);
+            return 16;
+
+        case TLV_CLASS_HIST: {
+            static const double percentiles[] = { 50, 90, 99, 99.9, 100 };
+            StatVal samples;
+            if (!Stats_percentile(stats, (HistKey) index, 50, &statval, &samples)) {
+                return 0;
+            }
+            put_be64(value, (uint64_t) samples);
+            Stats_sum(stats, (HistKey) index, &statval);
+            put_be64(value + 8, (uint64_t) statval);
+            for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++) {
+                Stats_percentile(stats, (HistKey) index, percentiles[i], &statval, NULL);
+                put_be64(value + 16 + 8 * i, (uint64_t) statval);
+            }
+            return 56;
+        }
+
+        case TLV_CLASS_SERVER: {
+            BufPoolStats pool;
+            switch (index) {
+                case TLV_SERVER_TRANSFORMACIONES:
+                    value[0] = transform_enabled ? 0x01 : 0x00;
+                    return 1;
+                case TLV_SERVER_BUFFERS_EN_USO:
+                case TLV_SERVER_BUFFERS_RESERVADOS:
+                    BufPool_stats(bufpool, &pool);
+                    put_be64(value, index == TLV_SERVER_BUFFERS_EN_USO ? pool.lent_bytes : pool.reserved_bytes);
+                    return 8;
+                case TLV_SERVER_HUGEPAGES:
+                    BufPool_stats(bufpool, &pool);
+                    value[0] = pool.hugepages ? 0x01 : 0x00;
+                    return 1;
+                case TLV_SERVER_VRFY_DIRECCIONES:
+                    if (vrfy_live == NULL) {
+                        return 0;
+                    }
+                    put_be64(value, (uint64_t) VrfyLive_count(vrfy_live));
+                    return 8;
+                default:
+                    return 0;
+            }
+        }
+
+        case TLV_CLASS_LIMIT: {
+            uint64_t limit;
+            if (!Limits_get(limits, (LimitKey) index, &limit)) {
+                return 0;
+            }
+            put_be64(value, limit);
+            return 8;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+static void put_be64(uint8_t * dst, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        dst[i] = value & 0xFF;
+        value >>= 8;
+    }
+}
+
+static ClientData create_client_data(void) {
+    ClientData data = Slab_alloc(client_slab);
+    if(data == NULL) {
+        return NULL;
+    }
+    memset(data, 0, sizeof(_ClientData_t));     // The buffer is drawn from the BufPool on the first read
+    data->accepted_ns = Clock_ns();
+    data->buff_hint = BufPool_min_size();
+    data->parser = initParserAt(data->parser_mem, domain);
+    data->receiverMails = data->inlineRcpts;
+    data->receiverMailsCapacity = CLIENT_INLINE_RCPTS;
+    data->parser->vrfyAllowed = vrfy_enabled;
+    data->parser->transformAllowed = transform_enabled;
+    return data;
+}
+
+static bool add_receiver(ClientData clientData, char * receiver) {
+    if(clientData->receiverMailsAmount == clientData->receiverMailsCapacity) {
+        int capacity = 2 * clientData->receiverMailsCapacity;
+        char ** mails = clientData->receiverMails == clientData->inlineRcpts ?
+            malloc(capacity * sizeof(char *)) :
+            realloc(clientData->receiverMails, capacity * sizeof(char *));
+        if(mails == NULL) {
+            return false;
+        }
+        if(clientData->receiverMails == clientData->inlineRcpts) {
+            memcpy(mails, clientData->inlineRcpts, sizeof(clientData->inlineRcpts));
+        }
+        clientData->receiverMails = mails;
+        clientData->receiverMailsCapacity = capacity;
+    }
+    clientData->receiverMails[clientData->receiverMailsAmount++] = receiver;
+    return true;
+}
+
+static void client_buffer_init(buffer * b, size_t size, uint8_t * data) {
+    if(BufPool_mirrored(bufpool)) {
+        buffer_init_mirrored(b, size, data);
+    }
+    else {
+        buffer_init(b, size, data);
+    }
+}
+
+static bool client_buffer_reserve(ClientData clientData) {
+    buffer * b = &clientData->buffer;
+    size_t size;
+
+    /* No buffer: draw one as large as the client needed last time */
+    if(b->data == NULL) {
+        uint8_t * data = BufPool_get(bufpool, clientData->buff_hint, &size);
+        if(data == NULL) {
+            return false;
+        }
+        client_buffer_init(b, size, data);
+        return true;
+    }
+
+    buffer_compact(b);
+    if(buffer_can_write(b)) {
+        return true;
+    }
+
+    /* Full: move its contents (contiguous, even in a ring) to a buffer of the next size class */
+    size_t capacity = b->limit - b->data;
+    uint8_t * data = BufPool_get(bufpool, capacity + 1, &size);
+    if(data == NULL || size <= capacity) {
+        BufPool_put(bufpool, data, size);       // NULL-safe
+        return false;
+    }
+    size_t n;
+    memcpy(data, buffer_read_ptr(b, &n), capacity);
+    BufPool_put(bufpool, b->data, capacity);
+    client_buffer_init(b, size, data);
+    buffer_write_adv(b, capacity);
+    return true;
+}
+
+static void client_buffer_release(ClientData clientData) {
+    buffer * b = &clientData->buffer;
+    if(b->data != NULL && !buffer_can_read(b)) {
+        BufPool_put(bufpool, b->data, b->limit - b->data);
+        memset(b, 0, sizeof(*b));
+    }
+}
+
+static bool next_client_line(ClientData clientData, char * line) {
+    size_t n;
+    uint8_t * ptr = buffer_read_ptr(&clientData->buffer, &n);
+    if(n == 0) {
+        return false;
+    }
+
+    uint8_t * eol = memchr(ptr, '\n', n < BUFF_SIZE ? n : BUFF_SIZE);
+    if(eol != NULL) {
+        n = eol - ptr + 1;
+    }
+    else if(n >= BUFF_SIZE) {
+        n = BUFF_SIZE;
+    }
+    else if(buffer_can_write(&clientData->buffer)) {
+        return false;
+    }
+
+    memcpy(line, ptr, n);
+    line[n] = '\0';
+    buffer_read_adv(&clientData->buffer, n);
+    return true;
+}
+
+static bool process_client_lines(int fd, ClientData clientData) {
+    char line[BUFF_SIZE + 1];
+    bool replied = false;
+    while(!replied && next_client_line(clientData, line)) {
+        replied = process_client_line(fd, clientData, line);
+    }
+    client_buffer_release(clientData);
+    return replied;
+}
+
+static bool process_client_line(int fd, ClientData clientData, char * line) {
+    int ret = parseCmd(clientData->parser, line);
+    if(ret == TERMINAL) {
+        clientData->parser->structure->cmd = QUIT;
+        count_reply(clientData);
+        Selector_add(selector, fd, SELECTOR_WRITE, -1, NULL);
+        Selector_remove(selector, fd, SELECTOR_READ, false);
+        return true;
+    }
+    if(ret == ERR) {
+        count_reply(clientData);
+        Selector_add(selector, fd, SELECTOR_WRITE, - 1, NULL);
+        Selector_remove(selector, fd, SELECTOR_READ, false);
+        return true;
+    }
+
+    CommandStructure * structure = clientData->parser->structure;
+    switch(structure->cmd) {
+        case HELO: clientData->clientDomain = strdup(structure->heloDomain); break;
+        case VRFY: Stats_increment(stats, STATKEY_VRFY_QUERIES); break;
+        case EHLO: clientData->clientDomain = strdup(structure->ehloDomain); break;
+        case MAIL_FROM: clientData->senderMail = strdup(structure->mailFromStr); break;
+        case RCPT_TO: {
+            if(max_recipients != 0 && (size_t) clientData->receiverMailsAmount >= max_recipients) {
+                free(clientData->parser->status);
+                clientData->parser->status = strdup(TOO_MANY_RCPTS);
+                Stats_increment(stats, STATKEY_RCPTS_OVER_LIMIT);
+                break;
+            }
+            char * receiver = strdup(structure->rcptToStr);
+            if(receiver == NULL || !add_receiver(clientData, receiver)) {
+                free(receiver);
+            }
+            break;
+        }
+        case DATA: {
+            if(structure->dataStr != NULL && strncmp(structure->dataStr, DOT_CLRF, strlen(DOT_CLRF)) == SUCCESS) {
+                StorageMsg msg = clientData->msg;
+                clientData->msg = NULL;
+
+                if(clientData->msgLimit != 0 && clientData->msgBytes > clientData->msgLimit) {
+                    Storage_abort(msg);
+                    Stats_increment(stats, STATKEY_MSGS_TOO_LARGE);
+                    abort_mail(clientData, MAIL_TOO_LARGE);
+                    break;
+                }
+                if(msg == NULL) {
+                    abort_mail(clientData, LOCAL_ERROR);
+                    break;
+                }
+
+                bool stored = true;
+                if(clientData->parser->transform && transform_enabled) {
+                    stored = Storage_transform(msg, transform_cmd);
+                }
+                stored = Storage_commit(msg) && stored;
+                if(!stored) {
+                    abort_mail(clientData, SERVER_ERROR);
+                    break;
+                }
+                Stats_increment(stats, STATKEY_MSGS_ACCEPTED);
+                Stats_update(stats, STATKEY_RCPTS_DELIVERED, clientData->receiverMailsAmount);
+                Stats_record(stats, HISTKEY_MSG_SIZE, clientData->msgBytes);
+                Stats_record(stats, HISTKEY_RCPTS_PER_MSG, clientData->receiverMailsAmount);
+                for(int i = 0; i < clientData->receiverMailsAmount ;i++) free(clientData->receiverMails[i]);
+                clientData->receiverMailsAmount = 0;
+            }
+            else if(structure->dataStr != NULL){
+                size_t len = strlen(structure->dataStr);
+                if(clientData->msg != NULL && (clientData->msgLimit == 0 || clientData->msgBytes + len <= clientData->msgLimit)
+                   && !Storage_append(clientData->msg, structure->dataStr, len)) {
+                    // The rest of the contents are discarded, and the mail is refused when it ends
+                    Storage_abort(clientData->msg);
+                    clientData->msg = NULL;
+                }
+                clientData->msgBytes += len;
+            }
+            else {
+                bool begun = (clientData->msg = Storage_begin(clientData->senderMail)) != NULL;
+                clientData->msgBytes = 0;
+                clientData->msgLimit = max_mail_size;
+                for(int i = 0; i < clientData->receiverMailsAmount && begun; i++) {
+                    begun = Storage_add_rcpt(clientData->msg, clientData->receiverMails[i]);
+                }
+                if(!begun) {
+                    Storage_abort(clientData->msg);
+                    clientData->msg = NULL;
+                    char buff[BUFF_SIZE] = {0};
+                    sprintf(buff, SERVER_ERROR, clientData->clientDomain);
+                    clientData->parser->status = strdup(buff);
+                    rollBack(clientData->parser);
+                    free(clientData->senderMail);
+                    clientData->senderMail = NULL;
+                }
+            }
+        }
+        default: break;
+    }
+
+    /* Mail contents are not replied to */
+    if(clientData->parser->status == NULL) {
+        return false;
+    }
+    record_service_time(clientData, structure);
+    count_reply(clientData);
+
+    Selector_add(selector, fd, SELECTOR_WRITE, -1, NULL);
+    Selector_remove(selector, fd, SELECTOR_READ, false);
+    return true;
+}
+
+static void record_service_time(ClientData clientData, CommandStructure * structure) {
+    HistKey key;
+    switch(structure->cmd) {
+        case HELO: key = HISTKEY_CMD_HELO; break;
+        case EHLO: key = HISTKEY_CMD_EHLO; break;
+        case MAIL_FROM: key = HISTKEY_CMD_MAIL; break;
+        case RCPT_TO: key = HISTKEY_CMD_RCPT; break;
+        case DATA: key = structure->dataStr == NULL ? HISTKEY_CMD_DATA : HISTKEY_DATA_END; break;
+        case VRFY: key = HISTKEY_CMD_VRFY; break;
+        default: return;
+    }
+    Stats_record(stats, key, Clock_ns() - clientData->recv_ns);
+}
+
+static void count_reply(ClientData clientData) {
+    static const StatKey keys[] = {
+        [HELO] = STATKEY_REPLIES_HELO, [EHLO] = STATKEY_REPLIES_EHLO, [VRFY] = STATKEY_REPLIES_VRFY,
+        [EXPN] = STATKEY_REPLIES_EXPN, [MAIL_FROM] = STATKEY_REPLIES_MAIL, [RCPT_TO] = STATKEY_REPLIES_RCPT,
+        [DATA] = STATKEY_REPLIES_DATA, [RSET] = STATKEY_REPLIES_RSET, [QUIT] = STATKEY_REPLIES_QUIT,
+        [NOOP] = STATKEY_REPLIES_NOOP, [TRFM] = STATKEY_REPLIES_TRFM, [ERROR] = STATKEY_REPLIES_ERROR,
+    };
+    const char * status = clientData->parser->status;
+    if(status == NULL) {
+        return;
+    }
+    switch(status[0]) {
+        case '2': Stats_increment(stats, STATKEY_REPLIES_2XX); break;
+        case '3': Stats_increment(stats, STATKEY_REPLIES_3XX); break;
+        case '4': Stats_increment(stats, STATKEY_REPLIES_4XX); break;
+        case '5': Stats_increment(stats, STATKEY_REPLIES_5XX); break;
+        default: break;
+    }
+    CommandStructure * structure = clientData->parser->structure;
+    if(structure != NULL && (unsigned) structure->cmd <= ERROR) {
+        Stats_increment(stats, keys[structure->cmd]);
+    }
+}
+
+static void abort_mail(ClientData clientData, const char * reply) {
+    char buff[BUFF_SIZE] = {0};
+    sprintf(buff, reply, clientData->clientDomain);
+    if(clientData->parser->status != NULL) free(clientData->parser->status);
+    clientData->parser->status = strdup(buff);
+    for(int i = 0; i < clientData->receiverMailsAmount ;i++) free(clientData->receiverMails[i]);
+    clientData->receiverMailsAmount = 0;
+}
+
 /*static int clearBuff(int offset, char * buff) {
     LOG_DEBUG("beforeClear: %s", buff);
     int i = 0;
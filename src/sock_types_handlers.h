@@ -60,7 +60,9 @@ typedef HandlerErrors (* SockWriteHandler) (int, void *);
     XX(SOCK_TYPE_SERVER4,       handle_server4,                 NULL                        ) \
     XX(SOCK_TYPE_SERVER6,       handle_server6,                 NULL                        ) \
     XX(SOCK_TYPE_CLIENT,        handle_client_read,             handle_client_write         ) \
-    XX(SOCK_TYPE_MANAGER,       handle_manager_read,            handle_manager_write        )
+    XX(SOCK_TYPE_MANAGER,       handle_manager_read,            handle_manager_write        ) \
+    XX(SOCK_TYPE_METRICS_SERVER,handle_metrics_server,          NULL                        ) \
+    XX(SOCK_TYPE_METRICS,       handle_metrics_read,            handle_metrics_write        )
 
 /**
  * \enum        SockTypes: socket types used in the Selector.
@@ -134,6 +136,32 @@ HandlerErrors handle_client_read        (int fd, void * data);
  */
 HandlerErrors handle_manager_read       (int fd, void * data);
 
+/**
+ * \brief       Handle new connection requests from the metrics server socket (see
+ *              src/utils/metrics.h).
+ *
+ * \details     Accepts all pending connections and adds them to the Selector to read their
+ *              requests. Connections beyond METRICS_MAX_SCRAPERS are closed right away.
+ *
+ * \param[in] fd        The metrics server socket file descriptor to which perform an accept (2).
+ * \param[in] _         Unused parameter.
+ *
+ * \return      Returns any of the following error codes:
+ *              - HANDLER_OK
+ */
+HandlerErrors handle_metrics_server     (int fd, void * _);
+
+/**
+ * \brief       Handle a request from a metrics scraper.
+ *
+ * \param[in] fd        The socket connected to the scraper.
+ * \param[in] _         Unused parameter (scrapers are looked up by socket).
+ *
+ * \return      Returns any of the following error codes:
+ *              - HANDLER_OK
+ */
+HandlerErrors handle_metrics_read       (int fd, void * _);
+
 /***********************************************************************************************/
 /* Write handler declarations                                                                  */
 /***********************************************************************************************/
@@ -160,4 +188,15 @@ HandlerErrors handle_client_write       (int fd, void * data);
  */
 HandlerErrors handle_manager_write      (int fd, void * data);
 
+/**
+ * \brief       Send the response to a metrics scraper, closing the connection once it is sent.
+ *
+ * \param[in] fd        The socket connected to the scraper.
+ * \param[in] _         Unused parameter (scrapers are looked up by socket).
+ *
+ * \return      Returns any of the following error codes:
+ *              - HANDLER_OK
+ */
+HandlerErrors handle_metrics_write      (int fd, void * _);
+
 #endif // __SOCK_TYPES_H__
@@ -8,6 +8,8 @@
  */
 
 #include "args.h"
+#include "spool.h"         // SPOOL_DEFAULT_BUFF_SIZE, SPOOL_DEFAULT_MEM_THRESHOLD, SPOOL_DEFAULT_MEM_BUDGET
+#include "storage.h"       // STORAGE_DEFAULT_BACKEND, Storage_exists()
 
 /*************************************************************************/
 /* Constant, macro, and module-global variable definitions               */
@@ -71,7 +73,7 @@ bool parse_args(int argc, char **argv, SMTPDArgs *const result) {
     if (argc < 7) {
         int option_index = 0;
         static struct option long_options[] = { { 0, 0, 0, 0 } };
-        c = getopt_long(argc, argv, "hd:m:s:p:t:f:L:l:v", long_options, &option_index);
+        c = getopt_long(argc, argv, "hd:m:s:p:P:e:t:f:u:L:l:Bb:r:R:S:i:FHMv", long_options, &option_index);
         switch (c) {
             case 'h':
                 usage(argv[0]);
@@ -88,11 +90,16 @@ bool parse_args(int argc, char **argv, SMTPDArgs *const result) {
 
     memset(result, 0, sizeof(SMTPDArgs));
     result->min_log_level = LOGGER_DEFAULT_MIN_LOG_LEVEL;
+    result->spool_buff_size = SPOOL_DEFAULT_BUFF_SIZE;
+    result->spool_mem_threshold = SPOOL_DEFAULT_MEM_THRESHOLD;
+    result->spool_mem_budget = SPOOL_DEFAULT_MEM_BUDGET;
+    result->storage = STORAGE_DEFAULT_BACKEND;
+    result->inbox_roots = INBOX_DEFAULT_ROOTS;
     while (true) {
         int option_index = 0;
         static struct option long_options[] = { { 0, 0, 0, 0 } };
 
-        c = getopt_long(argc, argv, "hd:m:s:p:t:f:L:l:v", long_options, &option_index);
+        c = getopt_long(argc, argv, "hd:m:s:p:P:e:t:f:u:L:l:Bb:r:R:S:i:FHMv", long_options, &option_index);
         if (c == -1) {
             break;
         }
@@ -113,6 +120,12 @@ bool parse_args(int argc, char **argv, SMTPDArgs *const result) {
                 result->mngr_port = parse_short(optarg, 10);
                 flag ++;
                 break;
+            case 'P':
+                result->metrics_port = parse_short(optarg, 10);
+                break;
+            case 'e':
+                result->shm_stats = optarg;
+                break;
             case 't':
                 result->trsf_cmd = optarg;
                 result->trsf_enabled = true;
@@ -121,6 +134,9 @@ bool parse_args(int argc, char **argv, SMTPDArgs *const result) {
                 result->vrfy_mails = optarg;
                 result->vrfy_enabled = true;
                 break;
+            case 'u':
+                result->rcpt_file = optarg;
+                break;
             case 'L':
                 if (optarg == NULL) {
                     fprintf(stderr, "missing argument for option -L\n");
@@ -145,6 +161,59 @@ bool parse_args(int argc, char **argv, SMTPDArgs *const result) {
                     return false;
                 }
                 break;
+            case 'B':
+                result->log_binary = true;
+                break;
+            case 'b': {
+                long size = parse_long(optarg, 10);
+                if (size <= 0) {
+                    fprintf(stderr, "invalid argument for option -b\n");
+                    return false;
+                }
+                result->spool_buff_size = (size_t) size;
+                break;
+            }
+            case 'r': {
+                long size = parse_long(optarg, 10);
+                if (size < 0 || errno != 0) {
+                    fprintf(stderr, "invalid argument for option -r\n");
+                    return false;
+                }
+                result->spool_mem_threshold = (size_t) size;
+                break;
+            }
+            case 'R': {
+                long size = parse_long(optarg, 10);
+                if (size < 0 || errno != 0) {
+                    fprintf(stderr, "invalid argument for option -R\n");
+                    return false;
+                }
+                result->spool_mem_budget = (size_t) size;
+                break;
+            }
+            case 'S':
+                if (! Storage_exists(optarg)) {
+                    fprintf(stderr, "invalid argument for option -S\n");
+                    return false;
+                }
+                result->storage = optarg;
+                break;
+            case 'i':
+                if (optarg[0] == '\0') {
+                    fprintf(stderr, "invalid argument for option -i\n");
+                    return false;
+                }
+                result->inbox_roots = optarg;
+                break;
+            case 'F':
+                result->inbox_fanout = true;
+                break;
+            case 'H':
+                result->hugepages = true;
+                break;
+            case 'M':
+                result->mirrored_buffers = true;
+                break;
             case 'v':
                 version();
                 exit(0);
@@ -188,12 +257,25 @@ void usage(const char *progname) {
         "Usage: %s -d <DOMAIN NAME> -s <SMTP PORT> -p <MANAGEMENT PORT> -l <LOG FILE PATH> [OPTION]...\n"
         "\n"
         "   -h                      Print this help message and exit.\n"
+        "   -P   <METRICS PORT>     Serve Prometheus metrics on this port, on the local host only.\n"
+        "   -e   <NAME>             Publish statistics into shared memory (/dev/shm/<NAME>), see manager.bin --shm.\n"
         "   -t   <COMMAND PATH>     What transformation command will be used.\n"
         "   -f   <VRFY PATH>        Directory where already verified mails are stored and new one will be stored.\n"
+        "   -u   <RCPT PATH>        Local recipients (one per line), others are rejected at RCPT TO.\n"
         "   -L   <LOG_LEVEL>        Min log level.\n"
+        "   -B                      Write binary logs (render them with logdecode.bin).\n"
+        "   -b   <BYTES>            Spool write buffer size per client (default: %d).\n"
+        "   -r   <BYTES>            Keep mails up to this size in memory instead of the spool, 0 disables (default: %d).\n"
+        "   -R   <BYTES>            Memory shared by all mails kept in memory (default: %d).\n"
+        "   -S   <BACKEND>          Mail storage backend: fs, log, null or memory (default: %s).\n"
+        "   -i   <DIR>[,<DIR>...]   Inbox roots, mailboxes are spread across them by hash (default: %s).\n"
+        "   -F                      Spread mail files across two levels of hashed subdirectories.\n"
+        "   -H                      Back the I/O buffer pool with huge pages, if available.\n"
+        "   -M                      Use mirrored (double-mapped) client buffers, which are never compacted.\n"
         "   -v                      Print version information and exit.\n"
         "\n",
-        progname);
+        progname, SPOOL_DEFAULT_BUFF_SIZE, SPOOL_DEFAULT_MEM_THRESHOLD, SPOOL_DEFAULT_MEM_BUDGET, STORAGE_DEFAULT_BACKEND,
+        INBOX_DEFAULT_ROOTS);
     exit(1);
 }
 
@@ -24,6 +24,7 @@
 #include <errno.h>          // errno
 #include <getopt.h>         // getopt_long
 #include <stdbool.h>        // bool
+#include <stddef.h>         // size_t
 #include "../lib/logger.h"  // LogLevels
 
 /*************************************************************************/
@@ -38,11 +39,23 @@ typedef struct {
     char *      domain;             // Domain the server is going to be managing ("example.com").
     uint16_t    smtp_port;          // Port where the SMTP server will be listening to.
     uint16_t    mngr_port;          // Port where the management server will be listening to.
+    uint16_t    metrics_port;       // Local port serving Prometheus metrics (0 disables).
+    char *      shm_stats;          // Shared memory segment to publish statistics into (NULL disables).
     char *      trsf_cmd;           // Command for mail transformation.
     char *      vrfy_mails;         // Where to find the verified mails.
     bool        vrfy_enabled;       // Enables or disables verification.
+    char *      rcpt_file;          // Local recipients accepted at RCPT TO (NULL accepts any).
     bool        trsf_enabled;       // Enables or disables transformation.
     char *      log_file;           // File where the logs will be written to.
+    bool        log_binary;         // Write binary logs (see src/lib/logfmt.h).
+    size_t      spool_buff_size;    // Size of the per-client buffer used to write mails to the spool.
+    size_t      spool_mem_threshold;// Mails up to this size are kept in memory instead of the spool (0 disables).
+    size_t      spool_mem_budget;   // Memory shared by all memory-resident mails.
+    char *      storage;            // Storage backend name (see src/utils/storage.h).
+    char *      inbox_roots;        // Comma-separated list of inbox roots (fs storage backend).
+    bool        inbox_fanout;       // Spread mail files across hashed subdirectories (fs storage backend).
+    bool        hugepages;          // Back the I/O buffer pool with huge pages (see src/utils/bufpool.h).
+    bool        mirrored_buffers;   // Lend mirrored client buffers (see src/utils/bufpool.h).
 
     /**
      * Minimum log level
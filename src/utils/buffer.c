@@ -19,18 +19,32 @@ buffer_init(buffer *b, const size_t n, uint8_t *data) {
     b->data = data;
     buffer_reset(b);
     b->limit = b->data + n;
+    b->mirrored = false;
+}
+
+void
+buffer_init_mirrored(buffer *b, const size_t n, uint8_t *data) {
+    buffer_init(b, n, data);
+    b->mirrored = true;
+}
+
+/** hasta dónde se puede escribir: en un buffer espejado, n bytes después de la lectura */
+static inline uint8_t *
+buffer_write_limit(buffer *b) {
+    return b->mirrored ? b->read + (b->limit - b->data) : b->limit;
 }
 
 
 inline bool
 buffer_can_write(buffer *b) {
-    return b->limit - b->write > 0;
+    return buffer_write_limit(b) - b->write > 0;
 }
 
 inline uint8_t *
 buffer_write_ptr(buffer *b, size_t *nbyte) {
-    assert(b->write <= b->limit);
-    *nbyte = b->limit - b->write;
+    uint8_t *limit = buffer_write_limit(b);
+    assert(b->write <= limit);
+    *nbyte = limit - b->write;
     return b->write;
 }
 
@@ -50,7 +64,7 @@ inline void
 buffer_write_adv(buffer *b, const ssize_t bytes) {
     if(bytes > -1) {
         b->write += (size_t) bytes;
-        assert(b->write <= b->limit);
+        assert(b->write <= buffer_write_limit(b));
     }
 }
 
@@ -60,6 +74,12 @@ buffer_read_adv(buffer *b, const ssize_t bytes) {
         b->read += (size_t) bytes;
         assert(b->read <= b->write);
 
+        if(b->mirrored && b->read >= b->limit) {
+            // la lectura pasó a la segunda copia: volver a la primera
+            const size_t n = b->limit - b->data;
+            b->read  -= n;
+            b->write -= n;
+        }
         if(b->read == b->write) {
             // compactacion poco costosa
             buffer_compact(b);
@@ -94,6 +114,8 @@ buffer_compact(buffer *b) {
     } else if(b->read == b->write) {
         b->read  = b->data;
         b->write = b->data;
+    } else if(b->mirrored) {
+        // los datos ya son contiguos
     } else {
         const size_t n = b->write - b->read;
         memmove(b->data, b->read, n);
@@ -81,6 +81,25 @@
  * +---+---+---+---+---+---+
  * ↑                       ↑
  * W=0                     limit=6
+ *
+ * Buffer espejado (`buffer_init_mirrored'): las mismas n páginas se mapean
+ * dos veces consecutivas, por lo que data[i] y data[n + i] son el mismo
+ * byte. El buffer es entonces circular, pero toda región legible o
+ * escribible es contigua en memoria, y nunca hace falta compactar: el
+ * puntero de escritura puede avanzar más allá de limit (hasta R + n), y
+ * cuando el de lectura lo alcanza, ambos retroceden n bytes.
+ *
+ *                R=4
+ *                  ↓
+ * +---+---+---+---+---+---+---+---+---+---+---+---+
+ * | M | U | N |   | L | A | M | U | N |   | L | A |
+ * +---+---+---+---+---+---+---+---+---+---+---+---+
+ *                         ↑           ↑   ↑
+ *                     limit=6       W=9   R+n=10
+ *
+ * Invariantes:
+ *    data <= R < limit (o R == W == data)
+ *    R <= W <= R + n
  */
 typedef struct buffer buffer;
 struct buffer {
@@ -94,6 +113,9 @@ struct buffer {
 
     /** puntero de escritura */
     uint8_t *write;
+
+    /** data está mapeado dos veces consecutivas (ver `buffer_init_mirrored') */
+    bool mirrored;
 };
 
 /**
@@ -102,6 +124,13 @@ struct buffer {
 void
 buffer_init(buffer *b, const size_t n, uint8_t *data);
 
+/**
+ * inicializa un buffer circular sobre `data', que debe tener mapeadas las
+ * mismas n páginas dos veces consecutivas (ver src/utils/bufpool.h)
+ */
+void
+buffer_init_mirrored(buffer *b, const size_t n, uint8_t *data);
+
 /**
  * Retorna un puntero donde se pueden escribir hasta `*nbytes`.
  * Se debe notificar mediante la función `buffer_write_adv'
@@ -127,7 +156,8 @@ void
 buffer_write(buffer *b, uint8_t c);
 
 /**
- * compacta el buffer
+ * compacta el buffer. En un buffer espejado solo reinicia los punteros si
+ * está vacío: los datos nunca se mueven.
  */
 void
 buffer_compact(buffer *b);
@@ -0,0 +1,326 @@
+/**
+ * \file        bufpool.c
+ * \brief       Pool of I/O buffers shared by all connections.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdlib.h>         // malloc(), free()
+#include <sys/mman.h>       // mmap(), munmap(), madvise(), memfd_create()
+#include <unistd.h>         // ftruncate(), close(), sysconf()
+
+#include "bufpool.h"
+
+/*************************************************************************/
+/* Private data structures                                               */
+/*************************************************************************/
+
+/**
+ * Returned buffers are linked through their first bytes.
+ */
+typedef struct _BufPool_Free_t {
+    struct _BufPool_Free_t * next;
+} _BufPool_Free_t;
+
+/**
+ * Mirrored arenas reserve twice their size of address space: the buffer carved from
+ * offset `off` of the memory file is mapped at `base + 2 * off`, and again right after it.
+ */
+typedef struct _BufPool_Arena_t {
+    struct _BufPool_Arena_t * next;
+    uint8_t *   base;
+    bool        hugepages;      // Backed by huge pages (MAP_HUGETLB).
+    int         fd;             // Memory file of a mirrored arena, -1 otherwise.
+} _BufPool_Arena_t;
+
+typedef struct _BufPool_Class_t {
+    size_t              size;       // Size of the buffers of this class.
+    _BufPool_Free_t *   free;       // Returned buffers.
+    size_t              free_qty;   // Amount of returned buffers.
+    _BufPool_Arena_t *  arena;      // Current arena.
+    uint8_t *           next;       // Next buffer to carve from the current arena.
+    uint8_t *           end;        // End of the current arena.
+    size_t              lent;       // Buffers currently lent out.
+} _BufPool_Class_t;
+
+typedef struct _BufPool_t {
+    bool                hugepages;      // Attempt to back arenas with huge pages.
+    bool                mirrored;       // Lend mirrored buffers.
+    _BufPool_Class_t    classes[BUFPOOL_CLASS_QTY];
+    _BufPool_Arena_t *  arenas;         // Every arena mapped.
+    size_t              arena_qty;
+} _BufPool_t;
+
+static const size_t class_sizes[] = {
+    #define XX(size) (size),
+    BUFPOOL_CLASSES(XX)
+    #undef XX
+};
+
+/* Arenas are carved into whole buffers, with nothing left over */
+#define XX(size) _Static_assert(BUFPOOL_ARENA_SIZE % (size) == 0, "BUFPOOL_ARENA_SIZE must be a multiple of every size class");
+BUFPOOL_CLASSES(XX)
+#undef XX
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+/**
+ * \brief       Whether the current arena of a class has no room left for another buffer.
+ */
+static bool exhausted(const _BufPool_Class_t * class);
+
+/**
+ * \brief       Get the smallest size class that holds `size` bytes (the largest one if none does).
+ */
+static size_t class_of(BufPool self, size_t size);
+
+/**
+ * \brief       Map a new arena for a size class.
+ *
+ * \return      true on success, false on memory allocation error.
+ */
+static bool map_arena(BufPool self, _BufPool_Class_t * class);
+
+/**
+ * \brief       Map a new mirrored arena for a size class.
+ *
+ * \return      true on success, false on error.
+ */
+static bool map_mirrored_arena(BufPool self, _BufPool_Class_t * class);
+
+/**
+ * \brief       Carve a new buffer from the current arena of a size class, mapping it twice if
+ *              the arena is mirrored.
+ *
+ * \return      The buffer, or NULL on error.
+ */
+static uint8_t * carve(_BufPool_Class_t * class);
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+BufPool BufPool_create(bool hugepages, bool mirrored){
+    BufPool self = calloc(1, sizeof(_BufPool_t));
+    if (self == NULL){
+        return NULL;
+    }
+    self->hugepages = hugepages && ! mirrored;
+    self->mirrored  = mirrored;
+    const size_t page = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < BUFPOOL_CLASS_QTY; i++){
+        self->classes[i].size = mirrored ? (class_sizes[i] + page - 1) / page * page : class_sizes[i];
+    }
+    return self;
+}
+
+uint8_t * BufPool_get(BufPool const self, size_t min_size, size_t * size){
+    if (self == NULL){
+        return NULL;
+    }
+    _BufPool_Class_t * class = &(self->classes[class_of(self, min_size)]);
+    uint8_t * buff;
+
+    /* Reuse a returned buffer */
+    if (class->free != NULL){
+        buff = (uint8_t *) class->free;
+        class->free = class->free->next;
+        class->free_qty--;
+    }
+
+    /* Carve a new one, touching its memory for the first time */
+    else{
+        if (exhausted(class) &&
+            ! (self->mirrored ? map_mirrored_arena(self, class) : map_arena(self, class))){
+            return NULL;
+        }
+        if ((buff = carve(class)) == NULL){
+            return NULL;
+        }
+    }
+
+    class->lent++;
+    * size = class->size;
+    return buff;
+}
+
+void BufPool_put(BufPool const self, uint8_t * buff, size_t size){
+    if (self == NULL || buff == NULL){
+        return;
+    }
+    _BufPool_Class_t * class = &(self->classes[class_of(self, size)]);
+    _BufPool_Free_t * node = (_BufPool_Free_t *) buff;
+    node->next = class->free;
+    class->free = node;
+    class->free_qty++;
+    class->lent--;
+}
+
+bool BufPool_mirrored(BufPool const self){
+    return self != NULL && self->mirrored;
+}
+
+size_t BufPool_min_size(void){
+    return class_sizes[0];
+}
+
+size_t BufPool_max_size(void){
+    return class_sizes[BUFPOOL_CLASS_QTY - 1];
+}
+
+void BufPool_stats(BufPool const self, BufPoolStats * stats){
+    * stats = (BufPoolStats) { 0 };
+    if (self == NULL){
+        return;
+    }
+    for (size_t i = 0; i < BUFPOOL_CLASS_QTY; i++){
+        const _BufPool_Class_t * class = &(self->classes[i]);
+        stats->lent             += class->lent;
+        stats->lent_bytes       += class->lent * class->size;
+        stats->cached_bytes     += class->free_qty * class->size;
+        stats->class_lent[i]     = class->lent;
+    }
+    stats->reserved_bytes = self->arena_qty * BUFPOOL_ARENA_SIZE;
+    for (_BufPool_Arena_t * arena = self->arenas; arena != NULL; arena = arena->next){
+        stats->hugepages = stats->hugepages || arena->hugepages;
+    }
+}
+
+void BufPool_cleanup(BufPool self){
+    if (self == NULL){
+        return;
+    }
+    _BufPool_Arena_t * arena = self->arenas, * next;
+    while (arena != NULL){
+        next = arena->next;
+        munmap(arena->base, arena->fd < 0 ? BUFPOOL_ARENA_SIZE : 2 * BUFPOOL_ARENA_SIZE);
+        if (arena->fd >= 0){
+            close(arena->fd);
+        }
+        free(arena);
+        arena = next;
+    }
+    free(self);
+}
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static size_t class_of(BufPool self, size_t size){
+    size_t i = 0;
+    while (i < BUFPOOL_CLASS_QTY - 1 && self->classes[i].size < size){
+        i++;
+    }
+    return i;
+}
+
+static bool map_arena(BufPool self, _BufPool_Class_t * class){
+    _BufPool_Arena_t * arena = malloc(sizeof(_BufPool_Arena_t));
+    if (arena == NULL){
+        return false;
+    }
+
+    /* Pages are not resident until buffers are carved from them */
+    void * base = MAP_FAILED;
+    arena->hugepages = false;
+#ifdef MAP_HUGETLB
+    if (self->hugepages){
+        base = mmap(NULL, BUFPOOL_ARENA_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        arena->hugepages = base != MAP_FAILED;
+    }
+#endif
+    if (base == MAP_FAILED){
+        base = mmap(NULL, BUFPOOL_ARENA_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED){
+            free(arena);
+            return false;
+        }
+#ifdef MADV_HUGEPAGE
+        /* No reserved huge pages: let transparent huge pages back the arena, if enabled */
+        if (self->hugepages){
+            madvise(base, BUFPOOL_ARENA_SIZE, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    arena->base = base;
+    arena->fd   = -1;
+    arena->next = self->arenas;
+    self->arenas = arena;
+    self->arena_qty++;
+
+    class->arena = arena;
+    class->next  = arena->base;
+    class->end   = arena->base + BUFPOOL_ARENA_SIZE;
+    return true;
+}
+
+static bool map_mirrored_arena(BufPool self, _BufPool_Class_t * class){
+    _BufPool_Arena_t * arena = malloc(sizeof(_BufPool_Arena_t));
+    if (arena == NULL){
+        return false;
+    }
+
+    /* Pages of the memory file are not resident until buffers are carved from it */
+    arena->hugepages = false;
+    arena->fd = memfd_create("bufpool", MFD_CLOEXEC);
+    if (arena->fd < 0 || ftruncate(arena->fd, BUFPOOL_ARENA_SIZE) < 0){
+        goto error;
+    }
+
+    /* Only reserve the address space: buffers are mapped into it as they are carved */
+    arena->base = mmap(NULL, 2 * BUFPOOL_ARENA_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (arena->base == MAP_FAILED){
+        goto error;
+    }
+
+    arena->next = self->arenas;
+    self->arenas = arena;
+    self->arena_qty++;
+
+    class->arena = arena;
+    class->next  = arena->base;
+    class->end   = arena->base + 2 * BUFPOOL_ARENA_SIZE;
+    return true;
+
+error:
+    if (arena->fd >= 0){
+        close(arena->fd);
+    }
+    free(arena);
+    return false;
+}
+
+static bool exhausted(const _BufPool_Class_t * class){
+    if (class->arena == NULL){
+        return true;
+    }
+    size_t needed = class->arena->fd < 0 ? class->size : 2 * class->size;      // Mirrored buffers take twice their size
+    return (size_t) (class->end - class->next) < needed;
+}
+
+static uint8_t * carve(_BufPool_Class_t * class){
+    _BufPool_Arena_t * arena = class->arena;
+    uint8_t * buff = class->next;
+    if (arena->fd < 0){
+        class->next += class->size;
+        return buff;
+    }
+
+    /* Both views share the same file pages */
+    const off_t off = (buff - arena->base) / 2;
+    for (int i = 0; i < 2; i++){
+        if (mmap(buff + i * class->size, class->size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_FIXED, arena->fd, off) == MAP_FAILED){
+            return NULL;
+        }
+    }
+    class->next += 2 * class->size;
+    return buff;
+}
@@ -0,0 +1,135 @@
+/**
+ * \file        bufpool.h
+ * \brief       Pool of I/O buffers shared by all connections.
+ *
+ * \details     Buffers come in a few size classes, from command-sized ones to DATA-sized
+ *              ones, so that a connection only holds a buffer while it has data in flight,
+ *              and the buffer grows with the amount of data the client sends at once.
+ *
+ *              Buffers are carved on demand from large anonymous mappings (arenas), one size
+ *              class per arena, and returned buffers are kept in a free list per size class.
+ *              Arenas may optionally be backed by huge pages, falling back to regular pages
+ *              when none are available. Arenas are only unmapped by `BufPool_cleanup`.
+ *
+ *              A pool may instead lend mirrored buffers, for `buffer_init_mirrored` (see
+ *              src/utils/buffer.h): each arena is then a memory file, and every buffer carved
+ *              from it is mapped twice back to back, so that a buffer used as a ring never
+ *              needs to be compacted. Size classes are rounded up to the page size, and huge
+ *              pages are not used.
+ *
+ * \note        Not thread-safe: the pool is meant to be used from the event loop.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __BUFPOOL_H__
+#define __BUFPOOL_H__
+
+#include <stddef.h>         // size_t
+#include <stdint.h>         // uint8_t
+#include <stdbool.h>        // bool
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Size classes in bytes, from the smallest to the largest */
+#define BUFPOOL_CLASSES(XX)     \
+    XX(512)                     \
+    XX(2 * 1024)                \
+    XX(8 * 1024)                \
+    XX(32 * 1024)
+
+/* Size of each arena in bytes (a multiple of the huge page size and of every size class) */
+#define BUFPOOL_ARENA_SIZE      (2 * 1024 * 1024)
+
+/*************************************************************************/
+
+/**
+ * \brief       Amount of size classes.
+ */
+#define _BUFPOOL_COUNT(size)    + 1
+#define BUFPOOL_CLASS_QTY       (0 BUFPOOL_CLASSES(_BUFPOOL_COUNT))
+
+/**
+ * \typedef     BufPool: Main Buffer Pool ADT data type.
+ */
+typedef struct _BufPool_t * BufPool;
+
+/**
+ * \typedef     BufPoolStats: Occupancy of a BufPool.
+ */
+typedef struct {
+    size_t      lent;                           // Buffers currently lent out.
+    size_t      lent_bytes;                     // Bytes of the buffers currently lent out.
+    size_t      cached_bytes;                   // Bytes of returned buffers, kept for reuse.
+    size_t      reserved_bytes;                 // Bytes of every arena mapped.
+    size_t      class_lent[BUFPOOL_CLASS_QTY];  // Buffers currently lent out, per size class.
+    bool        hugepages;                      // Whether any arena is backed by huge pages.
+} BufPoolStats;
+
+/*************************************************************************/
+
+/**
+ * \brief       Create a BufPool. No memory is reserved for buffers until one is needed.
+ *
+ * \param[in] hugepages     Attempt to back the arenas with huge pages.
+ * \param[in] mirrored      Lend mirrored buffers.
+ *
+ * \return      A new BufPool on success, NULL on memory allocation error.
+ */
+BufPool BufPool_create(bool hugepages, bool mirrored);
+
+/**
+ * \brief       Get a buffer of the smallest size class that holds at least `min_size`
+ *              bytes (or of the largest size class, if none does). To grow a buffer, ask
+ *              for one byte more than its size.
+ *
+ * \param[in]  self         The BufPool itself.
+ * \param[in]  min_size     Minimum size of the buffer.
+ * \param[out] size         Where to store the actual size of the buffer.
+ *
+ * \return      The buffer, or NULL on memory allocation error.
+ */
+uint8_t * BufPool_get(BufPool const self, size_t min_size, size_t * size);
+
+/**
+ * \brief       Return a buffer to the pool. NULL-safe.
+ *
+ * \param[in] self      The BufPool itself.
+ * \param[in] buff      The buffer, as returned by `BufPool_get`.
+ * \param[in] size      Its size.
+ */
+void BufPool_put(BufPool const self, uint8_t * buff, size_t size);
+
+/**
+ * \brief       Whether the buffers of the pool are mirrored.
+ */
+bool BufPool_mirrored(BufPool const self);
+
+/**
+ * \brief       Smallest size class, in bytes (before rounding, for mirrored pools).
+ */
+size_t BufPool_min_size(void);
+
+/**
+ * \brief       Largest size class, in bytes.
+ */
+size_t BufPool_max_size(void);
+
+/**
+ * \brief       Get the occupancy of the pool.
+ *
+ * \param[in]  self     The BufPool itself.
+ * \param[out] stats    Where to store the occupancy.
+ */
+void BufPool_stats(BufPool const self, BufPoolStats * stats);
+
+/**
+ * \brief       Unmap every arena and free the pool. Buffers still lent out become invalid.
+ *              NULL-safe.
+ */
+void BufPool_cleanup(BufPool self);
+
+#endif // __BUFPOOL_H__
@@ -11,35 +11,50 @@
 #define __CLIENT_DATA_H__
 
 #include <stdbool.h>
-#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <pthread.h>
 #include "parser.h"
 #include "buffer.h"
+#include "bufpool.h"
+#include "storage.h"
+
+#define BUFF_SIZE 1400     // Longest line processed at once (longer lines are split).
 
-#define BUFF_SIZE 1400
+#define CLIENT_INLINE_RCPTS 4  // Recipients stored within the client data before allocating an array.
 
 #define TMP "./tmp"
 #define INBOX "./inbox"
 #define FILE_PERMISSIONS 0770
 
+/**
+ * Client data is allocated from a Slab (see src/lib/slab.h), together with its parser.
+ */
 typedef struct _ClientData_t {
-    Parser parser;
+    Parser parser;          // Lives in parser_mem (see initParserAt).
 
-    uint8_t r_buff[BUFF_SIZE];
-    buffer buffer;
+    buffer buffer;          // Received data. Drawn from the BufPool only while data is in flight.
+    size_t buff_hint;       // Size of the buffer to draw next, adapted to the amount of data received.
 
     char * clientDomain;
 
     char * senderMail;
 
-    char ** receiverMails;
+    char ** receiverMails;  // Points to inlineRcpts until more recipients are needed.
     int receiverMailsAmount;
+    int receiverMailsCapacity;
+    char * inlineRcpts[CLIENT_INLINE_RCPTS];
+
+    StorageMsg msg;         // Mail being received (DATA), NULL otherwise.
+    size_t msgBytes;        // Size of the mail being received.
+    size_t msgLimit;        // max_mail_size when the mail began (0: no limit).
+
+    uint64_t accepted_ns;   // When the connection was accepted (see Clock_ns).
+    uint64_t recv_ns;       // When data was last received, for command service times.
 
-    char * mailPath;
-    FILE * mailFile;
-    int closedMailFd;
+    max_align_t parser_mem[];   // Parser memory, parserSize() bytes.
 } _ClientData_t;
 
 typedef struct _ClientData_t * ClientData;
@@ -0,0 +1,454 @@
+/**
+ * \file        dircache.c
+ * \brief       LRU cache of open directory file descriptors used to deliver
+ *              mails into `<root>/<domain>/<user>` without walking the full
+ *              path on every delivery.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdio.h>          // snprintf()
+#include <stdlib.h>         // malloc(), calloc(), free()
+#include <stdint.h>         // uint32_t
+#include <string.h>         // strlen(), memcpy(), strcmp(), strdup()
+#include <errno.h>          // errno, ENOENT, EEXIST, ENAMETOOLONG
+#include <fcntl.h>          // openat(), O_DIRECTORY
+#include <unistd.h>         // close()
+#include <sys/stat.h>       // mkdir(), mkdirat()
+
+#include "dircache.h"
+#include "../lib/hash.h"
+
+/* Levels below a root: domain, user and (optionally) two fan-out subdirectories */
+#define DIRCACHE_MAX_LEVELS         4
+#define DIRCACHE_FANOUT_LEVELS      2
+
+/* A key is "<root>/<domain>[/<user>[/<xx>/<yy>]]", where root is the index of the root */
+#define DIRCACHE_MAX_KEY_LEN        (2 + 1 + 2 * DIRCACHE_MAX_NAME_LEN + 1 + DIRCACHE_FANOUT_LEVELS * 3)
+
+/* Every level of a lookup must fit in the cache at once */
+#define DIRCACHE_MIN_CAPACITY       DIRCACHE_MAX_LEVELS
+
+/* Times a lookup is retried after finding out that a cached parent directory was removed */
+#define DIRCACHE_MAX_RETRIES        3
+
+#define DIRCACHE_OPEN_FLAGS         (O_RDONLY | O_DIRECTORY | O_CLOEXEC)
+
+/*************************************************************************/
+/* Private data structures                                               */
+/*************************************************************************/
+
+typedef struct _DirCache_Entry_t {
+    char                        key[DIRCACHE_MAX_KEY_LEN + 1];
+    uint32_t                    hash;
+    int                         fd;
+    struct _DirCache_Entry_t *  lru_prev;       // Towards the most recently used entry.
+    struct _DirCache_Entry_t *  lru_next;       // Towards the least recently used entry.
+    struct _DirCache_Entry_t *  chain_next;     // Next entry in the same bucket (or in the free list).
+} _DirCache_Entry_t;
+
+typedef struct {
+    char *                      path;           // Root directory path.
+    int                         fd;             // Root directory file descriptor.
+} _DirCache_Root_t;
+
+typedef struct _DirCache_t {
+    _DirCache_Root_t *          roots;
+    size_t                      root_qty;
+    bool                        fanout;         // Whether mail files go into hashed subdirectories.
+
+    _DirCache_Entry_t *         entries;        // Preallocated entries (capacity).
+    _DirCache_Entry_t *         free_list;      // Unused entries, linked through chain_next.
+    size_t                      capacity;
+
+    _DirCache_Entry_t **        buckets;        // Hash table (power of two size).
+    size_t                      bucket_mask;
+
+    _DirCache_Entry_t *         lru_head;       // Most recently used entry.
+    _DirCache_Entry_t *         lru_tail;       // Least recently used entry (first to be evicted).
+} _DirCache_t;
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+/**
+ * \brief       Build the key of the directory `names[0]/.../names[depth - 1]` under `root`.
+ */
+static void build_key(char * key, size_t root, const char * const * names, size_t depth);
+
+/**
+ * \brief       Split a lookup into its root and the names of every level below it.
+ *
+ * \param[out] fanout       Storage for the names of the fan-out subdirectories.
+ *
+ * \return      The amount of levels, or 0 if the names are too long or contain '/'
+ *              (errno is set accordingly).
+ */
+static size_t resolve(DirCache self, const char * domain, const char * user, const char * file,
+                      size_t * root, const char ** names, char fanout[DIRCACHE_FANOUT_LEVELS][3]);
+
+/**
+ * \brief       Find an entry by key. Returns NULL if not present.
+ */
+static _DirCache_Entry_t * find(DirCache self, const char * key, uint32_t hash);
+
+/**
+ * \brief       Insert a new entry for `fd`, evicting the least recently used entry if the
+ *              cache is full.
+ */
+static void insert(DirCache self, const char * key, uint32_t hash, int fd);
+
+/**
+ * \brief       Remove an entry from the cache, closing its file descriptor.
+ */
+static void drop(DirCache self, _DirCache_Entry_t * entry);
+
+/**
+ * \brief       Mark an entry as the most recently used one.
+ */
+static void touch(DirCache self, _DirCache_Entry_t * entry);
+
+/**
+ * \brief       Open the directory `name` relative to `parent_fd`, creating it if it does
+ *              not exist.
+ *
+ * \return      The directory file descriptor, or -1 on error (errno is set accordingly).
+ *              errno is ENOENT if `parent_fd` refers to a removed directory.
+ */
+static int open_or_create(int parent_fd, const char * name);
+
+/**
+ * \brief       (Re)open a root directory, creating it if needed.
+ */
+static bool open_root(DirCache self, size_t root);
+
+/**
+ * \brief       Get the file descriptor of the directory `names[0]/.../names[depth - 1]`
+ *              under `root`, opening (and creating) it and every missing parent if needed.
+ *              Parents that turn out to have been removed are reopened.
+ */
+static int get_dir(DirCache self, size_t root, const char * const * names, size_t depth);
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+DirCache DirCache_create(const char * const * roots, size_t root_qty, bool fanout, size_t capacity){
+    if (roots == NULL || root_qty == 0 || root_qty > DIRCACHE_MAX_ROOTS){
+        errno = EINVAL;
+        return NULL;
+    }
+    if (capacity == 0){
+        capacity = DIRCACHE_DEFAULT_CAPACITY;
+    }
+    if (capacity < DIRCACHE_MIN_CAPACITY){
+        capacity = DIRCACHE_MIN_CAPACITY;
+    }
+
+    DirCache self = calloc(1, sizeof(_DirCache_t));
+    if (self == NULL){
+        return NULL;
+    }
+    self->fanout = fanout;
+
+    if ((self->roots = calloc(root_qty, sizeof(_DirCache_Root_t))) == NULL){
+        DirCache_cleanup(self);
+        return NULL;
+    }
+    self->root_qty = root_qty;
+    for (size_t i = 0; i < root_qty; i++){
+        self->roots[i].fd = -1;
+    }
+    for (size_t i = 0; i < root_qty; i++){
+        if ((self->roots[i].path = strdup(roots[i])) == NULL || ! open_root(self, i)){
+            DirCache_cleanup(self);
+            return NULL;
+        }
+    }
+
+    /* Hash table with at least twice as many buckets as entries */
+    size_t bucket_qty = 1;
+    while (bucket_qty < 2 * capacity){
+        bucket_qty <<= 1;
+    }
+
+    self->entries   = calloc(capacity, sizeof(_DirCache_Entry_t));
+    self->buckets   = calloc(bucket_qty, sizeof(_DirCache_Entry_t *));
+    if (self->entries == NULL || self->buckets == NULL){
+        DirCache_cleanup(self);
+        return NULL;
+    }
+    self->capacity      = capacity;
+    self->bucket_mask   = bucket_qty - 1;
+
+    for (size_t i = 0; i < capacity; i++){
+        self->entries[i].fd         = -1;
+        self->entries[i].chain_next = self->free_list;
+        self->free_list             = &(self->entries[i]);
+    }
+
+    return self;
+}
+
+int DirCache_get(DirCache const self, const char * domain, const char * user, const char * file){
+    if (self == NULL || domain == NULL || user == NULL || file == NULL){
+        errno = EINVAL;
+        return -1;
+    }
+    size_t root;
+    const char * names[DIRCACHE_MAX_LEVELS];
+    char fanout[DIRCACHE_FANOUT_LEVELS][3];
+    size_t depth = resolve(self, domain, user, file, &root, names, fanout);
+    if (depth == 0){
+        return -1;
+    }
+    return get_dir(self, root, names, depth);
+}
+
+void DirCache_invalidate(DirCache const self, const char * domain, const char * user, const char * file){
+    if (self == NULL || domain == NULL || user == NULL || file == NULL){
+        return;
+    }
+    size_t root;
+    const char * names[DIRCACHE_MAX_LEVELS];
+    char fanout[DIRCACHE_FANOUT_LEVELS][3];
+    size_t depth = resolve(self, domain, user, file, &root, names, fanout);
+    if (depth == 0){
+        return;
+    }
+    char key[DIRCACHE_MAX_KEY_LEN + 1];
+    build_key(key, root, names, depth);
+    _DirCache_Entry_t * entry = find(self, key, Hash_fnv1a(key));
+    if (entry != NULL){
+        drop(self, entry);
+    }
+}
+
+void DirCache_cleanup(DirCache self){
+    if (self == NULL){
+        return;
+    }
+    if (self->entries != NULL){
+        for (size_t i = 0; i < self->capacity; i++){
+            if (self->entries[i].fd != -1){
+                close(self->entries[i].fd);
+            }
+        }
+    }
+    if (self->roots != NULL){
+        for (size_t i = 0; i < self->root_qty; i++){
+            if (self->roots[i].fd != -1){
+                close(self->roots[i].fd);
+            }
+            free(self->roots[i].path);
+        }
+    }
+    free(self->roots);
+    free(self->entries);
+    free(self->buckets);
+    free(self);
+}
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static void build_key(char * key, size_t root, const char * const * names, size_t depth){
+    int len = snprintf(key, DIRCACHE_MAX_KEY_LEN + 1, "%zu", root);
+    for (size_t i = 0; i < depth; i++){
+        size_t name_len = strlen(names[i]);
+        key[len++] = '/';
+        memcpy(key + len, names[i], name_len);
+        len += name_len;
+    }
+    key[len] = '\0';
+}
+
+static size_t resolve(DirCache self, const char * domain, const char * user, const char * file,
+                      size_t * root, const char ** names, char fanout[DIRCACHE_FANOUT_LEVELS][3]){
+    size_t domain_len   = strlen(domain);
+    size_t user_len     = strlen(user);
+    if (domain_len > DIRCACHE_MAX_NAME_LEN || user_len > DIRCACHE_MAX_NAME_LEN){
+        errno = ENAMETOOLONG;
+        return 0;
+    }
+    if (strchr(domain, '/') != NULL || strchr(user, '/') != NULL){
+        errno = EINVAL;
+        return 0;
+    }
+
+    /* The root only depends on the mailbox, so all of its mails stay together */
+    uint32_t hash = Hash_fnv1a_update(Hash_fnv1a_update(Hash_fnv1a(domain), "/"), user);
+    * root = hash % self->root_qty;
+
+    size_t depth = 0;
+    names[depth++] = domain;
+    names[depth++] = user;
+    if (self->fanout){
+        uint32_t file_hash = Hash_fnv1a(file);
+        for (size_t i = 0; i < DIRCACHE_FANOUT_LEVELS; i++){
+            snprintf(fanout[i], sizeof(fanout[i]), "%02x", (unsigned) (file_hash % DIRCACHE_FANOUT_WIDTH));
+            file_hash /= DIRCACHE_FANOUT_WIDTH;
+            names[depth++] = fanout[i];
+        }
+    }
+    return depth;
+}
+
+static _DirCache_Entry_t * find(DirCache self, const char * key, uint32_t hash){
+    _DirCache_Entry_t * entry = self->buckets[hash & self->bucket_mask];
+    while (entry != NULL && (entry->hash != hash || strcmp(entry->key, key) != 0)){
+        entry = entry->chain_next;
+    }
+    return entry;
+}
+
+static void insert(DirCache self, const char * key, uint32_t hash, int fd){
+    /* Evict the least recently used entry if there is no room left */
+    if (self->free_list == NULL){
+        drop(self, self->lru_tail);
+    }
+    _DirCache_Entry_t * entry = self->free_list;
+    self->free_list = entry->chain_next;
+
+    strcpy(entry->key, key);
+    entry->hash = hash;
+    entry->fd   = fd;
+
+    /* Link into its bucket */
+    _DirCache_Entry_t ** bucket = &(self->buckets[hash & self->bucket_mask]);
+    entry->chain_next = * bucket;
+    * bucket = entry;
+
+    /* Link as the most recently used entry */
+    entry->lru_prev = NULL;
+    entry->lru_next = self->lru_head;
+    if (self->lru_head != NULL){
+        self->lru_head->lru_prev = entry;
+    }
+    self->lru_head = entry;
+    if (self->lru_tail == NULL){
+        self->lru_tail = entry;
+    }
+}
+
+static void drop(DirCache self, _DirCache_Entry_t * entry){
+    /* Unlink from its bucket */
+    _DirCache_Entry_t ** link = &(self->buckets[entry->hash & self->bucket_mask]);
+    while (* link != entry){
+        link = &((* link)->chain_next);
+    }
+    * link = entry->chain_next;
+
+    /* Unlink from the LRU list */
+    if (entry->lru_prev != NULL){
+        entry->lru_prev->lru_next = entry->lru_next;
+    }
+    else{
+        self->lru_head = entry->lru_next;
+    }
+    if (entry->lru_next != NULL){
+        entry->lru_next->lru_prev = entry->lru_prev;
+    }
+    else{
+        self->lru_tail = entry->lru_prev;
+    }
+
+    close(entry->fd);
+    entry->fd           = -1;
+    entry->chain_next   = self->free_list;
+    self->free_list     = entry;
+}
+
+static void touch(DirCache self, _DirCache_Entry_t * entry){
+    if (entry == self->lru_head){
+        return;
+    }
+    /* Unlink (entry is not the head, so lru_prev is not NULL) */
+    entry->lru_prev->lru_next = entry->lru_next;
+    if (entry->lru_next != NULL){
+        entry->lru_next->lru_prev = entry->lru_prev;
+    }
+    else{
+        self->lru_tail = entry->lru_prev;
+    }
+    /* Relink as head */
+    entry->lru_prev = NULL;
+    entry->lru_next = self->lru_head;
+    self->lru_head->lru_prev = entry;
+    self->lru_head = entry;
+}
+
+static int open_or_create(int parent_fd, const char * name){
+    int fd = openat(parent_fd, name, DIRCACHE_OPEN_FLAGS);
+    if (fd == -1 && errno == ENOENT){
+        if (mkdirat(parent_fd, name, DIRCACHE_DIR_PERMISSIONS) == -1 && errno != EEXIST){
+            return -1;
+        }
+        fd = openat(parent_fd, name, DIRCACHE_OPEN_FLAGS);
+    }
+    return fd;
+}
+
+static bool open_root(DirCache self, size_t root){
+    if (self->roots[root].fd != -1){
+        close(self->roots[root].fd);
+    }
+    self->roots[root].fd = open_or_create(AT_FDCWD, self->roots[root].path);
+    return self->roots[root].fd != -1;
+}
+
+static int get_dir(DirCache self, size_t root, const char * const * names, size_t depth){
+    if (depth == 0){
+        if (self->roots[root].fd == -1 && ! open_root(self, root)){
+            return -1;
+        }
+        return self->roots[root].fd;
+    }
+
+    char key[DIRCACHE_MAX_KEY_LEN + 1];
+    build_key(key, root, names, depth);
+    uint32_t hash = Hash_fnv1a(key);
+
+    for (int attempt = 0; attempt < DIRCACHE_MAX_RETRIES; attempt++){
+        /* Cache hit: no system calls at all */
+        _DirCache_Entry_t * entry = find(self, key, hash);
+        if (entry != NULL){
+            touch(self, entry);
+            return entry->fd;
+        }
+
+        /* Cache miss: open (or create) the directory relative to its parent */
+        int parent_fd = get_dir(self, root, names, depth - 1);
+        if (parent_fd == -1){
+            return -1;
+        }
+        int fd = open_or_create(parent_fd, names[depth - 1]);
+        if (fd != -1){
+            insert(self, key, hash, fd);
+            return fd;
+        }
+
+        /* The cached parent directory was removed: drop it and retry */
+        if (errno != ENOENT){
+            return -1;
+        }
+        if (depth == 1){
+            close(self->roots[root].fd);
+            self->roots[root].fd = -1;
+        }
+        else{
+            char parent_key[DIRCACHE_MAX_KEY_LEN + 1];
+            build_key(parent_key, root, names, depth - 1);
+            _DirCache_Entry_t * parent = find(self, parent_key, Hash_fnv1a(parent_key));
+            if (parent != NULL){
+                drop(self, parent);
+            }
+        }
+    }
+
+    errno = ENOENT;
+    return -1;
+}
@@ -0,0 +1,119 @@
+/**
+ * \file        dircache.h
+ * \brief       LRU cache of open directory file descriptors used to deliver
+ *              mails into `<root>/<domain>/<user>` without walking the full
+ *              path on every delivery.
+ *
+ * \details     Mailboxes can be spread across several roots (for instance, on
+ *              different disks). The root of a mailbox is chosen by hashing
+ *              "<domain>/<user>", so the same mailbox always lands on the same root
+ *              as long as the list of roots does not change.
+ *
+ *              Optionally, mail files are further spread across two levels of hashed
+ *              subdirectories (`<root>/<domain>/<user>/<xx>/<yy>/<file>`, where xx and
+ *              yy are two hexadecimal digits taken from the hash of the file name),
+ *              so no directory grows past a few thousand entries even for very large
+ *              mailboxes.
+ *
+ *              Every mailbox directory is opened once (with `O_DIRECTORY`) and
+ *              kept open while it remains in the cache. Missing directories are
+ *              created with `mkdirat (2)` relative to their parent's cached file
+ *              descriptor, so a cache hit costs no path lookups at all, and files
+ *              can be created with a single-component `openat (2)`.
+ *
+ *              If a cached directory is removed from the file system, creating
+ *              files inside it fails with `ENOENT`. Callers are expected to call
+ *              `DirCache_invalidate` and retry; the next `DirCache_get` reopens
+ *              (and recreates, if necessary) every missing level.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __DIRCACHE_H__
+#define __DIRCACHE_H__
+
+#include <stddef.h>         // size_t
+#include <stdbool.h>        // bool
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Default amount of directories kept open (domains and users altogether) */
+#define DIRCACHE_DEFAULT_CAPACITY   256
+
+/* Permissions used for directories created by the cache */
+#define DIRCACHE_DIR_PERMISSIONS    0770
+
+/* Maximum length of a domain or user name (not including the null terminator) */
+#define DIRCACHE_MAX_NAME_LEN       255
+
+/* Maximum amount of roots */
+#define DIRCACHE_MAX_ROOTS          64
+
+/* Subdirectories per fan-out level (at most 256: names are two hexadecimal digits) */
+#define DIRCACHE_FANOUT_WIDTH       256
+
+/*************************************************************************/
+
+/**
+ * \typedef     DirCache: Main Directory Cache ADT data type.
+ */
+typedef struct _DirCache_t * DirCache;
+
+/*************************************************************************/
+
+/**
+ * \brief       Create a new DirCache over one or more roots. Root directories are
+ *              created if they do not exist.
+ *
+ * \param[in] roots         Paths to the root directories (for instance, "./inbox").
+ *                          The strings are internally copied.
+ * \param[in] root_qty      Amount of roots (between 1 and `DIRCACHE_MAX_ROOTS`).
+ * \param[in] fanout        Whether mail files are spread across hashed subdirectories.
+ * \param[in] capacity      Maximum amount of directories kept open. 0 means
+ *                          `DIRCACHE_DEFAULT_CAPACITY`.
+ *
+ * \return      A new DirCache on success, NULL on failure (errno is set accordingly).
+ */
+DirCache DirCache_create(const char * const * roots, size_t root_qty, bool fanout, size_t capacity);
+
+/**
+ * \brief       Get an open file descriptor for the directory where the mail file `file`
+ *              of `<domain>/<user>` goes, creating any missing level. Without fan-out
+ *              this is `<root>/<domain>/<user>` itself.
+ *
+ * \details     The returned file descriptor is owned by the DirCache. It must not
+ *              be closed by the caller, and it is only guaranteed to remain valid
+ *              until the next call to any DirCache function.
+ *
+ * \param[in] self          The DirCache itself.
+ * \param[in] domain        Domain name (one path component, no '/').
+ * \param[in] user          User name (one path component, no '/').
+ * \param[in] file          Mail file name. Only used to pick the fan-out subdirectory.
+ *
+ * \return      A directory file descriptor on success, -1 on error (errno is set
+ *              accordingly).
+ */
+int DirCache_get(DirCache const self, const char * domain, const char * user, const char * file);
+
+/**
+ * \brief       Drop the cached file descriptor returned by `DirCache_get` for the same
+ *              arguments, for instance because the directory was removed.
+ *
+ * \param[in] self          The DirCache itself.
+ * \param[in] domain        Domain name.
+ * \param[in] user          User name.
+ * \param[in] file          Mail file name.
+ */
+void DirCache_invalidate(DirCache const self, const char * domain, const char * user, const char * file);
+
+/**
+ * \brief       Close every cached file descriptor and free all memory.
+ *
+ * \param[in] self          The DirCache itself. NULL-safe.
+ */
+void DirCache_cleanup(DirCache self);
+
+#endif // __DIRCACHE_H__
@@ -0,0 +1,101 @@
+/**
+ * \file        limits.c
+ * \brief       Operational limits of the server, which the manager can change at runtime.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdlib.h>         // malloc(), free()
+
+#include "limits.h"
+
+typedef struct _Limits_t {
+    uint64_t    current[LIMIT_QTY];         // Values in effect
+    uint64_t    staged[LIMIT_QTY];          // Values in effect after the next commit
+} _Limits_t;
+
+/* Catalogue columns, indexed by key */
+static const uint64_t mins[LIMIT_QTY] = {
+    #define XX(KEY, NAME, MIN, MAX, DESCRIPTION) [LIMIT_##KEY] = MIN,
+    LIMITS_CATALOGUE(XX)
+    #undef XX
+};
+static const uint64_t maxs[LIMIT_QTY] = {
+    #define XX(KEY, NAME, MIN, MAX, DESCRIPTION) [LIMIT_##KEY] = MAX,
+    LIMITS_CATALOGUE(XX)
+    #undef XX
+};
+static const char * const names[LIMIT_QTY] = {
+    #define XX(KEY, NAME, MIN, MAX, DESCRIPTION) [LIMIT_##KEY] = NAME,
+    LIMITS_CATALOGUE(XX)
+    #undef XX
+};
+static const char * const descriptions[LIMIT_QTY] = {
+    #define XX(KEY, NAME, MIN, MAX, DESCRIPTION) [LIMIT_##KEY] = DESCRIPTION,
+    LIMITS_CATALOGUE(XX)
+    #undef XX
+};
+
+/**
+ * \brief       Whether `key` is a valid limit key.
+ */
+static inline bool valid_key(LimitKey key) {
+    return (unsigned) key < LIMIT_QTY;
+}
+
+Limits Limits_create(void){
+    Limits self = malloc(sizeof(_Limits_t));
+    if (self == NULL){
+        return NULL;
+    }
+    for (LimitKey key = 0; key < LIMIT_QTY; key++){
+        self->staged[key] = mins[key];
+        self->current[key] = UINT64_MAX;        // Out of every range: the first commit applies them all
+    }
+    return self;
+}
+
+bool Limits_get(Limits const self, LimitKey key, uint64_t * const val){
+    if (self == NULL || val == NULL || ! valid_key(key)){
+        return false;
+    }
+    * val = self->staged[key];
+    return true;
+}
+
+bool Limits_valid(LimitKey key, uint64_t val){
+    return valid_key(key) && val >= mins[key] && val <= maxs[key];
+}
+
+bool Limits_set(Limits const self, LimitKey key, uint64_t val){
+    if (self == NULL || ! Limits_valid(key, val)){
+        return false;
+    }
+    self->staged[key] = val;
+    return true;
+}
+
+void Limits_commit(Limits const self, LimitApply apply){
+    if (self == NULL){
+        return;
+    }
+    for (LimitKey key = 0; key < LIMIT_QTY; key++){
+        if (self->staged[key] != self->current[key]){
+            self->current[key] = self->staged[key];
+            apply(key, self->current[key]);
+        }
+    }
+}
+
+const char * Limits_name(LimitKey key){
+    return valid_key(key) ? names[key] : NULL;
+}
+
+const char * Limits_description(LimitKey key){
+    return valid_key(key) ? descriptions[key] : NULL;
+}
+
+void Limits_cleanup(Limits self){
+    free(self);
+}
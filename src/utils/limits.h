@@ -0,0 +1,112 @@
+/**
+ * \file        limits.h
+ * \brief       Operational limits of the server, which the manager can change at runtime.
+ *
+ * \details     Every limit is declared once in LIMITS_CATALOGUE, with the range of values it
+ *              accepts. New values are staged by Limits_set and only take effect when the
+ *              event loop commits them (see Limits_commit), between two iterations, so no
+ *              handler ever sees a limit change halfway through. Limits on connections and
+ *              mails apply to those that begin afterwards.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __LIMITS_H__
+#define __LIMITS_H__
+
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint64_t
+#include "../lib/logger.h"  // LogLevels
+#include "spool.h"          // SPOOL_MIN_BUFF_SIZE
+
+/**
+ * \typedef     Limits: Main Limits ADT data type.
+ */
+typedef struct _Limits_t * Limits;
+
+/**
+ * \def         LIMITS_CATALOGUE: Every limit, as XX(KEY, NAME, MIN, MAX, DESCRIPTION), where NAME
+ *              is a unique snake_case identifier and [MIN, MAX] the values accepted. Their order
+ *              is part of version 0x01 of the manager protocol (see src/manager/manager.h): new
+ *              limits go last.
+ */
+#define LIMITS_CATALOGUE(XX)                                                                                                                        \
+    XX(MAX_CONNS,       "max_connections",        0,                    1000000,             "Most concurrent SMTP connections (0: no limit)")      \
+    XX(BACKLOG,         "listen_backlog",         1,                    65535,               "Pending connections queued by the SMTP sockets")      \
+    XX(SPOOL_BUFF_SIZE, "spool_buffer_size",      SPOOL_MIN_BUFF_SIZE,  (1ULL << 30),        "Per-mail buffer used to write the spool, in bytes")   \
+    XX(MEM_THRESHOLD,   "memory_mail_threshold",  0,                    (1ULL << 30),        "Largest mail kept in memory, in bytes (0: none)")     \
+    XX(MEM_BUDGET,      "memory_mail_budget",     0,                    (1ULL << 40),        "Memory shared by all mails kept in memory, in bytes") \
+    XX(MAX_MAIL_SIZE,   "max_mail_size",          0,                    (1ULL << 40),        "Largest mail accepted, in bytes (0: no limit)")       \
+    XX(MAX_RCPTS,       "max_recipients",         0,                    1000000,             "Most recipients of a mail (0: no limit)")             \
+    XX(LOG_LEVEL,       "log_level",              0,                    LOG_LEVELS_QTY - 1,  "Minimum log level (0: debug to 3: critical)")
+
+/**
+ * \enum        LimitKey: Keys of the limits, as in LIMITS_CATALOGUE.
+ */
+typedef enum {
+    #define XX(KEY, NAME, MIN, MAX, DESCRIPTION) LIMIT_##KEY,
+    LIMITS_CATALOGUE(XX)
+    #undef XX
+    LIMIT_QTY
+} LimitKey;
+
+/**
+ * \typedef     LimitApply: Called by Limits_commit for every limit whose value changed.
+ */
+typedef void (* LimitApply) (LimitKey key, uint64_t val);
+
+/*************************************************************************/
+
+/**
+ * \brief       Create the limits, all of them staged at their minimum value. Initial values
+ *              are set like any other; the first commit applies every limit, changed or not.
+ *
+ * \return      A new Limits on success, NULL on memory allocation error.
+ */
+Limits Limits_create(void);
+
+/**
+ * \brief       Get the value of a limit: the one in effect, or the one staged to take effect
+ *              on the next commit.
+ *
+ * \return      true on success, false if `key` is not valid.
+ */
+bool Limits_get(Limits const self, LimitKey key, uint64_t * const val);
+
+/**
+ * \brief       Whether `val` is within the range of a limit.
+ */
+bool Limits_valid(LimitKey key, uint64_t val);
+
+/**
+ * \brief       Stage a new value for a limit, to take effect on the next commit.
+ *
+ * \return      true on success, false if `key` is not valid or `val` is out of range.
+ */
+bool Limits_set(Limits const self, LimitKey key, uint64_t val);
+
+/**
+ * \brief       Make every staged value take effect, calling `apply` for each limit whose
+ *              value changed. Meant to be called between event loop iterations. NULL-safe.
+ */
+void Limits_commit(Limits const self, LimitApply apply);
+
+/**
+ * \brief       Name of a limit (as in LIMITS_CATALOGUE), or NULL if `key` is not valid.
+ */
+const char * Limits_name(LimitKey key);
+
+/**
+ * \brief       Description of a limit, or NULL if `key` is not valid.
+ */
+const char * Limits_description(LimitKey key);
+
+/**
+ * \brief       Free all memory.
+ *
+ * \param[in] self          The Limits itself. NULL-safe.
+ */
+void Limits_cleanup(Limits self);
+
+#endif // __LIMITS_H__
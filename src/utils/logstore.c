@@ -0,0 +1,803 @@
+/**
+ * \file        logstore.c
+ * \brief       Log-structured message store: messages are appended to large
+ *              per-shard segment files, and every mailbox keeps a compact index
+ *              of the messages it holds.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdio.h>          // snprintf()
+#include <stdlib.h>         // malloc(), realloc(), free(), strtoul()
+#include <string.h>         // strlen(), strdup(), strchr(), memcpy()
+#include <errno.h>          // errno
+#include <fcntl.h>          // openat(), O_* flags
+#include <unistd.h>         // close(), pread(), pwrite(), unlinkat()
+#include <dirent.h>         // fdopendir(), readdir(), closedir()
+#include <signal.h>         // sigfillset(), pthread_sigmask()
+#include <time.h>           // time(), clock_gettime()
+#include <pthread.h>        // pthread_*
+#include <sys/stat.h>       // mkdirat(), fstat(), fstatat()
+#include <sys/uio.h>        // pwritev(), struct iovec
+
+#include "logstore.h"
+#include "../lib/hash.h"
+
+#define RECORD_MAGIC            0x4C54534DU     // "MSTL" in little endian
+#define RECORD_HEADER_SIZE      24
+#define SEGMENT_SUFFIX          ".seg"
+#define INDEX_SUFFIX            ".idx"
+#define INDEX_TMP_SUFFIX        ".tmp"
+#define MAX_FILE_NAME           255
+#define MAX_MAILBOX_LEN         (MAX_FILE_NAME - 8)
+#define MSGID_SEQ_BITS          24
+
+/*************************************************************************/
+/* Private data structures                                               */
+/*************************************************************************/
+
+typedef struct {
+    pthread_mutex_t lock;               // Held while writing to the shard, or swapping compacted indexes in.
+    pthread_mutex_t compact_lock;       // Held while compacting the shard.
+    int             dir_fd;             // Shard directory.
+    int             active_fd;          // Segment currently being appended to.
+    uint32_t        active_segment;     // Number of the active segment.
+    uint64_t        active_size;        // Size of the active segment.
+    uint32_t        last_segment;       // Highest segment number in use (the active one, or a compaction output).
+} _Shard_t;
+
+typedef struct _LogStore_t {
+    int             root_fd;
+    unsigned        shard_qty;
+    size_t          segment_size;
+    _Shard_t *      shards;
+    uint64_t        seq;                // Message id sequence (only used by the appending thread).
+
+    pthread_t       compactor;
+    bool            compactor_running;
+    unsigned        compact_interval;
+    pthread_mutex_t stop_lock;
+    pthread_cond_t  stop_cond;
+    bool            stop;
+} _LogStore_t;
+
+/* A mailbox index loaded in memory during compaction */
+typedef struct {
+    char            name[MAX_FILE_NAME + 1];
+    LogStoreEntry * entries;            // As loaded (never modified).
+    size_t          qty;
+    bool            dirty;
+    size_t          live;               // Entries in the rewritten index.
+} _Index_t;
+
+/* Where a record was moved to during compaction */
+typedef struct {
+    uint64_t        old_offset;
+    uint32_t        new_segment;
+    uint64_t        new_offset;
+} _Reloc_t;
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+/**
+ * \brief       Check that a mailbox name can be used as (part of) a file name.
+ */
+static bool valid_mailbox(const char * mailbox);
+
+/**
+ * \brief       Shard a mailbox belongs to.
+ */
+static _Shard_t * shard_of(LogStore self, const char * mailbox);
+
+/**
+ * \brief       Open (creating it if needed) the directory and the active segment of a shard.
+ */
+static bool open_shard(LogStore self, unsigned idx);
+
+/**
+ * \brief       Create a segment numbered after every other one of a shard. The shard must be locked.
+ *
+ * \return      Its file descriptor, or -1 on failure.
+ */
+static int create_segment(_Shard_t * shard);
+
+/**
+ * \brief       Seal the active segment of a shard and start a new one. The shard must be locked.
+ */
+static bool roll_segment(_Shard_t * shard);
+
+/**
+ * \brief       Write every byte described by `iov` at `offset`, retrying on short writes.
+ */
+static bool pwritev_all(int fd, struct iovec * iov, int iovcnt, uint64_t offset);
+
+/**
+ * \brief       Append raw record bytes to the active segment of a shard, rolling it if full.
+ *              The shard must be locked.
+ */
+static bool append_raw(LogStore self, _Shard_t * shard, struct iovec * iov, int iovcnt, size_t len,
+                       uint32_t * segment, uint64_t * offset);
+
+/**
+ * \brief       Append an entry to the index of a mailbox. The shard must be locked.
+ */
+static bool append_entry(_Shard_t * shard, const char * mailbox, const LogStoreEntry * entry);
+
+/**
+ * \brief       Read the entries of an index.
+ */
+static bool read_index(_Shard_t * shard, const char * name, LogStoreEntry ** entries, size_t * qty);
+
+/**
+ * \brief       Load every index of a shard.
+ */
+static bool load_indexes(_Shard_t * shard, _Index_t ** indexes, size_t * qty);
+
+/**
+ * \brief       Write the live entries of an index, with those of the victim segment pointed to
+ *              where they were relocated, to the index's temporary file (unless none is live).
+ */
+static bool write_index(_Shard_t * shard, const char * name, const LogStoreEntry * entries, size_t qty,
+                        uint32_t victim, const _Reloc_t * relocs, size_t reloc_qty, size_t * live);
+
+/**
+ * \brief       Replace an index by its rewritten copy (atomically, through rename (2)), merging
+ *              in the entries appended or deleted since it was loaded. The shard must be locked.
+ */
+static bool swap_index(_Shard_t * shard, _Index_t * index, uint32_t victim, const _Reloc_t * relocs, size_t reloc_qty);
+
+/**
+ * \brief       Compactor thread.
+ */
+static void * compactor_main(void * arg);
+
+/**
+ * \brief       Check whether the compactor was asked to stop.
+ */
+static bool should_stop(LogStore self);
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+LogStore LogStore_open(const char * root, unsigned shards, size_t segment_size){
+    if (root == NULL){
+        errno = EINVAL;
+        return NULL;
+    }
+    LogStore self = calloc(1, sizeof(_LogStore_t));
+    if (self == NULL){
+        return NULL;
+    }
+    self->shard_qty     = shards == 0 ? LOGSTORE_DEFAULT_SHARDS : shards;
+    self->segment_size  = segment_size == 0 ? LOGSTORE_DEFAULT_SEGMENT_SIZE : segment_size;
+    self->root_fd       = -1;
+    self->seq           = 0;
+    pthread_mutex_init(&self->stop_lock, NULL);
+    pthread_cond_init(&self->stop_cond, NULL);
+
+    if ((self->shards = calloc(self->shard_qty, sizeof(_Shard_t))) == NULL){
+        LogStore_close(self);
+        return NULL;
+    }
+    for (unsigned i = 0; i < self->shard_qty; i++){
+        self->shards[i].dir_fd      = -1;
+        self->shards[i].active_fd   = -1;
+        pthread_mutex_init(&self->shards[i].lock, NULL);
+        pthread_mutex_init(&self->shards[i].compact_lock, NULL);
+    }
+
+    if (mkdir(root, LOGSTORE_DIR_PERMISSIONS) == -1 && errno != EEXIST){
+        LogStore_close(self);
+        return NULL;
+    }
+    if ((self->root_fd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) == -1){
+        LogStore_close(self);
+        return NULL;
+    }
+    for (unsigned i = 0; i < self->shard_qty; i++){
+        if (! open_shard(self, i)){
+            LogStore_close(self);
+            return NULL;
+        }
+    }
+    return self;
+}
+
+bool LogStore_append(LogStore const self, const char * sender, const void * body, size_t len,
+                     const char * const * mailboxes, size_t qty, uint64_t * msgid){
+    if (self == NULL || sender == NULL || mailboxes == NULL || len > UINT32_MAX){
+        return false;
+    }
+    for (size_t i = 0; i < qty; i++){
+        if (! valid_mailbox(mailboxes[i])){
+            return false;
+        }
+    }
+
+    uint64_t id = ((uint64_t) time(NULL) << MSGID_SEQ_BITS) | (self->seq++ & ((1U << MSGID_SEQ_BITS) - 1));
+    if (msgid != NULL){
+        * msgid = id;
+    }
+
+    uint32_t header[RECORD_HEADER_SIZE / sizeof(uint32_t)] = {
+        RECORD_MAGIC, (uint32_t) strlen(sender), (uint32_t) len, 0, 0, 0
+    };
+    memcpy(&header[4], &id, sizeof(id));
+    size_t rec_len = RECORD_HEADER_SIZE + header[1] + len;
+
+    /* Records written so far, so that mailboxes of the same shard share them */
+    _Shard_t ** written_shards  = malloc(qty * sizeof(_Shard_t *));
+    LogStoreEntry * written     = malloc(qty * sizeof(LogStoreEntry));
+    if ((written_shards == NULL || written == NULL) && qty > 0){
+        free(written_shards);
+        free(written);
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < qty && ok; i++){
+        _Shard_t * shard = shard_of(self, mailboxes[i]);
+        LogStoreEntry entry = { .msgid = id, .flags = 0, .length = (uint32_t) rec_len, .reserved = 0 };
+
+        pthread_mutex_lock(&shard->lock);
+
+        /* Write the record once per shard */
+        size_t j = 0;
+        while (j < i && written_shards[j] != shard){
+            j++;
+        }
+        if (j < i){
+            entry.segment   = written[j].segment;
+            entry.offset    = written[j].offset;
+        }
+        else{
+            struct iovec iov[3] = {
+                { .iov_base = header,           .iov_len = RECORD_HEADER_SIZE   },
+                { .iov_base = (void *) sender,  .iov_len = header[1]            },
+                { .iov_base = (void *) body,    .iov_len = len                  }
+            };
+            ok = append_raw(self, shard, iov, 3, rec_len, &entry.segment, &entry.offset);
+        }
+        ok = ok && append_entry(shard, mailboxes[i], &entry);
+
+        pthread_mutex_unlock(&shard->lock);
+
+        written_shards[i]   = shard;
+        written[i]          = entry;
+    }
+
+    free(written_shards);
+    free(written);
+    return ok;
+}
+
+bool LogStore_delete(LogStore const self, const char * mailbox, uint64_t msgid){
+    if (self == NULL || ! valid_mailbox(mailbox)){
+        return false;
+    }
+    char name[MAX_FILE_NAME + 1];
+    snprintf(name, sizeof(name), "%s" INDEX_SUFFIX, mailbox);
+
+    _Shard_t * shard = shard_of(self, mailbox);
+    pthread_mutex_lock(&shard->lock);
+
+    bool found = false;
+    int fd = openat(shard->dir_fd, name, O_RDWR | O_CLOEXEC);
+    if (fd != -1){
+        LogStoreEntry entry;
+        off_t pos = 0;
+        while (! found && pread(fd, &entry, sizeof(entry), pos) == (ssize_t) sizeof(entry)){
+            if (entry.msgid == msgid && ! (entry.flags & LOGSTORE_FLAG_DELETED)){
+                entry.flags |= LOGSTORE_FLAG_DELETED;
+                found = pwrite(fd, &entry, sizeof(entry), pos) == (ssize_t) sizeof(entry);
+                break;
+            }
+            pos += sizeof(entry);
+        }
+        close(fd);
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+    return found;
+}
+
+bool LogStore_compact(LogStore const self, unsigned shard_idx){
+    if (self == NULL || shard_idx >= self->shard_qty){
+        return false;
+    }
+    _Shard_t * shard = &(self->shards[shard_idx]);
+    if (pthread_mutex_trylock(&shard->compact_lock) != 0){
+        return false;       // Busy: try again next time
+    }
+
+    /*
+     * Only segments sealed before the indexes are loaded are compacted. Nothing is ever
+     * appended to them, so they are copied without holding the shard's lock: appends
+     * only wait for the indexes to be swapped in.
+     */
+    pthread_mutex_lock(&shard->lock);
+    uint32_t active = shard->active_segment;
+    pthread_mutex_unlock(&shard->lock);
+
+    _Index_t * indexes  = NULL;
+    size_t index_qty    = 0;
+    _Reloc_t * relocs   = NULL;
+    size_t reloc_qty    = 0;
+    uint8_t * record    = NULL;
+    int victim_fd       = -1;
+    int out_fd          = -1;
+    uint32_t out_segment = 0;
+    uint64_t out_size   = 0;
+    bool reclaimed      = false;
+
+    if (! load_indexes(shard, &indexes, &index_qty)){
+        goto done;
+    }
+
+    /* Find a sealed segment that is mostly dead */
+    DIR * dir = fdopendir(dup(shard->dir_fd));
+    if (dir == NULL){
+        goto done;
+    }
+    rewinddir(dir);     // The duplicate shares its position with the shard's descriptor
+    uint32_t victim = 0;
+    struct dirent * ent;
+    while (victim == 0 && (ent = readdir(dir)) != NULL){
+        char * end;
+        unsigned long seg = strtoul(ent->d_name, &end, 10);
+        if (end == ent->d_name || strcmp(end, SEGMENT_SUFFIX) != 0 || seg >= active){
+            continue;
+        }
+        struct stat st;
+        if (fstatat(shard->dir_fd, ent->d_name, &st, 0) == -1){
+            continue;
+        }
+        uint64_t live = 0;
+        for (size_t i = 0; i < index_qty; i++){
+            for (size_t j = 0; j < indexes[i].qty; j++){
+                LogStoreEntry * e = &(indexes[i].entries[j]);
+                if (e->segment == seg && ! (e->flags & LOGSTORE_FLAG_DELETED)){
+                    live += e->length;
+                }
+            }
+        }
+        if (live * 100 < (uint64_t) st.st_size * LOGSTORE_COMPACT_LIVE_PERCENT){
+            victim = (uint32_t) seg;
+        }
+    }
+    closedir(dir);
+    if (victim == 0){
+        goto done;
+    }
+
+    char victim_name[MAX_FILE_NAME + 1];
+    snprintf(victim_name, sizeof(victim_name), "%08u" SEGMENT_SUFFIX, (unsigned) victim);
+    if ((victim_fd = openat(shard->dir_fd, victim_name, O_RDONLY | O_CLOEXEC)) == -1){
+        goto done;
+    }
+
+    /* Copy every live record out of the victim (once, even if several mailboxes share it) into a new segment */
+    for (size_t i = 0; i < index_qty; i++){
+        for (size_t j = 0; j < indexes[i].qty; j++){
+            LogStoreEntry * e = &(indexes[i].entries[j]);
+            if (e->segment != victim){
+                continue;
+            }
+            indexes[i].dirty = true;
+            if (e->flags & LOGSTORE_FLAG_DELETED){
+                continue;
+            }
+
+            size_t r = 0;
+            while (r < reloc_qty && relocs[r].old_offset != e->offset){
+                r++;
+            }
+            if (r < reloc_qty){
+                continue;
+            }
+            if (out_fd == -1){
+                pthread_mutex_lock(&shard->lock);
+                out_fd = create_segment(shard);
+                out_segment = shard->last_segment;
+                pthread_mutex_unlock(&shard->lock);
+                if (out_fd == -1){
+                    goto done;
+                }
+            }
+            _Reloc_t * new_relocs = realloc(relocs, (reloc_qty + 1) * sizeof(_Reloc_t));
+            uint8_t * new_record = realloc(record, e->length);
+            if (new_relocs != NULL){
+                relocs = new_relocs;
+            }
+            if (new_record != NULL){
+                record = new_record;
+            }
+            if (new_relocs == NULL || new_record == NULL ||
+                pread(victim_fd, record, e->length, e->offset) != (ssize_t) e->length){
+                goto done;
+            }
+            struct iovec iov = { .iov_base = record, .iov_len = e->length };
+            if (! pwritev_all(out_fd, &iov, 1, out_size)){
+                goto done;
+            }
+            relocs[r] = (_Reloc_t) { .old_offset = e->offset, .new_segment = out_segment, .new_offset = out_size };
+            out_size += e->length;
+            reloc_qty++;
+        }
+    }
+
+    /* Write the new indexes aside */
+    for (size_t i = 0; i < index_qty; i++){
+        if (indexes[i].dirty && ! write_index(shard, indexes[i].name, indexes[i].entries, indexes[i].qty,
+                                              victim, relocs, reloc_qty, &(indexes[i].live))){
+            goto done;
+        }
+    }
+
+    /* Swap them in, and only then drop the victim */
+    pthread_mutex_lock(&shard->lock);
+    bool swapped = true;
+    for (size_t i = 0; i < index_qty && swapped; i++){
+        swapped = ! indexes[i].dirty || swap_index(shard, &(indexes[i]), victim, relocs, reloc_qty);
+    }
+    reclaimed = swapped && unlinkat(shard->dir_fd, victim_name, 0) == 0;
+    pthread_mutex_unlock(&shard->lock);
+
+done:
+    if (victim_fd != -1){
+        close(victim_fd);
+    }
+    if (out_fd != -1){
+        close(out_fd);
+    }
+    for (size_t i = 0; i < index_qty; i++){
+        free(indexes[i].entries);
+    }
+    free(indexes);
+    free(relocs);
+    free(record);
+    pthread_mutex_unlock(&shard->compact_lock);
+    return reclaimed;
+}
+
+bool LogStore_start_compactor(LogStore const self, unsigned interval){
+    if (self == NULL || self->compactor_running){
+        return false;
+    }
+    self->compact_interval = interval == 0 ? LOGSTORE_COMPACT_INTERVAL : interval;
+
+    /* Signals must keep being handled by the main thread */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    self->compactor_running = pthread_create(&self->compactor, NULL, compactor_main, self) == 0;
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    return self->compactor_running;
+}
+
+void LogStore_close(LogStore self){
+    if (self == NULL){
+        return;
+    }
+    if (self->compactor_running){
+        pthread_mutex_lock(&self->stop_lock);
+        self->stop = true;
+        pthread_cond_signal(&self->stop_cond);
+        pthread_mutex_unlock(&self->stop_lock);
+        pthread_join(self->compactor, NULL);
+    }
+    if (self->shards != NULL){
+        for (unsigned i = 0; i < self->shard_qty; i++){
+            if (self->shards[i].active_fd != -1){
+                close(self->shards[i].active_fd);
+            }
+            if (self->shards[i].dir_fd != -1){
+                close(self->shards[i].dir_fd);
+            }
+            pthread_mutex_destroy(&self->shards[i].lock);
+            pthread_mutex_destroy(&self->shards[i].compact_lock);
+        }
+        free(self->shards);
+    }
+    if (self->root_fd != -1){
+        close(self->root_fd);
+    }
+    pthread_mutex_destroy(&self->stop_lock);
+    pthread_cond_destroy(&self->stop_cond);
+    free(self);
+}
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static bool valid_mailbox(const char * mailbox){
+    return mailbox != NULL && mailbox[0] != '\0' && mailbox[0] != '.' &&
+           strchr(mailbox, '/') == NULL && strlen(mailbox) <= MAX_MAILBOX_LEN;
+}
+
+static _Shard_t * shard_of(LogStore self, const char * mailbox){
+    return &(self->shards[Hash_fnv1a(mailbox) % self->shard_qty]);
+}
+
+static bool open_shard(LogStore self, unsigned idx){
+    _Shard_t * shard = &(self->shards[idx]);
+    char name[MAX_FILE_NAME + 1];
+    snprintf(name, sizeof(name), "%03u", idx);
+    if (mkdirat(self->root_fd, name, LOGSTORE_DIR_PERMISSIONS) == -1 && errno != EEXIST){
+        return false;
+    }
+    if ((shard->dir_fd = openat(self->root_fd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) == -1){
+        return false;
+    }
+
+    /* Keep appending to the newest segment */
+    DIR * dir = fdopendir(dup(shard->dir_fd));
+    if (dir == NULL){
+        return false;
+    }
+    rewinddir(dir);     // The duplicate shares its position with the shard's descriptor
+    struct dirent * ent;
+    while ((ent = readdir(dir)) != NULL){
+        char * end;
+        unsigned long seg = strtoul(ent->d_name, &end, 10);
+        if (end != ent->d_name && strcmp(end, SEGMENT_SUFFIX) == 0 && seg > shard->active_segment){
+            shard->active_segment = (uint32_t) seg;
+        }
+    }
+    closedir(dir);
+
+    /* Empty shard: start with segment 1 (0 means "no segment") */
+    shard->last_segment = shard->active_segment;
+    if (shard->active_segment == 0){
+        return roll_segment(shard);
+    }
+    snprintf(name, sizeof(name), "%08u" SEGMENT_SUFFIX, (unsigned) shard->active_segment);
+    struct stat st;
+    if ((shard->active_fd = openat(shard->dir_fd, name, O_WRONLY | O_CLOEXEC)) == -1 || fstat(shard->active_fd, &st) == -1){
+        return false;
+    }
+    shard->active_size = (uint64_t) st.st_size;
+    return true;
+}
+
+static int create_segment(_Shard_t * shard){
+    char name[MAX_FILE_NAME + 1];
+    snprintf(name, sizeof(name), "%08u" SEGMENT_SUFFIX, (unsigned) (shard->last_segment + 1));
+    int fd = openat(shard->dir_fd, name, O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, LOGSTORE_FILE_PERMISSIONS);
+    if (fd != -1){
+        shard->last_segment++;
+    }
+    return fd;
+}
+
+static bool roll_segment(_Shard_t * shard){
+    int fd = create_segment(shard);
+    if (fd == -1){
+        return false;
+    }
+    if (shard->active_fd != -1){
+        close(shard->active_fd);
+    }
+    shard->active_fd = fd;
+    shard->active_segment = shard->last_segment;
+    shard->active_size = 0;
+    return true;
+}
+
+static bool pwritev_all(int fd, struct iovec * iov, int iovcnt, uint64_t offset){
+    while (iovcnt > 0){
+        if (iov->iov_len == 0){
+            iov++;
+            iovcnt--;
+            continue;
+        }
+        ssize_t written = pwritev(fd, iov, iovcnt, (off_t) offset);
+        if (written == -1){
+            if (errno == EINTR){
+                continue;
+            }
+            return false;
+        }
+        offset += written;
+        while (iovcnt > 0 && (size_t) written >= iov->iov_len){
+            written -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0){
+            iov->iov_base = (uint8_t *) iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+    return true;
+}
+
+static bool append_raw(LogStore self, _Shard_t * shard, struct iovec * iov, int iovcnt, size_t len,
+                       uint32_t * segment, uint64_t * offset){
+    if (shard->active_size > 0 && shard->active_size + len > self->segment_size && ! roll_segment(shard)){
+        return false;
+    }
+    if (! pwritev_all(shard->active_fd, iov, iovcnt, shard->active_size)){
+        return false;
+    }
+    * segment           = shard->active_segment;
+    * offset            = shard->active_size;
+    shard->active_size += len;
+    return true;
+}
+
+static bool append_entry(_Shard_t * shard, const char * mailbox, const LogStoreEntry * entry){
+    char name[MAX_FILE_NAME + 1];
+    snprintf(name, sizeof(name), "%s" INDEX_SUFFIX, mailbox);
+    int fd = openat(shard->dir_fd, name, O_CREAT | O_WRONLY | O_APPEND | O_CLOEXEC, LOGSTORE_FILE_PERMISSIONS);
+    if (fd == -1){
+        return false;
+    }
+    bool ok = write(fd, entry, sizeof(* entry)) == (ssize_t) sizeof(* entry);
+    close(fd);
+    return ok;
+}
+
+static bool read_index(_Shard_t * shard, const char * name, LogStoreEntry ** entries, size_t * qty){
+    int fd = openat(shard->dir_fd, name, O_RDONLY | O_CLOEXEC);
+    if (fd == -1){
+        return false;
+    }
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    * qty       = ok ? (size_t) st.st_size / sizeof(LogStoreEntry) : 0;
+    * entries   = ok ? malloc(* qty * sizeof(LogStoreEntry) + 1) : NULL;
+    ok = * entries != NULL &&
+         pread(fd, * entries, * qty * sizeof(LogStoreEntry), 0) == (ssize_t) (* qty * sizeof(LogStoreEntry));
+    close(fd);
+    if (! ok){
+        free(* entries);
+        * entries = NULL;
+    }
+    return ok;
+}
+
+static bool load_indexes(_Shard_t * shard, _Index_t ** indexes, size_t * qty){
+    DIR * dir = fdopendir(dup(shard->dir_fd));
+    if (dir == NULL){
+        return false;
+    }
+    rewinddir(dir);     // The duplicate shares its position with the shard's descriptor
+    bool ok = true;
+    struct dirent * ent;
+    while (ok && (ent = readdir(dir)) != NULL){
+        size_t name_len = strlen(ent->d_name);
+        if (name_len <= strlen(INDEX_SUFFIX) || strcmp(ent->d_name + name_len - strlen(INDEX_SUFFIX), INDEX_SUFFIX) != 0){
+            continue;
+        }
+        _Index_t * new_indexes = realloc(* indexes, (* qty + 1) * sizeof(_Index_t));
+        if (new_indexes == NULL){
+            ok = false;
+            continue;
+        }
+        * indexes = new_indexes;
+        _Index_t * index = &((* indexes)[* qty]);
+        memcpy(index->name, ent->d_name, name_len + 1);
+        index->dirty    = false;
+        index->live     = 0;
+        if (! (ok = read_index(shard, index->name, &(index->entries), &(index->qty)))){
+            continue;
+        }
+        (* qty)++;
+
+        /* Deleted entries are dropped whenever an index is rewritten */
+        for (size_t i = 0; i < index->qty; i++){
+            if (index->entries[i].flags & LOGSTORE_FLAG_DELETED){
+                index->dirty = true;
+            }
+        }
+    }
+    closedir(dir);
+    return ok;
+}
+
+static bool write_index(_Shard_t * shard, const char * name, const LogStoreEntry * entries, size_t qty,
+                        uint32_t victim, const _Reloc_t * relocs, size_t reloc_qty, size_t * live){
+    LogStoreEntry * out = malloc(qty * sizeof(LogStoreEntry) + 1);
+    if (out == NULL){
+        return false;
+    }
+    * live = 0;
+    for (size_t i = 0; i < qty; i++){
+        LogStoreEntry entry = entries[i];
+        if (entry.flags & LOGSTORE_FLAG_DELETED){
+            continue;
+        }
+        if (entry.segment == victim){
+            size_t r = 0;
+            while (r < reloc_qty && relocs[r].old_offset != entry.offset){
+                r++;
+            }
+            if (r == reloc_qty){
+                free(out);
+                return false;       // Not relocated: the victim must stay
+            }
+            entry.segment   = relocs[r].new_segment;
+            entry.offset    = relocs[r].new_offset;
+        }
+        out[(* live)++] = entry;
+    }
+
+    bool ok = true;
+    if (* live > 0){
+        char tmp_name[MAX_FILE_NAME + sizeof(INDEX_TMP_SUFFIX)];
+        snprintf(tmp_name, sizeof(tmp_name), "%s" INDEX_TMP_SUFFIX, name);
+        int fd = openat(shard->dir_fd, tmp_name, O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, LOGSTORE_FILE_PERMISSIONS);
+        struct iovec iov = { .iov_base = out, .iov_len = * live * sizeof(LogStoreEntry) };
+        ok = fd != -1 && pwritev_all(fd, &iov, 1, 0);
+        if (fd != -1){
+            close(fd);
+        }
+        if (! ok){
+            unlinkat(shard->dir_fd, tmp_name, 0);
+        }
+    }
+    free(out);
+    return ok;
+}
+
+static bool swap_index(_Shard_t * shard, _Index_t * index, uint32_t victim, const _Reloc_t * relocs, size_t reloc_qty){
+    char tmp_name[MAX_FILE_NAME + sizeof(INDEX_TMP_SUFFIX)];
+    snprintf(tmp_name, sizeof(tmp_name), "%s" INDEX_TMP_SUFFIX, index->name);
+
+    /* Rewrite it again if it changed since it was loaded (new entries never point to the victim) */
+    LogStoreEntry * entries;
+    size_t qty;
+    if (! read_index(shard, index->name, &entries, &qty)){
+        return false;
+    }
+    bool ok = true;
+    if (qty != index->qty || memcmp(entries, index->entries, qty * sizeof(LogStoreEntry)) != 0){
+        ok = write_index(shard, index->name, entries, qty, victim, relocs, reloc_qty, &(index->live));
+    }
+    free(entries);
+    if (! ok){
+        return false;
+    }
+
+    if (index->live == 0){
+        unlinkat(shard->dir_fd, tmp_name, 0);
+        return unlinkat(shard->dir_fd, index->name, 0) == 0;
+    }
+    if (renameat(shard->dir_fd, tmp_name, shard->dir_fd, index->name) == -1){
+        unlinkat(shard->dir_fd, tmp_name, 0);
+        return false;
+    }
+    return true;
+}
+
+static void * compactor_main(void * arg){
+    LogStore self = arg;
+    while (! should_stop(self)){
+        /* Wait for the next run (or for a stop request) */
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += self->compact_interval;
+        pthread_mutex_lock(&self->stop_lock);
+        while (! self->stop && pthread_cond_timedwait(&self->stop_cond, &self->stop_lock, &deadline) != ETIMEDOUT);
+        pthread_mutex_unlock(&self->stop_lock);
+
+        for (unsigned i = 0; i < self->shard_qty && ! should_stop(self); i++){
+            while (LogStore_compact(self, i) && ! should_stop(self));
+        }
+    }
+    return NULL;
+}
+
+static bool should_stop(LogStore self){
+    pthread_mutex_lock(&self->stop_lock);
+    bool stop = self->stop;
+    pthread_mutex_unlock(&self->stop_lock);
+    return stop;
+}
@@ -0,0 +1,143 @@
+/**
+ * \file        logstore.h
+ * \brief       Log-structured message store: messages are appended to large
+ *              per-shard segment files, and every mailbox keeps a compact index
+ *              of the messages it holds.
+ *
+ * \details     Layout under the root directory:
+ *
+ *                  <root>/<shard>/<segment>.seg    Segment files (append only).
+ *                  <root>/<shard>/<mailbox>.idx    Mailbox indexes.
+ *
+ *              Mailboxes ("user@domain") are assigned to one of the shards by hash.
+ *              A message delivered to several mailboxes of the same shard is written
+ *              only once; each mailbox index points to the same record. Once the
+ *              active segment of a shard reaches the segment size, a new one is
+ *              started, so the amount of files is bounded by the amount of mailboxes
+ *              plus the amount of segments.
+ *
+ *              Deleting a message only marks its index entry. Compaction copies the
+ *              records that are still referenced out of mostly-dead segments into a new
+ *              segment, rewrites the affected indexes and removes the old segment files.
+ *              It runs on a background thread. Sealed segments are never written to, so
+ *              the copy and the new indexes are made without locking the shard, which
+ *              is only locked to swap the new indexes in: appends are not held up while
+ *              a shard compacts.
+ *
+ *              Segment record:     magic (4) | sender length (4) | body length (4) |
+ *                                  reserved (4) | message id (8) | sender | body
+ *              Index entry:        `LogStoreEntry`, in host byte order.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __LOGSTORE_H__
+#define __LOGSTORE_H__
+
+#include <stddef.h>         // size_t
+#include <stdint.h>         // uint32_t, uint64_t
+#include <stdbool.h>        // bool
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Default amount of shards */
+#define LOGSTORE_DEFAULT_SHARDS         16
+
+/* Default segment size in bytes. Messages are never split, so segments may grow slightly larger */
+#define LOGSTORE_DEFAULT_SEGMENT_SIZE   (64 * 1024 * 1024)
+
+/* Sealed segments whose live data is below this percentage are compacted */
+#define LOGSTORE_COMPACT_LIVE_PERCENT   50
+
+/* Seconds between background compaction runs */
+#define LOGSTORE_COMPACT_INTERVAL       60
+
+/* Permissions used for directories and files created by the store */
+#define LOGSTORE_DIR_PERMISSIONS        0770
+#define LOGSTORE_FILE_PERMISSIONS       0660
+
+/*************************************************************************/
+
+/**
+ * \typedef     LogStore: Main Log-Structured Store ADT data type.
+ */
+typedef struct _LogStore_t * LogStore;
+
+/**
+ * \typedef     LogStoreEntry: Index entry of a message in a mailbox.
+ */
+typedef struct {
+    uint64_t    msgid;          // Message id.
+    uint32_t    segment;        // Segment number within the mailbox's shard.
+    uint32_t    flags;          // LOGSTORE_FLAG_* bits.
+    uint64_t    offset;         // Offset of the record within the segment.
+    uint32_t    length;         // Length of the whole record (header included).
+    uint32_t    reserved;
+} LogStoreEntry;
+
+#define LOGSTORE_FLAG_DELETED   0x01
+
+/*************************************************************************/
+
+/**
+ * \brief       Open (creating it if needed) the store rooted at `root`.
+ *
+ * \param[in] root          Root directory. The string is internally copied.
+ * \param[in] shards        Amount of shards. 0 means `LOGSTORE_DEFAULT_SHARDS`. Must
+ *                          remain the same for the lifetime of the store.
+ * \param[in] segment_size  Segment size in bytes. 0 means `LOGSTORE_DEFAULT_SEGMENT_SIZE`.
+ *
+ * \return      A new LogStore on success, NULL on failure (errno is set accordingly).
+ */
+LogStore LogStore_open(const char * root, unsigned shards, size_t segment_size);
+
+/**
+ * \brief       Append a message and add it to the index of every mailbox.
+ *
+ * \param[in]  self         The LogStore itself.
+ * \param[in]  sender       Sender address.
+ * \param[in]  body         Message contents.
+ * \param[in]  len          Length of the message contents.
+ * \param[in]  mailboxes    Mailboxes ("user@domain") the message is delivered to.
+ * \param[in]  qty          Amount of mailboxes.
+ * \param[out] msgid        Id assigned to the message. May be NULL.
+ *
+ * \return      true on success, false on failure.
+ */
+bool LogStore_append(LogStore const self, const char * sender, const void * body, size_t len,
+                     const char * const * mailboxes, size_t qty, uint64_t * msgid);
+
+/**
+ * \brief       Mark a message of a mailbox as deleted. Its space is reclaimed by compaction.
+ *
+ * \return      true on success, false if the message was not found or on I/O error.
+ */
+bool LogStore_delete(LogStore const self, const char * mailbox, uint64_t msgid);
+
+/**
+ * \brief       Compact at most one segment of a shard. Does nothing if the shard is already
+ *              being compacted.
+ *
+ * \return      true if a segment was reclaimed, false otherwise.
+ */
+bool LogStore_compact(LogStore const self, unsigned shard);
+
+/**
+ * \brief       Start compacting every shard on a background thread, every `interval`
+ *              seconds (0 means `LOGSTORE_COMPACT_INTERVAL`).
+ *
+ * \return      true on success, false if the thread could not be started.
+ */
+bool LogStore_start_compactor(LogStore const self, unsigned interval);
+
+/**
+ * \brief       Stop the background compactor, close every file and free all memory.
+ *
+ * \param[in] self          The LogStore itself. NULL-safe.
+ */
+void LogStore_close(LogStore self);
+
+#endif // __LOGSTORE_H__
@@ -10,7 +10,7 @@
 
 #include "manager_parser.h"
 
-bool manager_parse(const uint8_t *buff, size_t len, MngrCommand *cmd) {
+bool manager_parse(const uint8_t *buff, size_t len, MngrRequest *req) {
     // Check for minimum length required for a valid message
     if (len < 15) { // Minimum message length is 15 bytes
         return false;
@@ -21,12 +21,11 @@ bool manager_parse(const uint8_t *buff, size_t len, MngrCommand *cmd) {
         return false; // Invalid protocol signature
     }
 
-    if (buff[2] != PROTOCOL_VERSION) {
+    if (buff[2] != PROTOCOL_VERSION && buff[2] != PROTOCOL_VERSION_TLV) {
         return false; // Invalid protocol version
     }
-
-    //uint16_t identifier = (buff[3] << 8) | buff[4];
-    // Check identifier if needed for your protocol
+    req->version = buff[2];
+    req->identifier = (buff[3] << 8) | buff[4];
 
     uint8_t expected_auth[8] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
     if (memcmp(buff + 5, expected_auth, 8) != 0) {
@@ -36,6 +35,36 @@ bool manager_parse(const uint8_t *buff, size_t len, MngrCommand *cmd) {
     // Extract the command byte
     uint8_t command_byte = buff[13]; // Command is located at byte 13
 
+    // Version 0x01: a command, and the count and list of types (and values) at byte 14 onwards
+    if (req->version == PROTOCOL_VERSION_TLV) {
+        if (command_byte != TLV_CMD_GET && command_byte != TLV_CMD_SET) {
+            return false; // Unsupported command
+        }
+        req->tlv_cmd = (MngrTlvCommand)command_byte;
+        req->type_qty = buff[14];
+        size_t pos = 15;
+        for (size_t i = 0; i < req->type_qty; i++) {
+            if (len < pos + 2) {
+                return false; // Fewer types than announced
+            }
+            req->types[i] = (buff[pos] << 8) | buff[pos + 1];
+            pos += 2;
+            if (req->tlv_cmd == TLV_CMD_GET) {
+                continue;
+            }
+            // TLV_CMD_SET: the length and value of every type
+            if (len < pos + 1 || buff[pos] > 8 || len < pos + 1 + buff[pos]) {
+                return false; // Truncated or too long value
+            }
+            req->values[i] = 0;
+            for (uint8_t j = 0; j < buff[pos]; j++) {
+                req->values[i] = (req->values[i] << 8) | buff[pos + 1 + j];
+            }
+            pos += 1 + buff[pos];
+        }
+        return true;
+    }
+
     // Validate and assign the command
     switch (command_byte) {
         case CMD_CONEX_HISTORICAS:
@@ -44,7 +73,16 @@ bool manager_parse(const uint8_t *buff, size_t len, MngrCommand *cmd) {
         case CMD_ESTADO_TRANSFORMACIONES:
         case CMD_TRANSFORMACIONES_ON:
         case CMD_TRANSFORMACIONES_OFF:
-            *cmd = (MngrCommand)command_byte;
+        case CMD_VRFY_RELOAD:
+        case CMD_BUFFERS_EN_USO:
+        case CMD_BUFFERS_RESERVADOS:
+        case CMD_CONEX_MAXIMAS:
+        case CMD_LATENCIA_P50:
+        case CMD_LATENCIA_P90:
+        case CMD_LATENCIA_P99:
+        case CMD_LATENCIA_P999:
+            req->cmd = (MngrCommand)command_byte;
+            req->arg = buff[14]; // Argument is located at byte 14
             return true;
         default:
             return false; // Unsupported command
@@ -21,14 +21,30 @@
 /***********************************************************************/
 
 /**
- * \brief       Parse a command from the manager.
+ * \typedef     MngrRequest: A parsed manager request, of either protocol version.
+ */
+typedef struct {
+    uint8_t         version;                // PROTOCOL_VERSION or PROTOCOL_VERSION_TLV
+    uint16_t        identifier;
+    MngrCommand     cmd;                    // Version 0x00 only
+    uint8_t         arg;                    // Version 0x00 only
+    MngrTlvCommand  tlv_cmd;                // Version 0x01 only
+    size_t          type_qty;               // Version 0x01 only: 0 for all types
+    uint16_t        types[TLV_MAX_TYPES];   // Version 0x01 only
+    uint64_t        values[TLV_MAX_TYPES];  // Version 0x01 only: new values, for TLV_CMD_SET
+} MngrRequest;
+
+/***********************************************************************/
+
+/**
+ * \brief       Parse a request from the manager.
  * 
  * \param[in]  buff     Buffer to read the message from.
  * \param[in]  len      Length of the data present in the buffer.
- * \param[out] cmd      Pointer to store the parsed command.
+ * \param[out] req      Pointer to store the parsed request.
  * 
  * \return      true on success, false otherwise.
  */
-bool manager_parse (const uint8_t * __restrict__ buff, size_t len, MngrCommand * const cmd);
+bool manager_parse (const uint8_t * __restrict__ buff, size_t len, MngrRequest * const req);
 
 #endif // __MANAGER_PARSER_H__
@@ -0,0 +1,335 @@
+/**
+ * \file        metrics.c
+ * \brief       Statistics (see stats.h) served over HTTP in the Prometheus text exposition
+ *              format, for monitoring systems to scrape.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <errno.h>          // errno, EAGAIN, EWOULDBLOCK, EINTR
+#include <inttypes.h>       // PRIu64
+#include <stdarg.h>         // va_list
+#include <stdio.h>          // vsnprintf()
+#include <stdlib.h>         // malloc(), realloc(), free()
+#include <string.h>         // memcpy(), strncmp(), strstr()
+#include <sys/socket.h>     // recv(), send()
+
+#include "metrics.h"
+#include "../lib/clock.h"   // Clock_ns()
+
+/* Room left before the body of every response, for its header */
+#define HEADER_RESERVE      256
+
+#define RESPONSE_HEADER                                                     \
+    "HTTP/1.1 200 OK\r\n"                                                   \
+    "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"            \
+    "Content-Length: %zu\r\n"                                               \
+    "Connection: close\r\n"                                                 \
+    "\r\n"
+
+#define ERROR_RESPONSE(STATUS)                                              \
+    "HTTP/1.1 " STATUS "\r\n"                                               \
+    "Content-Type: text/plain; charset=utf-8\r\n"                           \
+    "Content-Length: 0\r\n"                                                 \
+    "Connection: close\r\n"                                                 \
+    "\r\n"
+
+static const char bad_request[]         = ERROR_RESPONSE("400 Bad Request");
+static const char not_found[]           = ERROR_RESPONSE("404 Not Found");
+static const char method_not_allowed[]  = ERROR_RESPONSE("405 Method Not Allowed");
+static const char server_error[]        = ERROR_RESPONSE("500 Internal Server Error");
+
+/* Quantiles of every distribution, as rendered and as percentiles */
+static const struct { const char * label; double percentile; } quantiles[] = {
+    { "0.5", 50 }, { "0.9", 90 }, { "0.99", 99 }, { "0.999", 99.9 },
+};
+
+typedef struct {
+    int             fd;                                 // Scraper connection, -1 if the slot is free.
+    uint64_t        accepted;                           // Accept time (Clock_ns).
+    char            request[METRICS_REQUEST_SIZE + 1];  // Request received so far (NUL-terminated).
+    size_t          request_len;
+    char *          buff;                               // Response buffer, reused by every scrape.
+    size_t          buff_size;
+    const char *    reply;                              // Response (inside `buff`, or static).
+    size_t          reply_len;
+    size_t          sent;
+} _Scraper_t;
+
+typedef struct _Metrics_t {
+    Stats       stats;
+    _Scraper_t  scrapers[METRICS_MAX_SCRAPERS];
+} _Metrics_t;
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+/**
+ * \brief       Slot of a scraper connection, NULL if it has none.
+ */
+static _Scraper_t * find(Metrics self, int fd);
+
+/**
+ * \brief       Slot of the oldest scraper whose request is incomplete, NULL if there is none.
+ */
+static _Scraper_t * find_idle(Metrics self);
+
+/**
+ * \brief       Render the response to a complete request into the scraper's buffer.
+ */
+static void respond(Metrics self, _Scraper_t * scraper);
+
+/**
+ * \brief       Append formatted text to `buff`, as snprintf (3) would at offset `* len`,
+ *              adding the length of the text to `* len` even if it does not fit.
+ */
+static void append(char * buff, size_t size, size_t * len, const char * fmt, ...);
+
+/**
+ * \brief       Append a value of a distribution, converting nanoseconds to seconds.
+ */
+static void append_value(char * buff, size_t size, size_t * len, uint64_t value, bool ns);
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+Metrics Metrics_create(Stats stats){
+    Metrics self = malloc(sizeof(_Metrics_t));
+    if (self == NULL){
+        return NULL;
+    }
+    self->stats = stats;
+    bool ok = true;
+    for (size_t i = 0; i < METRICS_MAX_SCRAPERS; i++){
+        _Scraper_t * scraper = &(self->scrapers[i]);
+        scraper->fd = -1;
+        scraper->buff_size = METRICS_RESPONSE_SIZE;
+        ok = (scraper->buff = malloc(scraper->buff_size)) != NULL && ok;
+    }
+    if (! ok){
+        Metrics_cleanup(self);
+        return NULL;
+    }
+    return self;
+}
+
+bool Metrics_open(Metrics const self, int fd, int * evicted){
+    * evicted = -1;
+    if (self == NULL){
+        return false;
+    }
+    _Scraper_t * scraper = find(self, -1);
+    if (scraper == NULL){
+        /* Idle or slow scrapers must not lock out the rest: take over the oldest one */
+        if ((scraper = find_idle(self)) == NULL){
+            Stats_increment(self->stats, STATKEY_SCRAPERS_REFUSED);
+            return false;
+        }
+        * evicted = scraper->fd;
+        Stats_increment(self->stats, STATKEY_SCRAPERS_EVICTED);
+    }
+    scraper->fd = fd;
+    scraper->accepted = Clock_ns();
+    scraper->request_len = 0;
+    scraper->reply = NULL;
+    scraper->reply_len = scraper->sent = 0;
+    return true;
+}
+
+MetricsStatus Metrics_read(Metrics const self, int fd){
+    _Scraper_t * scraper = self == NULL ? NULL : find(self, fd);
+    if (scraper == NULL){
+        return METRICS_CLOSE;
+    }
+    ssize_t bytes;
+    do {
+        bytes = recv(fd, scraper->request + scraper->request_len,
+                     METRICS_REQUEST_SIZE - scraper->request_len, MSG_DONTWAIT);
+    } while (bytes < 0 && errno == EINTR);
+    if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+        return METRICS_WAIT;
+    }
+    if (bytes <= 0){
+        return METRICS_CLOSE;
+    }
+    scraper->request_len += bytes;
+    scraper->request[scraper->request_len] = '\0';
+
+    /* Wait for the blank line that ends the headers, unless there is no room left */
+    if (strstr(scraper->request, "\r\n\r\n") == NULL && strstr(scraper->request, "\n\n") == NULL){
+        if (scraper->request_len < METRICS_REQUEST_SIZE){
+            return METRICS_WAIT;
+        }
+        scraper->reply = bad_request;
+        scraper->reply_len = sizeof(bad_request) - 1;
+        return METRICS_REPLY;
+    }
+    respond(self, scraper);
+    return METRICS_REPLY;
+}
+
+MetricsStatus Metrics_write(Metrics const self, int fd){
+    _Scraper_t * scraper = self == NULL ? NULL : find(self, fd);
+    if (scraper == NULL || scraper->reply == NULL){
+        return METRICS_CLOSE;
+    }
+    ssize_t bytes;
+    do {
+        bytes = send(fd, scraper->reply + scraper->sent, scraper->reply_len - scraper->sent,
+                     MSG_DONTWAIT | MSG_NOSIGNAL);
+    } while (bytes < 0 && errno == EINTR);
+    if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+        return METRICS_WAIT;
+    }
+    if (bytes < 0){
+        return METRICS_CLOSE;
+    }
+    scraper->sent += bytes;
+    return scraper->sent < scraper->reply_len ? METRICS_WAIT : METRICS_CLOSE;
+}
+
+void Metrics_close(Metrics const self, int fd){
+    _Scraper_t * scraper = self == NULL || fd < 0 ? NULL : find(self, fd);
+    if (scraper != NULL){
+        scraper->fd = -1;
+    }
+}
+
+size_t Metrics_render(Stats const stats, char * buff, size_t size){
+    size_t len = 0;
+    if (size > 0){
+        buff[0] = '\0';
+    }
+
+    for (StatKey key = 0; key < STATKEY_QTY; key++){
+        StatVal val = 0;
+        Stats_get(stats, key, &val);
+        const char * name = Stats_name(key);
+        const char * suffix = Stats_is_gauge(key) ? "" : "_total";
+        append(buff, size, &len, "# HELP " METRICS_PREFIX "%s%s %s\n", name, suffix, Stats_description(key));
+        append(buff, size, &len, "# TYPE " METRICS_PREFIX "%s%s %s\n", name, suffix,
+               Stats_is_gauge(key) ? "gauge" : "counter");
+        append(buff, size, &len, METRICS_PREFIX "%s%s %ld\n", name, suffix, val);
+        if (Stats_is_gauge(key)){
+            Stats_get_max(stats, key, &val);
+            append(buff, size, &len, "# HELP " METRICS_PREFIX "%s_max Highest value of " METRICS_PREFIX "%s\n", name, name);
+            append(buff, size, &len, "# TYPE " METRICS_PREFIX "%s_max gauge\n", name);
+            append(buff, size, &len, METRICS_PREFIX "%s_max %ld\n", name, val);
+        }
+    }
+
+    for (HistKey key = 0; key < HISTKEY_QTY; key++){
+        const char * unit = Stats_hist_unit(key);
+        bool ns = strcmp(unit, "ns") == 0;
+        char name[128];
+        snprintf(name, sizeof(name), METRICS_PREFIX "%s%s", Stats_hist_name(key),
+                 ns ? "_seconds" : strcmp(unit, "bytes") == 0 ? "_bytes" : "");
+        append(buff, size, &len, "# HELP %s %s\n", name, Stats_hist_description(key));
+        append(buff, size, &len, "# TYPE %s summary\n", name);
+        StatVal val = 0, count = 0;
+        for (size_t i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); i++){
+            Stats_percentile(stats, key, quantiles[i].percentile, &val, &count);
+            append(buff, size, &len, "%s{quantile=\"%s\"} ", name, quantiles[i].label);
+            append_value(buff, size, &len, (uint64_t) val, ns);
+        }
+        Stats_sum(stats, key, &val);
+        append(buff, size, &len, "%s_sum ", name);
+        append_value(buff, size, &len, (uint64_t) val, ns);
+        append(buff, size, &len, "%s_count %ld\n", name, count);
+    }
+    return len;
+}
+
+void Metrics_cleanup(Metrics self){
+    if (self == NULL){
+        return;
+    }
+    for (size_t i = 0; i < METRICS_MAX_SCRAPERS; i++){
+        free(self->scrapers[i].buff);
+    }
+    free(self);
+}
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static _Scraper_t * find(Metrics self, int fd){
+    for (size_t i = 0; i < METRICS_MAX_SCRAPERS; i++){
+        if (self->scrapers[i].fd == fd){
+            return &(self->scrapers[i]);
+        }
+    }
+    return NULL;
+}
+
+static _Scraper_t * find_idle(Metrics self){
+    _Scraper_t * oldest = NULL;
+    for (size_t i = 0; i < METRICS_MAX_SCRAPERS; i++){
+        _Scraper_t * scraper = &(self->scrapers[i]);
+        if (scraper->fd != -1 && scraper->reply == NULL && (oldest == NULL || scraper->accepted < oldest->accepted)){
+            oldest = scraper;
+        }
+    }
+    return oldest;
+}
+
+static void respond(Metrics self, _Scraper_t * scraper){
+    const char * request = scraper->request;
+    bool head = strncmp(request, "HEAD ", 5) == 0;
+    if (! head && strncmp(request, "GET ", 4) != 0){
+        scraper->reply = method_not_allowed;
+        scraper->reply_len = sizeof(method_not_allowed) - 1;
+        return;
+    }
+    const char * path = request + (head ? 5 : 4);
+    if (strncmp(path, "/metrics", 8) != 0 || (path[8] != ' ' && path[8] != '?')){
+        scraper->reply = not_found;
+        scraper->reply_len = sizeof(not_found) - 1;
+        return;
+    }
+
+    /* Render the body after the room reserved for the header, growing the buffer if needed */
+    size_t len = Metrics_render(self->stats, scraper->buff + HEADER_RESERVE, scraper->buff_size - HEADER_RESERVE);
+    if (len >= scraper->buff_size - HEADER_RESERVE){
+        char * buff = realloc(scraper->buff, HEADER_RESERVE + len + 1);
+        if (buff == NULL){
+            scraper->reply = server_error;
+            scraper->reply_len = sizeof(server_error) - 1;
+            return;
+        }
+        scraper->buff = buff;
+        scraper->buff_size = HEADER_RESERVE + len + 1;
+        len = Metrics_render(self->stats, scraper->buff + HEADER_RESERVE, scraper->buff_size - HEADER_RESERVE);
+    }
+
+    /* Place the header right before the body, so that the response is contiguous */
+    char header[HEADER_RESERVE];
+    size_t header_len = (size_t) snprintf(header, sizeof(header), RESPONSE_HEADER, len);
+    char * reply = scraper->buff + HEADER_RESERVE - header_len;
+    memcpy(reply, header, header_len);
+    scraper->reply = reply;
+    scraper->reply_len = header_len + (head ? 0 : len);
+}
+
+static void append(char * buff, size_t size, size_t * len, const char * fmt, ...){
+    va_list args;
+    va_start(args, fmt);
+    int written = vsnprintf(* len < size ? buff + * len : NULL, * len < size ? size - * len : 0, fmt, args);
+    va_end(args);
+    if (written > 0){
+        * len += written;
+    }
+}
+
+static void append_value(char * buff, size_t size, size_t * len, uint64_t value, bool ns){
+    if (ns){
+        append(buff, size, len, "%" PRIu64 ".%09" PRIu64 "\n", value / 1000000000, value % 1000000000);
+    }
+    else{
+        append(buff, size, len, "%" PRIu64 "\n", value);
+    }
+}
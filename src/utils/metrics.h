@@ -0,0 +1,123 @@
+/**
+ * \file        metrics.h
+ * \brief       Statistics (see stats.h) served over HTTP in the Prometheus text exposition
+ *              format, for monitoring systems to scrape.
+ *
+ * \details     Scrapers connect to a local TCP listener and send `GET /metrics`. Every
+ *              counter, gauge (and its high-water mark) and distribution in STATS_CATALOGUE
+ *              and STATS_HISTOGRAMS is rendered, the latter as summaries with a few
+ *              quantiles. Latencies are converted to seconds, as Prometheus expects.
+ *
+ *              Scrapers are served from a fixed amount of slots, each with its own response
+ *              buffer, which is reused by every scrape (and only grows if the catalogue ever
+ *              outgrows it). Scraping therefore performs no memory allocation and never
+ *              competes with SMTP clients for memory.
+ *
+ *              Connections are closed after every response. When every slot is in use, a
+ *              new scraper takes over the slot of the oldest one that has not completed its
+ *              request yet (counted as evicted_scrapers), so that idle connections cannot
+ *              lock scrapers out. It is only refused (counted as refused_scrapers) if every
+ *              slot is busy replying.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+#include <stddef.h>         // size_t
+#include <stdbool.h>        // bool
+#include "stats.h"
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Prefix of every metric name */
+#define METRICS_PREFIX              "smtpd_"
+
+/* Scrapers served at the same time (see Metrics_open for what happens to more) */
+#define METRICS_MAX_SCRAPERS        4
+
+/* Longest request accepted, headers included */
+#define METRICS_REQUEST_SIZE        1024
+
+/* Initial size of every response buffer */
+#define METRICS_RESPONSE_SIZE       (32 * 1024)
+
+/*************************************************************************/
+
+/**
+ * \typedef     Metrics: Main Metrics ADT data type.
+ */
+typedef struct _Metrics_t * Metrics;
+
+/**
+ * \enum        MetricsStatus: What to do with a scraper connection after reading from or
+ *                             writing to it.
+ */
+typedef enum {
+    METRICS_WAIT,           // Wait for the socket to be ready again (same operation).
+    METRICS_REPLY,          // The request is complete: wait for the socket to be writable.
+    METRICS_CLOSE,          // The response was sent, or the connection failed: close it.
+} MetricsStatus;
+
+/*************************************************************************/
+
+/**
+ * \brief       Create the scraper slots and their response buffers.
+ *
+ * \param[in] stats         Statistics to serve.
+ *
+ * \return      A new Metrics on success, NULL on memory allocation error.
+ */
+Metrics Metrics_create(Stats stats);
+
+/**
+ * \brief       Assign a slot to a newly accepted scraper connection. If all slots are in
+ *              use, take over the slot of the oldest scraper whose request is incomplete.
+ *
+ * \param[out] evicted      The scraper that lost its slot, which the caller must close
+ *                          (its slot is already released), or -1 if none did.
+ *
+ * \return      `true` on success, `false` if all slots are in use by complete requests.
+ */
+bool Metrics_open(Metrics const self, int fd, int * evicted);
+
+/**
+ * \brief       Receive (part of) the request of a scraper, and render the response once it
+ *              is complete.
+ */
+MetricsStatus Metrics_read(Metrics const self, int fd);
+
+/**
+ * \brief       Send (part of) the response to a scraper.
+ */
+MetricsStatus Metrics_write(Metrics const self, int fd);
+
+/**
+ * \brief       Release the slot of a scraper connection. The connection itself is not closed.
+ */
+void Metrics_close(Metrics const self, int fd);
+
+/**
+ * \brief       Render all statistics in the Prometheus text exposition format.
+ *
+ * \param[in]  stats        Statistics to render.
+ * \param[out] buff         Where to render them. Always NUL-terminated if `size` > 0.
+ * \param[in]  size         Size of `buff`.
+ *
+ * \return      Length of the whole text, as in snprintf (3): if it is `size` or more, the
+ *              text was truncated.
+ */
+size_t Metrics_render(Stats const stats, char * buff, size_t size);
+
+/**
+ * \brief       Free all memory.
+ *
+ * \param[in] self          The Metrics itself. NULL-safe.
+ */
+void Metrics_cleanup(Metrics self);
+
+#endif // __METRICS_H__
@@ -6,9 +6,12 @@
 #include <regex.h>
 
 #include "parser.h"
-#include "vrfy.h"
+#include "vrfy_live.h"
+#include "rcpt_table.h"
+#include "stats.h"
 
 #define WELCOME_MSG "250-%s Welcome to the SMTP Server!\r\n"
+#define WELCOME_MSG_MAX_LEN 320
 #define HELO_GREETING_MSG "250-%s Hello %s\r\n"
 #define EHLO_GREETING_MSG "250-%s Hello %s\n250-TRFM - Triggers email transformation (if client allowed it)\r\n"
 
@@ -19,6 +22,7 @@
 #define VRFY_AMBIGUOUS_MSG "553-5.1.1-Ambiguous; Possibilities are:\n%s\r\n"
 #define VRFY_AMBIGUOUS_INIT_LINE "553-<"
 #define VRFY_OK_MSG "250-<%s>\r\n"
+#define VRFY_MAX_MATCHES 10
 #define NEED_MAIL_FROM "503-5.5.1 Bad Sequence of Commands. Need MAIL FROM\r\n"
 #define NEED_RCPT_TO "503-5.5.1 Bad Sequence of Commands. Need RCPT\r\n"
 #define MAIL_FROM_ALREADY_IN "503-5.5.1 Bad Sequence of Commands. Mail From has been already sent.\r\n"
@@ -30,6 +34,7 @@
 #define TRFM_ON_MSG "250 - Transformation turned on"
 #define TRFM_OFF_MSG "250 - Transformation turned off"
 #define GENERIC_OK_MSG "250 OK\r\n"
+#define RCPT_UNKNOWN_MSG "550 5.1.1 Mailbox unavailable: no such user here\r\n"
 
 #define IPV4_REGEX "(\\b25[0-5]|\\b2[0-4][0-9]|\\b[01]?[0-9][0-9]?)(\\.(25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)){3}"
 #define IPV6_REGEX "(([0-9a-fA-F]{1,4}:){7,7}[0-9a-fA-F]{1,4}|([0-9a-fA-F]{1,4}:){1,7}:|([0-9a-fA-F]{1,4}:){1,6}:[0-9a-fA-F]{1,4}|([0-9a-fA-F]{1,4}:){1,5}(:[0-9a-fA-F]{1,4}){1,2}|([0-9a-fA-F]{1,4}:){1,4}(:[0-9a-fA-F]{1,4}){1,3}|([0-9a-fA-F]{1,4}:){1,3}(:[0-9a-fA-F]{1,4}){1,4}|([0-9a-fA-F]{1,4}:){1,2}(:[0-9a-fA-F]{1,4}){1,5}|[0-9a-fA-F]{1,4}:((:[0-9a-fA-F]{1,4}){1,6})|:((:[0-9a-fA-F]{1,4}){1,7}|:)|fe80:(:[0-9a-fA-F]{0,4}){0,4}%[0-9a-zA-Z]{1,}|::(ffff(:0{1,4}){0,1}:){0,1}((25[0-5]|(2[0-4]|1{0,1}[0-9]){0,1}[0-9])\\.){3,3}(25[0-5]|(2[0-4]|1{0,1}[0-9]){0,1}[0-9])|([0-9a-fA-F]{1,4}:){1,4}:((25[0-5]|(2[0-4]|1{0,1}[0-9]){0,1}[0-9])\\.){3,3}(25[0-5]|(2[0-4]|1{0,1}[0-9]){0,1}[0-9]))"
@@ -75,7 +80,9 @@
 
 
 extern bool     vrfy_enabled;
-extern char     *vrfy_mails;
+extern VrfyLive vrfy_live;
+extern RcptTable rcpt_table;
+extern Stats    stats;
 
 char *strdup(const char *s);
 /**
@@ -116,7 +123,7 @@ static int welcomeEhloDomainTransition(Parser parser, char * command);
 static int greetingTransition(Parser parser, char * command);
 static int mailFromTransition(Parser parser, char * command);
 static int mailFromOkTransition(Parser parser, char * command);
-static int rcptToTransition(Parser parser, char * command);
+static int rcptToTransition(Parser parser, char * command, enum States rollback);
 static int rcptToOkTransition(Parser parser, char * command);
 static int dataTransition(Parser parser, char * command);
 static int vrfyTransition(Parser parser, char * command);
@@ -124,6 +131,9 @@ static int vrfyTransition(Parser parser, char * command);
 // Auxiliary function to free the command structure
 static void freeStruct(Parser parser);
 
+// Auxiliary function to free the status, unless it is the shared welcome message
+static void freeStatus(Parser parser);
+
 static void toUpperCmd(char * command);
 /**
  * Default state machine that the server receives, it should
@@ -136,11 +146,23 @@ struct StateMachine {
     enum Command loginState;
 };
 
+/**
+ * A parser and its state machine, allocated together.
+ */
+typedef struct ParserBlock {
+    _Parser_t parser;
+    struct StateMachine machine;
+} ParserBlock;
+
+/**
+ * Welcome message, formatted once for the first server domain and shared by
+ * every parser with that domain.
+ */
+static char welcomeMsg[WELCOME_MSG_MAX_LEN];
+static const char * welcomeDom = NULL;
+
 static int welcomeTransition(Parser parser, char * command) {
-    if(parser->status != NULL) {
-        free(parser->status);
-        parser->status = NULL;
-    }
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
     toUpperCmd(command);
 
@@ -199,10 +221,7 @@ static int welcomeTransition(Parser parser, char * command) {
 }
 
 static int welcomeHeloDomainTransition(Parser parser, char * command) {
-    if(parser->status != NULL) {
-        free(parser->status);
-        parser->status = NULL;
-    }
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
 
     if(command[0] == '\0' || command[0] == '\r' || command[0] == '\n') {
@@ -244,10 +263,7 @@ static int welcomeHeloDomainTransition(Parser parser, char * command) {
 }
 
 static int welcomeEhloDomainTransition(Parser parser, char * command) {
-    if(parser->status != NULL) {
-        free(parser->status);
-        parser->status = NULL;
-    }
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
 
     if(command[0] == '\0' || command[0] == '\r' || command[0] == '\n') {
@@ -291,10 +307,7 @@ static int welcomeEhloDomainTransition(Parser parser, char * command) {
 }
 
 static int greetingTransition(Parser parser, char * command) {
-    if(parser->status != NULL) {
-        free(parser->status);
-        parser->status = NULL;
-    }
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
     toUpperCmd(command);
 
@@ -393,32 +406,28 @@ static int greetingTransition(Parser parser, char * command) {
 }
 
 static int vrfyTransition(Parser parser, char * command) {
-    if(parser->status != NULL) {
-        free(parser->status);
-        parser->status = NULL;
-    }
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
 
-    char **result = NULL;
-    int count;
-    char parsedCmd[256] = {0};
-    for(int i=0; i<256 && command[i] != '\0' && command[i] != '\r'; i++) parsedCmd[i] = command[i];
+    char parsedCmd[VRFY_INDEX_MAX_ADDR_LEN + 1] = {0};
+    for(int i=0; i<VRFY_INDEX_MAX_ADDR_LEN && command[i] != '\0' && command[i] != '\r' && command[i] != '\n'; i++) parsedCmd[i] = command[i];
 
-    int res = vrfy(parsedCmd, vrfy_mails, &result, &count);
-    if(res == ERR) {
+    /* Matches belong to the index, which may only be replaced once it is released */
+    const char * result[VRFY_MAX_MATCHES];
+    VrfyIndex index = VrfyLive_acquire(vrfy_live);
+    size_t count = VrfyIndex_lookup(index, parsedCmd, result, VRFY_MAX_MATCHES);
+    if(count == 0) {
+        VrfyLive_release(vrfy_live);
         parser->status = strdup(VRFY_NOT_FOUND);
         parser->machine->currentState = parser->machine->priorState;
         parser->structure = malloc(sizeof(CommandStructure));
         parser->structure->cmd = VRFY;
         return ERR;
     }
-    char buff[1024];
+    char buff[VRFY_MAX_MATCHES * (VRFY_INDEX_MAX_ADDR_LEN + sizeof(VRFY_AMBIGUOUS_INIT_LINE) + 2)];
     if(count == 1) {
-        for(int i = 0; result[0][i] != '\0'; i++) {
-            if(result[0][i] == '\n') result[0][i] = '\0';
-        }
-        sprintf(buff, VRFY_OK_MSG, result[0]);
-        freeValidMails(result, count);
+        snprintf(buff, sizeof(buff), VRFY_OK_MSG, result[0]);
+        VrfyLive_release(vrfy_live);
         parser->status = strdup(buff);
         parser->machine->currentState = parser->machine->priorState;
         parser->structure = (CommandStructure *) malloc(sizeof(CommandStructure));
@@ -426,23 +435,17 @@ static int vrfyTransition(Parser parser, char * command) {
         return SUCCESS;
     }
 
+    /* Only the first VRFY_MAX_MATCHES possibilities are listed */
     int j = 0;
-    for(int i = 0; i < count ; i++) {
-        strcpy(buff + j, VRFY_AMBIGUOUS_INIT_LINE);
-        j += strlen(VRFY_AMBIGUOUS_INIT_LINE);
-        for(int k = 0; j<1024 && result[i][k] != '\n' ; j++, k++) {
-            buff[j] = result[i][k];
-        }
-        buff[j++] = '>';
-        buff[j++] = '\n';
+    for(size_t i = 0; i < count && i < VRFY_MAX_MATCHES; i++) {
+        j += sprintf(buff + j, VRFY_AMBIGUOUS_INIT_LINE "%s>\n", result[i]);
     }
+    VrfyLive_release(vrfy_live);
 
     buff[j-1] = '\0';
-    buff[j] = '\0';
-    char ret[1500] = {0};
-    sprintf(ret, VRFY_AMBIGUOUS_MSG, buff);
-    freeValidMails(result, count);
-    parser->status = strdup(ret);
+    char * ret = malloc(sizeof(VRFY_AMBIGUOUS_MSG) + j);
+    if(ret != NULL) sprintf(ret, VRFY_AMBIGUOUS_MSG, buff);
+    parser->status = ret;
     parser->machine->currentState = parser->machine->priorState;
     parser->structure = (CommandStructure *) malloc(sizeof(CommandStructure));
     parser->structure->cmd = VRFY;
@@ -450,10 +453,7 @@ static int vrfyTransition(Parser parser, char * command) {
 }
 
 static int mailFromTransition(Parser parser, char * command) {
-    if(parser->status != NULL) {
-        free(parser->status);
-        parser->status = NULL;
-    }
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
     toUpperCmd(command);
 
@@ -498,17 +498,14 @@ static int mailFromTransition(Parser parser, char * command) {
 }
 
 static int mailFromOkTransition(Parser parser, char * command) {
-    if(parser->status != NULL) {
-        free(parser->status);
-        parser->status = NULL;
-    }
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
     toUpperCmd(command);
 
     if((strncmp(command, RCPT_CMD, CMD_LEN) == SUCCESS) && command[CMD_LEN] == SPACE){
         char * mailArgs = command + CMD_LEN + 1;
         parser->machine->currentState = RCPT_TO_INPUT;
-        return rcptToTransition(parser, mailArgs);
+        return rcptToTransition(parser, mailArgs, MAIL_FROM_OK);
     }
     else if((strncmp(command, MAIL_CMD, CMD_LEN) == SUCCESS) && command[CMD_LEN] == SPACE){
         parser->machine->currentState = MAIL_FROM_OK;
@@ -598,11 +595,8 @@ static int mailFromOkTransition(Parser parser, char * command) {
     return ERR;
 }
 
-static int rcptToTransition(Parser parser, char * command) {
-    if(parser->status != NULL) {
-        free(parser->status);
-        parser->status = NULL;
-    }
+static int rcptToTransition(Parser parser, char * command, enum States rollback) {
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
 
     toUpperCmd(command);
@@ -611,7 +605,7 @@ static int rcptToTransition(Parser parser, char * command) {
         parser->status = strdup(PARAM_SYNTAX_ERROR_MSG);
         parser->structure = (CommandStructure *) malloc(sizeof(CommandStructure));
         parser->structure->cmd = ERROR;
-        parser->machine->currentState = MAIL_FROM_OK;
+        parser->machine->currentState = rollback;
         return ERR;
     }
 
@@ -626,18 +620,32 @@ static int rcptToTransition(Parser parser, char * command) {
         parser->status = strdup(PARAM_SYNTAX_ERROR_MSG);
         parser->structure = (CommandStructure *) malloc(sizeof(CommandStructure));
         parser->structure->cmd = ERROR;
-        parser->machine->currentState = MAIL_FROM_OK;
+        parser->machine->currentState = rollback;
         return ERR;
     }
 
     if(regexec(&mailRegex, parsedCmd, NO_FLAGS, NULL, NO_FLAGS) == REG_NOMATCH){
-        parser->machine->currentState = MAIL_FROM_OK;
+        parser->machine->currentState = rollback;
         parser->status = strdup(PARAM_SYNTAX_ERROR_MSG);
         parser->structure = malloc(sizeof(CommandStructure));
         parser->structure->cmd = ERROR;
         return ERR;
     }
 
+    /* Unknown local recipient: reject it before any contents are transferred */
+    if(rcpt_table != NULL) {
+        RcptResult found = RcptTable_lookup(rcpt_table, parsedCmd);
+        Stats_increment(stats, found == RCPT_KNOWN ? STATKEY_RCPT_HITS : STATKEY_RCPT_MISSES);
+        if(found == RCPT_UNKNOWN_CACHED) Stats_increment(stats, STATKEY_RCPT_NEG_HITS);
+        if(found != RCPT_KNOWN) {
+            parser->machine->currentState = rollback;
+            parser->status = strdup(RCPT_UNKNOWN_MSG);
+            parser->structure = malloc(sizeof(CommandStructure));
+            parser->structure->cmd = ERROR;
+            return ERR;
+        }
+    }
+
     parser->machine->currentState = RCPT_TO_OK;
     parser->status = strdup(GENERIC_OK_MSG);
     parser->structure = malloc(sizeof(CommandStructure));
@@ -648,10 +656,7 @@ static int rcptToTransition(Parser parser, char * command) {
 
 
 static int rcptToOkTransition(Parser parser, char * command) {
-    if(parser->status != NULL) {
-        free(parser->status);
-        parser->status = NULL;
-    }
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
     toUpperCmd(command);
     if((strncmp(command, DATA_CMD, CMD_LEN) == SUCCESS) && !(command[4] != '\n' && command[4] != '\r'  && command[4] != '\0')  ){
@@ -665,7 +670,7 @@ static int rcptToOkTransition(Parser parser, char * command) {
     else if((strncmp(command, RCPT_CMD, CMD_LEN) == SUCCESS) && command[CMD_LEN] == SPACE){
         char * mailArgs = command + CMD_LEN + 1;
         parser->machine->currentState = RCPT_TO_INPUT;
-        return rcptToTransition(parser, mailArgs);
+        return rcptToTransition(parser, mailArgs, RCPT_TO_OK);
     }
     else if((strncmp(command, MAIL_CMD, CMD_LEN) == SUCCESS) && command[CMD_LEN] == SPACE){
         parser->machine->currentState = RCPT_TO_OK;
@@ -750,10 +755,7 @@ static int rcptToOkTransition(Parser parser, char * command) {
 }
 
 static int dataTransition(Parser parser, char * command) {
-    if(parser->status != NULL) {
-        free(parser->status);
-        parser->status = NULL;
-    }
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
 
     if(strncmp(command, END_DATA, END_DATA_LEN) == SUCCESS) {
@@ -779,6 +781,11 @@ void toUpperCmd(char * command) {
     }
 }
 
+static void freeStatus(Parser parser) {
+    if(parser->status != NULL && parser->status != welcomeMsg) free(parser->status);
+    parser->status = NULL;
+}
+
 static void freeStruct(Parser parser) {
     if(parser->structure == NULL) return;
     switch(parser->structure->cmd){
@@ -811,14 +818,37 @@ int compileRegexes(void) {
  * for the parser.
  */
 Parser initParser(const char * serverDomain) {
-    StateMachinePtr sm = malloc(sizeof(struct StateMachine));
-    sm->currentState = WELCOME;
-    Parser parser = malloc(sizeof(_Parser_t));
-    parser->serverDom = strdup(serverDomain);
-    parser->machine = sm;
-    char buff[256] = {0};
-    sprintf(buff, WELCOME_MSG, parser->serverDom);
-    parser->status = strdup(buff);
+    void * mem = malloc(parserSize());
+    if(mem == NULL) return NULL;
+    return initParserAt(mem, serverDomain);
+}
+
+size_t parserSize(void) {
+    return sizeof(ParserBlock);
+}
+
+/**
+ * Initializes the parser and its State Machine in memory provided
+ * by the caller. The server domain is not copied.
+ */
+Parser initParserAt(void * mem, const char * serverDomain) {
+    ParserBlock * block = (ParserBlock *) mem;
+    Parser parser = &block->parser;
+    parser->machine = &block->machine;
+    parser->machine->currentState = WELCOME;
+    parser->serverDom = serverDomain;
+    if(welcomeDom == NULL || strcmp(welcomeDom, serverDomain) == SUCCESS) {
+        if(welcomeDom == NULL) {
+            snprintf(welcomeMsg, WELCOME_MSG_MAX_LEN, WELCOME_MSG, serverDomain);
+            welcomeDom = serverDomain;
+        }
+        parser->status = welcomeMsg;
+    }
+    else {
+        char buff[WELCOME_MSG_MAX_LEN] = {0};
+        snprintf(buff, WELCOME_MSG_MAX_LEN, WELCOME_MSG, serverDomain);
+        parser->status = strdup(buff);
+    }
     parser->structure = NULL;
     parser->transform = true;
     parser->vrfyAllowed = true;
@@ -901,9 +931,12 @@ void rollBack(Parser parser) {
  */
 void destroyParser(Parser parser) {
     if(parser == NULL) return;
-    free(parser->machine);
-    if(parser->status != NULL) free(parser->status);
+    finishParser(parser);
+    free(parser);       // The parser is the first member of its ParserBlock
+}
+
+void finishParser(Parser parser) {
+    if(parser == NULL) return;
+    freeStatus(parser);
     if(parser->structure != NULL) freeStruct(parser);
-    if(parser->serverDom != NULL) free(parser->serverDom);
-    free(parser);
 }
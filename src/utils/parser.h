@@ -2,6 +2,7 @@
 #define _PARSER_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #define ERR -1
 #define TERMINAL -2
@@ -51,7 +52,7 @@ typedef struct _Parser_t {
     StateMachinePtr machine;
     char * status;
     CommandStructure * structure;
-    char * serverDom;
+    const char * serverDom;     // Shared, not copied: must outlive the parser.
     bool transform;
     bool transformAllowed;
     bool vrfyAllowed;
@@ -74,10 +75,24 @@ typedef struct _Parser_t * Parser;
 int compileRegexes(void);
 
 /**
- * Allocates memory for the parser
+ * Allocates memory for the parser. The server domain is not copied,
+ * so it must outlive the parser.
  */
 Parser initParser(const char * serverDomain);
 
+/**
+ * Size of the memory needed by initParserAt.
+ */
+size_t parserSize(void);
+
+/**
+ * Initializes a parser in memory provided by the caller (at least
+ * parserSize() bytes, suitably aligned for any type), so that it can
+ * be allocated together with other data. No memory is allocated for
+ * the parser itself. Release it with finishParser.
+ */
+Parser initParserAt(void * mem, const char * serverDomain);
+
 /**
  * Parses a given string, ended in <CLRF> it will change
  * the inner state of the parser. It should be used one
@@ -119,4 +134,10 @@ void rollBack(Parser parser);
  */
 void destroyParser(Parser parser);
 
+/**
+ * Frees the inner state of a parser created by initParserAt,
+ * leaving its memory to the caller.
+ */
+void finishParser(Parser parser);
+
 #endif
@@ -0,0 +1,211 @@
+/**
+ * \file        rcpt_table.c
+ * \brief       Table of local recipients, checked when a client sends RCPT TO so that
+ *              mail for unknown users is rejected before any contents are transferred.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdio.h>          // FILE, fopen(), fread(), fclose()
+#include <stdlib.h>         // malloc(), calloc(), free()
+#include <stdint.h>         // uint32_t
+#include <string.h>         // strlen(), strcmp(), strdup(), memcpy()
+#include <ctype.h>          // tolower()
+#include <errno.h>          // errno
+#include <sys/stat.h>       // stat()
+
+#include "rcpt_table.h"
+#include "../lib/hash.h"
+
+/*************************************************************************/
+/* Private data structures                                               */
+/*************************************************************************/
+
+typedef struct {
+    uint32_t        hash;
+    const char *    addr;           // Points into the text of the file. NULL if empty.
+} _Slot_t;
+
+typedef struct {
+    uint32_t        hash;
+    char            addr[RCPT_TABLE_NEG_CACHE_ADDR_LEN + 1];   // Empty string if the slot is empty.
+} _NegSlot_t;
+
+typedef struct _RcptTable_t {
+    char *          text;           // Contents of the file (lowercased, one string per line).
+    _Slot_t *       slots;
+    size_t          mask;           // Amount of slots minus one.
+    size_t          count;
+    _NegSlot_t      neg_cache[RCPT_TABLE_NEG_CACHE_SLOTS];
+} _RcptTable_t;
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+/**
+ * \brief       Insert an address into the table, unless it is already there.
+ */
+static void insert(RcptTable self, const char * addr);
+
+/**
+ * \brief       Find the slot of an address (or the empty slot where it would go).
+ */
+static _Slot_t * find(RcptTable self, const char * addr, uint32_t hash);
+
+/**
+ * \brief       Split the text of the file into trimmed, lowercased, non-empty lines
+ *              (in place), calling `insert` for each of them if `self` is not NULL.
+ *
+ * \return      The amount of lines.
+ */
+static size_t split_lines(char * text, RcptTable self);
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+RcptTable RcptTable_load(const char * path){
+    if (path == NULL){
+        errno = EINVAL;
+        return NULL;
+    }
+    RcptTable self = calloc(1, sizeof(_RcptTable_t));
+    if (self == NULL){
+        return NULL;
+    }
+
+    /* Read the whole file */
+    FILE * file = fopen(path, "r");
+    struct stat st;
+    if (file == NULL || stat(path, &st) == -1 || (self->text = malloc((size_t) st.st_size + 1)) == NULL){
+        if (file != NULL){
+            fclose(file);
+        }
+        RcptTable_cleanup(self);
+        return NULL;
+    }
+    size_t len = fread(self->text, 1, (size_t) st.st_size, file);
+    fclose(file);
+    self->text[len] = '\0';
+
+    /* Count lines first, to size the table: at least twice as many slots as lines */
+    char * copy = strdup(self->text);
+    if (copy == NULL){
+        RcptTable_cleanup(self);
+        return NULL;
+    }
+    size_t lines = split_lines(copy, NULL);
+    free(copy);
+
+    size_t slot_qty = 1;
+    while (slot_qty < 2 * lines){
+        slot_qty <<= 1;
+    }
+    if ((self->slots = calloc(slot_qty, sizeof(_Slot_t))) == NULL){
+        RcptTable_cleanup(self);
+        return NULL;
+    }
+    self->mask = slot_qty - 1;
+    split_lines(self->text, self);
+    return self;
+}
+
+RcptResult RcptTable_lookup(RcptTable const self, const char * addr){
+    if (self == NULL || addr == NULL){
+        return RCPT_UNKNOWN;
+    }
+    char key[RCPT_TABLE_MAX_ADDR_LEN + 1];
+    size_t len = 0;
+    while (addr[len] != '\0'){
+        if (len == RCPT_TABLE_MAX_ADDR_LEN){
+            return RCPT_UNKNOWN;
+        }
+        key[len] = (char) tolower((unsigned char) addr[len]);
+        len++;
+    }
+    key[len] = '\0';
+    uint32_t hash = Hash_fnv1a(key);
+
+    /* Recently rejected recipient */
+    _NegSlot_t * neg = &(self->neg_cache[hash & (RCPT_TABLE_NEG_CACHE_SLOTS - 1)]);
+    if (neg->hash == hash && neg->addr[0] != '\0' && strcmp(neg->addr, key) == 0){
+        return RCPT_UNKNOWN_CACHED;
+    }
+
+    if (find(self, key, hash)->addr != NULL){
+        return RCPT_KNOWN;
+    }
+
+    /* Remember it, replacing whatever was cached in that slot */
+    if (len > 0 && len <= RCPT_TABLE_NEG_CACHE_ADDR_LEN){
+        memcpy(neg->addr, key, len + 1);
+        neg->hash = hash;
+    }
+    return RCPT_UNKNOWN;
+}
+
+size_t RcptTable_count(RcptTable const self){
+    return self == NULL ? 0 : self->count;
+}
+
+void RcptTable_cleanup(RcptTable self){
+    if (self == NULL){
+        return;
+    }
+    free(self->slots);
+    free(self->text);
+    free(self);
+}
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static void insert(RcptTable self, const char * addr){
+    uint32_t hash = Hash_fnv1a(addr);
+    _Slot_t * slot = find(self, addr, hash);
+    if (slot->addr == NULL){
+        slot->addr = addr;
+        slot->hash = hash;
+        self->count++;
+    }
+}
+
+static _Slot_t * find(RcptTable self, const char * addr, uint32_t hash){
+    size_t i = hash & self->mask;
+    while (self->slots[i].addr != NULL && (self->slots[i].hash != hash || strcmp(self->slots[i].addr, addr) != 0)){
+        i = (i + 1) & self->mask;
+    }
+    return &(self->slots[i]);
+}
+
+static size_t split_lines(char * text, RcptTable self){
+    size_t lines = 0;
+    char * line = text;
+    while (* line != '\0'){
+        char * end = line;
+        while (* end != '\n' && * end != '\0'){
+            * end = (char) tolower((unsigned char) * end);
+            end++;
+        }
+        char * next = * end == '\0' ? end : end + 1;
+        while (line < end && (* line == ' ' || * line == '\t')){
+            line++;
+        }
+        while (end > line && (end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')){
+            end--;
+        }
+        * end = '\0';
+
+        if (end > line && (size_t) (end - line) <= RCPT_TABLE_MAX_ADDR_LEN){
+            if (self != NULL){
+                insert(self, line);
+            }
+            lines++;
+        }
+        line = next;
+    }
+    return lines;
+}
@@ -0,0 +1,83 @@
+/**
+ * \file        rcpt_table.h
+ * \brief       Table of local recipients, checked when a client sends RCPT TO so that
+ *              mail for unknown users is rejected before any contents are transferred.
+ *
+ * \details     Recipients ("user@domain", one per line) are loaded from a file into an
+ *              open-addressing hash table. Addresses are compared case-insensitively.
+ *
+ *              Unknown recipients are remembered in a small direct-mapped negative
+ *              cache, so that the same nonexistent addresses being tried over and over
+ *              (as spammers do) are answered without probing the table.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __RCPT_TABLE_H__
+#define __RCPT_TABLE_H__
+
+#include <stddef.h>         // size_t
+#include <stdbool.h>        // bool
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Longest recipient accepted (longer lines are ignored) */
+#define RCPT_TABLE_MAX_ADDR_LEN     255
+
+/* Slots of the negative cache (a power of two) */
+#define RCPT_TABLE_NEG_CACHE_SLOTS  1024
+
+/* Longest recipient kept in the negative cache (longer ones are not cached). 59 makes every slot 64 bytes */
+#define RCPT_TABLE_NEG_CACHE_ADDR_LEN   59
+
+/*************************************************************************/
+
+/**
+ * \typedef     RcptTable: Main Recipient Table ADT data type.
+ */
+typedef struct _RcptTable_t * RcptTable;
+
+/**
+ * \enum        RcptResult: Result of a recipient lookup.
+ */
+typedef enum {
+    RCPT_KNOWN,             // Found in the table.
+    RCPT_UNKNOWN,           // Not found in the table.
+    RCPT_UNKNOWN_CACHED,    // Not found, answered by the negative cache.
+} RcptResult;
+
+/*************************************************************************/
+
+/**
+ * \brief       Load the recipients listed in `path` (one per line).
+ *
+ * \return      A new RcptTable on success, NULL on failure (errno is set accordingly).
+ */
+RcptTable RcptTable_load(const char * path);
+
+/**
+ * \brief       Look up a recipient.
+ *
+ * \param[in] self          The RcptTable itself.
+ * \param[in] addr          Recipient address ("user@domain").
+ *
+ * \return      Whether the recipient is known, and how the answer was found.
+ */
+RcptResult RcptTable_lookup(RcptTable const self, const char * addr);
+
+/**
+ * \brief       Amount of recipients in the table.
+ */
+size_t RcptTable_count(RcptTable const self);
+
+/**
+ * \brief       Free all memory.
+ *
+ * \param[in] self          The RcptTable itself. NULL-safe.
+ */
+void RcptTable_cleanup(RcptTable self);
+
+#endif // __RCPT_TABLE_H__
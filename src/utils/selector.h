@@ -4,7 +4,7 @@
  *              the same time, useful for non-blocking socket applications.
  *
  * \note        HashMap library is required.
- * \note        LinkedList library is required.
+ * \note        IList library is required.
  * \note        Exceptions header file is required.
  *
  * \date        June, 2024
@@ -18,7 +18,7 @@
 #include <sys/select.h>     // select()
 #include <unistd.h>         // close()
 #include "../lib/hashmap.h"
-#include "../lib/linkedlist.h"
+#include "../lib/ilist.h"
 #include "../lib/exceptions.h"
 
 /*************************************************************************/
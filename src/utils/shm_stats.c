@@ -0,0 +1,168 @@
+/**
+ * \file        shm_stats.c
+ * \brief       Statistics (see stats.h) published into a shared memory segment, so that
+ *              other processes can read them without any system call or round trip to the
+ *              server.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <errno.h>          // errno
+#include <fcntl.h>          // O_CREAT, O_RDWR, O_TRUNC
+#include <stddef.h>         // offsetof
+#include <stdio.h>          // snprintf()
+#include <stdlib.h>         // malloc(), free()
+#include <string.h>         // memcpy(), strncpy(), strchr()
+#include <sys/mman.h>       // shm_open(), shm_unlink(), mmap(), munmap()
+#include <time.h>           // clock_gettime()
+#include <unistd.h>         // ftruncate(), close(), getpid()
+
+#include "shm_stats.h"
+#include "../lib/clock.h"
+
+/* The layout is documented in shm_stats.h for other programs: keep it */
+_Static_assert(sizeof(ShmStatsHeader) == 72,                "ShmStatsHeader layout changed");
+_Static_assert(offsetof(ShmStatsHeader, seq) == 48,         "ShmStatsHeader layout changed");
+_Static_assert(sizeof(ShmStat) == 64,                       "ShmStat layout changed");
+_Static_assert(offsetof(ShmStat, value) == 48,              "ShmStat layout changed");
+_Static_assert(sizeof(ShmHist) == 104,                      "ShmHist layout changed");
+_Static_assert(offsetof(ShmHist, count) == 48,              "ShmHist layout changed");
+
+#define NS_PER_MS           1000000ULL
+#define SEGMENT_NAME_MAX    255         // As NAME_MAX, for files under /dev/shm
+
+typedef struct _ShmStats_t {
+    Stats               stats;
+    char                path[SEGMENT_NAME_MAX + 2];     // "/<name>", for shm_unlink (3)
+    ShmStatsHeader *    header;                         // Mapped segment
+    size_t              size;
+    ShmStat *           entries;
+    ShmHist *           hists;
+    uint64_t            last_ns;                        // Last publication (see Clock_ns)
+} _ShmStats_t;
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+ShmStats ShmStats_create(const char * name, Stats stats){
+    if (name == NULL || * name == '\0' || strchr(name, '/') != NULL || strlen(name) > SEGMENT_NAME_MAX){
+        errno = EINVAL;
+        return NULL;
+    }
+    ShmStats self = malloc(sizeof(_ShmStats_t));
+    if (self == NULL){
+        return NULL;
+    }
+    self->stats = stats;
+    snprintf(self->path, sizeof(self->path), "/%s", name);
+    size_t stat_offset = sizeof(ShmStatsHeader);
+    size_t hist_offset = stat_offset + STATKEY_QTY * sizeof(ShmStat);
+    self->size = hist_offset + HISTKEY_QTY * sizeof(ShmHist);
+
+    /* Create the segment, zero-filled, and map it */
+    int fd = shm_open(self->path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0){
+        free(self);
+        return NULL;
+    }
+    void * mem = MAP_FAILED;
+    if (ftruncate(fd, self->size) == 0){
+        mem = mmap(NULL, self->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int err = errno;
+    close(fd);
+    if (mem == MAP_FAILED){
+        shm_unlink(self->path);
+        free(self);
+        errno = err;
+        return NULL;
+    }
+    self->header = mem;
+    self->entries = (ShmStat *) ((char *) mem + stat_offset);
+    self->hists = (ShmHist *) ((char *) mem + hist_offset);
+
+    /* Everything but the values is written once */
+    memcpy(self->header->magic, SHM_STATS_MAGIC, sizeof(self->header->magic));
+    self->header->version = SHM_STATS_VERSION;
+    self->header->size = self->size;
+    self->header->stat_qty = STATKEY_QTY;
+    self->header->stat_offset = stat_offset;
+    self->header->stat_size = sizeof(ShmStat);
+    self->header->hist_qty = HISTKEY_QTY;
+    self->header->hist_offset = hist_offset;
+    self->header->hist_size = sizeof(ShmHist);
+    self->header->pid = (uint64_t) getpid();
+    for (StatKey key = 0; key < STATKEY_QTY; key++){
+        strncpy(self->entries[key].name, Stats_name(key), SHM_STATS_NAME_SIZE - 1);
+        self->entries[key].gauge = Stats_is_gauge(key);
+    }
+    for (HistKey key = 0; key < HISTKEY_QTY; key++){
+        strncpy(self->hists[key].name, Stats_hist_name(key), SHM_STATS_NAME_SIZE - 1);
+        strncpy(self->hists[key].unit, Stats_hist_unit(key), SHM_STATS_UNIT_SIZE - 1);
+    }
+    ShmStats_publish(self);
+    return self;
+}
+
+void ShmStats_tick(ShmStats const self){
+    if (self != NULL && Clock_ns() - self->last_ns >= SHM_STATS_INTERVAL_MS * NS_PER_MS){
+        ShmStats_publish(self);
+    }
+}
+
+void ShmStats_publish(ShmStats const self){
+    if (self == NULL){
+        return;
+    }
+    ShmStatsHeader * header = self->header;
+
+    /* Odd sequence number: readers retry until it is even again */
+    uint64_t seq = atomic_load_explicit(&(header->seq), memory_order_relaxed);
+    atomic_store_explicit(&(header->seq), seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (StatKey key = 0; key < STATKEY_QTY; key++){
+        StatVal val = 0;
+        Stats_get(self->stats, key, &val);
+        atomic_store_explicit(&(self->entries[key].value), val, memory_order_relaxed);
+        if (Stats_get_max(self->stats, key, &val)){
+            atomic_store_explicit(&(self->entries[key].max), val, memory_order_relaxed);
+        }
+    }
+    for (HistKey key = 0; key < HISTKEY_QTY; key++){
+        ShmHist * hist = &(self->hists[key]);
+        StatVal val = 0, count = 0;
+        Stats_percentile(self->stats, key, 50, &val, &count);
+        atomic_store_explicit(&(hist->p50), val, memory_order_relaxed);
+        atomic_store_explicit(&(hist->count), count, memory_order_relaxed);
+        Stats_percentile(self->stats, key, 90, &val, NULL);
+        atomic_store_explicit(&(hist->p90), val, memory_order_relaxed);
+        Stats_percentile(self->stats, key, 99, &val, NULL);
+        atomic_store_explicit(&(hist->p99), val, memory_order_relaxed);
+        Stats_percentile(self->stats, key, 99.9, &val, NULL);
+        atomic_store_explicit(&(hist->p999), val, memory_order_relaxed);
+        Stats_percentile(self->stats, key, 100, &val, NULL);
+        atomic_store_explicit(&(hist->max), val, memory_order_relaxed);
+        Stats_sum(self->stats, key, &val);
+        atomic_store_explicit(&(hist->sum), val, memory_order_relaxed);
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    atomic_store_explicit(&(header->published), (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec, memory_order_relaxed);
+    atomic_fetch_add_explicit(&(header->publications), 1, memory_order_relaxed);
+
+    atomic_store_explicit(&(header->seq), seq + 2, memory_order_release);
+    self->last_ns = Clock_ns();
+}
+
+void ShmStats_cleanup(ShmStats self){
+    if (self == NULL){
+        return;
+    }
+    munmap(self->header, self->size);
+    shm_unlink(self->path);
+    free(self);
+}
@@ -0,0 +1,169 @@
+/**
+ * \file        shm_stats.h
+ * \brief       Statistics (see stats.h) published into a shared memory segment, so that
+ *              other processes can read them without any system call or round trip to the
+ *              server.
+ *
+ * \details     The server periodically copies every statistic and a summary of every
+ *              distribution into the segment `/dev/shm/<name>` (see shm_overview (7)).
+ *              Readers map it read-only and copy whatever they need under a seqlock: the
+ *              event loop never waits for them, however often they read.
+ *
+ *              Segment layout (version 1). All integers are in native byte order; 64-bit
+ *              ones are 8-byte aligned and must be read with single 64-bit loads.
+ *
+ *                  Offset  Size  Field
+ *                  0       8     magic         "SMTPDSHM" (not NUL-terminated)
+ *                  8       4     version       SHM_STATS_VERSION
+ *                  12      4     size          Size of the whole segment
+ *                  16      4     stat_qty      Amount of statistic entries
+ *                  20      4     stat_offset   Offset of the first statistic entry
+ *                  24      4     stat_size     Size of every statistic entry
+ *                  28      4     hist_qty      Amount of distribution entries
+ *                  32      4     hist_offset   Offset of the first distribution entry
+ *                  36      4     hist_size     Size of every distribution entry
+ *                  40      8     pid           Process ID of the server
+ *                  48      8     seq           Sequence number (see below)
+ *                  56      8     published     Time of the last publication (ns since the epoch)
+ *                  64      8     publications  Amount of publications
+ *
+ *              Statistic entry (ShmStat, 64 bytes), as in STATS_CATALOGUE:
+ *
+ *                  0       40    name          NUL-terminated
+ *                  40      4     gauge         1 for gauges, 0 for counters
+ *                  44      4     (padding)
+ *                  48      8     value         Signed
+ *                  56      8     max           High-water mark (gauges only)
+ *
+ *              Distribution entry (ShmHist, 104 bytes), as in STATS_HISTOGRAMS:
+ *
+ *                  0       40    name          NUL-terminated
+ *                  40      8     unit          NUL-terminated ("ns", "bytes"...)
+ *                  48      8     count         Amount of values recorded
+ *                  56      8     sum           Sum of the values recorded
+ *                  64      8     max           Highest value recorded
+ *                  72      8     p50           50th percentile
+ *                  80      8     p90           90th percentile
+ *                  88      8     p99           99th percentile
+ *                  96      8     p999          99.9th percentile
+ *
+ *              Everything but `seq`, `published`, `publications` and the values of the
+ *              entries is written once, before the segment is first published. To take a
+ *              consistent snapshot, a reader:
+ *
+ *              1. Loads `seq` (acquire). If it is odd, the server is publishing: retry.
+ *              2. Copies the values it needs.
+ *              3. Issues an acquire fence and loads `seq` again. If it changed, retry.
+ *
+ *              Readers must check `magic` and `version`, and use the offsets and amounts
+ *              and sizes in the header rather than their own: later versions may only add
+ *              fields at the end of the header and of the entries. The segment is removed when the
+ *              server exits; a segment whose `pid` is not running is stale.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __SHM_STATS_H__
+#define __SHM_STATS_H__
+
+#include <stdatomic.h>      // _Atomic
+#include <stdint.h>         // uint32_t, uint64_t, int64_t
+#include "stats.h"
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Minimum time between publications, in milliseconds */
+#define SHM_STATS_INTERVAL_MS       100
+
+/*************************************************************************/
+
+#define SHM_STATS_MAGIC             "SMTPDSHM"
+#define SHM_STATS_VERSION           1
+#define SHM_STATS_NAME_SIZE         40
+#define SHM_STATS_UNIT_SIZE         8
+
+/**
+ * \typedef     ShmStatsHeader: Header of the segment (see layout above).
+ */
+typedef struct {
+    char                magic[8];
+    uint32_t            version;
+    uint32_t            size;
+    uint32_t            stat_qty;
+    uint32_t            stat_offset;
+    uint32_t            stat_size;
+    uint32_t            hist_qty;
+    uint32_t            hist_offset;
+    uint32_t            hist_size;
+    uint64_t            pid;
+    _Atomic uint64_t    seq;
+    _Atomic uint64_t    published;
+    _Atomic uint64_t    publications;
+} ShmStatsHeader;
+
+/**
+ * \typedef     ShmStat: Statistic entry (see layout above).
+ */
+typedef struct {
+    char                name[SHM_STATS_NAME_SIZE];
+    uint32_t            gauge;
+    uint32_t            _padding;
+    _Atomic int64_t     value;
+    _Atomic int64_t     max;
+} ShmStat;
+
+/**
+ * \typedef     ShmHist: Distribution entry (see layout above).
+ */
+typedef struct {
+    char                name[SHM_STATS_NAME_SIZE];
+    char                unit[SHM_STATS_UNIT_SIZE];
+    _Atomic uint64_t    count;
+    _Atomic uint64_t    sum;
+    _Atomic uint64_t    max;
+    _Atomic uint64_t    p50;
+    _Atomic uint64_t    p90;
+    _Atomic uint64_t    p99;
+    _Atomic uint64_t    p999;
+} ShmHist;
+
+/**
+ * \typedef     ShmStats: Main ShmStats ADT data type (the publishing side).
+ */
+typedef struct _ShmStats_t * ShmStats;
+
+/*************************************************************************/
+
+/**
+ * \brief       Create the segment `/dev/shm/<name>` (replacing any previous one), and
+ *              publish `stats` into it for the first time.
+ *
+ * \param[in] name          Segment name, without slashes.
+ * \param[in] stats         Statistics to publish.
+ *
+ * \return      A new ShmStats on success, NULL on failure (errno is set accordingly).
+ */
+ShmStats ShmStats_create(const char * name, Stats stats);
+
+/**
+ * \brief       Publish the statistics, if SHM_STATS_INTERVAL_MS have passed since the last
+ *              publication. Meant to be called on every event loop iteration. NULL-safe.
+ */
+void ShmStats_tick(ShmStats const self);
+
+/**
+ * \brief       Publish the statistics right away. NULL-safe.
+ */
+void ShmStats_publish(ShmStats const self);
+
+/**
+ * \brief       Remove the segment and free all memory.
+ *
+ * \param[in] self          The ShmStats itself. NULL-safe.
+ */
+void ShmStats_cleanup(ShmStats self);
+
+#endif // __SHM_STATS_H__
@@ -137,6 +137,36 @@ bool tcp_serve(uint16_t port, unsigned int backlog, int * const ipv4_sockfd, int
     return true;
 }
 
+bool tcp_serve_local(uint16_t port, unsigned int backlog, int * const sockfd){
+    int fd, flags;
+    const int optval = 1;                   // Value used for socket option SO_REUSEADDR
+
+    /* Create socket */
+    if ((fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)) < 0) {
+        return false;
+    }
+
+    /* Create and setup address structure */
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+
+    /* Bind, listen and set the socket to non-blocking mode */
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0 ||
+        bind(fd, (const struct sockaddr *) &addr, sizeof(addr)) < 0 ||
+        listen(fd, backlog) < 0 ||
+        (flags = fcntl(fd, F_GETFL, 0)) < 0 ||
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        close(fd);
+        return false;
+    }
+
+    * sockfd = fd;
+    return true;
+}
+
 bool udp_serve(uint16_t port, int * sockfd){
     int fd;
 
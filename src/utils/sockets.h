@@ -65,6 +65,22 @@ bool tcp_serve(
     int * const ipv6_sockfd
 );
 
+/**
+ * \brief       Create and bind a non-blocking passive socket, reachable only from the local host
+ *              (IPv4 loopback).
+ *
+ * \param[in]  port         Port to listen on.
+ * \param[in]  backlog      Backlog size for the listen queue.
+ * \param[out] sockfd       Socket file descriptor.
+ *
+ * \return      `true` on success, `false` on failure.
+ */
+bool tcp_serve_local(
+    uint16_t port,
+    unsigned int backlog,
+    int * const sockfd
+);
+
 /**
  * \brief       Create and bind a passive socket for both IPv4 and IPv6.
  *
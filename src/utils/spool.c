@@ -0,0 +1,296 @@
+/**
+ * \file        spool.c
+ * \brief       Write-coalescing spool writer used to store mail contents while
+ *              a client is sending them (DATA command).
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdlib.h>         // malloc(), realloc(), free()
+#include <stdint.h>         // uint8_t
+#include <string.h>         // memcpy(), strdup()
+#include <errno.h>          // errno, EINTR
+#include <fcntl.h>          // open(), fallocate()
+#include <unistd.h>         // close()
+#include <sys/uio.h>        // pwritev(), struct iovec
+
+#include "spool.h"
+
+/*************************************************************************/
+/* Private data structures                                               */
+/*************************************************************************/
+
+typedef struct _SpoolWriter_t {
+    char *      path;           // Spool file path. The file is only created when data spills.
+    int         fd;             // Spool file, or -1 while the mail is memory-resident.
+    uint8_t *   buff;           // Write buffer (or the whole mail while memory-resident).
+    size_t      buff_size;      // Current capacity of `buff`.
+    size_t      buff_len;       // Bytes currently in `buff`.
+    size_t      file_buff_size; // Capacity of `buff` once the mail spills to the file.
+    size_t      mem_threshold;  // Maximum size of a memory-resident mail.
+    off_t       offset;         // Bytes already written to the file.
+    size_t      syscalls;       // Write system calls performed.
+    bool        failed;         // Sticky: set on the first I/O error.
+} _SpoolWriter_t;
+
+/*************************************************************************/
+/* Module-global variables                                               */
+/*************************************************************************/
+
+static size_t mem_budget    = SPOOL_DEFAULT_MEM_BUDGET;     // Memory available for memory-resident mails.
+static size_t mem_used      = 0;                            // Memory held by memory-resident mails.
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+/**
+ * \brief       Write every byte described by `iov` at the current offset, retrying on
+ *              short writes and on EINTR.
+ *
+ * \return      true on success, false on I/O error.
+ */
+static bool write_all(SpoolWriter self, struct iovec * iov, int iovcnt);
+
+/**
+ * \brief       Grow the memory-resident buffer so that it can hold `needed` bytes,
+ *              charging the growth to the global memory budget.
+ *
+ * \return      true on success, false if the mail must spill to its file instead.
+ */
+static bool reserve_memory(SpoolWriter self, size_t needed);
+
+/**
+ * \brief       Move a memory-resident mail to its file, appending `len` more bytes from
+ *              `data` in the same system call, and switch to a regular write buffer.
+ *
+ * \return      true on success, false on I/O error.
+ */
+static bool spill(SpoolWriter self, const void * data, size_t len);
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+SpoolWriter SpoolWriter_open(const char * path, size_t buff_size, size_t mem_threshold){
+    if (buff_size < SPOOL_MIN_BUFF_SIZE){
+        buff_size = SPOOL_MIN_BUFF_SIZE;
+    }
+
+    SpoolWriter self = malloc(sizeof(_SpoolWriter_t));
+    if (self == NULL){
+        return NULL;
+    }
+    if ((self->path = strdup(path)) == NULL){
+        free(self);
+        return NULL;
+    }
+    self->fd                = -1;
+    self->buff              = NULL;
+    self->buff_size         = 0;
+    self->buff_len          = 0;
+    self->file_buff_size    = buff_size;
+    self->mem_threshold     = mem_threshold;
+    self->offset            = 0;
+    self->syscalls          = 0;
+    self->failed            = false;
+
+    /* Memory-resident mails need no file (nor memory) until data arrives */
+    if (mem_threshold > 0){
+        return self;
+    }
+    if (! spill(self, NULL, 0)){
+        SpoolWriter_close(self);
+        return NULL;
+    }
+    return self;
+}
+
+bool SpoolWriter_write(SpoolWriter const self, const void * data, size_t len){
+    if (self == NULL || self->failed){
+        return false;
+    }
+
+    /* Memory-resident: keep it in memory while it is small enough and memory is available */
+    if (self->fd == -1){
+        size_t needed = self->buff_len + len;
+        if (needed <= self->mem_threshold && reserve_memory(self, needed)){
+            memcpy(self->buff + self->buff_len, data, len);
+            self->buff_len = needed;
+            return true;
+        }
+        return spill(self, data, len);
+    }
+
+    /* Fits in the buffer: just copy it */
+    if (len < self->buff_size - self->buff_len){
+        memcpy(self->buff + self->buff_len, data, len);
+        self->buff_len += len;
+        return true;
+    }
+
+    /* Does not fit: write the buffered data and the new data together */
+    struct iovec iov[2] = {
+        { .iov_base = self->buff,     .iov_len = self->buff_len },
+        { .iov_base = (void *) data,  .iov_len = len            }
+    };
+    bool ok = write_all(self, iov, 2);
+    self->buff_len = 0;
+    return ok;
+}
+
+bool SpoolWriter_flush(SpoolWriter const self){
+    if (self == NULL || self->failed){
+        return false;
+    }
+    if (self->fd == -1 || self->buff_len == 0){
+        return true;
+    }
+    struct iovec iov = { .iov_base = self->buff, .iov_len = self->buff_len };
+    bool ok = write_all(self, &iov, 1);
+    self->buff_len = 0;
+    return ok;
+}
+
+bool SpoolWriter_spill(SpoolWriter const self){
+    if (self == NULL || self->failed){
+        return false;
+    }
+    return self->fd != -1 || spill(self, NULL, 0);
+}
+
+const void * SpoolWriter_memory(SpoolWriter const self, size_t * len){
+    if (self == NULL || self->fd != -1){
+        return NULL;
+    }
+    * len = self->buff_len;
+    return self->buff_len == 0 ? (const void *) "" : (const void *) self->buff;
+}
+
+off_t SpoolWriter_size(SpoolWriter const self){
+    return self == NULL ? 0 : self->offset + (off_t) self->buff_len;
+}
+
+size_t SpoolWriter_syscalls(SpoolWriter const self){
+    return self == NULL ? 0 : self->syscalls;
+}
+
+bool SpoolWriter_close(SpoolWriter self){
+    if (self == NULL){
+        return true;
+    }
+    bool ok = SpoolWriter_flush(self);
+    if (self->fd == -1){
+        mem_used -= self->buff_size;
+    }
+    else if (close(self->fd) != 0){
+        ok = false;
+    }
+    free(self->buff);
+    free(self->path);
+    free(self);
+    return ok;
+}
+
+void spool_set_memory_budget(size_t bytes){
+    mem_budget = bytes;
+}
+
+void spool_preallocate(int fd, off_t size){
+    if (size > 0){
+        fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, size);    // Only a hint: errors (e.g. EOPNOTSUPP) are ignored
+    }
+}
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static bool write_all(SpoolWriter self, struct iovec * iov, int iovcnt){
+    while (iovcnt > 0){
+        /* Skip empty vectors */
+        if (iov->iov_len == 0){
+            iov++;
+            iovcnt--;
+            continue;
+        }
+
+        ssize_t written = pwritev(self->fd, iov, iovcnt, self->offset);
+        self->syscalls++;
+        if (written == -1){
+            if (errno == EINTR){
+                continue;
+            }
+            self->failed = true;
+            return false;
+        }
+        self->offset += written;
+
+        /* Advance over fully written vectors, and into a partially written one */
+        while (iovcnt > 0 && (size_t) written >= iov->iov_len){
+            written -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0){
+            iov->iov_base = (uint8_t *) iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+    return true;
+}
+
+static bool reserve_memory(SpoolWriter self, size_t needed){
+    if (needed <= self->buff_size){
+        return true;
+    }
+
+    /* Grow geometrically, but never beyond the threshold */
+    size_t new_size = self->buff_size == 0 ? SPOOL_MIN_BUFF_SIZE : self->buff_size;
+    while (new_size < needed){
+        new_size *= 2;
+    }
+    if (new_size > self->mem_threshold){
+        new_size = self->mem_threshold;
+    }
+
+    size_t growth = new_size - self->buff_size;
+    if (mem_used + growth > mem_budget){
+        return false;
+    }
+    uint8_t * new_buff = realloc(self->buff, new_size);
+    if (new_buff == NULL){
+        return false;
+    }
+    self->buff      = new_buff;
+    self->buff_size = new_size;
+    mem_used       += growth;
+    return true;
+}
+
+static bool spill(SpoolWriter self, const void * data, size_t len){
+    if ((self->fd = open(self->path, O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, SPOOL_FILE_PERMISSIONS)) == -1){
+        self->failed = true;
+        return false;
+    }
+
+    /* Write whatever was held in memory, together with the new data */
+    struct iovec iov[2] = {
+        { .iov_base = self->buff,     .iov_len = self->buff_len },
+        { .iov_base = (void *) data,  .iov_len = len            }
+    };
+    bool ok = write_all(self, iov, 2);
+
+    /* Give the memory back to the budget and switch to a regular write buffer */
+    mem_used -= self->buff_size;
+    free(self->buff);
+    self->buff_len  = 0;
+    self->buff_size = 0;
+    if ((self->buff = malloc(self->file_buff_size)) == NULL){
+        self->failed = true;
+        return false;
+    }
+    self->buff_size = self->file_buff_size;
+    return ok;
+}
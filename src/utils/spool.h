@@ -0,0 +1,142 @@
+/**
+ * \file        spool.h
+ * \brief       Write-coalescing spool writer used to store mail contents while
+ *              a client is sending them (DATA command).
+ *
+ * \details     Small mails are memory-resident: they are kept entirely in memory
+ *              (no file is created at all) so they can be written straight into
+ *              their final locations. A mail spills to its spool file once it grows
+ *              beyond the memory-resident threshold, or when the memory budget shared
+ *              by all writers is exhausted.
+ *
+ *              Once spilled, written data is accumulated in a (large) user-space
+ *              buffer and only reaches the file when the buffer is full or when the
+ *              writer is flushed. When a write does not fit in the buffer, the buffered
+ *              data and the new data are written together with a single `pwritev (2)`.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __SPOOL_H__
+#define __SPOOL_H__
+
+#include <stddef.h>         // size_t
+#include <stdbool.h>        // bool
+#include <sys/types.h>      // off_t
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Default spool buffer size in bytes */
+#define SPOOL_DEFAULT_BUFF_SIZE     (64 * 1024)
+
+/* Minimum spool buffer size in bytes */
+#define SPOOL_MIN_BUFF_SIZE         1024
+
+/* Default maximum size of a memory-resident mail in bytes (0 disables memory-resident mails) */
+#define SPOOL_DEFAULT_MEM_THRESHOLD (32 * 1024)
+
+/* Default memory budget shared by all memory-resident mails in bytes */
+#define SPOOL_DEFAULT_MEM_BUDGET    (64 * 1024 * 1024)
+
+/* Permissions used for spool files */
+#define SPOOL_FILE_PERMISSIONS      0660
+
+/*************************************************************************/
+
+/**
+ * \typedef     SpoolWriter: Main Spool Writer ADT data type.
+ */
+typedef struct _SpoolWriter_t * SpoolWriter;
+
+/*************************************************************************/
+
+/**
+ * \brief       Open a SpoolWriter for a mail whose spool file is `path`. The file is
+ *              created (or truncated) when the mail spills, which happens right away
+ *              if `mem_threshold` is 0.
+ *
+ * \param[in] path          Path to the spool file. The string is internally copied.
+ * \param[in] buff_size     Size of the write buffer used once the mail spills. Values lower
+ *                          than `SPOOL_MIN_BUFF_SIZE` are rounded up.
+ * \param[in] mem_threshold Maximum size of the mail while memory-resident.
+ *
+ * \return      A new SpoolWriter on success, NULL on failure (errno is set accordingly).
+ */
+SpoolWriter SpoolWriter_open(const char * path, size_t buff_size, size_t mem_threshold);
+
+/**
+ * \brief       Append `len` bytes to the spool.
+ *
+ * \return      true on success, false on I/O error. After an I/O error, every
+ *              subsequent operation fails, so that an incomplete spool file is
+ *              never reported as complete.
+ */
+bool SpoolWriter_write(SpoolWriter const self, const void * data, size_t len);
+
+/**
+ * \brief       Write all buffered data to the file with a single system call. Memory-resident
+ *              mails stay in memory.
+ *
+ * \return      true on success, false on I/O error.
+ */
+bool SpoolWriter_flush(SpoolWriter const self);
+
+/**
+ * \brief       Move a memory-resident mail to its spool file, for instance because the
+ *              file is needed by an external command. Does nothing if it already spilled.
+ *
+ * \return      true on success, false on I/O error.
+ */
+bool SpoolWriter_spill(SpoolWriter const self);
+
+/**
+ * \brief       Get the contents of a memory-resident mail.
+ *
+ * \param[in]  self         The SpoolWriter itself.
+ * \param[out] len          Length of the mail contents.
+ *
+ * \return      The mail contents, owned by the SpoolWriter and valid until its next
+ *              write or close, or NULL if the mail spilled to its spool file.
+ */
+const void * SpoolWriter_memory(SpoolWriter const self, size_t * len);
+
+/**
+ * \brief       Get the amount of bytes appended so far (written and buffered).
+ */
+off_t SpoolWriter_size(SpoolWriter const self);
+
+/**
+ * \brief       Get the amount of write system calls performed so far.
+ */
+size_t SpoolWriter_syscalls(SpoolWriter const self);
+
+/**
+ * \brief       Flush the SpoolWriter, close its file and free all memory.
+ *
+ * \param[in] self          The SpoolWriter itself. NULL-safe.
+ *
+ * \return      true if every buffered byte reached the file, false otherwise.
+ */
+bool SpoolWriter_close(SpoolWriter self);
+
+/**
+ * \brief       Set the memory budget shared by all memory-resident mails. Writers that
+ *              would exceed it spill to their spool files.
+ *
+ * \param[in] bytes         Budget in bytes.
+ */
+void spool_set_memory_budget(size_t bytes);
+
+/**
+ * \brief       Hint the file system about the final size of a file, so that it can
+ *              allocate its blocks at once. The file size itself is not modified.
+ *
+ * \param[in] fd            File descriptor of the file.
+ * \param[in] size          Expected final size in bytes.
+ */
+void spool_preallocate(int fd, off_t size);
+
+#endif // __SPOOL_H__
@@ -1,71 +1,222 @@
 /**
  * \file        stats.c
  * \brief       SMTPD statistics.
- * 
+ *
  * \date        June, 2024
  * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
  */
 
+#include <stdalign.h>   // alignas
+#include <stdatomic.h>  // atomic_long, atomic_fetch_add_explicit(), atomic_load_explicit()
+
 #include "stats.h"
+#include "../lib/histogram.h"
+
+/**
+ * Counters updated by the threads assigned to a shard. Gauges have an unused slot.
+ */
+typedef struct _Stats_Shard_t{
+    alignas(STATS_CACHE_LINE_SIZE) atomic_long vals[STATKEY_QTY];
+} _Stats_Shard_t;
 
 typedef struct _Stats_t{
-    StatVal conns;
-    StatVal curr_conns;
-    StatVal transf_bytes;
+    _Stats_Shard_t  shards[STATS_SHARD_QTY];
+    alignas(STATS_CACHE_LINE_SIZE) atomic_long gauges[STATKEY_QTY];      // Counters have an unused slot.
+    alignas(STATS_CACHE_LINE_SIZE) atomic_long maxs[STATKEY_QTY];        // High-water marks of the gauges.
+    Histogram       hists[HISTKEY_QTY];
 } _Stats_t;
 
+#define COUNTER     false
+#define GAUGE       true
+
+/* Catalogue columns, indexed by key */
+static const bool is_gauge[STATKEY_QTY] = {
+    #define XX(KEY, KIND, NAME, DESCRIPTION) [STATKEY_##KEY] = KIND,
+    STATS_CATALOGUE(XX)
+    #undef XX
+};
+static const char * const names[STATKEY_QTY] = {
+    #define XX(KEY, KIND, NAME, DESCRIPTION) [STATKEY_##KEY] = NAME,
+    STATS_CATALOGUE(XX)
+    #undef XX
+};
+static const char * const descriptions[STATKEY_QTY] = {
+    #define XX(KEY, KIND, NAME, DESCRIPTION) [STATKEY_##KEY] = DESCRIPTION,
+    STATS_CATALOGUE(XX)
+    #undef XX
+};
+static const char * const hist_names[HISTKEY_QTY] = {
+    #define XX(KEY, UNIT, NAME, DESCRIPTION) [HISTKEY_##KEY] = NAME,
+    STATS_HISTOGRAMS(XX)
+    #undef XX
+};
+static const char * const hist_units[HISTKEY_QTY] = {
+    #define XX(KEY, UNIT, NAME, DESCRIPTION) [HISTKEY_##KEY] = UNIT,
+    STATS_HISTOGRAMS(XX)
+    #undef XX
+};
+static const char * const hist_descriptions[HISTKEY_QTY] = {
+    #define XX(KEY, UNIT, NAME, DESCRIPTION) [HISTKEY_##KEY] = DESCRIPTION,
+    STATS_HISTOGRAMS(XX)
+    #undef XX
+};
+
+/* Amount of threads that have updated a counter, to assign shards round robin */
+static atomic_uint thread_qty = 0;
+
+/* Shard of the calling thread, assigned on its first counter update */
+static _Thread_local int thread_shard = -1;
+
 /**
- * \brief       Get the pointer of the statistic corresponding to the
- *              provided `key`.
- * 
- * \param[in] self      The Stats object itself.
- * \param[in] key       The statistic to get.
- * 
- * \return      A pointer to the statistic on success (`StatVal *`), `NULL`
- *              on failure.
+ * \brief       Whether `key` is a valid statistic key.
  */
-static StatVal * get_stat_ptr(Stats self, StatKey key) {
-    if (self == NULL){
-        return NULL;
-    }
-    switch (key) {
-        case STATKEY_CONNS: 
-            return &(self->conns);
-        case STATKEY_CURR_CONNS: 
-            return &(self->curr_conns);
-        case STATKEY_TRANSF_BYTES: 
-            return &(self->transf_bytes);
-        default: 
-            return NULL;
+static inline bool valid_key(StatKey key) {
+    return (unsigned) key < STATKEY_QTY;
+}
+
+/**
+ * \brief       Whether `key` is a valid histogram key.
+ */
+static inline bool valid_hist_key(HistKey key) {
+    return (unsigned) key < HISTKEY_QTY;
+}
+
+/**
+ * \brief       Get the shard of the calling thread.
+ */
+static inline _Stats_Shard_t * get_shard(Stats self) {
+    if (thread_shard < 0){
+        thread_shard = atomic_fetch_add_explicit(&thread_qty, 1, memory_order_relaxed) % STATS_SHARD_QTY;
     }
+    return &(self->shards[thread_shard]);
+}
+
+/**
+ * \brief       Raise the high-water mark of a gauge to `val`, if higher.
+ */
+static inline void update_max(Stats self, StatKey key, StatVal val) {
+    StatVal max = atomic_load_explicit(&(self->maxs[key]), memory_order_relaxed);
+    while (val > max && ! atomic_compare_exchange_weak_explicit(&(self->maxs[key]), &max, val,
+                                                                 memory_order_relaxed, memory_order_relaxed));
 }
 
 Stats Stats_init(){
-    Stats self = calloc(1, sizeof(struct _Stats_t));
+    Stats self = aligned_alloc(alignof(_Stats_t), sizeof(_Stats_t));
+    if (self == NULL){
+        return NULL;
+    }
+    for (int key = 0; key < STATKEY_QTY; key++){
+        for (int shard = 0; shard < STATS_SHARD_QTY; shard++){
+            atomic_init(&(self->shards[shard].vals[key]), 0);
+        }
+        atomic_init(&(self->gauges[key]), 0);
+        atomic_init(&(self->maxs[key]), 0);
+    }
+    bool ok = true;
+    for (int key = 0; key < HISTKEY_QTY; key++){
+        ok = (self->hists[key] = Histogram_create()) != NULL && ok;
+    }
+    if (! ok){
+        Stats_cleanup(self);
+        return NULL;
+    }
     return self;
 }
 
 bool Stats_get(Stats const self, StatKey key, StatVal * const val){
-    if (self == NULL || val == NULL){
+    if (self == NULL || val == NULL || ! valid_key(key)){
         return false;
     }
-    StatVal * ptr = get_stat_ptr(self, key);
-    if (ptr == NULL){
+    if (Stats_is_gauge(key)){
+        * val = atomic_load_explicit(&(self->gauges[key]), memory_order_relaxed);
+        return true;
+    }
+    StatVal sum = 0;
+    for (int shard = 0; shard < STATS_SHARD_QTY; shard++){
+        sum += atomic_load_explicit(&(self->shards[shard].vals[key]), memory_order_relaxed);
+    }
+    * val = sum;
+    return true;
+}
+
+bool Stats_get_max(Stats const self, StatKey key, StatVal * const val){
+    if (self == NULL || val == NULL || ! Stats_is_gauge(key)){
         return false;
     }
-    * val = * ptr;
+    * val = atomic_load_explicit(&(self->maxs[key]), memory_order_relaxed);
     return true;
 }
 
-bool Stats_update(Stats const self, StatKey key, StatVal delta){
-    if (self == NULL){
+bool Stats_set(Stats const self, StatKey key, StatVal val){
+    if (self == NULL || ! Stats_is_gauge(key)){
         return false;
     }
-    StatVal * ptr = get_stat_ptr(self, key);
-    if (ptr == NULL){
+    atomic_store_explicit(&(self->gauges[key]), val, memory_order_relaxed);
+    update_max(self, key, val);
+    return true;
+}
+
+bool Stats_is_gauge(StatKey key){
+    return valid_key(key) && is_gauge[key];
+}
+
+const char * Stats_name(StatKey key){
+    return valid_key(key) ? names[key] : NULL;
+}
+
+const char * Stats_description(StatKey key){
+    return valid_key(key) ? descriptions[key] : NULL;
+}
+
+const char * Stats_hist_name(HistKey key){
+    return valid_hist_key(key) ? hist_names[key] : NULL;
+}
+
+const char * Stats_hist_unit(HistKey key){
+    return valid_hist_key(key) ? hist_units[key] : NULL;
+}
+
+const char * Stats_hist_description(HistKey key){
+    return valid_hist_key(key) ? hist_descriptions[key] : NULL;
+}
+
+bool Stats_record(Stats const self, HistKey key, uint64_t value){
+    if (self == NULL || ! valid_hist_key(key)){
         return false;
     }
-    *ptr += delta;
+    Histogram_record(self->hists[key], value);
+    return true;
+}
+
+bool Stats_percentile(Stats const self, HistKey key, double percentile, StatVal * const val, StatVal * const samples){
+    if (self == NULL || val == NULL || ! valid_hist_key(key)){
+        return false;
+    }
+    * val = (StatVal) Histogram_percentile(self->hists[key], percentile);
+    if (samples != NULL){
+        * samples = (StatVal) Histogram_count(self->hists[key]);
+    }
+    return true;
+}
+
+bool Stats_sum(Stats const self, HistKey key, StatVal * const val){
+    if (self == NULL || val == NULL || ! valid_hist_key(key)){
+        return false;
+    }
+    * val = (StatVal) Histogram_sum(self->hists[key]);
+    return true;
+}
+
+bool Stats_update(Stats const self, StatKey key, StatVal delta){
+    if (self == NULL || ! valid_key(key)){
+        return false;
+    }
+    if (Stats_is_gauge(key)){
+        StatVal val = atomic_fetch_add_explicit(&(self->gauges[key]), delta, memory_order_relaxed) + delta;
+        update_max(self, key, val);
+        return true;
+    }
+    atomic_fetch_add_explicit(&(get_shard(self)->vals[key]), delta, memory_order_relaxed);
     return true;
 }
 
@@ -81,5 +232,8 @@ void Stats_cleanup(Stats const self){
     if (self == NULL){
         return;
     }
+    for (int key = 0; key < HISTKEY_QTY; key++){
+        Histogram_cleanup(self->hists[key]);    // NULL-safe
+    }
     free(self);
 }
@@ -1,6 +1,21 @@
 /**
  * \file        stats.h
  * \brief       SMTPD statistics.
+ *
+ * \details     Statistics are either counters, which only accumulate, or gauges, which go up
+ *              and down and also keep their high-water mark.
+ *
+ *              Counters are split in cache-line-aligned shards of relaxed atomics, one per
+ *              thread (threads beyond `STATS_SHARD_QTY` share shards), so that updates from
+ *              different threads never contend on the same cache line; reading a counter
+ *              sums its shards. Gauges are a single atomic each, as their high-water mark
+ *              needs the current total.
+ *
+ *              Distributions, such as latencies (in nanoseconds) and mail sizes, are
+ *              recorded into histograms (see src/lib/histogram.h), from which percentiles
+ *              are computed.
+ *
+ * \note        Thread-safe. Values read while other threads update them are approximate.
  * 
  * \date        June, 2024
  * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
@@ -9,8 +24,19 @@
 #ifndef __STATS_H__
 #define __STATS_H__
 
-#include <stdlib.h>     // calloc(), free()
+#include <stdlib.h>     // aligned_alloc(), free()
 #include <stdbool.h>    // bool, true, false
+#include <stdint.h>     // uint64_t
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Amount of counter shards */
+#define STATS_SHARD_QTY         16
+
+/* Size of a cache line, in bytes */
+#define STATS_CACHE_LINE_SIZE   64
 
 /*************************************************************************/
 
@@ -20,15 +46,93 @@
 typedef struct _Stats_t * Stats;
 
 /**
- * \enum        StatKey: Keys of all possible statistics. STATKEY_START and STATKEY_END
- *                       are not valid statistic keys.
+ * \def         STATS_CATALOGUE: Every statistic, as XX(KEY, KIND, NAME, DESCRIPTION), where KIND is
+ *              COUNTER or GAUGE and NAME is a unique snake_case identifier. Adding a statistic
+ *              takes a single line here. Their order is part of version 0x01 of the manager
+ *              protocol (see src/manager/manager.h): new statistics go last.
+ */
+#define STATS_CATALOGUE(XX)                                                                                            \
+    XX(CONNS,               COUNTER,    "connections",              "All connections since the server started")        \
+    XX(CURR_CONNS,          GAUGE,      "current_connections",      "Current connection count")                        \
+    XX(TRANSF_BYTES,        COUNTER,    "transferred_bytes",        "Bytes received from and sent to clients")         \
+    XX(BYTES_IN,            COUNTER,    "received_bytes",           "Bytes received from clients")                     \
+    XX(BYTES_OUT,           COUNTER,    "sent_bytes",               "Bytes sent to clients")                           \
+    XX(MSGS_ACCEPTED,       COUNTER,    "accepted_mails",           "Mails accepted for delivery")                     \
+    XX(RCPTS_DELIVERED,     COUNTER,    "delivered_recipients",     "Recipients of the mails accepted for delivery")   \
+    XX(SPOOL_MSGS,          COUNTER,    "spooled_mails",            "Mails written to the spool")                      \
+    XX(SPOOL_WRITES,        COUNTER,    "spool_writes",             "Write system calls performed on spool files")     \
+    XX(SPOOL_BYTES,         COUNTER,    "spool_bytes",              "Bytes written to spool files")                    \
+    XX(SPOOL_MEM_MSGS,      COUNTER,    "memory_mails",             "Mails delivered straight from memory")            \
+    XX(TRANSFORMS,          COUNTER,    "transformations",          "Transformation command runs")                     \
+    XX(TRANSFORM_FAILURES,  COUNTER,    "transformation_failures",  "Transformation command runs that failed")         \
+    XX(VRFY_QUERIES,        COUNTER,    "vrfy_queries",             "VRFY commands answered")                          \
+    XX(RCPT_HITS,           COUNTER,    "rcpt_table_hits",          "Recipients found in the local recipients table")  \
+    XX(RCPT_MISSES,         COUNTER,    "rcpt_table_misses",        "Recipients not in the local recipients table")    \
+    XX(RCPT_NEG_HITS,       COUNTER,    "rcpt_table_negative_hits", "Misses answered by the negative cache")          \
+    XX(REPLIES_2XX,         COUNTER,    "replies_2xx",              "Positive completion replies")                     \
+    XX(REPLIES_3XX,         COUNTER,    "replies_3xx",              "Positive intermediate replies")                   \
+    XX(REPLIES_4XX,         COUNTER,    "replies_4xx",              "Transient negative replies")                      \
+    XX(REPLIES_5XX,         COUNTER,    "replies_5xx",              "Permanent negative replies")                      \
+    XX(REPLIES_HELO,        COUNTER,    "replies_helo",             "Replies to HELO")                                 \
+    XX(REPLIES_EHLO,        COUNTER,    "replies_ehlo",             "Replies to EHLO")                                 \
+    XX(REPLIES_VRFY,        COUNTER,    "replies_vrfy",             "Replies to VRFY")                                 \
+    XX(REPLIES_EXPN,        COUNTER,    "replies_expn",             "Replies to EXPN")                                 \
+    XX(REPLIES_MAIL,        COUNTER,    "replies_mail",             "Replies to MAIL FROM")                            \
+    XX(REPLIES_RCPT,        COUNTER,    "replies_rcpt",             "Replies to RCPT TO")                              \
+    XX(REPLIES_DATA,        COUNTER,    "replies_data",             "Replies to DATA and to the mail contents")        \
+    XX(REPLIES_RSET,        COUNTER,    "replies_rset",             "Replies to RSET")                                 \
+    XX(REPLIES_QUIT,        COUNTER,    "replies_quit",             "Replies to QUIT")                                 \
+    XX(REPLIES_NOOP,        COUNTER,    "replies_noop",             "Replies to NOOP")                                 \
+    XX(REPLIES_TRFM,        COUNTER,    "replies_trfm",             "Replies to TRFM")                                 \
+    XX(REPLIES_ERROR,       COUNTER,    "replies_error",            "Replies to invalid or unknown commands")          \
+    XX(CONNS_REJECTED,      COUNTER,    "rejected_connections",     "Connections refused past max_connections")        \
+    XX(MSGS_TOO_LARGE,      COUNTER,    "oversized_mails",          "Mails refused past max_mail_size")                \
+    XX(RCPTS_OVER_LIMIT,    COUNTER,    "excess_recipients",        "Recipients refused past max_recipients")          \
+    XX(SCRAPERS_EVICTED,    COUNTER,    "evicted_scrapers",         "Idle metrics scrapers closed to serve new ones")  \
+    XX(SCRAPERS_REFUSED,    COUNTER,    "refused_scrapers",         "Metrics scrapers refused: all slots replying")
+
+/**
+ * \def         STATS_HISTOGRAMS: Every distribution, as XX(KEY, UNIT, NAME, DESCRIPTION). Their
+ *              order is part of the manager protocol (see src/manager/manager.h): new
+ *              distributions go last.
+ */
+#define STATS_HISTOGRAMS(XX)                                                                                           \
+    XX(CMD_HELO,            "ns",       "helo_time",                "HELO service time")                               \
+    XX(CMD_EHLO,            "ns",       "ehlo_time",                "EHLO service time")                               \
+    XX(CMD_MAIL,            "ns",       "mail_time",                "MAIL FROM service time")                          \
+    XX(CMD_RCPT,            "ns",       "rcpt_time",                "RCPT TO service time")                            \
+    XX(CMD_DATA,            "ns",       "data_time",                "DATA service time, until the 354 reply")          \
+    XX(CMD_VRFY,            "ns",       "vrfy_time",                "VRFY service time")                               \
+    XX(DATA_END,            "ns",       "data_end_time",            "Time from the end of a mail to its reply")        \
+    XX(TRANSFORM,           "ns",       "transformation_time",      "Transformation command run time")                 \
+    XX(DUMP,                "ns",       "dump_time",                "Time to store a mail into an inbox")              \
+    XX(CONN_LIFETIME,       "ns",       "connection_lifetime",      "Connection lifetime")                             \
+    XX(MSG_SIZE,            "bytes",    "mail_size",                "Size of the mails accepted")                      \
+    XX(RCPTS_PER_MSG,       "rcpts",    "mail_recipients",          "Recipients per mail accepted")
+
+/**
+ * \enum        StatKey: Keys of all possible statistics (see STATS_CATALOGUE). STATKEY_QTY is
+ *                       not a valid statistic key.
  */
 typedef enum{
-    STATKEY_CONNS,          // All connections since the server started
-    STATKEY_CURR_CONNS,     // Current connection count
-    STATKEY_TRANSF_BYTES,   // Total transferred bytes
+    #define XX(KEY, KIND, NAME, DESCRIPTION) STATKEY_##KEY,
+    STATS_CATALOGUE(XX)
+    #undef XX
+    STATKEY_QTY,
 } StatKey;
 
+/**
+ * \enum        HistKey: Keys of all distributions (see STATS_HISTOGRAMS). HISTKEY_QTY is not a
+ *                       valid histogram key. Service times are measured from the arrival of
+ *                       a command to its reply being queued.
+ */
+typedef enum{
+    #define XX(KEY, UNIT, NAME, DESCRIPTION) HISTKEY_##KEY,
+    STATS_HISTOGRAMS(XX)
+    #undef XX
+    HISTKEY_QTY,
+} HistKey;
+
 /**
  * \typedef     StatVal: Value type of a statistic.
  */
@@ -55,6 +159,98 @@ Stats Stats_init();
  */
 bool Stats_get(Stats const self, StatKey key, StatVal * const val);
 
+/**
+ * \brief       Get the highest value a gauge has had.
+ * 
+ * \param[in]  self     The Stats object itself.
+ * \param[in]  key      Gauge to get the high-water mark of (as in `StatKey` enumeration).
+ * \param[out] val      High-water mark of the gauge. Pointed data is left unchanged on error.
+ * 
+ * \return      Returns `true` on success, or `false` if `key` does not represent a gauge.
+ */
+bool Stats_get_max(Stats const self, StatKey key, StatVal * const val);
+
+/**
+ * \brief       Set the value of a gauge.
+ * 
+ * \param[in]  self     The Stats object itself.
+ * \param[in]  key      Gauge to set (as in `StatKey` enumeration).
+ * \param[in]  val      New value of the gauge.
+ * 
+ * \return      Returns `true` on success, or `false` if `key` does not represent a gauge.
+ */
+bool Stats_set(Stats const self, StatKey key, StatVal val);
+
+/**
+ * \brief       Whether a statistic is a gauge.
+ */
+bool Stats_is_gauge(StatKey key);
+
+/**
+ * \brief       Name of a statistic (as in STATS_CATALOGUE), or NULL if `key` is not valid.
+ */
+const char * Stats_name(StatKey key);
+
+/**
+ * \brief       Description of a statistic (as in STATS_CATALOGUE), or NULL if `key` is not valid.
+ */
+const char * Stats_description(StatKey key);
+
+/**
+ * \brief       Name of a distribution (as in STATS_HISTOGRAMS), or NULL if `key` is not valid.
+ */
+const char * Stats_hist_name(HistKey key);
+
+/**
+ * \brief       Unit of a distribution (as in STATS_HISTOGRAMS), or NULL if `key` is not valid.
+ */
+const char * Stats_hist_unit(HistKey key);
+
+/**
+ * \brief       Description of a distribution (as in STATS_HISTOGRAMS), or NULL if `key` is not
+ *              valid.
+ */
+const char * Stats_hist_description(HistKey key);
+
+/**
+ * \brief       Record a value into a distribution. Thread-safe.
+ * 
+ * \param[in]  self     The Stats object itself.
+ * \param[in]  key      Histogram to record the value into (as in `HistKey` enumeration).
+ * \param[in]  value    Value, in the unit of the distribution (as in STATS_HISTOGRAMS).
+ * 
+ * \return      Returns `true` on success, or `false` if `key` does not represent a valid
+ *              histogram key (as in `HistKey` enumeration).
+ */
+bool Stats_record(Stats const self, HistKey key, uint64_t value);
+
+/**
+ * \brief       Get a percentile of a distribution.
+ * 
+ * \param[in]  self         The Stats object itself.
+ * \param[in]  key          Histogram to query (as in `HistKey` enumeration).
+ * \param[in]  percentile   Percentage, from 0 to 100 (for instance, 99.9).
+ * \param[out] val          Value, in the unit of the distribution (0 if none was recorded).
+ *                          Pointed data is left unchanged on error.
+ * \param[out] samples      Amount of values recorded. May be NULL.
+ * 
+ * \return      Returns `true` on success, or `false` if `key` does not represent a valid
+ *              histogram key (as in `HistKey` enumeration).
+ */
+bool Stats_percentile(Stats const self, HistKey key, double percentile, StatVal * const val, StatVal * const samples);
+
+/**
+ * \brief       Get the sum of the values recorded into a distribution.
+ * 
+ * \param[in]  self     The Stats object itself.
+ * \param[in]  key      Histogram to query (as in `HistKey` enumeration).
+ * \param[out] val      Sum, in the unit of the distribution. Pointed data is left unchanged on error.
+ * 
+ * \return      Returns `true` on success, or `false` if `key` does not represent a valid
+ *              histogram key (as in `HistKey` enumeration).
+ */
+bool Stats_sum(Stats const self, HistKey key, StatVal * const val);
+
 /**
  * \brief       Update a statistic by adding the value of `delta` to it.
  * 
@@ -0,0 +1,127 @@
+/**
+ * \file        storage.c
+ * \brief       Pluggable mail storage backends.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <string.h>         // strcmp()
+
+#include "storage.h"
+
+/*************************************************************************/
+/* Backends                                                              */
+/*************************************************************************/
+
+#define XX(NAME, BACKEND) extern const StorageBackend BACKEND;
+STORAGE_BACKENDS(XX)
+#undef XX
+
+static const char * backend_names[] = {
+    #define XX(NAME, BACKEND) NAME,
+    STORAGE_BACKENDS(XX)
+    #undef XX
+    NULL
+};
+
+static const StorageBackend * backends[] = {
+    #define XX(NAME, BACKEND) &BACKEND,
+    STORAGE_BACKENDS(XX)
+    #undef XX
+    NULL
+};
+
+/*************************************************************************/
+/* Module-global variables                                               */
+/*************************************************************************/
+
+static const StorageBackend *   backend         = NULL;     // Selected backend.
+static const char *             backend_name    = NULL;     // Selected backend name.
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+/**
+ * \brief       Find a backend by name. Returns its index, or -1 if not found.
+ */
+static int find_backend(const char * name);
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+bool Storage_init(const char * name){
+    int idx = find_backend(name);
+    if (idx == -1){
+        return false;
+    }
+    if (backends[idx]->init != NULL && ! backends[idx]->init()){
+        return false;
+    }
+    backend         = backends[idx];
+    backend_name    = backend_names[idx];
+    return true;
+}
+
+bool Storage_exists(const char * name){
+    return find_backend(name) != -1;
+}
+
+const char * Storage_name(void){
+    return backend_name;
+}
+
+StorageMsg Storage_begin(const char * sender){
+    return backend == NULL ? NULL : backend->begin(sender);
+}
+
+bool Storage_add_rcpt(StorageMsg msg, const char * rcpt){
+    return msg != NULL && backend->add_rcpt(msg, rcpt);
+}
+
+bool Storage_append(StorageMsg msg, const void * data, size_t len){
+    return msg != NULL && backend->append(msg, data, len);
+}
+
+bool Storage_transform(StorageMsg msg, const char * cmd){
+    if (msg == NULL){
+        return false;
+    }
+    return backend->transform == NULL || backend->transform(msg, cmd);
+}
+
+bool Storage_commit(StorageMsg msg){
+    return msg != NULL && backend->commit(msg);
+}
+
+void Storage_abort(StorageMsg msg){
+    if (msg != NULL){
+        backend->abort(msg);
+    }
+}
+
+void Storage_cleanup(void){
+    if (backend != NULL && backend->cleanup != NULL){
+        backend->cleanup();
+    }
+    backend         = NULL;
+    backend_name    = NULL;
+}
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static int find_backend(const char * name){
+    if (name == NULL){
+        return -1;
+    }
+    for (int i = 0; backend_names[i] != NULL; i++){
+        if (strcmp(backend_names[i], name) == 0){
+            return i;
+        }
+    }
+    return -1;
+}
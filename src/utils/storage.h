@@ -0,0 +1,150 @@
+/**
+ * \file        storage.h
+ * \brief       Pluggable mail storage backends.
+ *
+ * \details     Mails are handed to the storage in the same order the SMTP session
+ *              produces them: a message is begun, recipients are added, contents are
+ *              appended line by line, and finally the message is either committed
+ *              (delivered) or aborted (discarded).
+ *
+ *              Available backends are listed in `STORAGE_BACKENDS`, and exactly one of
+ *              them is selected with `Storage_init`:
+ *
+ *              - fs:       Mailbox files under <inbox>/<domain>/<user> (default), where
+ *                          <inbox> is one of the inbox roots (see dircache.h).
+ *              - null:     Accepts everything and stores nothing. Useful to benchmark
+ *                          the protocol path in isolation from the disk.
+ *              - memory:   Keeps delivered mails in memory (up to a limit, oldest
+ *                          mails are dropped first). Nothing touches the disk.
+ *              - log:      Log-structured store under ./store: mails are appended to
+ *                          per-shard segment files and indexed per mailbox (see
+ *                          logstore.h).
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __STORAGE_H__
+#define __STORAGE_H__
+
+#include <stddef.h>         // size_t
+#include <stdbool.h>        // bool
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Backend used when none is specified */
+#define STORAGE_DEFAULT_BACKEND     "fs"
+
+/* Inbox roots used by the fs backend when none are specified (comma-separated) */
+#define INBOX_DEFAULT_ROOTS         "./inbox"
+
+/*************************************************************************/
+
+/**
+ * \brief       X-Macro with every storage backend: name (as selected from the command
+ *              line) and the `StorageBackend` that implements it.
+ */
+#define STORAGE_BACKENDS(XX)                        \
+    XX("fs",        storage_fs_backend)             \
+    XX("null",      storage_null_backend)           \
+    XX("memory",    storage_memory_backend)         \
+    XX("log",       storage_log_backend)
+
+/**
+ * \typedef     StorageMsg: A message being received. Its contents depend on the backend.
+ */
+typedef void * StorageMsg;
+
+/**
+ * \typedef     StorageBackend: Operations a storage backend provides. Unless noted
+ *              otherwise, every operation is mandatory.
+ */
+typedef struct {
+    bool        (* init)        (void);                                     // Optional.
+    void        (* cleanup)     (void);                                     // Optional.
+    StorageMsg  (* begin)       (const char * sender);
+    bool        (* add_rcpt)    (StorageMsg msg, const char * rcpt);
+    bool        (* append)      (StorageMsg msg, const void * data, size_t len);
+    bool        (* transform)   (StorageMsg msg, const char * cmd);         // Optional.
+    bool        (* commit)      (StorageMsg msg);
+    void        (* abort)       (StorageMsg msg);
+} StorageBackend;
+
+/*************************************************************************/
+
+/**
+ * \brief       Select and initialize a storage backend.
+ *
+ * \param[in] name          Backend name (as in `STORAGE_BACKENDS`).
+ *
+ * \return      true on success, false if the backend does not exist or could not be
+ *              initialized.
+ */
+bool Storage_init(const char * name);
+
+/**
+ * \brief       Check whether `name` is a valid backend name.
+ */
+bool Storage_exists(const char * name);
+
+/**
+ * \brief       Get the name of the selected backend.
+ */
+const char * Storage_name(void);
+
+/**
+ * \brief       Begin a new message sent by `sender`.
+ *
+ * \return      The new message, or NULL on failure.
+ */
+StorageMsg Storage_begin(const char * sender);
+
+/**
+ * \brief       Add a recipient to a message. Recipients must be added before the message
+ *              is committed.
+ *
+ * \return      true on success, false on failure.
+ */
+bool Storage_add_rcpt(StorageMsg msg, const char * rcpt);
+
+/**
+ * \brief       Append `len` bytes to the contents of a message. Failures are sticky: once
+ *              an append fails, so do the following ones and the commit, so a message is
+ *              never delivered with part of its contents missing.
+ *
+ * \return      true on success, false on failure.
+ */
+bool Storage_append(StorageMsg msg, const void * data, size_t len);
+
+/**
+ * \brief       Ask for the contents of a message to be transformed by the shell command
+ *              `cmd` when it is committed. Backends that do not support transformations
+ *              store the contents as they are.
+ *
+ * \return      true on success, false on failure.
+ */
+bool Storage_transform(StorageMsg msg, const char * cmd);
+
+/**
+ * \brief       Deliver a message to all of its recipients. The message is released,
+ *              whatever the result.
+ *
+ * \return      true on success, false on failure.
+ */
+bool Storage_commit(StorageMsg msg);
+
+/**
+ * \brief       Discard a message and release it.
+ *
+ * \param[in] msg           The message. NULL-safe.
+ */
+void Storage_abort(StorageMsg msg);
+
+/**
+ * \brief       Cleanup the selected backend.
+ */
+void Storage_cleanup(void);
+
+#endif // __STORAGE_H__
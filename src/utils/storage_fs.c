@@ -0,0 +1,226 @@
+/**
+ * \file        storage_fs.c
+ * \brief       "fs" storage backend: one file per recipient under
+ *              <inbox>/<domain>/<user>, where <inbox> is one of the inbox roots
+ *              (see dircache.h).
+ *
+ * \details     Message contents go through a SpoolWriter (see spool.h). Small
+ *              messages stay in memory and are written straight into every inbox;
+ *              larger ones (and those that must be transformed) are spooled to
+ *              ./tmp and copied into every inbox with sendfile (2).
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdio.h>          // snprintf(), remove()
+#include <stdlib.h>         // malloc(), realloc(), free()
+#include <string.h>         // strdup(), strtok_r()
+#include <time.h>           // struct tm
+#include <sys/stat.h>       // mkdir()
+
+#include "storage.h"
+#include "spool.h"
+#include "dircache.h"
+#include "stats.h"
+#include "transform.h"
+#include "../lib/clock.h"
+
+#define TMP                 "./tmp"
+#define TMP_PERMISSIONS     0770
+#define MAX_PATH_SIZE       512
+#define SPOOL_PATH_FMT      "%s/From:%s %d-%02d-%02d %02d:%02d:%02d"
+#define MAIL_NAME_FMT       "From:%s %d-%02d-%02d %02d:%02d:%02d"
+#define ERR                 -1
+#define INBOX_ROOTS_SEP     ","
+
+/*************************************************************************/
+/* Private data structures                                               */
+/*************************************************************************/
+
+typedef struct _FsMsg_t {
+    char *          sender;
+    char **         rcpts;
+    size_t          rcpt_qty;
+    SpoolWriter     spool;
+    const char *    transform_cmd;      // Not owned. NULL if no transformation is needed.
+    char            spool_path[MAX_PATH_SIZE];
+} _FsMsg_t;
+
+/*************************************************************************/
+/* Global variables                                                      */
+/*************************************************************************/
+
+DirCache dircache = NULL;       // Mailbox directory cache (see dircache.h)
+
+/*************************************************************************/
+/* Extern global variables                                               */
+/*************************************************************************/
+
+extern Stats    stats;
+extern size_t   spool_buff_size;
+extern size_t   spool_mem_threshold;
+extern char *   inbox_roots;
+extern bool     inbox_fanout;
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static void free_msg(_FsMsg_t * msg){
+    SpoolWriter_close(msg->spool);      // NULL-safe
+    for (size_t i = 0; i < msg->rcpt_qty; i++){
+        free(msg->rcpts[i]);
+    }
+    free(msg->rcpts);
+    free(msg->sender);
+    free(msg);
+}
+
+static bool fs_init(void){
+    /* It is not necessary to check for errors: it only fails if the directory already exists */
+    mkdir(TMP, TMP_PERMISSIONS);
+
+    /* Split the comma-separated list of inbox roots. They are created by the DirCache */
+    char * list = strdup(inbox_roots);
+    if (list == NULL){
+        return false;
+    }
+    const char * roots[DIRCACHE_MAX_ROOTS];
+    size_t root_qty = 0;
+    char * save_ptr = NULL;
+    for (char * root = strtok_r(list, INBOX_ROOTS_SEP, &save_ptr); root != NULL && root_qty < DIRCACHE_MAX_ROOTS;
+         root = strtok_r(NULL, INBOX_ROOTS_SEP, &save_ptr)){
+        roots[root_qty++] = root;
+    }
+
+    dircache = DirCache_create(roots, root_qty, inbox_fanout, DIRCACHE_DEFAULT_CAPACITY);
+    free(list);
+    return dircache != NULL;
+}
+
+static void fs_cleanup(void){
+    DirCache_cleanup(dircache);         // NULL-safe
+    dircache = NULL;
+}
+
+static StorageMsg fs_begin(const char * sender){
+    _FsMsg_t * msg = calloc(1, sizeof(_FsMsg_t));
+    if (msg == NULL){
+        return NULL;
+    }
+    if ((msg->sender = strdup(sender)) == NULL){
+        free(msg);
+        return NULL;
+    }
+
+    struct tm tm;
+    Clock_localtime(&tm);
+    snprintf(msg->spool_path, MAX_PATH_SIZE, SPOOL_PATH_FMT, TMP, sender,
+        tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+
+    if ((msg->spool = SpoolWriter_open(msg->spool_path, spool_buff_size, spool_mem_threshold)) == NULL){
+        free_msg(msg);
+        return NULL;
+    }
+    return msg;
+}
+
+static bool fs_add_rcpt(StorageMsg _msg, const char * rcpt){
+    _FsMsg_t * msg = _msg;
+    char ** rcpts = realloc(msg->rcpts, (msg->rcpt_qty + 1) * sizeof(char *));
+    if (rcpts == NULL){
+        return false;
+    }
+    msg->rcpts = rcpts;
+    if ((msg->rcpts[msg->rcpt_qty] = strdup(rcpt)) == NULL){
+        return false;
+    }
+    msg->rcpt_qty++;
+    return true;
+}
+
+static bool fs_append(StorageMsg _msg, const void * data, size_t len){
+    _FsMsg_t * msg = _msg;
+    return SpoolWriter_write(msg->spool, data, len);
+}
+
+static bool fs_transform(StorageMsg _msg, const char * cmd){
+    _FsMsg_t * msg = _msg;
+    msg->transform_cmd = cmd;
+    return true;
+}
+
+static bool fs_commit(StorageMsg _msg){
+    _FsMsg_t * msg = _msg;
+
+    struct tm tm;
+    Clock_localtime(&tm);
+    char mail_name[MAX_PATH_SIZE];
+    snprintf(mail_name, MAX_PATH_SIZE, MAIL_NAME_FMT, msg->sender,
+        tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+
+    /* The transformation command works on files: memory-resident mails must spill */
+    bool ok = msg->transform_cmd == NULL || SpoolWriter_spill(msg->spool);
+
+    /* Write whatever is left in the spool buffer, and account for the whole mail */
+    ok = SpoolWriter_flush(msg->spool) && ok;
+    Stats_increment(stats, STATKEY_SPOOL_MSGS);
+    Stats_update(stats, STATKEY_SPOOL_WRITES, (StatVal) SpoolWriter_syscalls(msg->spool));
+    Stats_update(stats, STATKEY_SPOOL_BYTES, (StatVal) SpoolWriter_size(msg->spool));
+
+    /* Memory-resident mail: write it straight into every inbox */
+    size_t mail_len;
+    const void * mail = SpoolWriter_memory(msg->spool, &mail_len);
+    if (ok && mail != NULL){
+        Stats_increment(stats, STATKEY_SPOOL_MEM_MSGS);
+        for (size_t i = 0; i < msg->rcpt_qty && ok; i++){
+            uint64_t start = Clock_ns();
+            ok = dump_mem(mail, mail_len, msg->rcpts[i], msg->sender, mail_name) != ERR;
+            Stats_record(stats, HISTKEY_DUMP, Clock_ns() - start);
+        }
+        free_msg(msg);
+        return ok;
+    }
+
+    /* Spooled mail: transform it if needed, and copy it into every inbox */
+    ok = SpoolWriter_close(msg->spool) && ok;
+    msg->spool = NULL;
+    if (ok && msg->transform_cmd != NULL){
+        uint64_t start = Clock_ns();
+        ok = transform(msg->transform_cmd, msg->spool_path) != ERR;
+        Stats_record(stats, HISTKEY_TRANSFORM, Clock_ns() - start);
+        Stats_increment(stats, ok ? STATKEY_TRANSFORMS : STATKEY_TRANSFORM_FAILURES);
+    }
+    for (size_t i = 0; i < msg->rcpt_qty && ok; i++){
+        uint64_t start = Clock_ns();
+        ok = dump(msg->spool_path, msg->rcpts[i], msg->sender, mail_name) != ERR;
+        Stats_record(stats, HISTKEY_DUMP, Clock_ns() - start);
+    }
+    remove(msg->spool_path);
+    free_msg(msg);
+    return ok;
+}
+
+static void fs_abort(StorageMsg _msg){
+    _FsMsg_t * msg = _msg;
+    SpoolWriter_close(msg->spool);
+    msg->spool = NULL;
+    remove(msg->spool_path);            // The file may not exist (memory-resident mail)
+    free_msg(msg);
+}
+
+/*************************************************************************/
+/* Backend                                                               */
+/*************************************************************************/
+
+const StorageBackend storage_fs_backend = {
+    .init       = fs_init,
+    .cleanup    = fs_cleanup,
+    .begin      = fs_begin,
+    .add_rcpt   = fs_add_rcpt,
+    .append     = fs_append,
+    .transform  = fs_transform,
+    .commit     = fs_commit,
+    .abort      = fs_abort,
+};
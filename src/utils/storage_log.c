@@ -0,0 +1,153 @@
+/**
+ * \file        storage_log.c
+ * \brief       "log" storage backend: messages are appended to the segment files
+ *              of a log-structured store under ./store (see logstore.h).
+ *
+ * \details     Message contents are kept in memory while they are received, so
+ *              that every message becomes a single sequential append per shard.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdlib.h>         // malloc(), realloc(), free()
+#include <stdint.h>         // uint8_t
+#include <string.h>         // memcpy(), strdup(), strcspn()
+
+#include "storage.h"
+#include "logstore.h"
+
+#define STORE_ROOT              "./store"
+#define INITIAL_BODY_SIZE       1024
+
+/*************************************************************************/
+/* Private data structures                                               */
+/*************************************************************************/
+
+typedef struct _LogMsg_t {
+    char *      sender;
+    char **     rcpts;          // Mailboxes ("user@domain").
+    size_t      rcpt_qty;
+    uint8_t *   body;
+    size_t      body_len;
+    size_t      body_size;
+    bool        failed;         // Sticky: set on the first append error.
+} _LogMsg_t;
+
+/*************************************************************************/
+/* Module-global variables                                               */
+/*************************************************************************/
+
+static LogStore store = NULL;
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static void free_msg(_LogMsg_t * msg){
+    for (size_t i = 0; i < msg->rcpt_qty; i++){
+        free(msg->rcpts[i]);
+    }
+    free(msg->rcpts);
+    free(msg->body);
+    free(msg->sender);
+    free(msg);
+}
+
+static bool log_init(void){
+    if ((store = LogStore_open(STORE_ROOT, LOGSTORE_DEFAULT_SHARDS, LOGSTORE_DEFAULT_SEGMENT_SIZE)) == NULL){
+        return false;
+    }
+    if (! LogStore_start_compactor(store, LOGSTORE_COMPACT_INTERVAL)){
+        LogStore_close(store);
+        store = NULL;
+        return false;
+    }
+    return true;
+}
+
+static void log_cleanup(void){
+    LogStore_close(store);      // NULL-safe
+    store = NULL;
+}
+
+static StorageMsg log_begin(const char * sender){
+    _LogMsg_t * msg = calloc(1, sizeof(_LogMsg_t));
+    if (msg == NULL){
+        return NULL;
+    }
+    if ((msg->sender = strdup(sender)) == NULL){
+        free(msg);
+        return NULL;
+    }
+    return msg;
+}
+
+static bool log_add_rcpt(StorageMsg _msg, const char * rcpt){
+    _LogMsg_t * msg = _msg;
+    char ** rcpts = realloc(msg->rcpts, (msg->rcpt_qty + 1) * sizeof(char *));
+    if (rcpts == NULL){
+        return false;
+    }
+    msg->rcpts = rcpts;
+
+    /* Recipients may still carry the line terminator */
+    size_t len = strcspn(rcpt, "\r\n");
+    if ((msg->rcpts[msg->rcpt_qty] = malloc(len + 1)) == NULL){
+        return false;
+    }
+    memcpy(msg->rcpts[msg->rcpt_qty], rcpt, len);
+    msg->rcpts[msg->rcpt_qty][len] = '\0';
+    msg->rcpt_qty++;
+    return true;
+}
+
+static bool log_append(StorageMsg _msg, const void * data, size_t len){
+    _LogMsg_t * msg = _msg;
+    if (msg->failed){
+        return false;
+    }
+    if (msg->body_len + len > msg->body_size){
+        size_t size = msg->body_size == 0 ? INITIAL_BODY_SIZE : msg->body_size;
+        while (size < msg->body_len + len){
+            size *= 2;
+        }
+        uint8_t * body = realloc(msg->body, size);
+        if (body == NULL){
+            msg->failed = true;
+            return false;
+        }
+        msg->body       = body;
+        msg->body_size  = size;
+    }
+    memcpy(msg->body + msg->body_len, data, len);
+    msg->body_len += len;
+    return true;
+}
+
+static bool log_commit(StorageMsg _msg){
+    _LogMsg_t * msg = _msg;
+    bool ok = ! msg->failed && LogStore_append(store, msg->sender, msg->body, msg->body_len,
+                                               (const char * const *) msg->rcpts, msg->rcpt_qty, NULL);
+    free_msg(msg);
+    return ok;
+}
+
+static void log_abort(StorageMsg msg){
+    free_msg(msg);
+}
+
+/*************************************************************************/
+/* Backend                                                               */
+/*************************************************************************/
+
+const StorageBackend storage_log_backend = {
+    .init       = log_init,
+    .cleanup    = log_cleanup,
+    .begin      = log_begin,
+    .add_rcpt   = log_add_rcpt,
+    .append     = log_append,
+    .transform  = NULL,
+    .commit     = log_commit,
+    .abort      = log_abort,
+};
@@ -0,0 +1,164 @@
+/**
+ * \file        storage_memory.c
+ * \brief       "memory" storage backend: delivered messages are kept in memory.
+ *
+ * \details     Committed messages are kept in a FIFO list. When the contents of all
+ *              stored messages exceed `STORAGE_MEMORY_MAX_BYTES`, the oldest ones are
+ *              dropped, so the backend can be used for long load tests.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdlib.h>         // malloc(), realloc(), free()
+#include <stdint.h>         // uint8_t
+#include <string.h>         // memcpy(), strdup()
+
+#include "storage.h"
+
+/* Maximum amount of bytes kept for all stored messages */
+#define STORAGE_MEMORY_MAX_BYTES    (64 * 1024 * 1024)
+
+/* Initial capacity of a message's contents */
+#define STORAGE_MEMORY_INITIAL_SIZE 1024
+
+/*************************************************************************/
+/* Private data structures                                               */
+/*************************************************************************/
+
+typedef struct _MemoryMsg_t {
+    char *                  sender;
+    char **                 rcpts;
+    size_t                  rcpt_qty;
+    uint8_t *               body;
+    size_t                  body_len;
+    size_t                  body_size;
+    bool                    failed;         // Sticky: set on the first append error.
+    struct _MemoryMsg_t *   next;           // Next (newer) stored message.
+} _MemoryMsg_t;
+
+/*************************************************************************/
+/* Module-global variables                                               */
+/*************************************************************************/
+
+static _MemoryMsg_t *   oldest          = NULL;
+static _MemoryMsg_t *   newest          = NULL;
+static size_t           stored_bytes    = 0;
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static void free_msg(_MemoryMsg_t * msg){
+    for (size_t i = 0; i < msg->rcpt_qty; i++){
+        free(msg->rcpts[i]);
+    }
+    free(msg->rcpts);
+    free(msg->body);
+    free(msg->sender);
+    free(msg);
+}
+
+static void drop_oldest(void){
+    _MemoryMsg_t * msg = oldest;
+    oldest = msg->next;
+    if (oldest == NULL){
+        newest = NULL;
+    }
+    stored_bytes -= msg->body_len;
+    free_msg(msg);
+}
+
+static StorageMsg memory_begin(const char * sender){
+    _MemoryMsg_t * msg = calloc(1, sizeof(_MemoryMsg_t));
+    if (msg == NULL){
+        return NULL;
+    }
+    if ((msg->sender = strdup(sender == NULL ? "" : sender)) == NULL){
+        free(msg);
+        return NULL;
+    }
+    return msg;
+}
+
+static bool memory_add_rcpt(StorageMsg _msg, const char * rcpt){
+    _MemoryMsg_t * msg = _msg;
+    char ** rcpts = realloc(msg->rcpts, (msg->rcpt_qty + 1) * sizeof(char *));
+    if (rcpts == NULL){
+        return false;
+    }
+    msg->rcpts = rcpts;
+    if ((msg->rcpts[msg->rcpt_qty] = strdup(rcpt)) == NULL){
+        return false;
+    }
+    msg->rcpt_qty++;
+    return true;
+}
+
+static bool memory_append(StorageMsg _msg, const void * data, size_t len){
+    _MemoryMsg_t * msg = _msg;
+    if (msg->failed){
+        return false;
+    }
+    if (msg->body_len + len > msg->body_size){
+        size_t size = msg->body_size == 0 ? STORAGE_MEMORY_INITIAL_SIZE : msg->body_size;
+        while (size < msg->body_len + len){
+            size *= 2;
+        }
+        uint8_t * body = realloc(msg->body, size);
+        if (body == NULL){
+            msg->failed = true;
+            return false;
+        }
+        msg->body       = body;
+        msg->body_size  = size;
+    }
+    memcpy(msg->body + msg->body_len, data, len);
+    msg->body_len += len;
+    return true;
+}
+
+static bool memory_commit(StorageMsg _msg){
+    _MemoryMsg_t * msg = _msg;
+    if (msg->failed || msg->body_len > STORAGE_MEMORY_MAX_BYTES){
+        free_msg(msg);
+        return false;
+    }
+
+    /* Make room by dropping the oldest messages */
+    while (stored_bytes + msg->body_len > STORAGE_MEMORY_MAX_BYTES){
+        drop_oldest();
+    }
+
+    msg->next = NULL;
+    if (newest != NULL){
+        newest->next = msg;
+    }
+    else{
+        oldest = msg;
+    }
+    newest = msg;
+    stored_bytes += msg->body_len;
+    return true;
+}
+
+static void memory_abort(StorageMsg msg){
+    free_msg(msg);
+}
+
+static void memory_cleanup(void){
+    while (oldest != NULL){
+        drop_oldest();
+    }
+}
+
+const StorageBackend storage_memory_backend = {
+    .init       = NULL,
+    .cleanup    = memory_cleanup,
+    .begin      = memory_begin,
+    .add_rcpt   = memory_add_rcpt,
+    .append     = memory_append,
+    .transform  = NULL,
+    .commit     = memory_commit,
+    .abort      = memory_abort,
+};
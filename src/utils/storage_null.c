@@ -0,0 +1,50 @@
+/**
+ * \file        storage_null.c
+ * \brief       "null" storage backend: accepts every message and stores nothing.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include "storage.h"
+
+/* Every message is the same (stateless) message */
+static char null_msg;
+
+static StorageMsg null_begin(const char * sender){
+    (void) sender;
+    return &null_msg;
+}
+
+static bool null_add_rcpt(StorageMsg msg, const char * rcpt){
+    (void) msg;
+    (void) rcpt;
+    return true;
+}
+
+static bool null_append(StorageMsg msg, const void * data, size_t len){
+    (void) msg;
+    (void) data;
+    (void) len;
+    return true;
+}
+
+static bool null_commit(StorageMsg msg){
+    (void) msg;
+    return true;
+}
+
+static void null_abort(StorageMsg msg){
+    (void) msg;
+}
+
+const StorageBackend storage_null_backend = {
+    .init       = NULL,
+    .cleanup    = NULL,
+    .begin      = null_begin,
+    .add_rcpt   = null_add_rcpt,
+    .append     = null_append,
+    .transform  = NULL,
+    .commit     = null_commit,
+    .abort      = null_abort,
+};
@@ -9,27 +9,20 @@
 #include "../lib/logger.h"
 
 #define TMP "./tmp"
-#define INBOX "./inbox"
 #define MODE_T 0770
 #define SUCCESS 0
 #define ERR -1
 #define BUFF_SIZE 1024
-#define MAX_DIR_SIZE 512 // Out file system has a 2-level directory to save the mails
+#define DUMP_MAX_ATTEMPTS 2
 #define MAIL_FROM_STR "MAIL FROM: <%s>\r\n"
 #define RCPT_TO_STR "RCPT TO: <%s>\r\n"
 #define DATA_STR "DATA\r\n"
 #define DOT_CLRF ".\r\n"
 
 extern Logger logger;
+extern DirCache dircache;
 
-static void check_dir(char * dir) {
-    struct stat st = {0};
-    if (stat(dir, &st) == -1) {
-        mkdir(dir, MODE_T);
-    }
-}
-
-int transform(char * cmd, char * mailDir) {
+int transform(const char * cmd, const char * mailDir) {
 
     char buff[BUFF_SIZE] = {0};
 
@@ -41,22 +34,16 @@ int transform(char * cmd, char * mailDir) {
     return retVal;
 }
 
-static int send_mail(char * mailDir, char * receiverMail, char * senderMail,char * toSave) {
-    int mailFd = open(mailDir, 0 , MODE_T);
-    int toSaveFd = open(toSave, O_CREAT | O_EXCL | O_WRONLY , MODE_T);
-
-    if(mailFd == ERR || toSaveFd == ERR) return ERR;
+static int send_mail(char * mailDir, char * receiverMail, char * senderMail, int toSaveFd) {
+    int mailFd = open(mailDir, O_RDONLY);
+    if(mailFd == ERR) return ERR;
 
     char buff[BUFF_SIZE] = {0};
-
-    sprintf(buff, MAIL_FROM_STR, senderMail);
-    write(toSaveFd, buff, strlen(buff));
-    for(int i = 0; i < BUFF_SIZE && buff[i] != '\0'; i++) buff[i] = '\0';
-
-    sprintf(buff, RCPT_TO_STR, receiverMail);
-    write(toSaveFd, buff, strlen(buff));
-
-    write(toSaveFd, DATA_STR, strlen(DATA_STR));
+    int headerLen = snprintf(buff, BUFF_SIZE, MAIL_FROM_STR RCPT_TO_STR DATA_STR, senderMail, receiverMail);
+    if(headerLen < 0 || headerLen >= BUFF_SIZE) {
+        close(mailFd);
+        return ERR;
+    }
 
     int n;
     struct stat s;
@@ -65,6 +52,11 @@ static int send_mail(char * mailDir, char * receiverMail, char * senderMail,char
     fstat(mailFd, &s);
     n = s.st_size;
 
+    /* The final size is known beforehand: let the file system allocate it at once */
+    spool_preallocate(toSaveFd, headerLen + s.st_size + strlen(DOT_CLRF));
+
+    write(toSaveFd, buff, headerLen);
+
     while(n > 0) {
         const int sb = sendfile(toSaveFd, mailFd, &offset, n);
         if(sb <= -1) {
@@ -79,43 +71,79 @@ static int send_mail(char * mailDir, char * receiverMail, char * senderMail,char
     write(toSaveFd, DOT_CLRF, strlen(DOT_CLRF));
 
     close(mailFd);
-    close(toSaveFd);
 
     return SUCCESS;
 }
 
-int dump(char * mailDir, char * receiverMail, char * senderMail, char * fileName){
-    char userName[MAX_DIR_SIZE/2] = {0};
-    char domain[MAX_DIR_SIZE/2] = {0};
-    int receiverLen = strlen(receiverMail);
+/**
+ * \brief       Create the file `fileName` in the mailbox of `receiverMail` (user@domain).
+ *
+ * \return      The new file descriptor, or ERR on failure.
+ */
+static int open_mailbox_file(char * receiverMail, char * fileName) {
+    char userName[DIRCACHE_MAX_NAME_LEN + 1] = {0};
+    char domain[DIRCACHE_MAX_NAME_LEN + 1] = {0};
     int i = 0;
-    while(i < receiverLen && receiverMail[i] != '@'){
+    while(i < DIRCACHE_MAX_NAME_LEN && receiverMail[i] != '@' && receiverMail[i] != '\0'){
         userName[i] = receiverMail[i];
         i++;
     }
+    if(receiverMail[i] != '@') return ERR;
     i++;
     int j = 0;
-    while(i < receiverLen && receiverMail[i] != '\r' && receiverMail[i] != '\n' && receiverMail[i] != '\0' ){
+    while(j < DIRCACHE_MAX_NAME_LEN && receiverMail[i] != '\r' && receiverMail[i] != '\n' && receiverMail[i] != '\0' ){
         domain[j] = receiverMail[i];
         i++;
         j++;
     }
-    check_dir(INBOX);
 
-    char user_dir[BUFF_SIZE] = {0};
-    char toSave[BUFF_SIZE] = {0};
+    /**
+     * The mailbox directory (or its fan-out subdirectory for this file) comes from the
+     * DirCache, so on a cache hit the only path lookup left is the single-component
+     * openat (2) below. If it fails with ENOENT the cached directory was removed:
+     * invalidate it and try again (recreating it).
+     */
+    int toSaveFd = ERR;
+    for(int attempt = 0; attempt < DUMP_MAX_ATTEMPTS && toSaveFd == ERR; attempt++) {
+        int userDirFd = DirCache_get(dircache, domain, userName, fileName);
+        if(userDirFd == ERR) return ERR;
+
+        toSaveFd = openat(userDirFd, fileName, O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, MODE_T);
+        if(toSaveFd == ERR && errno != ENOENT) return ERR;
+        if(toSaveFd == ERR) DirCache_invalidate(dircache, domain, userName, fileName);
+    }
+    return toSaveFd;
+}
 
-    snprintf(user_dir, strlen(INBOX) + strlen(domain) + 2, "%s/%s", INBOX, domain);
-    check_dir(user_dir);
+int dump(char * mailDir, char * receiverMail, char * senderMail, char * fileName){
+    int toSaveFd = open_mailbox_file(receiverMail, fileName);
+    if(toSaveFd == ERR) return ERR;
 
-    snprintf(user_dir, strlen(INBOX) + strlen(domain) + strlen(userName) + 3, "%s/%s/%s", INBOX, domain, userName);
-    check_dir(user_dir);
+    int transform = send_mail(mailDir, receiverMail, senderMail, toSaveFd);
+    close(toSaveFd);
 
-    snprintf(toSave, strlen(INBOX) + strlen(domain) + strlen(userName) + strlen(fileName) + 4, "%s/%s/%s/%s", INBOX, domain, userName, fileName);
+    return transform != SUCCESS ? ERR : SUCCESS;
+}
 
-    int transform = send_mail(mailDir, receiverMail, senderMail, toSave);
+int dump_mem(const void * mail, size_t mailLen, char * receiverMail, char * senderMail, char * fileName){
+    char buff[BUFF_SIZE] = {0};
+    int headerLen = snprintf(buff, BUFF_SIZE, MAIL_FROM_STR RCPT_TO_STR DATA_STR, senderMail, receiverMail);
+    if(headerLen < 0 || headerLen >= BUFF_SIZE) return ERR;
+
+    int toSaveFd = open_mailbox_file(receiverMail, fileName);
+    if(toSaveFd == ERR) return ERR;
+
+    /* Header, contents and trailer with a single system call */
+    struct iovec iov[3] = {
+        { .iov_base = buff,                 .iov_len = headerLen        },
+        { .iov_base = (void *) mail,        .iov_len = mailLen          },
+        { .iov_base = (void *) DOT_CLRF,    .iov_len = strlen(DOT_CLRF) }
+    };
+    ssize_t total = headerLen + mailLen + strlen(DOT_CLRF);
+    ssize_t written = writev(toSaveFd, iov, 3);
+    close(toSaveFd);
 
-    return transform != SUCCESS ? ERR : SUCCESS;
+    return written != total ? ERR : SUCCESS;
 }
 
 #if 0
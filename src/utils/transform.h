@@ -14,6 +14,7 @@
 #include <sys/types.h>
 #include <sys/sendfile.h>
 #include <fcntl.h>
+#include <errno.h>
 #include <stdbool.h>
 #include <string.h>
 #include <dirent.h>
@@ -21,7 +22,10 @@
 #include <unistd.h>
 #include <sys/wait.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 #include "../lib/logger.h"
+#include "dircache.h"
+#include "spool.h"
 
 /**
  * \brief                       Parses the file given to extract the user and the mail to transform.
@@ -32,7 +36,15 @@
  *
  * \return                      On success, 254. On failure, 255 via pipe.
  */
-int transform(char * cmd, char * mailDir);
+int transform(const char * cmd, const char * mailDir);
 int dump(char * mailDir, char * receiverMail, char * senderMail, char * fileName);
 
+/**
+ * \brief                       Deliver a mail held in memory (see `SpoolWriter_memory`) into the
+ *                              mailbox of `receiverMail`, writing the whole file at once.
+ *
+ * \return                      SUCCESS (0) on success, ERR (-1) on failure.
+ */
+int dump_mem(const void * mail, size_t mailLen, char * receiverMail, char * senderMail, char * fileName);
+
 #endif // __TRANSFORM_H__
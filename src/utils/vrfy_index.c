@@ -0,0 +1,415 @@
+/**
+ * \file        vrfy_index.c
+ * \brief       Read-only index of verified addresses used to answer VRFY commands
+ *              without touching the disk.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdio.h>          // snprintf(), rename()
+#include <stdlib.h>         // malloc(), realloc(), free(), qsort()
+#include <string.h>         // strlen(), strcmp(), strncmp(), memcpy(), memset()
+#include <errno.h>          // errno
+#include <fcntl.h>          // open(), O_* flags
+#include <unistd.h>         // read(), write(), close(), fsync()
+#include <sys/mman.h>       // mmap(), munmap()
+#include <sys/stat.h>       // fstat()
+
+#include "vrfy_index.h"
+#include "../lib/hash.h"
+
+#define FILE_PERMISSIONS        0644
+#define TMP_SUFFIX              ".tmp"
+#define INITIAL_ADDR_QTY        1024
+
+/*************************************************************************/
+/* Private data structures                                               */
+/*************************************************************************/
+
+typedef struct _VrfyIndex_t {
+    void *                  base;           // Whole index (mapped or allocated).
+    size_t                  size;
+    bool                    mapped;         // Whether `base` must be unmapped instead of freed.
+
+    const VrfyIndexHeader * header;
+    const uint32_t *        sorted;
+    const uint32_t *        buckets;
+    const char *            strings;
+} _VrfyIndex_t;
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+/**
+ * \brief       qsort (3) comparator for an array of strings.
+ */
+static int compare_addrs(const void * a, const void * b);
+
+/**
+ * \brief       Read a whole file into a null-terminated buffer.
+ */
+static char * read_file(const char * path, size_t * len);
+
+/**
+ * \brief       Check that `base` holds a well-formed index, and point the index sections
+ *              into it.
+ */
+static bool attach(VrfyIndex self, void * base, size_t size, bool mapped);
+
+/**
+ * \brief       Address stored at position `i` of the sorted array.
+ */
+static const char * addr_at(VrfyIndex self, size_t i);
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+VrfyIndex VrfyIndex_open(const char * path){
+    if (path == NULL){
+        errno = EINVAL;
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1){
+        return NULL;
+    }
+    struct stat st;
+    VrfyIndexHeader header;
+    if (fstat(fd, &st) == -1){
+        close(fd);
+        return NULL;
+    }
+
+    /* Not an index: take it as an address list */
+    if ((size_t) st.st_size < sizeof(header)
+        || read(fd, &header, sizeof(header)) != (ssize_t) sizeof(header)
+        || memcmp(header.magic, VRFY_INDEX_MAGIC, sizeof(VRFY_INDEX_MAGIC)) != 0){
+        close(fd);
+        return VrfyIndex_compile(path);
+    }
+
+    VrfyIndex self = calloc(1, sizeof(_VrfyIndex_t));
+    if (self == NULL){
+        close(fd);
+        return NULL;
+    }
+    void * base = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);                      // The mapping remains valid
+    if (base == MAP_FAILED){
+        free(self);
+        return NULL;
+    }
+    if (! attach(self, base, (size_t) st.st_size, true)){
+        munmap(base, (size_t) st.st_size);
+        free(self);
+        errno = EINVAL;
+        return NULL;
+    }
+    return self;
+}
+
+VrfyIndex VrfyIndex_compile(const char * path){
+    if (path == NULL){
+        errno = EINVAL;
+        return NULL;
+    }
+    size_t text_len;
+    char * text = read_file(path, &text_len);
+    if (text == NULL){
+        return NULL;
+    }
+
+    /* Split the text into trimmed, non-empty lines (in place) */
+    size_t addr_qty = 0;
+    size_t addr_size = INITIAL_ADDR_QTY;
+    char ** addrs = malloc(addr_size * sizeof(char *));
+    if (addrs == NULL){
+        free(text);
+        return NULL;
+    }
+    for (char * line = text; line < text + text_len; ){
+        char * end = line;
+        while (* end != '\n' && * end != '\0'){
+            end++;
+        }
+        char * next = end + 1;
+        while (line < end && (* line == ' ' || * line == '\t')){
+            line++;
+        }
+        while (end > line && (end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')){
+            end--;
+        }
+        * end = '\0';
+
+        if (end > line && (size_t) (end - line) <= VRFY_INDEX_MAX_ADDR_LEN){
+            if (addr_qty == addr_size){
+                char ** aux = realloc(addrs, 2 * addr_size * sizeof(char *));
+                if (aux == NULL){
+                    free(addrs);
+                    free(text);
+                    return NULL;
+                }
+                addrs = aux;
+                addr_size *= 2;
+            }
+            addrs[addr_qty++] = line;
+        }
+        line = next;
+    }
+
+    /* Sort and drop duplicates */
+    qsort(addrs, addr_qty, sizeof(char *), compare_addrs);
+    size_t count = 0;
+    uint64_t strings_size = 0;
+    for (size_t i = 0; i < addr_qty; i++){
+        if (count == 0 || strcmp(addrs[count - 1], addrs[i]) != 0){
+            addrs[count++] = addrs[i];
+            strings_size += strlen(addrs[i]) + 1;
+        }
+    }
+    if (count > UINT32_MAX / 2 || strings_size > UINT32_MAX){
+        free(addrs);
+        free(text);
+        errno = EFBIG;
+        return NULL;
+    }
+
+    /* Hash table with at least twice as many buckets as addresses */
+    size_t bucket_qty = 1;
+    while (bucket_qty < 2 * count){
+        bucket_qty <<= 1;
+    }
+
+    size_t size = sizeof(VrfyIndexHeader) + (count + bucket_qty) * sizeof(uint32_t) + strings_size;
+    VrfyIndex self = calloc(1, sizeof(_VrfyIndex_t));
+    uint8_t * base = calloc(1, size);
+    if (self == NULL || base == NULL){
+        free(self);
+        free(base);
+        free(addrs);
+        free(text);
+        return NULL;
+    }
+
+    VrfyIndexHeader * header = (VrfyIndexHeader *) base;
+    memcpy(header->magic, VRFY_INDEX_MAGIC, sizeof(VRFY_INDEX_MAGIC));
+    header->version         = VRFY_INDEX_VERSION;
+    header->count           = (uint32_t) count;
+    header->bucket_qty      = (uint32_t) bucket_qty;
+    header->strings_size    = strings_size;
+
+    uint32_t * sorted   = (uint32_t *) (base + sizeof(VrfyIndexHeader));
+    uint32_t * buckets  = sorted + count;
+    char * strings      = (char *) (buckets + bucket_qty);
+    uint32_t offset = 0;
+    for (size_t i = 0; i < count; i++){
+        size_t len = strlen(addrs[i]) + 1;
+        memcpy(strings + offset, addrs[i], len);
+        sorted[i] = offset;
+        offset += (uint32_t) len;
+
+        uint32_t b = Hash_fnv1a(addrs[i]) & (bucket_qty - 1);
+        while (buckets[b] != 0){
+            b = (b + 1) & (bucket_qty - 1);
+        }
+        buckets[b] = (uint32_t) (i + 1);
+    }
+    free(addrs);
+    free(text);
+
+    attach(self, base, size, false);        // Well-formed by construction
+    return self;
+}
+
+bool VrfyIndex_save(VrfyIndex const self, const char * path){
+    if (self == NULL || path == NULL){
+        errno = EINVAL;
+        return false;
+    }
+    size_t path_len = strlen(path);
+    char * tmp = malloc(path_len + sizeof(TMP_SUFFIX));
+    if (tmp == NULL){
+        return false;
+    }
+    memcpy(tmp, path, path_len);
+    memcpy(tmp + path_len, TMP_SUFFIX, sizeof(TMP_SUFFIX));
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, FILE_PERMISSIONS);
+    if (fd == -1){
+        free(tmp);
+        return false;
+    }
+    const uint8_t * data = self->base;
+    size_t left = self->size;
+    while (left > 0){
+        ssize_t written = write(fd, data, left);
+        if (written == -1 && errno == EINTR){
+            continue;
+        }
+        if (written <= 0){
+            break;
+        }
+        data += written;
+        left -= (size_t) written;
+    }
+    bool ok = left == 0 && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    ok = ok && rename(tmp, path) == 0;
+    if (! ok){
+        int err = errno;
+        unlink(tmp);
+        errno = err;
+    }
+    free(tmp);
+    return ok;
+}
+
+size_t VrfyIndex_count(VrfyIndex const self){
+    return self == NULL ? 0 : self->header->count;
+}
+
+size_t VrfyIndex_lookup(VrfyIndex const self, const char * query, const char ** matches, size_t max){
+    if (self == NULL || query == NULL || query[0] == '\0' || self->header->count == 0){
+        return 0;
+    }
+
+    /* Exact match */
+    uint32_t mask = self->header->bucket_qty - 1;
+    for (uint32_t b = Hash_fnv1a(query) & mask; self->buckets[b] != 0; b = (b + 1) & mask){
+        const char * addr = addr_at(self, self->buckets[b] - 1);
+        if (strcmp(addr, query) == 0){
+            if (max > 0){
+                matches[0] = addr;
+            }
+            return 1;
+        }
+    }
+
+    /* Prefix match: first address not lower than the query... */
+    size_t query_len = strlen(query);
+    size_t lo = 0, hi = self->header->count;
+    while (lo < hi){
+        size_t mid = lo + (hi - lo) / 2;
+        if (strcmp(addr_at(self, mid), query) < 0){
+            lo = mid + 1;
+        }
+        else{
+            hi = mid;
+        }
+    }
+    size_t first = lo;
+
+    /* ...and first address past the ones starting with it */
+    hi = self->header->count;
+    while (lo < hi){
+        size_t mid = lo + (hi - lo) / 2;
+        if (strncmp(addr_at(self, mid), query, query_len) == 0){
+            lo = mid + 1;
+        }
+        else{
+            hi = mid;
+        }
+    }
+
+    for (size_t i = first; i < lo && i - first < max; i++){
+        matches[i - first] = addr_at(self, i);
+    }
+    return lo - first;
+}
+
+void VrfyIndex_close(VrfyIndex self){
+    if (self == NULL){
+        return;
+    }
+    if (self->mapped){
+        munmap(self->base, self->size);
+    }
+    else{
+        free(self->base);
+    }
+    free(self);
+}
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static int compare_addrs(const void * a, const void * b){
+    return strcmp(* (const char * const *) a, * (const char * const *) b);
+}
+
+static char * read_file(const char * path, size_t * len){
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1){
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1){
+        close(fd);
+        return NULL;
+    }
+    char * text = malloc((size_t) st.st_size + 1);
+    if (text == NULL){
+        close(fd);
+        return NULL;
+    }
+    size_t total = 0;
+    while (total < (size_t) st.st_size){
+        ssize_t n = read(fd, text + total, (size_t) st.st_size - total);
+        if (n == -1 && errno == EINTR){
+            continue;
+        }
+        if (n <= 0){
+            break;                  // The file shrank: use what was read
+        }
+        total += (size_t) n;
+    }
+    close(fd);
+    text[total] = '\0';
+    * len = total;
+    return text;
+}
+
+static bool attach(VrfyIndex self, void * base, size_t size, bool mapped){
+    const VrfyIndexHeader * header = base;
+    if (header->version != VRFY_INDEX_VERSION || header->bucket_qty == 0
+        || (header->bucket_qty & (header->bucket_qty - 1)) != 0 || header->bucket_qty <= header->count){
+        return false;
+    }
+    uint64_t expected = sizeof(VrfyIndexHeader) + ((uint64_t) header->count + header->bucket_qty) * sizeof(uint32_t)
+                        + header->strings_size;
+    if (expected != size){
+        return false;
+    }
+
+    self->base      = base;
+    self->size      = size;
+    self->mapped    = mapped;
+    self->header    = header;
+    self->sorted    = (const uint32_t *) ((const uint8_t *) base + sizeof(VrfyIndexHeader));
+    self->buckets   = self->sorted + header->count;
+    self->strings   = (const char *) (self->buckets + header->bucket_qty);
+
+    /* Every address must lie within the string pool, which must end with a terminator */
+    if (header->count > 0 && (header->strings_size == 0 || self->strings[header->strings_size - 1] != '\0')){
+        return false;
+    }
+    for (uint32_t i = 0; i < header->count; i++){
+        if (self->sorted[i] >= header->strings_size){
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->bucket_qty; i++){
+        if (self->buckets[i] > header->count){
+            return false;
+        }
+    }
+    return true;
+}
+
+static const char * addr_at(VrfyIndex self, size_t i){
+    return self->strings + self->sorted[i];
+}
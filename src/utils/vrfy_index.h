@@ -0,0 +1,121 @@
+/**
+ * \file        vrfy_index.h
+ * \brief       Read-only index of verified addresses used to answer VRFY commands
+ *              without touching the disk.
+ *
+ * \details     The index is a single block of memory that can be saved to a file
+ *              and memory-mapped back, so smtpd loads it at startup at the cost of
+ *              an mmap (2). Index files are built with the vrfyidx tool
+ *              (src/vrfyidx). A plain address list (one address per line) is also
+ *              accepted and compiled in memory at load time.
+ *
+ *              Since index files are mapped, they must be replaced with rename (2)
+ *              (as vrfyidx does) and never rewritten in place while loaded.
+ *
+ *              Layout (host byte order):
+ *
+ *                  header          `VrfyIndexHeader`
+ *                  sorted          uint32_t[count]         Offsets of every address in
+ *                                                          `strings`, in lexicographic order.
+ *                  buckets         uint32_t[bucket_qty]    Open-addressing hash table
+ *                                                          (linear probing) of positions in
+ *                                                          `sorted` plus one (0: empty).
+ *                  strings         char[strings_size]      Null-terminated addresses.
+ *
+ *              Exact matches are answered by the hash table in O(1). Otherwise, the
+ *              query is taken as a prefix ("john" or "john@") and the range of
+ *              addresses that start with it is found by binary search.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __VRFY_INDEX_H__
+#define __VRFY_INDEX_H__
+
+#include <stddef.h>         // size_t
+#include <stdint.h>         // uint32_t, uint64_t
+#include <stdbool.h>        // bool
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Longest address accepted (longer lines are ignored) */
+#define VRFY_INDEX_MAX_ADDR_LEN     255
+
+/*************************************************************************/
+
+#define VRFY_INDEX_MAGIC            "VRFYIDX"
+#define VRFY_INDEX_VERSION          1
+
+/**
+ * \typedef     VrfyIndexHeader: Header at the beginning of every index.
+ */
+typedef struct {
+    char        magic[8];       // VRFY_INDEX_MAGIC (null-terminated).
+    uint32_t    version;        // VRFY_INDEX_VERSION.
+    uint32_t    count;          // Amount of addresses.
+    uint32_t    bucket_qty;     // Size of the hash table (a power of two).
+    uint32_t    reserved;
+    uint64_t    strings_size;   // Size of the string pool in bytes.
+} VrfyIndexHeader;
+
+/**
+ * \typedef     VrfyIndex: Main VRFY Index ADT data type.
+ */
+typedef struct _VrfyIndex_t * VrfyIndex;
+
+/*************************************************************************/
+
+/**
+ * \brief       Load an index file (memory-mapping it) or, if `path` is not an index,
+ *              compile it as an address list with one address per line.
+ *
+ * \return      A new VrfyIndex on success, NULL on failure (errno is set accordingly;
+ *              EINVAL means that the file is a corrupt index).
+ */
+VrfyIndex VrfyIndex_open(const char * path);
+
+/**
+ * \brief       Compile an address list (one address per line) into an index held in memory.
+ *
+ * \return      A new VrfyIndex on success, NULL on failure (errno is set accordingly).
+ */
+VrfyIndex VrfyIndex_compile(const char * path);
+
+/**
+ * \brief       Write an index to `path`, so that it can be loaded with `VrfyIndex_open`.
+ *              The file is replaced atomically.
+ *
+ * \return      true on success, false on failure (errno is set accordingly).
+ */
+bool VrfyIndex_save(VrfyIndex const self, const char * path);
+
+/**
+ * \brief       Amount of addresses in the index.
+ */
+size_t VrfyIndex_count(VrfyIndex const self);
+
+/**
+ * \brief       Look up an address. If `query` is an address of the index, it is the only
+ *              match. Otherwise, every address that starts with `query` matches.
+ *
+ * \param[in]  self         The VrfyIndex itself.
+ * \param[in]  query        Address or prefix.
+ * \param[out] matches      Where to store (up to `max`) matches, in lexicographic order. The
+ *                          strings belong to the index. May be NULL if `max` is 0.
+ * \param[in]  max          Maximum amount of matches to store.
+ *
+ * \return      The total amount of matches (which may be greater than `max`).
+ */
+size_t VrfyIndex_lookup(VrfyIndex const self, const char * query, const char ** matches, size_t max);
+
+/**
+ * \brief       Unmap or free the index.
+ *
+ * \param[in] self          The VrfyIndex itself. NULL-safe.
+ */
+void VrfyIndex_close(VrfyIndex self);
+
+#endif // __VRFY_INDEX_H__
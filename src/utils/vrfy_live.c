@@ -0,0 +1,293 @@
+/**
+ * \file        vrfy_live.c
+ * \brief       VRFY address set that is reloaded while smtpd runs, without blocking
+ *              the event loop.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdlib.h>         // calloc(), free()
+#include <string.h>         // strdup(), strrchr(), strcmp()
+#include <errno.h>          // errno
+#include <fcntl.h>          // fcntl(), O_NONBLOCK
+#include <unistd.h>         // pipe(), read(), write(), close()
+#include <poll.h>           // poll()
+#include <signal.h>         // sigfillset(), pthread_sigmask()
+#include <stdatomic.h>      // atomic_*
+#include <time.h>           // nanosleep()
+#include <pthread.h>        // pthread_create(), pthread_join()
+#include <sys/inotify.h>    // inotify_*
+
+#include "vrfy_live.h"
+
+#define CMD_RELOAD              'r'
+#define CMD_STOP                's'
+#define EVENTS_BUFF_SIZE        4096
+#define WATCH_MASK              (IN_CLOSE_WRITE | IN_MOVED_TO)
+#define MAX_SETTLE_ROUNDS       50                  // Reload anyway if the file never settles
+#define GRACE_POLL_NS           100000              // 100 us
+
+/*************************************************************************/
+/* Private data structures                                               */
+/*************************************************************************/
+
+typedef struct _VrfyLive_t {
+    char *                  path;
+    char *                  dir;                // Directory that holds the file (watched).
+    const char *            name;               // File name within `dir` (points into `path`).
+
+    _Atomic(VrfyIndex)      current;            // Published index.
+    atomic_uint             readers;            // Critical sections in progress.
+    atomic_size_t           reloads_ok;
+    atomic_size_t           reloads_failed;
+
+    int                     inotify_fd;         // -1 if the file cannot be watched.
+    int                     cmd_fds[2];         // Pipe used to send commands to the reload thread.
+    pthread_t               thread;
+    bool                    thread_running;
+} _VrfyLive_t;
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+/**
+ * \brief       Start watching the directory of the address file. Failing to do so is
+ *              not an error: explicit reloads keep working.
+ */
+static void start_watching(VrfyLive self);
+
+/**
+ * \brief       Drain pending inotify events.
+ *
+ * \return      true if any of them refers to the address file.
+ */
+static bool drain_events(VrfyLive self);
+
+/**
+ * \brief       Build a new index and publish it, releasing the old one after a grace period.
+ */
+static void reload(VrfyLive self);
+
+/**
+ * \brief       Reload thread.
+ */
+static void * reload_main(void * arg);
+
+/*************************************************************************/
+/* Public functions                                                      */
+/*************************************************************************/
+
+VrfyLive VrfyLive_open(const char * path){
+    if (path == NULL){
+        errno = EINVAL;
+        return NULL;
+    }
+    VrfyLive self = calloc(1, sizeof(_VrfyLive_t));
+    if (self == NULL){
+        return NULL;
+    }
+    self->inotify_fd    = -1;
+    self->cmd_fds[0]    = -1;
+    self->cmd_fds[1]    = -1;
+    atomic_init(&self->current, NULL);
+    atomic_init(&self->readers, 0);
+    atomic_init(&self->reloads_ok, 0);
+    atomic_init(&self->reloads_failed, 0);
+
+    /* Split the path into directory and file name */
+    if ((self->path = strdup(path)) == NULL || (self->dir = strdup(path)) == NULL){
+        VrfyLive_close(self);
+        return NULL;
+    }
+    char * slash = strrchr(self->dir, '/');
+    if (slash == NULL){
+        free(self->dir);
+        self->dir   = strdup(".");
+        self->name  = self->path;
+    }
+    else{
+        * (slash == self->dir ? slash + 1 : slash) = '\0';      // Keep "/" for files in the root directory
+        self->name  = self->path + (slash - self->dir) + 1;
+    }
+
+    VrfyIndex index = VrfyIndex_open(path);
+    if (self->dir == NULL || index == NULL){
+        VrfyLive_close(self);
+        return NULL;
+    }
+    atomic_store(&self->current, index);
+
+    /* The write end must never block a signal handler */
+    if (pipe(self->cmd_fds) == -1 || fcntl(self->cmd_fds[1], F_SETFL, O_NONBLOCK) == -1
+        || fcntl(self->cmd_fds[0], F_SETFD, FD_CLOEXEC) == -1 || fcntl(self->cmd_fds[1], F_SETFD, FD_CLOEXEC) == -1){
+        VrfyLive_close(self);
+        return NULL;
+    }
+    start_watching(self);
+
+    /* The reload thread must not handle signals meant for the event loop */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    int err = pthread_create(&self->thread, NULL, reload_main, self);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (err != 0){
+        VrfyLive_close(self);
+        errno = err;
+        return NULL;
+    }
+    self->thread_running = true;
+    return self;
+}
+
+VrfyIndex VrfyLive_acquire(VrfyLive const self){
+    atomic_fetch_add(&self->readers, 1);
+    return atomic_load(&self->current);
+}
+
+void VrfyLive_release(VrfyLive const self){
+    atomic_fetch_sub(&self->readers, 1);
+}
+
+void VrfyLive_request_reload(VrfyLive const self){
+    if (self == NULL){
+        return;
+    }
+    int err = errno;                    // May be called from a signal handler
+    char cmd = CMD_RELOAD;
+    if (write(self->cmd_fds[1], &cmd, 1) == -1){
+        /* The pipe is full: a reload is already pending */
+    }
+    errno = err;
+}
+
+size_t VrfyLive_count(VrfyLive const self){
+    if (self == NULL){
+        return 0;
+    }
+    VrfyIndex index = VrfyLive_acquire(self);
+    size_t count = VrfyIndex_count(index);
+    VrfyLive_release(self);
+    return count;
+}
+
+void VrfyLive_reloads(VrfyLive const self, size_t * ok, size_t * failed){
+    * ok        = self == NULL ? 0 : atomic_load(&self->reloads_ok);
+    * failed    = self == NULL ? 0 : atomic_load(&self->reloads_failed);
+}
+
+void VrfyLive_close(VrfyLive self){
+    if (self == NULL){
+        return;
+    }
+    if (self->thread_running){
+        char cmd = CMD_STOP;
+        while (write(self->cmd_fds[1], &cmd, 1) == -1 && (errno == EAGAIN || errno == EINTR)){
+            nanosleep(&(struct timespec){ .tv_sec = 0, .tv_nsec = GRACE_POLL_NS }, NULL);
+        }
+        pthread_join(self->thread, NULL);
+    }
+    for (int i = 0; i < 2; i++){
+        if (self->cmd_fds[i] != -1){
+            close(self->cmd_fds[i]);
+        }
+    }
+    if (self->inotify_fd != -1){
+        close(self->inotify_fd);
+    }
+    VrfyIndex_close(atomic_load(&self->current));       // NULL-safe
+    free(self->dir);
+    free(self->path);
+    free(self);
+}
+
+/*************************************************************************/
+/* Private functions                                                     */
+/*************************************************************************/
+
+static void start_watching(VrfyLive self){
+    /**
+     * The directory is watched instead of the file itself, so that files replaced with
+     * rename (2) (as vrfyidx does) keep being noticed.
+     */
+    self->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (self->inotify_fd != -1 && inotify_add_watch(self->inotify_fd, self->dir, WATCH_MASK) == -1){
+        close(self->inotify_fd);
+        self->inotify_fd = -1;
+    }
+}
+
+static bool drain_events(VrfyLive self){
+    bool changed = false;
+    _Alignas(struct inotify_event) char buff[EVENTS_BUFF_SIZE];
+    ssize_t len;
+    while ((len = read(self->inotify_fd, buff, sizeof(buff))) > 0){
+        for (char * ptr = buff; ptr < buff + len; ){
+            const struct inotify_event * event = (const struct inotify_event *) ptr;
+            if (event->len > 0 && strcmp(event->name, self->name) == 0){
+                changed = true;
+            }
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    return changed;
+}
+
+static void reload(VrfyLive self){
+    VrfyIndex index = VrfyIndex_open(self->path);
+    if (index == NULL){
+        atomic_fetch_add(&self->reloads_failed, 1);
+        return;
+    }
+    VrfyIndex old = atomic_exchange(&self->current, index);
+
+    /**
+     * Grace period: critical sections that began before the exchange may still be using
+     * the old index. Once the count of readers drops to zero, every one of them has ended,
+     * and those that begin afterwards can only see the new index.
+     */
+    while (atomic_load(&self->readers) != 0){
+        nanosleep(&(struct timespec){ .tv_sec = 0, .tv_nsec = GRACE_POLL_NS }, NULL);
+    }
+    VrfyIndex_close(old);
+    atomic_fetch_add(&self->reloads_ok, 1);
+}
+
+static void * reload_main(void * arg){
+    VrfyLive self = arg;
+    struct pollfd fds[2] = {
+        { .fd = self->cmd_fds[0],   .events = POLLIN },
+        { .fd = self->inotify_fd,   .events = POLLIN },     // Ignored by poll (2) if -1
+    };
+
+    while (true){
+        if (poll(fds, 2, -1) == -1){
+            continue;                   // EINTR
+        }
+
+        bool pending = false;
+        if (fds[0].revents & POLLIN){
+            char cmds[EVENTS_BUFF_SIZE];
+            ssize_t len = read(self->cmd_fds[0], cmds, sizeof(cmds));
+            for (ssize_t i = 0; i < len; i++){
+                if (cmds[i] == CMD_STOP){
+                    return NULL;
+                }
+                pending = true;
+            }
+        }
+        if (fds[1].revents & POLLIN && drain_events(self)){
+            /* Wait for the file to settle: it may still be being written */
+            for (int i = 0; i < MAX_SETTLE_ROUNDS && poll(&fds[1], 1, VRFY_LIVE_SETTLE_MS) > 0; i++){
+                drain_events(self);
+            }
+            pending = true;
+        }
+        if (pending){
+            reload(self);
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,98 @@
+/**
+ * \file        vrfy_live.h
+ * \brief       VRFY address set that is reloaded while smtpd runs, without blocking
+ *              the event loop.
+ *
+ * \details     The address file (index or plain list, see vrfy_index.h) is watched with
+ *              inotify (7). Reloads can also be requested explicitly (SIGHUP, manager
+ *              command) with `VrfyLive_request_reload`.
+ *
+ *              The new index is built on a background thread and published with an
+ *              atomic pointer swap. Lookups run inside read-side critical sections
+ *              (`VrfyLive_acquire` / `VrfyLive_release`), and the old index is only
+ *              released once no critical section that may have seen it is still
+ *              running (an RCU-style grace period). Readers never wait.
+ *
+ *              If a reload fails (for instance, the file is being rewritten or is
+ *              corrupt), the current index is kept.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#ifndef __VRFY_LIVE_H__
+#define __VRFY_LIVE_H__
+
+#include <stddef.h>         // size_t
+#include <stdbool.h>        // bool
+
+#include "vrfy_index.h"
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+/* Milliseconds without changes to the file before it is reloaded */
+#define VRFY_LIVE_SETTLE_MS         100
+
+/*************************************************************************/
+
+/**
+ * \typedef     VrfyLive: Main Live VRFY Address Set ADT data type.
+ */
+typedef struct _VrfyLive_t * VrfyLive;
+
+/*************************************************************************/
+
+/**
+ * \brief       Load the address file at `path` and start watching it.
+ *
+ * \param[in] path          Path to the address file. The string is internally copied.
+ *
+ * \return      A new VrfyLive on success, NULL if the file could not be loaded or the
+ *              reload thread could not be started (errno is set accordingly).
+ */
+VrfyLive VrfyLive_open(const char * path);
+
+/**
+ * \brief       Begin a read-side critical section and get the current index. The index
+ *              (and every string obtained from it) remains valid until `VrfyLive_release`.
+ *              Critical sections must be short and must not be nested.
+ *
+ * \param[in] self          The VrfyLive itself.
+ *
+ * \return      The current index.
+ */
+VrfyIndex VrfyLive_acquire(VrfyLive const self);
+
+/**
+ * \brief       End a read-side critical section.
+ */
+void VrfyLive_release(VrfyLive const self);
+
+/**
+ * \brief       Ask the reload thread to reload the address file. Async-signal-safe.
+ *
+ * \param[in] self          The VrfyLive itself. NULL-safe.
+ */
+void VrfyLive_request_reload(VrfyLive const self);
+
+/**
+ * \brief       Amount of addresses currently loaded.
+ */
+size_t VrfyLive_count(VrfyLive const self);
+
+/**
+ * \brief       Amount of successful and failed reloads so far.
+ */
+void VrfyLive_reloads(VrfyLive const self, size_t * ok, size_t * failed);
+
+/**
+ * \brief       Stop the reload thread and free all memory. No critical section may be
+ *              running.
+ *
+ * \param[in] self          The VrfyLive itself. NULL-safe.
+ */
+void VrfyLive_close(VrfyLive self);
+
+#endif // __VRFY_LIVE_H__
@@ -0,0 +1,42 @@
+/**
+ * \file        vrfyidx.c
+ * \brief       Compile a list of verified addresses (one per line) into an index that
+ *              smtpd memory-maps at startup (see src/utils/vrfy_index.h).
+ *
+ *              Usage: vrfyidx <ADDRESS LIST> <INDEX FILE>
+ *
+ *              The index file is replaced atomically, so it can be rebuilt while smtpd
+ *              is running.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdio.h>          // fprintf(), stderr
+#include <stdlib.h>         // EXIT_SUCCESS, EXIT_FAILURE
+#include <string.h>         // strerror()
+#include <errno.h>          // errno
+
+#include "vrfy_index.h"
+
+int main(int argc, char ** argv){
+    if (argc != 3){
+        fprintf(stderr, "Usage: %s <ADDRESS LIST> <INDEX FILE>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    VrfyIndex index = VrfyIndex_compile(argv[1]);
+    if (index == NULL){
+        fprintf(stderr, "Could not compile %s: %s\n", argv[1], strerror(errno));
+        return EXIT_FAILURE;
+    }
+    if (! VrfyIndex_save(index, argv[2])){
+        fprintf(stderr, "Could not write %s: %s\n", argv[2], strerror(errno));
+        VrfyIndex_close(index);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stdout, "%zu addresses written to %s\n", VrfyIndex_count(index), argv[2]);
+    VrfyIndex_close(index);
+    return EXIT_SUCCESS;
+}
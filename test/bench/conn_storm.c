@@ -0,0 +1,170 @@
+/**
+ * \file        conn_storm.c
+ * \brief       Benchmark connection churn: connect, read the greeting and disconnect,
+ *              over and over, counting the memory allocations the server performs.
+ *
+ *              Usage: conn_storm [CONNECTION QTY] [ROUND QTY] [CONCURRENT CONNECTIONS]
+ *                     (default: 10000 20 10)
+ *
+ *              The server (src/smtpd.bin, built beforehand) is started on a working
+ *              directory under /tmp with malloc_count.so preloaded. After every round, the
+ *              amount of allocations it performed during the round is reported: once the
+ *              server has warmed up, it should be 0.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SERVER_PATH         "../../src/smtpd.bin"
+#define PRELOAD_PATH        "./malloc_count.so"
+#define WORK_DIR            "/tmp/conn_storm"
+#define COUNT_FILE          WORK_DIR "/malloc_count.txt"
+#define DEFAULT_CONN_QTY    10000
+#define DEFAULT_ROUND_QTY   20
+#define DEFAULT_BATCH       10          // Up to the server's listen backlog
+#define SETTLE_US           100000
+#define GREETING_SIZE       512
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int connect_to(unsigned short port){
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0){
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+/* Ask the server for its allocation count, and read it back */
+static long alloc_count(pid_t server){
+    kill(server, SIGUSR2);
+    usleep(SETTLE_US);
+    FILE * file = fopen(COUNT_FILE, "r");
+    if (file == NULL){
+        return -1;
+    }
+    long count = -1, n;
+    while (fscanf(file, "%ld", &n) == 1){
+        count = n;
+    }
+    fclose(file);
+    return count;
+}
+
+static pid_t start_server(unsigned short port){
+    char preload[4096], server[4096], s_port[8], m_port[8];
+    if (realpath(PRELOAD_PATH, preload) == NULL || realpath(SERVER_PATH, server) == NULL){
+        perror("realpath");
+        return -1;
+    }
+    snprintf(s_port, sizeof(s_port), "%hu", port);
+    snprintf(m_port, sizeof(m_port), "%hu", (unsigned short) (port + 1));
+    pid_t pid = fork();
+    if (pid == 0){
+        if (chdir(WORK_DIR) < 0){
+            _exit(EXIT_FAILURE);
+        }
+        setenv("LD_PRELOAD", preload, 1);
+        setenv("MALLOC_COUNT_FILE", COUNT_FILE, 1);
+        execl(server, server, "-d", "example.com", "-s", s_port, "-p", m_port,
+              "-l", WORK_DIR "/smtpd.log", "-L", "3", (char *) NULL);
+        _exit(EXIT_FAILURE);
+    }
+    return pid;
+}
+
+int main(int argc, char ** argv){
+    size_t conn_qty  = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_CONN_QTY;
+    size_t round_qty = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_ROUND_QTY;
+    size_t batch     = argc > 3 ? strtoul(argv[3], NULL, 10) : DEFAULT_BATCH;
+    if (batch == 0){
+        batch = 1;
+    }
+
+    if (system("rm -rf " WORK_DIR " && mkdir -p " WORK_DIR) != 0){
+        perror(WORK_DIR);
+        return EXIT_FAILURE;
+    }
+    unsigned short port = 20000 + getpid() % 10000;
+    pid_t server = start_server(port);
+    if (server < 0){
+        return EXIT_FAILURE;
+    }
+
+    /* Wait for the server to be ready */
+    int probe = -1;
+    for (int i = 0; i < 50 && probe < 0; i++){
+        usleep(SETTLE_US);
+        probe = connect_to(port);
+    }
+    if (probe < 0){
+        fprintf(stderr, "Could not connect to the server on port %hu\n", port);
+        kill(server, SIGKILL);
+        return EXIT_FAILURE;
+    }
+    close(probe);
+    usleep(SETTLE_US);
+
+    int * fds = malloc(batch * sizeof(int));
+    char greeting[GREETING_SIZE];
+    long prev = alloc_count(server);
+    if (fds == NULL || prev < 0){
+        fprintf(stderr, "Could not read the allocation count (is %s built?)\n", PRELOAD_PATH);
+        kill(server, SIGKILL);
+        return EXIT_FAILURE;
+    }
+    printf("%zu connections per round, %zu at once\n", conn_qty, batch);
+
+    int ret = EXIT_SUCCESS;
+    for (size_t round = 1; round <= round_qty && ret == EXIT_SUCCESS; round++){
+        double t = now();
+        for (size_t done = 0; done < conn_qty; done += batch){
+            size_t qty = conn_qty - done < batch ? conn_qty - done : batch;
+            for (size_t i = 0; i < qty; i++){
+                fds[i] = connect_to(port);
+                if (fds[i] < 0){
+                    perror("connect");
+                    ret = EXIT_FAILURE;
+                    qty = i;
+                    break;
+                }
+            }
+            for (size_t i = 0; i < qty; i++){
+                if (recv(fds[i], greeting, sizeof(greeting), 0) <= 0){
+                    ret = EXIT_FAILURE;
+                }
+                close(fds[i]);
+            }
+        }
+        double elapsed = now() - t;
+        usleep(SETTLE_US);          // Let the server process the last disconnections
+        long count = alloc_count(server);
+        printf("round %3zu: %10.0f conn/s, %8ld server allocations\n", round, conn_qty / elapsed, count - prev);
+        prev = count;
+    }
+
+    free(fds);
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+    return ret;
+}
@@ -0,0 +1,193 @@
+/**
+ * \file        hashmap_bench.c
+ * \brief       Benchmark the open addressing HashMap (src/lib/hashmap.h) against the
+ *              former chained one (hashmap_chained.h), with 100, 10k and 1M entries.
+ *
+ *              Usage: hashmap_bench [ROUNDS]    (default: 3, the best round is shown)
+ *
+ *              Keys are either consecutive, as file descriptors are, or scattered
+ *              over the whole key range (odd multiples of a large constant, so they
+ *              are all different). The chained map is
+ *              measured both with its former fixed table of 100 buckets (as the
+ *              Selector used it, skipped for 1M entries since it takes minutes) and
+ *              with a table as big as the amount of entries.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "hashmap.h"
+#include "hashmap_chained.h"
+
+#define DEFAULT_ROUNDS      3
+#define CHAINED_FIXED_SIZE  100
+#define CHAINED_FIXED_MAX   10000       // Largest amount of entries measured with the fixed table.
+#define SCATTER_STRIDE      2654435761U
+
+#define KEY(i)              ((uint32_t) ((i) * key_stride))
+
+static uint32_t key_stride = 1;
+
+typedef struct {
+    double put;
+    double hit;
+    double miss;
+    double pop;
+} Times;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Frozen copy of the hash function that the Selector used with the chained map */
+static unsigned int num_digits(unsigned int number) {
+    if (number == 0){
+        return 1;
+    }
+    int digits = 0;
+    while (number > 0){
+        number /= 10;
+        digits++;
+    }
+    return digits;
+}
+
+static uint32_t multiplicative_hash(const ChainedMapKey key, const size_t size) {
+    const unsigned long long A = 2654435769U; // Knuth's multiplicative constant. See https://gist.github.com/badboy/6267743.
+    unsigned long long hash = key * A;
+    return (hash >> (32 - num_digits(size))) % size;
+}
+
+static bool key_equals(const ChainedMapKey key1, const ChainedMapKey key2){
+    return key1 == key2;
+}
+
+static void keep_best(Times * best, const Times * t){
+    best->put   = t->put  < best->put  ? t->put  : best->put;
+    best->hit   = t->hit  < best->hit  ? t->hit  : best->hit;
+    best->miss  = t->miss < best->miss ? t->miss : best->miss;
+    best->pop   = t->pop  < best->pop  ? t->pop  : best->pop;
+}
+
+static bool bench_chained(uint32_t qty, size_t table_size, Times * t){
+    ChainedMap map = ChainedMap_create_sized(multiplicative_hash, key_equals, table_size);
+    if (map == NULL){
+        return false;
+    }
+    size_t found = 0;
+    double start = now();
+    for (uint32_t i = 0; i < qty; i++){
+        if (ChainedMap_put(map, KEY(i), &found) != CHAINEDMAP_OK){
+            ChainedMap_cleanup(map, NULL);
+            return false;
+        }
+    }
+    t->put = now() - start;
+    start = now();
+    for (uint32_t i = 0; i < qty; i++){
+        found += ChainedMap_contains(map, KEY(i));
+    }
+    t->hit = now() - start;
+    start = now();
+    for (uint32_t i = qty; i < 2 * qty; i++){
+        found += ChainedMap_contains(map, KEY(i));
+    }
+    t->miss = now() - start;
+    start = now();
+    for (uint32_t i = 0; i < qty; i++){
+        found += ChainedMap_pop(map, KEY(i), NULL) == CHAINEDMAP_OK;
+    }
+    t->pop = now() - start;
+    ChainedMap_cleanup(map, NULL);
+    return found == 2 * (size_t) qty;
+}
+
+static bool bench_open(uint32_t qty, Times * t){
+    HashMap map = HashMap_create_default(HASHMAP_DEFAULT_CAPACITY);    // Grows as needed
+    if (map == NULL){
+        return false;
+    }
+    size_t found = 0;
+    double start = now();
+    for (uint32_t i = 0; i < qty; i++){
+        if (HashMap_put(map, KEY(i), &found) != HASHMAP_OK){
+            HashMap_cleanup(map, NULL);
+            return false;
+        }
+    }
+    t->put = now() - start;
+    start = now();
+    for (uint32_t i = 0; i < qty; i++){
+        found += HashMap_contains(map, KEY(i));
+    }
+    t->hit = now() - start;
+    start = now();
+    for (uint32_t i = qty; i < 2 * qty; i++){
+        found += HashMap_contains(map, KEY(i));
+    }
+    t->miss = now() - start;
+    start = now();
+    for (uint32_t i = 0; i < qty; i++){
+        found += HashMap_pop(map, KEY(i), NULL) == HASHMAP_OK;
+    }
+    t->pop = now() - start;
+    HashMap_cleanup(map, NULL);
+    return found == 2 * (size_t) qty;
+}
+
+static void print_row(const char * name, uint32_t qty, const Times * t){
+    printf("%-28s %8u %10.1f %10.1f %10.1f %10.1f\n", name, qty,
+           t->put / qty * 1e9, t->hit / qty * 1e9, t->miss / qty * 1e9, t->pop / qty * 1e9);
+}
+
+int main(int argc, char ** argv){
+    int rounds = argc > 1 ? atoi(argv[1]) : DEFAULT_ROUNDS;
+    if (rounds <= 0){
+        fprintf(stderr, "usage: %s [ROUNDS]\n", argv[0]);
+        return 1;
+    }
+
+    const uint32_t qtys[] = { 100, 10000, 1000000 };
+    const uint32_t strides[] = { 1, SCATTER_STRIDE };
+    for (size_t k = 0; k < sizeof(strides) / sizeof(strides[0]); k++){
+        key_stride = strides[k];
+        printf("%s keys\n", key_stride == 1 ? "Consecutive" : "Scattered");
+        printf("%-28s %8s %10s %10s %10s %10s   (ns per operation)\n", "map", "entries", "put", "hit", "miss", "pop");
+        for (size_t q = 0; q < sizeof(qtys) / sizeof(qtys[0]); q++){
+            uint32_t qty = qtys[q];
+            Times fixed = { 1e9, 1e9, 1e9, 1e9 }, sized = fixed, open = fixed, t;
+            for (int r = 0; r < rounds; r++){
+                if (qty <= CHAINED_FIXED_MAX){
+                    if (! bench_chained(qty, CHAINED_FIXED_SIZE, &t)){
+                        fprintf(stderr, "chained map failed\n");
+                        return 1;
+                    }
+                    keep_best(&fixed, &t);
+                }
+                if (! bench_chained(qty, qty, &t)){
+                    fprintf(stderr, "chained map failed\n");
+                    return 1;
+                }
+                keep_best(&sized, &t);
+                if (! bench_open(qty, &t)){
+                    fprintf(stderr, "open addressing map failed\n");
+                    return 1;
+                }
+                keep_best(&open, &t);
+            }
+            if (qty <= CHAINED_FIXED_MAX){
+                print_row("chained (100 buckets)", qty, &fixed);
+            }
+            print_row("chained (sized to entries)", qty, &sized);
+            print_row("open addressing (robin hood)", qty, &open);
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,212 @@
+/**
+ * \file        hashmap_chained.c
+ * \brief       Frozen copy of the former chained HashMap (src/lib/hashmap), renamed to
+ *              ChainedMap, kept as a baseline for hashmap_bench. Keys are widened to
+ *              uint32_t so that it can hold more than 65536 entries.
+ * 
+ * \date        May, 2024
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+*/
+
+#include "hashmap_chained.h"
+
+#define CHAINEDMAP_DEFAULT_HASH_TABLE_SIZE 100
+
+typedef struct _ChainedMap_Node_t{
+    ChainedMapKey                  key;
+    ChainedMapValue                val;
+    struct _ChainedMap_Node_t *    next;
+} _ChainedMap_Node_t;
+
+typedef struct _ChainedMap_t{
+    struct _ChainedMap_Node_t **   table;
+    size_t                      table_size;
+    ChainedMapHashFunction         hash_fn;
+    ChainedMapKeyEqualsCallback    equals_fn;
+    int32_t elem_count;
+} _ChainedMap_t;
+
+static ChainedMapErrors ChainedMap_find(ChainedMap map, ChainedMapKey key, ChainedMapValue * val, bool remove_on_found){
+    // Find position in the hash table
+    uint32_t position = map->hash_fn(key, map->table_size);
+    if (position >= map->table_size){ // As hash_fn is customizable, check if the returned position is within the hash table bounds
+        return CHAINEDMAP_BAD_HASH_FUNCTION;
+    }
+
+    // Find the node inside the linked list for the calculated position in the hash table
+    _ChainedMap_Node_t * previous_node = NULL;
+    _ChainedMap_Node_t * current_node = map->table[position];
+    while(current_node != NULL && ! map->equals_fn(current_node->key, key)){
+        previous_node = current_node;
+        current_node = current_node->next;
+    }
+    if (current_node == NULL){
+        return CHAINEDMAP_KEY_NOT_FOUND;
+    }
+
+    // Store the value
+    if (val != NULL){
+        * val = current_node->val;
+    }
+    
+    // Remove the value if asked to do so
+    if (remove_on_found){
+        if (previous_node == NULL){ // The key was found in the first node of the linked list
+            map->table[position] = current_node->next;
+        }
+        else{
+            previous_node->next = current_node->next;
+        }
+        CHAINEDMAP_FREE(current_node);
+    }
+
+    // Found!
+    return CHAINEDMAP_OK;
+}
+
+ChainedMap ChainedMap_create(ChainedMapHashFunction hash_fn, ChainedMapKeyEqualsCallback equals_fn){
+    return ChainedMap_create_sized(hash_fn, equals_fn, CHAINEDMAP_DEFAULT_HASH_TABLE_SIZE);
+}
+
+ChainedMap ChainedMap_create_sized(ChainedMapHashFunction hash_fn, ChainedMapKeyEqualsCallback equals_fn, const size_t table_size){
+    // Check parameters
+    if (hash_fn == NULL || equals_fn == NULL){
+        return NULL;
+    }
+
+    // Create ChainedMap structure
+    ChainedMap map = CHAINEDMAP_MALLOC(sizeof(_ChainedMap_t));
+    if (map  == NULL){
+        return NULL;
+    }
+    map->table_size = table_size;
+    map->hash_fn = hash_fn;
+    map->equals_fn = equals_fn;
+    map->elem_count = 0;
+    
+    // Create table
+    map->table = CHAINEDMAP_CALLOC(map->table_size, sizeof(_ChainedMap_Node_t *)); // Each element is initialized to 0 (NULL)
+    if (map->table == NULL){
+        CHAINEDMAP_FREE(map);
+        return NULL;
+    }
+
+    // ChainedMap created an initialized
+    return map;
+}
+
+ChainedMapErrors ChainedMap_put(ChainedMap const map, const ChainedMapKey key, const ChainedMapValue val){
+    if (map == NULL || map->table == NULL || map->hash_fn == NULL || map->equals_fn == NULL){
+        return CHAINEDMAP_INVALID_STATE;
+    }
+    // Find position in the hash table
+    uint32_t position = map->hash_fn(key, map->table_size);
+    if (position >= map->table_size){ // As hash_fn is customizable, check if the returned position is within the hash table bounds
+        return CHAINEDMAP_BAD_HASH_FUNCTION;
+    }
+    // Traverse the linked list for the calculated position
+    _ChainedMap_Node_t * previous_node = NULL;
+    _ChainedMap_Node_t * current_node = map->table[position];
+    while (current_node != NULL){
+        // Make sure that the provided key is not already present in the Hash Map
+        if (map->equals_fn(current_node->key, key)){
+            return CHAINEDMAP_DUPLICATED_KEY;
+        }
+        previous_node = current_node;
+        current_node = current_node->next;
+    }
+    // Create a new node
+    _ChainedMap_Node_t * new_node = CHAINEDMAP_MALLOC(sizeof(_ChainedMap_Node_t));
+    if (new_node == NULL){
+        return CHAINEDMAP_NO_MEMORY;
+    }
+    new_node->key = key;
+    new_node->val = val;
+    new_node->next = NULL;
+    // Insert the new node into the list
+    if (previous_node == NULL){ // No node in that table position
+        map->table[position] = new_node;
+    }
+    else {
+        previous_node->next = new_node;
+    }
+    // Increment the size
+    map->elem_count++;
+    return CHAINEDMAP_OK;
+}
+
+ChainedMapErrors ChainedMap_peek(ChainedMap const map, const ChainedMapKey key, ChainedMapValue * val){
+    if (map == NULL || map->table == NULL || map->hash_fn == NULL || map->equals_fn == NULL){
+        return CHAINEDMAP_INVALID_STATE;
+    }
+    ChainedMapValue value;
+    switch (ChainedMap_find(map, key, &value, false)){
+        case CHAINEDMAP_KEY_NOT_FOUND:
+            return CHAINEDMAP_KEY_NOT_FOUND;
+        case CHAINEDMAP_BAD_HASH_FUNCTION:
+            return CHAINEDMAP_BAD_HASH_FUNCTION;
+        default:
+            break;
+    }
+    if (val != NULL){
+        * val = value;
+    }
+    return CHAINEDMAP_OK;
+}
+
+ChainedMapErrors ChainedMap_pop(ChainedMap const map, const ChainedMapKey key, ChainedMapValue * val){
+    if (map == NULL || map->table == NULL || map->hash_fn == NULL || map->equals_fn == NULL){
+        return CHAINEDMAP_INVALID_STATE;
+    }
+    ChainedMapValue value;
+    switch (ChainedMap_find(map, key, &value, true)){
+        case CHAINEDMAP_KEY_NOT_FOUND:
+            return CHAINEDMAP_KEY_NOT_FOUND;
+        case CHAINEDMAP_BAD_HASH_FUNCTION:
+            return CHAINEDMAP_BAD_HASH_FUNCTION;
+        default:
+            break;
+    }
+    if (val != NULL){
+        * val = value;
+    }
+    // Decrement the size
+    map->elem_count--;
+    return CHAINEDMAP_OK;
+}   
+
+bool ChainedMap_contains(ChainedMap const map, const ChainedMapKey key){
+    if (map == NULL || map->table == NULL || map->hash_fn == NULL || map->equals_fn == NULL){
+        return false;
+    }
+    return ChainedMap_find(map, key, NULL, false) == CHAINEDMAP_OK;
+}
+
+void ChainedMap_cleanup(ChainedMap const map, ChainedMapCleanupCallback cb){
+    if (map == NULL){
+        return;
+    }
+    if (map->table != NULL){
+        for (unsigned int i = 0; i < map->table_size; i++){
+            _ChainedMap_Node_t * current_node = map->table[i];
+            _ChainedMap_Node_t * next_node = NULL;
+            while (current_node != NULL){
+                if (cb != NULL){
+                    cb(current_node->val);
+                }
+                next_node = current_node->next;
+                CHAINEDMAP_FREE(current_node);
+                current_node = next_node;
+            }
+        }
+        CHAINEDMAP_FREE(map->table);
+    }
+    CHAINEDMAP_FREE(map);
+}
+
+int32_t ChainedMap_size(ChainedMap const map){
+    if (map == NULL || map->table == NULL || map->hash_fn == NULL || map->equals_fn == NULL){
+        return CHAINEDMAP_INVALID_STATE;
+    }
+    return map->elem_count;
+}
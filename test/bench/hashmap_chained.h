@@ -0,0 +1,192 @@
+/**
+ * \file        hashmap_chained.h
+ * \brief       Frozen copy of the former chained HashMap (src/lib/hashmap), renamed to
+ *              ChainedMap, kept as a baseline for hashmap_bench. Keys are widened to
+ *              uint32_t so that it can hold more than 65536 entries.
+ * 
+ * \date        May, 2024
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+*/
+
+#ifndef __HASHMAP_CHAINED_H__
+#define __HASHMAP_CHAINED_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************************************/
+/*                              CUSTOMIZABLE                             */
+/*************************************************************************/
+
+#include <stdlib.h>
+
+/* Memory allocation function equivalent to malloc (3) or a malloc (3) wrapper. May not initialize the allocated zone. */
+#define CHAINEDMAP_MALLOC(size) malloc((size))
+
+/* Memory allocation function equivalent to calloc (3) or a calloc (3) wrapper. Must initialize the allocated zone to 0. */
+#define CHAINEDMAP_CALLOC(qty, el_size) calloc((qty), (el_size))
+
+/* Memory freeing function equivalent to free (3) or a free (3) wrapper. */
+#define CHAINEDMAP_FREE(ptr) free((ptr))
+
+/* Data type used for the Keys. */
+/* This type must be trivially copyable (via assignment). I.e. it cannot be an array type like char[], use char* instead. */
+#define CHAINEDMAP_KEY_DATA_TYPE uint32_t
+
+/* Data type used for the Values. */
+/* This type must be trivially copyable (via assignment). I.e. it cannot be an array type like char[], use char* instead. */
+#define CHAINEDMAP_VAL_DATA_TYPE void *
+
+/*************************************************************************/
+/*                           NON - CUSTOMIZABLE                          */
+/*************************************************************************/
+
+/**
+ * \typedef Data type of the Keys.
+*/
+typedef CHAINEDMAP_KEY_DATA_TYPE ChainedMapKey;
+
+/**
+ * \typedef Data type of the stored Values.
+*/
+typedef CHAINEDMAP_VAL_DATA_TYPE ChainedMapValue;
+
+/**
+ * \typedef ChainedMap main Abstract Data Type
+*/
+typedef struct _ChainedMap_t * ChainedMap;
+
+/**
+ * \typedef Hashing function callback
+*/
+typedef uint32_t (* ChainedMapHashFunction) (const ChainedMapKey key, const size_t hash_table_size);
+
+/**
+ * \typedef Callback function used to check if two ChainedMapKeys are equal
+*/
+typedef bool (* ChainedMapKeyEqualsCallback) (const ChainedMapKey key1, const ChainedMapKey key2);
+
+/**
+ * \typedef Callback function used to free the memory allocated for the Values when calling \ChainedMap_cleanup
+*/
+typedef void (* ChainedMapCleanupCallback) (ChainedMapValue val);
+
+/**
+ * \enum Enumeration of possible errors that can occur when calling ChainedMap functions.
+*/
+typedef enum {
+    CHAINEDMAP_OK                  =  0,   // 0: No error
+    CHAINEDMAP_NO_MEMORY           = -1,   // 1: Not enough memory
+    CHAINEDMAP_DUPLICATED_KEY      = -2,   // 2: Key was already present when performing a put() operation
+    CHAINEDMAP_KEY_NOT_FOUND       = -3,   // 3: Key was not found when performing a peek() or pop() operation
+    CHAINEDMAP_INVALID_STATE       = -4,   // 4: ChainedMap is in an invalid state (it may not have been created successfully)
+    CHAINEDMAP_BAD_HASH_FUNCTION   = -5    // 5: The provided ChainedMapHashFunction returned an invalid value. This happens when
+                                        //    said function returns a value that is greater or equal to the internal hash
+                                        //    table size. Verify that your function uses the \hash_table_size parameter and
+                                        //    that the number it returns is never greater nor equal to that parameter.
+} ChainedMapErrors;
+
+/*************************************************************************/
+
+/**
+ * \brief       Initializes a new ChainedMap using the default hash table size (100).
+ * 
+ * \param[in]  hash_fn   Function used to perform hashing operations according to the ChainedMapKey data type.
+ * \param[in]  equals_fn Function used to indicate whether 2 elements of type ChainedMapKey are equal or not.
+ * 
+ * \return      A new ChainedMap on success, NULL on failure (memory not available or NULL passed as a function).
+ */
+ChainedMap ChainedMap_create(ChainedMapHashFunction hash_fn, ChainedMapKeyEqualsCallback equals_fn);
+
+/**
+ * \brief       Initializes a new ChainedMap indicating a hash table size.
+ * 
+ * \param[in]  hash_fn   Function used to perform hashing operations according to the ChainedMapKey data type.
+ * \param[in]  equals_fn Function used to indicate whether 2 elements of type ChainedMapKey are equal or not.
+ * \param[in]  size      Size of the internal hash table. A bigger size typically improves performance, but also 
+ *                       increases memory usage.
+ * 
+ * \return      A new ChainedMap on success, NULL on failure (memory not available or NULL passed as a function).
+ */
+ChainedMap ChainedMap_create_sized(ChainedMapHashFunction hash_fn, ChainedMapKeyEqualsCallback equals_fn, const size_t size);
+
+/**
+ * \brief       Insert a new (key, value) pair to the ChainedMap.
+ * 
+ * \param[in]  map The ChainedMap itself.
+ * \param[in]  key Integer used as Key. Must be unique.
+ * \param[in]  val The Value associated to the previous Key.
+ * 
+ * \return      Returns CHAINEDMAP_OK on success, CHAINEDMAP_NO_MEMORY if no memory was available
+ *              to create the new (key, value) pair, or CHAINEDMAP_DUPLICATED_KEY if the
+ *              provided Key was already present in the ChainedMap.
+ *              If an invalid or corrupted ChainedMap is provided, CHAINEDMAP_INVALID_STATE is returned.
+ *              If the provided ChainedMapHashFunction returns an invalid value, CHAINEDMAP_BAD_HASH_FUNCTION is returned.
+*/
+ChainedMapErrors ChainedMap_put(ChainedMap const map, const ChainedMapKey key, const ChainedMapValue val);
+
+/**
+ * \brief       Get the Value associated to a Key.
+ * 
+ * \param[in]  map The ChainedMap itself.
+ * \param[in]  key A key of type ChainedMapKey.
+ * \param[out] val A pointer to ChainedMapValue. It is only modified if the provided Key is found.
+ * 
+ * \return      Returns CHAINEDMAP_OK on success, or CHAINEDMAP_KEY_NOT_FOUND if the ChainedMap
+ *              does not contain the provided Key.
+ *              If an invalid or corrupted ChainedMap is provided, CHAINEDMAP_INVALID_STATE is returned.
+ *              If the provided ChainedMapHashFunction returns an invalid value, CHAINEDMAP_BAD_HASH_FUNCTION is returned.
+*/
+ChainedMapErrors ChainedMap_peek(ChainedMap const map, const ChainedMapKey key, ChainedMapValue * val);
+
+/**
+ * \brief       Get the Value associated to a Key, and remove the (key, value) pair from the ChainedMap.
+ * 
+ * \param[in]  map The ChainedMap itself.
+ * \param[in]  key A key of type ChainedMapKey.
+ * \param[out] val A pointer to ChainedMapValue. It is only modified if the provided Key is found.
+ *                 Note that the caller is responsible for freeing values after a pop operation, as the ChainedMap will
+ *                 no longer keep a reference to it.
+ * 
+ * \return      Returns CHAINEDMAP_OK on success, or CHAINEDMAP_KEY_NOT_FOUND if the ChainedMap
+ *              does not contain the provided Key.
+ *              If an invalid or corrupted ChainedMap is provided, CHAINEDMAP_INVALID_STATE is returned.
+ *              If the provided ChainedMapHashFunction returns an invalid value, CHAINEDMAP_BAD_HASH_FUNCTION is returned.
+*/
+ChainedMapErrors ChainedMap_pop(ChainedMap const map, const ChainedMapKey key, ChainedMapValue * val);
+
+/**
+ * \brief       Check if a Key is present in the ChainedMap.
+ * 
+ * \param[in]  map The ChainedMap itself.
+ * \param[in]  key A key of type ChainedMapKey.
+ * 
+ * \return      A boolean value indicating whether the Key is present or not.
+ *              If an invalid or corrupted ChainedMap is provided, false is returned.
+ *              If the provided ChainedMapHashFunction returns an invalid value, false is returned.
+*/
+bool ChainedMap_contains(ChainedMap const map, const ChainedMapKey key);
+
+/**
+ * \brief       Free all memory used by the ChainedMap and destroy it.
+ * \details     After calling this function, \map must not be dereferenced again.
+ *              If an invalid or corrupted ChainedMap is provided, any resources that may remain allocated are freed.
+ * 
+ * \param[in]  map The ChainedMap itself.
+ * \param[in]  cb  A \ChainedMapCleanupCallback function that is used to free the memory allocated for the Values.
+ *                 If this parameter is NULL, no Value cleanup will be performed.
+*/
+void ChainedMap_cleanup(ChainedMap const map, ChainedMapCleanupCallback cb);
+
+/**
+ * \brief       Get how many elements are inside the ChainedMap.
+ * 
+ * \param[in]  map The ChainedMap itself.
+ * 
+ * \return      An integer indicating how many elements the ChainedMap holds inside. If the provided ChainedMap
+ *              is NULL, CHAINEDMAP_INVALID_STATE is returned.
+*/
+int32_t ChainedMap_size(ChainedMap const map);
+
+#endif // __HASHMAP_CHAINED_H__
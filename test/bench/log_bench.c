@@ -0,0 +1,106 @@
+/**
+ * \file        log_bench.c
+ * \brief       Benchmark the cost of a log record: formatting the date and time with
+ *              time (2), localtime (3) and strftime (3) on every record (as the Logger
+ *              used to) against the per-second cache of src/lib/clock.h.
+ *
+ *              Usage: log_bench [RECORD QTY]    (default: 2000000)
+ *
+ *              Records are written to /dev/null by a synchronous Logger, so that the
+ *              numbers reflect formatting rather than the disk. The cost of a record in
+ *              binary mode (src/lib/logfmt.h) is shown too.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "logger.h"
+#include "clock.h"
+
+#define DEFAULT_RECORD_QTY  2000000
+
+/* Frozen copy of the former get_current_datetime (): one localtime (3) and strftime (3) per record */
+static void legacy_datetime(char * buff, size_t size){
+    time_t rawtime;
+    time(&rawtime);
+    strftime(buff, size, DATETIME_FORMAT, localtime(&rawtime));
+}
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char ** argv){
+    long qty = argc > 1 ? atol(argv[1]) : DEFAULT_RECORD_QTY;
+    if (qty <= 0){
+        fprintf(stderr, "usage: %s [RECORD QTY]\n", argv[0]);
+        return 1;
+    }
+
+    /* Date and time alone */
+    char buff[MAX_DATETIME_LEN];
+    volatile char sink = 0;
+    double start = now();
+    for (long i = 0; i < qty; i++){
+        legacy_datetime(buff, MAX_DATETIME_LEN);
+        sink ^= buff[18];
+    }
+    double legacy = now() - start;
+
+    start = now();
+    for (long i = 0; i < qty; i++){
+        sink ^= Clock_datetime()[18];
+    }
+    double cached = now() - start;
+
+    /* Whole records: the former per-record formatting is emulated by formatting the date and time as part of the message */
+    LoggerConfig cfg = {
+        .min_log_level  = LOGGER_LEVEL_NORMAL,
+        .with_level     = true,
+        .log_prefix     = "smtpd v0.1.0"
+    };
+    Logger logger = Logger_create(cfg, "/dev/null");
+    if (logger == NULL){
+        perror("Logger_create");
+        return 1;
+    }
+    start = now();
+    for (long i = 0; i < qty; i++){
+        legacy_datetime(buff, MAX_DATETIME_LEN);
+        LOG_MSG("@[%s] New client connected at %s : %ld.", buff, "127.0.0.1", i);
+    }
+    double legacy_record = now() - start;
+
+    start = now();
+    for (long i = 0; i < qty; i++){
+        LOG_MSG("@[%s] New client connected at %s : %ld.", Clock_datetime(), "127.0.0.1", i);
+    }
+    double cached_record = now() - start;
+    Logger_cleanup(logger);
+
+    /* Whole records in binary mode: no formatting at all */
+    cfg.with_datetime = true;
+    cfg.binary = true;
+    if ((logger = Logger_create(cfg, "/dev/null")) == NULL){
+        perror("Logger_create");
+        return 1;
+    }
+    start = now();
+    for (long i = 0; i < qty; i++){
+        LOG_MSG("New client connected at %s : %ld.", "127.0.0.1", i);
+    }
+    double binary_record = now() - start;
+    Logger_cleanup(logger);
+
+    printf("records:                     %ld\n", qty);
+    printf("date and time, per record:   %8.1f ns  ->  %8.1f ns (cached)\n", legacy / qty * 1e9, cached / qty * 1e9);
+    printf("whole record (/dev/null):    %8.1f ns  ->  %8.1f ns (cached)\n", legacy_record / qty * 1e9, cached_record / qty * 1e9);
+    printf("binary record (/dev/null):   %8.1f ns\n", binary_record / qty * 1e9);
+    return sink == 42 ? 2 : 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * \file        stats_bench.c
+ * \brief       Benchmark concurrent counter updates: sharded Stats (src/utils/stats.h)
+ *              against a single atomic shared by every thread.
+ *
+ *              Usage: stats_bench [MAX THREAD QTY] [UPDATES PER THREAD]    (default: 8 10000000)
+ *
+ *              For 1, 2, 4... threads, every thread increments the same counter, and the
+ *              time per update is reported.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "stats.h"
+
+#define DEFAULT_MAX_THREADS     8
+#define DEFAULT_UPDATES         10000000
+
+static Stats stats;
+static atomic_long shared = 0;
+static size_t updates;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void * sharded_worker(void * arg){
+    (void) arg;
+    for (size_t i = 0; i < updates; i++){
+        Stats_increment(stats, STATKEY_TRANSF_BYTES);
+    }
+    return NULL;
+}
+
+static void * shared_worker(void * arg){
+    (void) arg;
+    for (size_t i = 0; i < updates; i++){
+        atomic_fetch_add_explicit(&shared, 1, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+/* Run `qty` threads and return the time per update, in nanoseconds */
+static double run(void * (* worker)(void *), int qty){
+    pthread_t threads[qty];
+    double t = now();
+    for (int i = 0; i < qty; i++){
+        pthread_create(&threads[i], NULL, worker, NULL);
+    }
+    for (int i = 0; i < qty; i++){
+        pthread_join(threads[i], NULL);
+    }
+    return (now() - t) / (updates * qty) * 1e9;
+}
+
+int main(int argc, char ** argv){
+    int max_threads = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_THREADS;
+    updates = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_UPDATES;
+    if ((stats = Stats_init()) == NULL){
+        perror("Stats_init");
+        return EXIT_FAILURE;
+    }
+
+    printf("%8s %18s %18s\n", "threads", "shared ns/update", "sharded ns/update");
+    long expected = 0;
+    for (int qty = 1; qty <= max_threads; qty *= 2){
+        double shared_ns  = run(shared_worker, qty);
+        double sharded_ns = run(sharded_worker, qty);
+        expected += (long) updates * qty;
+        printf("%8d %18.2f %18.2f\n", qty, shared_ns, sharded_ns);
+    }
+
+    /* No update may be lost */
+    StatVal val;
+    Stats_get(stats, STATKEY_TRANSF_BYTES, &val);
+    int ret = val == expected && atomic_load(&shared) == expected ? EXIT_SUCCESS : EXIT_FAILURE;
+    if (ret != EXIT_SUCCESS){
+        fprintf(stderr, "Lost updates: %ld sharded, %ld shared, %ld expected\n", val, atomic_load(&shared), expected);
+    }
+    Stats_cleanup(stats);
+    return ret;
+}
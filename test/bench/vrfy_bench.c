@@ -0,0 +1,127 @@
+/**
+ * \file        vrfy_bench.c
+ * \brief       Benchmark VRFY lookups: the former line-by-line scan of the address file
+ *              against the memory-mapped index (src/utils/vrfy_index.h).
+ *
+ *              Usage: vrfy_bench [ADDRESS QTY]    (default: 1000000)
+ *
+ *              A list of random addresses is generated under /tmp, compiled into an
+ *              index, and queried with exact addresses, ambiguous prefixes and unknown
+ *              addresses.
+ *
+ * \date        October, 2026
+ * \author      Causse, Juan Ignacio (jcausse@itba.edu.ar)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vrfy_index.h"
+
+#define LIST_PATH           "/tmp/vrfy_bench.txt"
+#define INDEX_PATH          "/tmp/vrfy_bench.idx"
+#define DEFAULT_ADDR_QTY    1000000
+#define SCAN_QUERIES        20
+#define INDEX_QUERIES       1000000
+#define MAX_MATCHES         10
+#define LINE_SIZE           256
+
+static const char * domains[] = { "example.com", "itba.edu.ar", "mail.org", "test.net" };
+
+/* Frozen copy of the former vrfy (): one pass over the file per query */
+static int scan(const char * query, const char * path){
+    FILE * file = fopen(path, "r");
+    if (file == NULL){
+        return -1;
+    }
+    int count = 0;
+    char line[LINE_SIZE];
+    while (fgets(line, LINE_SIZE, file) != NULL){
+        if (strlen(line) > strlen(query) && strstr(line, query) != NULL){
+            count++;
+        }
+    }
+    fclose(file);
+    return count;
+}
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void make_addr(char * buff, size_t i){
+    snprintf(buff, LINE_SIZE, "user%zu.%x@%s", i, (unsigned) (i * 2654435761U) & 0xFFFF, domains[i % 4]);
+}
+
+int main(int argc, char ** argv){
+    size_t qty = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_ADDR_QTY;
+    char addr[LINE_SIZE];
+
+    FILE * list = fopen(LIST_PATH, "w");
+    if (list == NULL){
+        perror(LIST_PATH);
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < qty; i++){
+        make_addr(addr, i);
+        fprintf(list, "%s\n", addr);
+    }
+    fclose(list);
+
+    double t = now();
+    VrfyIndex built = VrfyIndex_compile(LIST_PATH);
+    if (built == NULL || ! VrfyIndex_save(built, INDEX_PATH)){
+        perror("build");
+        return EXIT_FAILURE;
+    }
+    VrfyIndex_close(built);
+    printf("%zu addresses, index built in %.3f s\n", qty, now() - t);
+
+    t = now();
+    VrfyIndex index = VrfyIndex_open(INDEX_PATH);
+    if (index == NULL){
+        perror(INDEX_PATH);
+        return EXIT_FAILURE;
+    }
+    printf("index loaded in %.3f ms\n", (now() - t) * 1e3);
+
+    /* Former scan: a handful of queries is enough */
+    t = now();
+    long found = 0;
+    for (size_t i = 0; i < SCAN_QUERIES; i++){
+        make_addr(addr, (i * 7919) % qty);
+        found += scan(addr, LIST_PATH);
+    }
+    double scan_us = (now() - t) / SCAN_QUERIES * 1e6;
+    printf("scan:          %12.2f us/query (%ld found)\n", scan_us, found);
+
+    const char * matches[MAX_MATCHES];
+    const char * kinds[] = { "index exact:", "index prefix:", "index miss:" };
+    for (int kind = 0; kind < 3; kind++){
+        found = 0;
+        t = now();
+        for (size_t i = 0; i < INDEX_QUERIES; i++){
+            size_t n = (i * 7919) % qty;
+            if (kind == 0){
+                make_addr(addr, n);
+            }
+            else if (kind == 1){
+                snprintf(addr, LINE_SIZE, "user%zu", n / 10);       // Ambiguous: user12, user120...
+            }
+            else{
+                snprintf(addr, LINE_SIZE, "nobody%zu@example.com", n);
+            }
+            found += VrfyIndex_lookup(index, addr, matches, MAX_MATCHES) > 0;
+        }
+        printf("%-14s %12.3f us/query (%ld found)\n", kinds[kind], (now() - t) / INDEX_QUERIES * 1e6, found);
+    }
+
+    VrfyIndex_close(index);
+    remove(LIST_PATH);
+    remove(INDEX_PATH);
+    return EXIT_SUCCESS;
+}
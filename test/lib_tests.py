@@ -5,7 +5,7 @@ import argparse
 
 COMPILER: str = 'gcc'
 COMPILER_VERSION_CMD: str = 'gcc -v'
-CFLAGS: str = '-std=c11 -pedantic -pedantic-errors -Wall -Werror -Wextra -D_POSIX_C_SOURCE=200112L -D __USE_DEBUG_LOGS__'
+CFLAGS: str = '-std=c11 -pedantic -pedantic-errors -Wall -Werror -Wextra -D_POSIX_C_SOURCE=200112L -D __USE_DEBUG_LOGS__ -pthread'
 
 VALGRIND: str = 'valgrind'
 VALGRIND_VERSION_CMD: str = 'valgrind --version'
@@ -31,21 +31,23 @@ def check_valgrind():
 
 
 class Library:
-    def __init__(self, dir: str, name: str, verbose: bool):
+    def __init__(self, dir: str, name: str, deps: list[str], verbose: bool):
         self.__dir: str = dir
         self.__name: str = name
         self.__verbose: bool = verbose
         self.__source: str = f'{name}.c'
         self.__header: str = f'{name}.h'
         self.__tester: str = f'{name}_test.c'
-        self.__files: list[str] = [self.__source, self.__header, self.__tester]
+        self.__deps: list[str] = [f'{dep}.c' for dep in deps]
+        self.__files: list[str] = [self.__source, self.__header, self.__tester] + self.__deps
     
     def check(self) -> bool:
         file_list: list[str] = [f for f in os.listdir(self.__dir) if os.path.isfile(self.__dir + '/' + f)]
         return all(file in file_list for file in self.__files)
     
     def compile(self) -> bool:
-        cmd: str = f"{COMPILER} {CFLAGS} {self.__dir + '/' + self.__source} {self.__dir + '/' + self.__tester} -o {self.__dir + '/' + self.__name}.bin "
+        sources: list[str] = [self.__source] + self.__deps + [self.__tester]
+        cmd: str = f"{COMPILER} {CFLAGS} {' '.join(self.__dir + '/' + source for source in sources)} -o {self.__dir + '/' + self.__name}.bin "
         cmd += f"{'' if self.__verbose else ' > /dev/null 2>&1'}"
         if self.__verbose:
             print(cmd)
@@ -73,10 +75,12 @@ def test_all():
     for i in range(len(libraries)):
         libraries[i] = libraries[i].strip()
     
-    for lib_name in libraries:
-        if lib_name.startswith('#'):
+    for line in libraries:
+        if line == '' or line.startswith('#'):
             continue
-        lib = Library(LIB_DIR, lib_name, args.verbose)
+        # Each line holds a library name, followed by the libraries it depends on (if any)
+        lib_name, *deps = line.split()
+        lib = Library(LIB_DIR, lib_name, deps, args.verbose)
         if lib.check() is False:
             print(f'Missing files for library: {lib_name}')
             continue